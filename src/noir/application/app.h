@@ -32,14 +32,31 @@ public:
   virtual std::unique_ptr<ResponseDeliverTx> deliver_tx_async(const RequestDeliverTx& req) {
     return {};
   }
+
+  /// \brief delivers txs of a block in consecutive groups, none of which has txs conflicting with each other
+  /// Groups are a hint of the proposer, so apps delivering txs of a group in parallel must still give the results of
+  /// delivering txs one by one. Only in-process apps are called; returns empty to have txs delivered one by one.
+  /// \param group_sizes sizes of the groups, adding up to the number of txs
+  virtual std::vector<std::unique_ptr<ResponseDeliverTx>> deliver_tx_groups(
+    const std::vector<RequestDeliverTx>& reqs, const std::vector<uint32_t>& group_sizes) {
+    return {};
+  }
   virtual std::unique_ptr<ResponseCommit> commit() {
     return std::make_unique<ResponseCommit>();
   }
 
-  virtual std::unique_ptr<ResponseCheckTx> check_tx_sync() {
+  /// \brief read-only query, which may run concurrently with block execution and other queries
+  virtual std::unique_ptr<ResponseQuery> query_sync(const RequestQuery& req) {
+    return {};
+  }
+
+  /// \brief checks tx before it enters the mempool
+  /// Apps delivering txs in groups declare the keys tx reads and writes in read_keys and write_keys of the response,
+  /// from which the proposer makes groups of txs not conflicting with each other.
+  virtual std::unique_ptr<ResponseCheckTx> check_tx_sync(const RequestCheckTx& req) {
     return {};
   }
-  virtual std::unique_ptr<ResponseCheckTx> check_tx_async() {
+  virtual std::unique_ptr<ResponseCheckTx> check_tx_async(const RequestCheckTx& req) {
     return {};
   }
 
@@ -0,0 +1,93 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/application/app.h>
+#include <map>
+#include <mutex>
+#include <optional>
+
+namespace noir::application {
+
+/// \brief in-memory key-value store, the counterpart of the kvstore example app of tendermint
+/// A tx of `key=value` sets key to value, and any other tx is stored as both key and value.
+/// The app hash is the number of keys as a big-endian 8-byte integer. A query returns the value of the key in its data.
+class kvstore_app : public base_application {
+public:
+  kvstore_app() {}
+
+  virtual std::unique_ptr<ResponseBeginBlock> begin_block(const RequestBeginBlock& req) override {
+    return std::make_unique<ResponseBeginBlock>();
+  }
+
+  virtual std::unique_ptr<ResponseEndBlock> end_block(const RequestEndBlock& req) override {
+    return std::make_unique<ResponseEndBlock>();
+  }
+
+  virtual std::unique_ptr<ResponseDeliverTx> deliver_tx_async(const RequestDeliverTx& req) override {
+    auto res = std::make_unique<ResponseDeliverTx>();
+    const auto& tx = req.tx();
+    if (tx.empty()) {
+      res->set_code(1);
+      res->set_log("empty tx");
+      return res;
+    }
+
+    std::scoped_lock g{mtx};
+    if (auto pos = tx.find('='); pos != std::string::npos) {
+      store[tx.substr(0, pos)] = tx.substr(pos + 1);
+    } else {
+      store[tx] = tx;
+    }
+    res->set_code(consensus::code_type_ok);
+    return res;
+  }
+
+  virtual std::unique_ptr<ResponseCommit> commit() override {
+    std::scoped_lock g{mtx};
+    height++;
+    std::string app_hash(8, '\0');
+    uint64_t size = store.size();
+    for (auto i = 0; i < 8; i++) {
+      app_hash[7 - i] = static_cast<char>((size >> (8 * i)) & 0xff);
+    }
+    auto res = std::make_unique<ResponseCommit>();
+    res->set_data(app_hash);
+    return res;
+  }
+
+  virtual std::unique_ptr<ResponseQuery> query_sync(const RequestQuery& req) override {
+    auto res = std::make_unique<ResponseQuery>();
+    std::scoped_lock g{mtx};
+    res->set_key(req.data());
+    res->set_height(height);
+    if (auto it = store.find(req.data()); it != store.end()) {
+      res->set_value(it->second);
+      res->set_log("exists");
+    } else {
+      res->set_log("does not exist");
+    }
+    return res;
+  }
+
+  auto get(const std::string& key) -> std::optional<std::string> {
+    std::scoped_lock g{mtx};
+    if (auto it = store.find(key); it != store.end())
+      return it->second;
+    return std::nullopt;
+  }
+
+  auto size() -> size_t {
+    std::scoped_lock g{mtx};
+    return store.size();
+  }
+
+protected:
+  std::mutex mtx;
+  std::map<std::string, std::string> store;
+  int64_t height{0};
+};
+
+} // namespace noir::application
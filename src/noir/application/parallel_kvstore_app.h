@@ -0,0 +1,187 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/application/kvstore_app.h>
+#include <noir/common/thread_pool.h>
+#include <noir/db/session.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace noir::application {
+
+/// \brief kvstore app delivering txs of a group in parallel, a demo of tx groups proposed from declared keys
+/// Besides txs of kvstore_app, a tx of `key=@src` copies the value of src to key. check_tx declares the keys a tx
+/// reads and writes. Each tx may be made to take a cost before taking effect, modeling apps doing more work per tx.
+///
+/// Txs of a group run on forks of the store, one per tx, which record the keys they read and write. Forks are merged
+/// in the order of the block. A tx which read a key written by an earlier tx of its group, i.e. the group was wrong,
+/// runs again on the merged fork, so results are always those of delivering txs one by one.
+class parallel_kvstore_app : public kvstore_app {
+public:
+  explicit parallel_kvstore_app(
+    size_t num_threads = std::thread::hardware_concurrency(), std::chrono::microseconds cost_per_tx = {})
+    : num_threads(std::max<size_t>(num_threads, 1)), cost_per_tx(cost_per_tx) {
+    if (this->num_threads > 1)
+      thread_pool = std::make_unique<named_thread_pool>("kvstore", this->num_threads);
+  }
+
+  /// \brief declares the keys tx accesses
+  virtual std::unique_ptr<ResponseCheckTx> check_tx_sync(const RequestCheckTx& req) override {
+    auto res = std::make_unique<ResponseCheckTx>();
+    auto [key, src] = parse(req.tx());
+    if (key.empty()) {
+      res->set_code(1);
+      return res;
+    }
+    res->set_code(consensus::code_type_ok);
+    if (!src.empty())
+      res->add_read_keys(std::string(src));
+    res->add_write_keys(std::string(key));
+    return res;
+  }
+
+  virtual std::unique_ptr<ResponseCheckTx> check_tx_async(const RequestCheckTx& req) override {
+    return check_tx_sync(req);
+  }
+
+  virtual std::unique_ptr<ResponseDeliverTx> deliver_tx_async(const RequestDeliverTx& req) override {
+    std::scoped_lock g{mtx};
+    auto f = fork();
+    auto res = run(req.tx(), f);
+    f.commit();
+    return res;
+  }
+
+  virtual std::vector<std::unique_ptr<ResponseDeliverTx>> deliver_tx_groups(
+    const std::vector<RequestDeliverTx>& reqs, const std::vector<uint32_t>& group_sizes) override {
+    std::vector<std::unique_ptr<ResponseDeliverTx>> res(reqs.size());
+    std::vector<store_fork> forks;
+
+    std::scoped_lock g{mtx};
+    size_t begin = 0;
+    for (auto size : group_sizes) {
+      forks.clear();
+      for (size_t i = 0; i < size; i++)
+        forks.push_back(fork());
+      run_parallel(reqs, begin, forks, res);
+
+      auto merged = fork();
+      for (size_t i = 0; i < size; i++) {
+        if (!merged.merge(std::move(forks[i])).empty()) {
+          res[begin + i] = run(reqs[begin + i].tx(), merged);
+          reruns++;
+        }
+      }
+      merged.commit();
+      begin += size;
+    }
+    res.resize(begin);
+    return res;
+  }
+
+  /// \brief number of txs which ran again as they conflicted with others of their group
+  auto num_reruns() -> uint64_t {
+    std::scoped_lock g{mtx};
+    return reruns;
+  }
+
+private:
+  /// store as the forked session of db::session::session_fork
+  struct store_session {
+    std::map<std::string, std::string>& store;
+
+    std::optional<db::session::shared_bytes> read(const db::session::shared_bytes& key) const {
+      if (auto it = store.find(to_string(key)); it != store.end())
+        return db::session::shared_bytes(it->second.data(), it->second.size());
+      return std::nullopt;
+    }
+    void write(const db::session::shared_bytes& key, const db::session::shared_bytes& value) {
+      store[to_string(key)] = to_string(value);
+    }
+    void erase(const db::session::shared_bytes& key) {
+      store.erase(to_string(key));
+    }
+
+    static std::string to_string(const db::session::shared_bytes& b) {
+      return b.size() ? std::string(b.data(), b.size()) : std::string{};
+    }
+  };
+  using store_fork = db::session::session_fork<store_session>;
+
+  store_fork fork() {
+    return store_fork(session, fork_mtx);
+  }
+
+  /// \return key and source key of `key=@src`, or empty source key if tx sets a value
+  static std::pair<std::string_view, std::string_view> parse(std::string_view tx) {
+    auto pos = tx.find('=');
+    if (pos == std::string_view::npos)
+      return {tx, {}};
+    auto value = tx.substr(pos + 1);
+    return {tx.substr(0, pos), value.starts_with('@') ? value.substr(1) : std::string_view{}};
+  }
+
+  /// runs tx on f, which keeps its effects
+  std::unique_ptr<ResponseDeliverTx> run(const std::string& tx, store_fork& f) const {
+    auto res = std::make_unique<ResponseDeliverTx>();
+    if (tx.empty()) {
+      res->set_code(1);
+      res->set_log("empty tx");
+      return res;
+    }
+    if (cost_per_tx.count() > 0) {
+      for (auto until = std::chrono::steady_clock::now() + cost_per_tx; std::chrono::steady_clock::now() < until;) {
+      }
+    }
+
+    auto [key, src] = parse(tx);
+    std::string_view value;
+    std::optional<db::session::shared_bytes> src_value;
+    if (!src.empty()) {
+      src_value = f.read(db::session::shared_bytes(src.data(), src.size()));
+      if (src_value && src_value->size())
+        value = {src_value->data(), src_value->size()};
+    } else if (auto pos = tx.find('='); pos != std::string::npos) {
+      value = std::string_view(tx).substr(pos + 1);
+    } else {
+      value = tx;
+    }
+    f.write(db::session::shared_bytes(key.data(), key.size()), db::session::shared_bytes(value.data(), value.size()));
+    res->set_code(consensus::code_type_ok);
+    return res;
+  }
+
+  /// runs txs of a group on threads of the pool, each with a contiguous range of txs
+  void run_parallel(const std::vector<RequestDeliverTx>& reqs, size_t begin, std::vector<store_fork>& forks,
+    std::vector<std::unique_ptr<ResponseDeliverTx>>& res) {
+    auto size = forks.size();
+    auto num_tasks = std::min(num_threads, size);
+    if (num_tasks <= 1) {
+      for (size_t i = 0; i < size; i++)
+        res[begin + i] = run(reqs[begin + i].tx(), forks[i]);
+      return;
+    }
+    std::vector<std::future<void>> tasks;
+    for (size_t t = 0; t < num_tasks; t++) {
+      tasks.push_back(async_thread_pool(thread_pool->get_executor(), [&, t]() {
+        for (auto i = size * t / num_tasks; i < size * (t + 1) / num_tasks; i++)
+          res[begin + i] = run(reqs[begin + i].tx(), forks[i]);
+      }));
+    }
+    for (auto& task : tasks)
+      task.get();
+  }
+
+  const size_t num_threads;
+  const std::chrono::microseconds cost_per_tx;
+  std::unique_ptr<named_thread_pool> thread_pool;
+  store_session session{store};
+  std::shared_ptr<std::mutex> fork_mtx = std::make_shared<std::mutex>();
+  uint64_t reruns{0};
+};
+
+} // namespace noir::application
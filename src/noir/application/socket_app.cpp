@@ -70,4 +70,18 @@ std::unique_ptr<ResponseCommit> socket_app::commit() {
   return std::move(res.value());
 }
 
+std::unique_ptr<ResponseQuery> socket_app::query_sync(const RequestQuery& req) {
+  auto res = my_cli->conn->query_sync(req);
+  if (!res)
+    return {};
+  return std::move(res.value());
+}
+
+std::unique_ptr<ResponseCheckTx> socket_app::check_tx_sync(const RequestCheckTx& req) {
+  auto res = my_cli->conn->check_tx_sync(req);
+  if (!res)
+    return {};
+  return std::move(res.value());
+}
+
 } // namespace noir::application
@@ -22,6 +22,10 @@ public:
 
   virtual std::unique_ptr<ResponseCommit> commit() override;
 
+  virtual std::unique_ptr<ResponseQuery> query_sync(const RequestQuery& req) override;
+
+  virtual std::unique_ptr<ResponseCheckTx> check_tx_sync(const RequestCheckTx& req) override;
+
 private:
   std::shared_ptr<struct cli_impl> my_cli;
 };
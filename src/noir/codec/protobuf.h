@@ -7,6 +7,10 @@
 #include <noir/codec/datastream.h>
 #include <google/protobuf/message_lite.h>
 
+#include <algorithm>
+#include <span>
+#include <string_view>
+
 namespace noir::codec::protobuf {
 
 template<typename T>
@@ -33,4 +37,221 @@ void decode(std::span<const unsigned char> s, T& v) {
   v.ParseFromArray(s.data(), s.size());
 }
 
+enum class wire_type : uint8_t {
+  varint = 0,
+  fixed64 = 1,
+  length_delimited = 2,
+  fixed32 = 5,
+};
+
+constexpr size_t varint_size(uint64_t v) {
+  size_t n = 1;
+  for (; v >= 0x80; v >>= 7)
+    ++n;
+  return n;
+}
+
+constexpr size_t tag_size(uint32_t field) {
+  return varint_size(static_cast<uint64_t>(field) << 3);
+}
+
+/// \brief size of a varint field as written by wire_writer, i.e. 0 for a default value
+constexpr size_t uint_field_size(uint32_t field, uint64_t v) {
+  return v ? tag_size(field) + varint_size(v) : 0;
+}
+
+constexpr size_t int_field_size(uint32_t field, int64_t v) {
+  return uint_field_size(field, static_cast<uint64_t>(v));
+}
+
+/// \brief size of a length delimited field holding len bytes, which is written even if empty
+constexpr size_t message_field_size(uint32_t field, size_t len) {
+  return tag_size(field) + varint_size(len) + len;
+}
+
+constexpr size_t bytes_field_size(uint32_t field, size_t len) {
+  return len ? message_field_size(field, len) : 0;
+}
+
+/// \brief writes protobuf wire format into a caller provided buffer without building a message object
+/// Field writers follow proto3 rules, so scalar fields with default values are omitted.
+/// \note on overflow, nothing more is written and overflow() returns true; callers fall back to a larger buffer
+class wire_writer {
+public:
+  explicit wire_writer(std::span<unsigned char> buf): buf(buf) {}
+
+  void varint(uint64_t v) {
+    if (!reserve(varint_size(v)))
+      return;
+    for (; v >= 0x80; v >>= 7)
+      buf[pos++] = static_cast<unsigned char>(v | 0x80);
+    buf[pos++] = static_cast<unsigned char>(v);
+  }
+
+  void tag(uint32_t field, wire_type type) {
+    varint((static_cast<uint64_t>(field) << 3) | static_cast<uint8_t>(type));
+  }
+
+  void raw(std::span<const unsigned char> s) {
+    if (!reserve(s.size()))
+      return;
+    std::copy(s.begin(), s.end(), buf.begin() + pos);
+    pos += s.size();
+  }
+
+  void uint_field(uint32_t field, uint64_t v) {
+    if (v) {
+      tag(field, wire_type::varint);
+      varint(v);
+    }
+  }
+
+  /// \note negative values take 10 bytes as int32/int64 are sign extended
+  void int_field(uint32_t field, int64_t v) {
+    uint_field(field, static_cast<uint64_t>(v));
+  }
+
+  void bool_field(uint32_t field, bool v) {
+    uint_field(field, v ? 1 : 0);
+  }
+
+  void bytes_field(uint32_t field, std::span<const unsigned char> s) {
+    if (!s.empty())
+      message_field(field, s);
+  }
+
+  void bytes_field(uint32_t field, std::string_view s) {
+    bytes_field(field, {reinterpret_cast<const unsigned char*>(s.data()), s.size()});
+  }
+
+  /// \brief writes an encoded sub-message, which is written even if empty as it is present
+  void message_field(uint32_t field, std::span<const unsigned char> encoded) {
+    tag(field, wire_type::length_delimited);
+    varint(encoded.size());
+    raw(encoded);
+  }
+
+  /// \brief starts a sub-message of len bytes; the caller writes exactly len bytes of its fields next
+  void message_field(uint32_t field, size_t len) {
+    tag(field, wire_type::length_delimited);
+    varint(len);
+  }
+
+  std::span<const unsigned char> data() const {
+    return buf.first(pos);
+  }
+  size_t size() const {
+    return pos;
+  }
+  bool overflow() const {
+    return overflowed;
+  }
+
+private:
+  bool reserve(size_t n) {
+    if (overflowed || pos + n > buf.size()) {
+      overflowed = true;
+      return false;
+    }
+    return true;
+  }
+
+  std::span<unsigned char> buf;
+  size_t pos{0};
+  bool overflowed{false};
+};
+
+/// \brief reads protobuf wire format from a buffer without building a message object
+/// Typical usage is a loop over next(), dispatching on the field number and skipping unknown fields.
+/// \note on malformed input, reads return default values and error() returns true
+class wire_reader {
+public:
+  explicit wire_reader(std::span<const unsigned char> buf): buf(buf) {}
+
+  /// \brief reads the next tag; returns false at the end of input or on error
+  bool next(uint32_t& field, wire_type& type) {
+    if (failed || pos >= buf.size())
+      return false;
+    auto key = varint();
+    field = static_cast<uint32_t>(key >> 3);
+    type = static_cast<wire_type>(key & 0x7);
+    if (field == 0 || key >> 32) {
+      failed = true;
+      return false;
+    }
+    return true;
+  }
+
+  uint64_t varint() {
+    uint64_t v = 0;
+    for (auto shift = 0; shift < 64; shift += 7) {
+      if (pos >= buf.size())
+        break;
+      auto b = buf[pos++];
+      v |= static_cast<uint64_t>(b & 0x7f) << shift;
+      if (!(b & 0x80))
+        return v;
+    }
+    failed = true;
+    return 0;
+  }
+
+  /// \brief reads a length delimited value, which views the underlying buffer
+  std::span<const unsigned char> bytes() {
+    auto len = varint();
+    if (failed || len > buf.size() - pos) {
+      failed = true;
+      return {};
+    }
+    auto ret = buf.subspan(pos, len);
+    pos += len;
+    return ret;
+  }
+
+  std::string_view string() {
+    auto s = bytes();
+    return {reinterpret_cast<const char*>(s.data()), s.size()};
+  }
+
+  void skip(wire_type type) {
+    switch (type) {
+    case wire_type::varint:
+      varint();
+      break;
+    case wire_type::fixed64:
+      advance(8);
+      break;
+    case wire_type::length_delimited:
+      bytes();
+      break;
+    case wire_type::fixed32:
+      advance(4);
+      break;
+    default: // groups are not supported
+      failed = true;
+    }
+  }
+
+  /// \brief marks the input as malformed, e.g. when a field has an unexpected wire type
+  void fail() {
+    failed = true;
+  }
+
+  bool error() const {
+    return failed;
+  }
+
+private:
+  void advance(size_t n) {
+    if (n > buf.size() - pos)
+      failed = true;
+    else
+      pos += n;
+  }
+
+  std::span<const unsigned char> buf;
+  size_t pos{0};
+  bool failed{false};
+};
+
 } // namespace noir::codec::protobuf
@@ -0,0 +1,80 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace noir {
+
+/// \brief hashed wheel of keys bucketed by their expiry deadline, e.g. a block height or a timestamp
+/// Expiring only visits buckets passed since the last call, so its cost is proportional to the number of keys expired
+/// rather than the number of keys registered. A wheel spanning the ttl keeps each bucket to a single turn.
+/// Keys are never removed before they are due; callers check that a popped key still refers to an expired entry.
+template<typename Key>
+class expiry_wheel {
+public:
+  /// \param span range of deadlines covered by one turn of the wheel
+  explicit expiry_wheel(int64_t span, size_t num_buckets = 256)
+    : width(std::max<int64_t>(1, (span + num_buckets - 1) / num_buckets)), buckets(num_buckets) {}
+
+  void add(int64_t deadline, Key key) {
+    // buckets already passed are only visited again after a turn, so a past deadline goes to the next one due
+    auto tick = std::max(deadline / width, cursor);
+    buckets[tick % buckets.size()].push_back({deadline, std::move(key)});
+    size_++;
+  }
+
+  /// \brief pops keys whose deadline is at or before now, calling on_expired for each of them
+  /// \return number of keys popped
+  template<typename Func>
+  size_t expire(int64_t now, Func&& on_expired) {
+    auto now_tick = now / width;
+    if (now_tick < cursor) {
+      return 0;
+    }
+
+    size_t count = 0;
+    auto num_ticks = std::min<uint64_t>(now_tick - cursor + 1, buckets.size());
+    for (uint64_t i = 0; i < num_ticks; i++) {
+      auto& bucket = buckets[(cursor + i) % buckets.size()];
+      auto due = std::partition(bucket.begin(), bucket.end(), [&](const auto& e) { return e.deadline > now; });
+      for (auto it = due; it != bucket.end(); it++) {
+        on_expired(it->key);
+      }
+      count += bucket.end() - due;
+      bucket.erase(due, bucket.end());
+    }
+    // the bucket of now may still have keys due later in the same tick
+    cursor = now_tick;
+    size_ -= count;
+    return count;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  void clear() {
+    for (auto& bucket : buckets) {
+      bucket.clear();
+    }
+    size_ = 0;
+  }
+
+private:
+  struct entry {
+    int64_t deadline;
+    Key key;
+  };
+
+  int64_t width;
+  std::vector<std::vector<entry>> buckets;
+  int64_t cursor{0};
+  size_t size_{0};
+};
+
+} // namespace noir
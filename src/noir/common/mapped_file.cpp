@@ -0,0 +1,52 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <noir/common/mapped_file.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace noir {
+
+Result<std::shared_ptr<mapped_file>> mapped_file::open(const std::string& path) {
+  auto fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return Error::format("unable to open {}: {}", path, std::strerror(errno));
+
+  struct stat st {};
+  if (::fstat(fd, &st) < 0) {
+    auto err = errno;
+    ::close(fd);
+    return Error::format("unable to stat {}: {}", path, std::strerror(err));
+  }
+
+  auto size = static_cast<size_t>(st.st_size);
+  if (size == 0) {
+    ::close(fd);
+    return std::shared_ptr<mapped_file>(new mapped_file(nullptr, 0));
+  }
+
+  auto addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  auto err = errno;
+  ::close(fd); // the mapping stays valid after closing the descriptor
+  if (addr == MAP_FAILED)
+    return Error::format("unable to map {}: {}", path, std::strerror(err));
+
+  // the file is mostly read front to back
+  ::madvise(addr, size, MADV_SEQUENTIAL);
+  return std::shared_ptr<mapped_file>(new mapped_file(static_cast<const char*>(addr), size));
+}
+
+mapped_file::~mapped_file() {
+  if (data_)
+    ::munmap(const_cast<char*>(data_), size_);
+}
+
+} // namespace noir
@@ -0,0 +1,40 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/core/result.h>
+#include <memory>
+#include <string_view>
+
+namespace noir {
+
+/// \brief read-only memory mapping of a whole file
+/// \ingroup common
+class mapped_file {
+public:
+  static Result<std::shared_ptr<mapped_file>> open(const std::string& path);
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+  ~mapped_file();
+
+  const char* data() const {
+    return data_;
+  }
+  size_t size() const {
+    return size_;
+  }
+  std::string_view view() const {
+    return {data_, size_};
+  }
+
+private:
+  mapped_file(const char* data, size_t size): data_(data), size_(size) {}
+
+  const char* data_;
+  size_t size_;
+};
+
+} // namespace noir
@@ -40,12 +40,17 @@ namespace methods {
 } // namespace methods
 
 namespace incoming {
-  namespace channels {
-    using cs_reactor_message_queue = appbase::channel_decl<struct cs_reactor_message_queue_tag, p2p::envelope_ptr>;
-    using bs_reactor_message_queue = appbase::channel_decl<struct bs_reactor_message_queue_tag, p2p::envelope_ptr>;
-    using es_reactor_message_queue = appbase::channel_decl<struct es_reactor_message_queue_tag, p2p::envelope_ptr>;
-    using tp_reactor_message_queue = appbase::channel_decl<struct tp_reactor_message_queue_tag, p2p::envelope_ptr>;
-  } // namespace channels
+  /// envelopes from peers are handed to reactors by p2p::dispatcher on its threads, bypassing the app's queue
+  namespace methods {
+    using cs_reactor_message = appbase::
+      method_decl<struct cs_reactor_message_tag, void(const p2p::envelope_ptr&), appbase::first_provider_policy>;
+    using bs_reactor_message = appbase::
+      method_decl<struct bs_reactor_message_tag, void(const p2p::envelope_ptr&), appbase::first_provider_policy>;
+    using es_reactor_message = appbase::
+      method_decl<struct es_reactor_message_tag, void(const p2p::envelope_ptr&), appbase::first_provider_policy>;
+    using tp_reactor_message = appbase::
+      method_decl<struct tp_reactor_message_tag, void(const p2p::envelope_ptr&), appbase::first_provider_policy>;
+  } // namespace methods
 } // namespace incoming
 
 namespace egress {
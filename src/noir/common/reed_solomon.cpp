@@ -0,0 +1,163 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <noir/common/check.h>
+#include <noir/common/reed_solomon.h>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+
+namespace noir::reed_solomon {
+
+namespace {
+
+  struct gf256 {
+    std::array<uint8_t, 512> exp{};
+    std::array<uint8_t, 256> log{};
+
+    gf256() {
+      // x^8 + x^4 + x^3 + x^2 + 1
+      uint16_t x = 1;
+      for (auto i = 0; i < 255; i++) {
+        exp[i] = exp[i + 255] = x;
+        log[x] = i;
+        x <<= 1;
+        if (x & 0x100)
+          x ^= 0x11d;
+      }
+    }
+
+    uint8_t mul(uint8_t a, uint8_t b) const {
+      return a && b ? exp[log[a] + log[b]] : 0;
+    }
+
+    uint8_t inv(uint8_t a) const {
+      return exp[255 - log[a]];
+    }
+  };
+
+  const gf256& gf() {
+    static const gf256 field;
+    return field;
+  }
+
+  /// \brief row of the generator matrix for shard i: identity for data shards, Cauchy for parity shards
+  std::vector<uint8_t> generator_row(size_t i, size_t k) {
+    std::vector<uint8_t> row(k);
+    if (i < k) {
+      row[i] = 1;
+    } else {
+      for (size_t j = 0; j < k; j++)
+        row[j] = gf().inv(static_cast<uint8_t>(i ^ j));
+    }
+    return row;
+  }
+
+  /// \brief dst ^= c * src
+  void mul_add(Bytes& dst, const Bytes& src, uint8_t c) {
+    if (!c)
+      return;
+    auto& f = gf();
+    auto log_c = f.log[c];
+    for (size_t i = 0; i < src.size(); i++) {
+      if (src[i])
+        dst[i] ^= f.exp[f.log[src[i]] + log_c];
+    }
+  }
+
+  /// \brief inverts a square matrix in place by Gauss-Jordan elimination
+  void invert(std::vector<std::vector<uint8_t>>& a) {
+    auto& f = gf();
+    auto n = a.size();
+    std::vector<std::vector<uint8_t>> b(n, std::vector<uint8_t>(n));
+    for (size_t i = 0; i < n; i++)
+      b[i][i] = 1;
+    for (size_t col = 0; col < n; col++) {
+      auto pivot = col;
+      while (pivot < n && !a[pivot][col])
+        pivot++;
+      check(pivot < n, "reed_solomon: singular matrix");
+      std::swap(a[col], a[pivot]);
+      std::swap(b[col], b[pivot]);
+      auto scale = f.inv(a[col][col]);
+      for (size_t j = 0; j < n; j++) {
+        a[col][j] = f.mul(a[col][j], scale);
+        b[col][j] = f.mul(b[col][j], scale);
+      }
+      for (size_t row = 0; row < n; row++) {
+        if (row == col || !a[row][col])
+          continue;
+        auto c = a[row][col];
+        for (size_t j = 0; j < n; j++) {
+          a[row][j] ^= f.mul(c, a[col][j]);
+          b[row][j] ^= f.mul(c, b[col][j]);
+        }
+      }
+    }
+    a = std::move(b);
+  }
+
+} // namespace
+
+std::vector<Bytes> encode(const std::vector<Bytes>& data, size_t m) {
+  auto k = data.size();
+  check(k > 0 && k + m <= max_shards, fmt::format("reed_solomon: invalid number of shards: {} + {}", k, m));
+  auto shard_size = data[0].size();
+  for (const auto& d : data)
+    check(d.size() == shard_size, "reed_solomon: shards must have the same size");
+
+  std::vector<Bytes> parity;
+  parity.reserve(m);
+  for (size_t i = 0; i < m; i++) {
+    auto row = generator_row(k + i, k);
+    auto& p = parity.emplace_back(shard_size);
+    for (size_t j = 0; j < k; j++)
+      mul_add(p, data[j], row[j]);
+  }
+  return parity;
+}
+
+bool reconstruct(std::vector<Bytes>& shards, size_t k) {
+  check(k > 0 && k <= shards.size() && shards.size() <= max_shards,
+    fmt::format("reed_solomon: invalid number of shards: {} of {}", k, shards.size()));
+  std::vector<size_t> present;
+  for (size_t i = 0; i < shards.size() && present.size() < k; i++) {
+    if (!shards[i].empty())
+      present.push_back(i);
+  }
+  if (present.size() < k)
+    return false;
+  auto shard_size = shards[present[0]].size();
+  for (auto i : present)
+    check(shards[i].size() == shard_size, "reed_solomon: shards must have the same size");
+
+  // data shards are the inverse of the generator rows of shards present applied to them
+  std::vector<std::vector<uint8_t>> rows;
+  for (auto i : present)
+    rows.push_back(generator_row(i, k));
+  invert(rows);
+  for (size_t j = 0; j < k; j++) {
+    if (!shards[j].empty())
+      continue;
+    Bytes d(shard_size);
+    for (size_t r = 0; r < k; r++)
+      mul_add(d, shards[present[r]], rows[j][r]);
+    shards[j] = std::move(d);
+  }
+
+  auto m = shards.size() - k;
+  if (std::any_of(shards.begin() + k, shards.end(), [](const auto& s) { return s.empty(); })) {
+    auto parity = encode({shards.begin(), shards.begin() + k}, m);
+    for (size_t i = 0; i < m; i++) {
+      if (shards[k + i].empty())
+        shards[k + i] = std::move(parity[i]);
+    }
+  }
+  return true;
+}
+
+} // namespace noir::reed_solomon
@@ -0,0 +1,25 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/common/bytes.h>
+#include <vector>
+
+/// \brief systematic Reed-Solomon erasure code over GF(2^8)
+/// k data shards are extended with m parity shards of the same size, and any k of the k + m shards rebuild the rest.
+/// Parity rows form a Cauchy matrix, so every k rows of the generator are independent; k + m must not exceed 256.
+namespace noir::reed_solomon {
+
+constexpr size_t max_shards = 256;
+
+/// \brief computes m parity shards of data shards, all of which have the same size
+std::vector<Bytes> encode(const std::vector<Bytes>& data, size_t m);
+
+/// \brief fills missing shards, given as empty ones, from any k shards present
+/// \param[in,out] shards k data shards followed by parity shards
+/// \return false if fewer than k shards are present
+bool reconstruct(std::vector<Bytes>& shards, size_t k);
+
+} // namespace noir::reed_solomon
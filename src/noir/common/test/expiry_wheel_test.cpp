@@ -0,0 +1,60 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/common/expiry_wheel.h>
+#include <algorithm>
+
+using namespace noir;
+
+namespace {
+
+auto expire(expiry_wheel<int>& wheel, int64_t now) {
+  std::vector<int> keys;
+  wheel.expire(now, [&](int key) { keys.push_back(key); });
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+} // namespace
+
+TEST_CASE("expiry_wheel: deadlines", "[noir][common]") {
+  auto wheel = expiry_wheel<int>(100, 8);
+  for (auto i = 0; i < 10; i++) {
+    wheel.add(1000 + i * 10, i);
+  }
+  CHECK(wheel.size() == 10);
+
+  CHECK(expire(wheel, 999).empty());
+  CHECK(expire(wheel, 1000) == std::vector<int>{0});
+  // keys in the bucket of now are popped only once due
+  CHECK(expire(wheel, 1005).empty());
+  CHECK(expire(wheel, 1035) == std::vector<int>{1, 2, 3});
+  CHECK(wheel.size() == 6);
+
+  // past deadlines are due on the next call
+  wheel.add(0, 100);
+  CHECK(expire(wheel, 1035) == std::vector<int>{100});
+
+  // more than a turn of the wheel at once
+  CHECK(expire(wheel, 5000) == std::vector<int>{4, 5, 6, 7, 8, 9});
+  CHECK(wheel.size() == 0);
+}
+
+TEST_CASE("expiry_wheel: deadlines beyond a turn", "[noir][common]") {
+  auto wheel = expiry_wheel<int>(8, 8);
+  wheel.add(3, 0);
+  wheel.add(3 + 8, 1); // same bucket, one turn later
+  wheel.add(3 + 16, 2);
+
+  CHECK(expire(wheel, 3) == std::vector<int>{0});
+  CHECK(expire(wheel, 10).empty());
+  CHECK(expire(wheel, 11) == std::vector<int>{1});
+  CHECK(expire(wheel, 19) == std::vector<int>{2});
+
+  wheel.add(30, 3);
+  wheel.clear();
+  CHECK(expire(wheel, 100).empty());
+}
@@ -0,0 +1,68 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/common/reed_solomon.h>
+#include <random>
+
+using namespace noir;
+
+namespace {
+
+std::vector<Bytes> random_shards(size_t k, size_t shard_size) {
+  std::mt19937 rng(k * 1000 + shard_size);
+  std::vector<Bytes> shards;
+  for (size_t i = 0; i < k; i++) {
+    auto& s = shards.emplace_back(shard_size);
+    std::generate(s.begin(), s.end(), [&]() { return rng(); });
+  }
+  return shards;
+}
+
+} // namespace
+
+TEST_CASE("reed_solomon: Rebuild from any k shards", "[noir][common]") {
+  constexpr size_t k = 6, m = 3;
+  auto data = random_shards(k, 100);
+  auto parity = reed_solomon::encode(data, m);
+  REQUIRE(parity.size() == m);
+  auto all = data;
+  all.insert(all.end(), parity.begin(), parity.end());
+
+  // every way of losing m shards
+  for (uint32_t lost = 0; lost < (1u << (k + m)); lost++) {
+    if (std::popcount(lost) != m)
+      continue;
+    auto shards = all;
+    for (size_t i = 0; i < k + m; i++) {
+      if (lost & (1u << i))
+        shards[i] = {};
+    }
+    REQUIRE(reed_solomon::reconstruct(shards, k));
+    CHECK(shards == all);
+  }
+}
+
+TEST_CASE("reed_solomon: Too few shards", "[noir][common]") {
+  auto data = random_shards(4, 10);
+  auto shards = data;
+  auto parity = reed_solomon::encode(data, 2);
+  shards.insert(shards.end(), parity.begin(), parity.end());
+  shards[0] = shards[2] = shards[5] = {};
+  CHECK(!reed_solomon::reconstruct(shards, 4));
+}
+
+TEST_CASE("reed_solomon: Many shards", "[noir][common]") {
+  constexpr size_t k = 200, m = 56;
+  auto data = random_shards(k, 32);
+  auto parity = reed_solomon::encode(data, m);
+  auto shards = data;
+  shards.insert(shards.end(), parity.begin(), parity.end());
+  for (size_t i = 0; i < m; i++)
+    shards[i * 3] = {};
+  REQUIRE(reed_solomon::reconstruct(shards, k));
+  CHECK(std::equal(data.begin(), data.end(), shards.begin()));
+  CHECK_THROWS(reed_solomon::encode(data, m + 1));
+}
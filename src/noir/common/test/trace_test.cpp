@@ -0,0 +1,73 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/common/trace.h>
+#include <fc/io/json.hpp>
+#include <algorithm>
+#include <thread>
+
+using namespace noir;
+
+namespace {
+
+auto count_spans(const std::string& name) {
+  auto events = fc::json::from_string(trace::to_chrome_trace()).get_object()["traceEvents"].get_array();
+  return std::count_if(events.begin(), events.end(), [&](const fc::variant& e) {
+    return e["ph"].as_string() == "X" && e["name"].as_string() == name;
+  });
+}
+
+} // namespace
+
+TEST_CASE("trace: spans", "[noir][common]") {
+  trace::clear();
+
+  SECTION("disabled") {
+    trace::set_enabled(false);
+    { trace::span s("disabled_span"); }
+    CHECK(count_spans("disabled_span") == 0);
+  }
+
+  SECTION("threads") {
+    trace::set_enabled(true);
+    auto record = []() {
+      for (auto i = 0; i < 10; i++) {
+        trace::span s("thread_span");
+      }
+    };
+    std::thread t1(record), t2(record);
+    t1.join();
+    t2.join();
+    CHECK(count_spans("thread_span") == 20);
+
+    trace::clear();
+    CHECK(count_spans("thread_span") == 0);
+  }
+
+  SECTION("wraparound") {
+    trace::set_enabled(true);
+    for (auto i = 0; i < 100000; i++) {
+      trace::span s("wrapped_span");
+    }
+    auto count = count_spans("wrapped_span");
+    CHECK(count > 0);
+    CHECK(count < 100000);
+  }
+
+  SECTION("thread churn") {
+    trace::set_enabled(true);
+    { trace::span s("churn_span"); }
+    auto num_rings = trace::detail::num_rings();
+    for (auto i = 0; i < 100; i++) {
+      std::thread([]() { trace::span s("churn_span"); }).join();
+    }
+    // exited threads hand their rings over to new ones
+    CHECK(trace::detail::num_rings() <= num_rings + 1);
+    CHECK(count_spans("churn_span") >= 2);
+  }
+
+  trace::set_enabled(false);
+}
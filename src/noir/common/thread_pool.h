@@ -8,9 +8,11 @@
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/post.hpp>
 #include <boost/asio/thread_pool.hpp>
+#include <algorithm>
 #include <future>
 #include <memory>
 #include <optional>
+#include <vector>
 
 namespace noir {
 /**
@@ -49,4 +51,25 @@ auto async_thread_pool(boost::asio::io_context& thread_pool, F&& f) {
   return task->get_future();
 }
 
+/// \brief calls f(begin, end) for num_tasks contiguous ranges of [0, size) on thread_pool, and waits for all of them
+/// \note must not be called from a thread of thread_pool, as the tasks may then wait for the thread forever
+template<typename F>
+void parallel_for(boost::asio::io_context& thread_pool, size_t size, size_t num_tasks, F&& f) {
+  num_tasks = std::min(num_tasks, size);
+  if (num_tasks <= 1) {
+    if (size > 0)
+      f(size_t(0), size);
+    return;
+  }
+  std::vector<std::future<void>> tasks;
+  for (size_t t = 0; t < num_tasks; t++) {
+    tasks.push_back(async_thread_pool(thread_pool, [&, t]() { f(size * t / num_tasks, size * (t + 1) / num_tasks); }));
+  }
+  // tasks refer to f, so all of them must finish before an exception is rethrown
+  for (auto& task : tasks)
+    task.wait();
+  for (auto& task : tasks)
+    task.get();
+}
+
 } // namespace noir
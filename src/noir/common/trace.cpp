@@ -0,0 +1,197 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <noir/common/trace.h>
+#include <fmt/core.h>
+
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace noir::trace {
+
+namespace detail {
+  std::atomic<bool> enabled{false};
+
+  namespace {
+    constexpr size_t ring_size = 16384;
+
+    /// spans of a single thread; only the owning thread writes, and readers skip slots that may have been overwritten
+    struct ring {
+      struct slot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<int64_t> start_ns{0};
+        std::atomic<int64_t> end_ns{0};
+      };
+
+      // tid and thread_name change only under rings_mtx, as a ring is taken over
+      int64_t tid;
+      std::string thread_name;
+      std::atomic<uint64_t> head{0};
+      std::atomic<uint64_t> tail{0};
+      std::atomic<bool> exited{false};
+      std::array<slot, ring_size> slots;
+    };
+
+    std::mutex rings_mtx;
+    std::vector<std::shared_ptr<ring>> rings;
+
+    /// marks the ring of a thread as free when the thread exits
+    struct ring_owner {
+      std::shared_ptr<ring> r;
+
+      ~ring_owner() {
+        r->exited.store(true, std::memory_order_release);
+      }
+    };
+
+    ring& local_ring() {
+      // rings outlive their threads, so spans of exited threads are still dumped until a new thread takes the ring
+      // over; threads coming and going thus reuse the same rings instead of allocating one each
+      thread_local ring_owner local = []() {
+        auto tid = ::syscall(SYS_gettid);
+        char name[16] = {};
+        ::pthread_getname_np(::pthread_self(), name, sizeof(name));
+        std::scoped_lock g{rings_mtx};
+        auto it = std::find_if(
+          rings.begin(), rings.end(), [](const auto& r) { return r->exited.load(std::memory_order_acquire); });
+        auto r = it != rings.end() ? *it : rings.emplace_back(std::make_shared<ring>());
+        r->exited.store(false, std::memory_order_relaxed);
+        r->tid = tid;
+        r->thread_name = name;
+        r->tail.store(r->head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return ring_owner{r};
+      }();
+      return *local.r;
+    }
+
+    std::string json_string(std::string_view s) {
+      std::string out = "\"";
+      for (auto c : s) {
+        if (c == '"' || c == '\\') {
+          out += '\\';
+          out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+          out += fmt::format("\\u{:04x}", static_cast<int>(c));
+        } else {
+          out += c;
+        }
+      }
+      out += '"';
+      return out;
+    }
+  } // namespace
+
+  void record(const char* name, int64_t start_ns, int64_t end_ns) {
+    auto& r = local_ring();
+    auto h = r.head.load(std::memory_order_relaxed);
+    auto& s = r.slots[h % ring_size];
+    s.name.store(name, std::memory_order_relaxed);
+    s.start_ns.store(start_ns, std::memory_order_relaxed);
+    s.end_ns.store(end_ns, std::memory_order_relaxed);
+    r.head.store(h + 1, std::memory_order_release);
+  }
+
+  size_t num_rings() {
+    std::scoped_lock g{rings_mtx};
+    return rings.size();
+  }
+} // namespace detail
+
+void set_enabled(bool enabled) {
+  detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+std::string to_chrome_trace() {
+  // a ring may be taken over by a new thread while it is read, so its owner and spans are taken as of now
+  struct ring_view {
+    std::shared_ptr<detail::ring> r;
+    int64_t tid;
+    std::string thread_name;
+    uint64_t tail;
+    uint64_t head;
+  };
+  std::vector<ring_view> rings;
+  {
+    std::scoped_lock g{detail::rings_mtx};
+    for (const auto& r : detail::rings) {
+      rings.push_back({r, r->tid, r->thread_name, r->tail.load(std::memory_order_relaxed),
+        r->head.load(std::memory_order_acquire)});
+    }
+  }
+
+  auto pid = ::getpid();
+  std::string out = R"({"displayTimeUnit": "ns", "traceEvents": [)";
+  auto first = true;
+  auto append_event = [&](std::string_view name, const std::string& fields) {
+    out += first ? "\n" : ",\n";
+    first = false;
+    out += fmt::format(R"({{"name": {}, {}}})", detail::json_string(name), fields);
+  };
+
+  for (const auto& [r, tid, name, tail, head] : rings) {
+    auto from = std::max<uint64_t>(tail, head - std::min(head, detail::ring_size));
+
+    struct event {
+      const char* name;
+      int64_t start_ns;
+      int64_t end_ns;
+    };
+    std::vector<event> events;
+    events.reserve(head - from);
+    for (auto i = from; i < head; i++) {
+      const auto& s = r->slots[i % detail::ring_size];
+      events.push_back({s.name.load(std::memory_order_relaxed), s.start_ns.load(std::memory_order_relaxed),
+        s.end_ns.load(std::memory_order_relaxed)});
+    }
+    // the slot being written when head was read again may have overwritten one read above
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto new_head = r->head.load(std::memory_order_relaxed);
+    auto valid_from = std::max<uint64_t>(from, new_head - std::min(new_head, detail::ring_size - 1));
+    if (valid_from >= head)
+      continue;
+
+    auto thread_name = name.empty() ? std::to_string(tid) : name;
+    append_event("thread_name",
+      fmt::format(R"("ph": "M", "pid": {}, "tid": {}, "args": {{"name": {}}})", pid, tid,
+        detail::json_string(thread_name)));
+    for (auto i = valid_from; i < head; i++) {
+      const auto& e = events[i - from];
+      append_event(e.name,
+        fmt::format(R"("ph": "X", "pid": {}, "tid": {}, "ts": {:.3f}, "dur": {:.3f})", pid, tid,
+          e.start_ns / 1e3, (e.end_ns - e.start_ns) / 1e3));
+    }
+  }
+  out += "\n]}";
+  return out;
+}
+
+Result<void> write_chrome_trace(const std::string& path) {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file)
+    return Error::format("unable to open {}: {}", path, std::strerror(errno));
+  file << to_chrome_trace() << std::endl;
+  if (!file)
+    return Error::format("unable to write {}", path);
+  return success();
+}
+
+void clear() {
+  std::scoped_lock g{detail::rings_mtx};
+  for (auto& r : detail::rings) {
+    r->tail.store(r->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+  }
+}
+
+} // namespace noir::trace
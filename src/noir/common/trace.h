@@ -0,0 +1,64 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/core/result.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace noir::trace {
+
+namespace detail {
+  extern std::atomic<bool> enabled;
+
+  inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+  }
+
+  void record(const char* name, int64_t start_ns, int64_t end_ns);
+
+  /// \return number of rings allocated, which is the largest number of threads that recorded spans at the same time
+  size_t num_rings();
+} // namespace detail
+
+/// \brief spans are only recorded while enabled, which is off by default
+void set_enabled(bool enabled);
+
+inline bool is_enabled() {
+  return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/// \brief times the enclosing scope into a ring buffer of the current thread
+/// Each thread keeps its most recent spans only, so tracing never allocates after a thread's first span and never
+/// blocks. name must outlive the span records, e.g. a string literal.
+/// \ingroup common
+class span {
+public:
+  explicit span(const char* name) noexcept: name(name), start_ns(is_enabled() ? detail::now_ns() : 0) {}
+
+  span(const span&) = delete;
+  span& operator=(const span&) = delete;
+
+  ~span() {
+    if (start_ns)
+      detail::record(name, start_ns, detail::now_ns());
+  }
+
+private:
+  const char* name;
+  int64_t start_ns;
+};
+
+/// \brief spans recorded by all threads in the Chrome trace event format, which Perfetto also opens
+std::string to_chrome_trace();
+
+Result<void> write_chrome_trace(const std::string& path);
+
+/// \brief drops spans recorded so far
+void clear();
+
+} // namespace noir::trace
@@ -24,6 +24,14 @@ void MempoolConfig::bind(CLI::App& root) {
 # Limit the total size of all txs in the mempool.
 # This only accounts for raw transactions (e.g. given 1MB transactions and
 # max-txs-bytes=5MB, mempool will only accept 5 transactions).)");
+  mempool->add_option("--max-resident-txs-bytes", max_resident_txs_bytes, R"(
+# max-resident-txs-bytes, if non-zero, limits the total size of txs kept in RAM.
+# Bodies of the lowest priority txs beyond this limit are moved to spill-file
+# and loaded when reaped or gossiped, while their metadata stays in RAM.
+# max-txs-bytes still limits the total size of all txs.)");
+  mempool->add_option("--spill-file", spill_file, R"(
+# Path of the file holding spilled tx bodies, relative to the home directory.
+# It is only used while running and grows up to max-txs-bytes (sparse).)");
   mempool->add_option(
     "--cache-size", cache_size, "Size of the cache (used to filter transactions we saw earlier) in transactions");
   mempool->add_option("--keep-invalid-txs-in-chache", keep_invalid_txs_in_cache, R"(
@@ -15,6 +15,8 @@ struct MempoolConfig {
   bool broadcast;
   int size;
   int64_t max_txs_bytes;
+  int64_t max_resident_txs_bytes;
+  std::string spill_file;
   int cache_size;
   bool keep_invalid_txs_in_cache;
   int max_tx_bytes;
@@ -28,6 +30,8 @@ struct MempoolConfig {
     broadcast = true;
     size = 5000;
     max_txs_bytes = 1024 * 1024 * 1024; // 1GB
+    max_resident_txs_bytes = 0; // keep all txs in RAM
+    spill_file = "data/mempool.spill";
     cache_size = 10000;
     keep_invalid_txs_in_cache = false;
     max_tx_bytes = 1024 * 1024; // 1MB
@@ -4,8 +4,15 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 #pragma once
+#include <noir/common/thread_pool.h>
+#include <noir/common/trace.h>
 #include <noir/consensus/node.h>
+#include <noir/metrics/exposer.h>
+#include <noir/metrics/metrics.h>
 #include <appbase/application.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <csignal>
 
 namespace noir::consensus {
 
@@ -20,12 +27,30 @@ public:
       "###############################################\n"
       "###        ABCI Configuration Options       ###\n"
       "###############################################");
-    abci_options->add_option("--proxy-app", "Proxy app: one of kvstore (not supported), or noop (default \"\")")
+    abci_options->add_option("--proxy-app", "Proxy app: one of kvstore, parallel_kvstore, or noop (default \"\")")
       ->default_val("");
     abci_options->add_option("--mode", "Mode of Node: full | validator | seed (not supported)")
       ->check(CLI::IsMember({"full", "validator", "seed"}))
       ->default_val("validator");
     abci_options->add_option("--moniker", "A custom human readable name for this node")->default_val("");
+    abci_options->add_option("--query-conns", "Number of app connections serving queries, apart from consensus")
+      ->default_val(4);
+    abci_options
+      ->add_option("--target-block-exec-ms",
+        "Shrink or grow proposed blocks so that executing and committing one takes about this long (0 disables)")
+      ->default_val(0);
+    abci_options
+      ->add_option(
+        "--vote-batch-bytes", "Gossip votes a peer is missing in messages of up to this many bytes (0 disables)")
+      ->default_val(0);
+    abci_options
+      ->add_option("--has-votes-interval-ms",
+        "Announce votes received within this interval in a bitmap, rather than one by one (0 disables)")
+      ->default_val(0);
+    abci_options
+      ->add_option("--block-validation-threads",
+        "Check txs, last commit signatures and evidence of a block on this many threads (0 checks them one by one)")
+      ->default_val(4);
 
     auto bs_options = app_config.add_section("blocksync",
       "######################################################\n"
@@ -41,6 +66,30 @@ public:
         "  2) \"v2\" - DEPRECATED")
       ->check(CLI::IsMember({"v0"}))
       ->default_val("v0");
+
+    auto instrumentation_options = app_config.add_section("instrumentation",
+      "###############################################\n"
+      "###   Instrumentation Configuration Options  ###\n"
+      "###############################################");
+    instrumentation_options
+      ->add_option("--trace",
+        "Record tracing spans of hot paths, written as Chrome trace JSON to trace-file on SIGUSR2")
+      ->check(CLI::IsMember({"true", "false"}))
+      ->default_val("false");
+    instrumentation_options->add_option("--trace-file", "Path of the dumped spans, relative to the home directory")
+      ->default_val("trace.json");
+    instrumentation_options
+      ->add_option("--db-stats-interval",
+        "Seconds between logs of db statistics and of the slowest store operations since the last log (0 disables)")
+      ->default_val(60);
+    instrumentation_options
+      ->add_option("--db-perf-sample-every",
+        "Break down one of every N store operations of each thread with the rocksdb perf context (0 disables)")
+      ->default_val(16);
+    instrumentation_options
+      ->add_option("--prometheus-listen-addr",
+        "Address to serve metrics to Prometheus scrapes at /metrics, e.g. \"0.0.0.0:26660\" (default \"\" disables)")
+      ->default_val("");
   }
 
   void plugin_initialize(const CLI::App& app_config) {
@@ -69,24 +118,169 @@ public:
     config_->base.proxy_app = proxy_app;
     config_->base.mode = mode;
     config_->base.fast_sync_mode = bs_enable;
+    config_->base.query_conns = abci_options->get_option("--query-conns")->as<int>();
     config_->base.root_dir = app.home_dir().string();
     config_->consensus.root_dir = config_->base.root_dir;
+    config_->consensus.target_block_exec_time =
+      std::chrono::milliseconds(abci_options->get_option("--target-block-exec-ms")->as<int64_t>());
+    config_->consensus.vote_batch_bytes = abci_options->get_option("--vote-batch-bytes")->as<uint32_t>();
+    config_->consensus.has_votes_interval =
+      std::chrono::milliseconds(abci_options->get_option("--has-votes-interval-ms")->as<int64_t>());
+    config_->consensus.block_validation_threads =
+      abci_options->get_option("--block-validation-threads")->as<uint32_t>();
     config_->priv_validator.root_dir = config_->base.root_dir;
 
     node_ = node::new_default_node(app, config_);
+
+    auto instrumentation_options = app_config.get_subcommand("instrumentation");
+    trace_enabled = instrumentation_options->get_option("--trace")->as<bool>();
+    trace_file = (app.home_dir() / instrumentation_options->get_option("--trace-file")->as<std::string>()).string();
+    db_stats_interval = std::chrono::seconds(instrumentation_options->get_option("--db-stats-interval")->as<int64_t>());
+    db::set_perf_sample_every(instrumentation_options->get_option("--db-perf-sample-every")->as<uint32_t>());
+    prometheus_listen_addr = instrumentation_options->get_option("--prometheus-listen-addr")->as<std::string>();
+    metrics::default_registry().add_collector([this](std::vector<metrics::sample>& samples) {
+      collect_db_metrics(samples);
+    });
   }
 
   void plugin_startup() {
+    if (trace_enabled) {
+      trace::set_enabled(true);
+      trace_thread.emplace("trace", 1);
+      trace_signals = std::make_unique<boost::asio::signal_set>(trace_thread->get_executor(), SIGUSR2);
+      wait_trace_signal();
+    }
+    if (db_stats_interval.count() > 0) {
+      db_stats_thread.emplace("db_stats", 1);
+      db_stats_timer = std::make_unique<boost::asio::steady_timer>(db_stats_thread->get_executor());
+      wait_db_stats();
+    }
+    if (!prometheus_listen_addr.empty()) {
+      metrics_thread.emplace("metrics", 1);
+      auto ok = metrics::exposer::listen(metrics_thread->get_executor(), prometheus_listen_addr);
+      if (!ok)
+        check(false, fmt::format("failed to serve metrics at {}: {}", prometheus_listen_addr, ok.error().message()));
+      metrics_exposer = ok.value();
+    }
     node_->on_start();
   }
 
   void plugin_shutdown() {
     ilog("shutting down abci");
     node_->on_stop();
+    if (trace_signals) {
+      trace_signals->cancel();
+      trace_thread->stop();
+    }
+    if (db_stats_timer) {
+      db_stats_timer->cancel();
+      db_stats_thread->stop();
+    }
+    if (metrics_exposer) {
+      metrics_exposer->stop();
+      metrics_thread->stop();
+    }
+  }
+
+  void wait_trace_signal() {
+    trace_signals->async_wait([this](const boost::system::error_code& ec, int) {
+      if (ec)
+        return;
+      if (auto ok = trace::write_chrome_trace(trace_file); !ok)
+        elog(fmt::format("unable to dump trace: {}", ok.error().message()));
+      else
+        ilog(fmt::format("dumped trace to {}", trace_file));
+      wait_trace_signal();
+    });
+  }
+
+  void wait_db_stats() {
+    db_stats_timer->expires_after(db_stats_interval);
+    db_stats_timer->async_wait([this](const boost::system::error_code& ec) {
+      if (ec)
+        return;
+      log_db_stats();
+      wait_db_stats();
+    });
+  }
+
+  void log_db_stats() {
+    auto stats = db::collect_stats(*node_->db_session_->db());
+    ilog(fmt::format("db: block cache hit rate {:.3f}, read {}B, written {}B, compacted {}B/{}B, stalled {}us, "
+                     "get p50/p99 {:.1f}/{:.1f}us, write p50/p99 {:.1f}/{:.1f}us",
+      stats.block_cache_hit_rate(), stats.bytes_read, stats.bytes_written, stats.compaction_bytes_read,
+      stats.compaction_bytes_written, stats.stall_micros, stats.get.p50_us, stats.get.p99_us, stats.write.p50_us,
+      stats.write.p99_us));
+    for (const auto& cf : stats.column_families) {
+      ilog(fmt::format("db {}: pending compaction {}B, running compactions {}, memtables {}B, ssts {}B{}", cf.name,
+        cf.pending_compaction_bytes, cf.running_compactions, cf.memtable_bytes, cf.sst_bytes,
+        cf.write_stopped ? ", writes stopped" : ""));
+    }
+    for (const auto& op : db::take_slow_ops()) {
+      ilog(fmt::format("db slow op: {}", op.to_string()));
+    }
+  }
+
+  void collect_db_metrics(std::vector<metrics::sample>& samples) {
+    if (!node_ || !node_->db_session_)
+      return;
+    auto add = [&](std::string name, std::string help, metrics::metric_type type, double value,
+                 metrics::label_set labels = {}) {
+      samples.push_back({std::move(name), std::move(help), type, std::move(labels), value});
+    };
+    using metrics::metric_type;
+
+    auto stats = db::collect_stats(*node_->db_session_->db());
+    add("noir_db_block_cache_hits_total", "Block cache hits", metric_type::counter, stats.block_cache_hits);
+    add("noir_db_block_cache_misses_total", "Block cache misses", metric_type::counter, stats.block_cache_misses);
+    add("noir_db_block_cache_bytes", "Bytes in the block cache", metric_type::gauge, stats.block_cache_bytes);
+    add("noir_db_read_bytes_total", "Bytes read", metric_type::counter, stats.bytes_read);
+    add("noir_db_written_bytes_total", "Bytes written", metric_type::counter, stats.bytes_written);
+    add("noir_db_compaction_read_bytes_total", "Bytes read by compactions", metric_type::counter,
+      stats.compaction_bytes_read);
+    add("noir_db_compaction_written_bytes_total", "Bytes written by compactions", metric_type::counter,
+      stats.compaction_bytes_written);
+    add("noir_db_stall_seconds_total", "Time writes were stalled", metric_type::counter, stats.stall_micros / 1e6);
+    for (const auto& [op, latency] : {std::pair{"get", stats.get}, {"write", stats.write}, {"seek", stats.seek}}) {
+      for (const auto& [quantile, us] : {std::pair{"0.5", latency.p50_us}, {"0.99", latency.p99_us}}) {
+        add("noir_db_latency_seconds", "Latency of db calls", metric_type::gauge, us / 1e6,
+          {{"op", op}, {"quantile", quantile}});
+      }
+    }
+    for (const auto& cf : stats.column_families) {
+      metrics::label_set labels = {{"cf", cf.name}};
+      add("noir_db_pending_compaction_bytes", "Bytes pending compaction", metric_type::gauge,
+        cf.pending_compaction_bytes, labels);
+      add("noir_db_running_compactions", "Running compactions", metric_type::gauge, cf.running_compactions, labels);
+      add("noir_db_memtable_bytes", "Bytes of memtables", metric_type::gauge, cf.memtable_bytes, labels);
+      add("noir_db_sst_bytes", "Bytes of sst files", metric_type::gauge, cf.sst_bytes, labels);
+      add("noir_db_write_stopped", "Whether writes are stopped", metric_type::gauge, cf.write_stopped, labels);
+    }
+    for (const auto& [op, totals] : db::get_op_stats()) {
+      metrics::label_set labels = {{"op", op}};
+      add("noir_store_ops_total", "Store operations", metric_type::counter, totals.count, labels);
+      add("noir_store_op_seconds_total", "Time taken by store operations", metric_type::counter,
+        totals.total_ns / 1e9, labels);
+      add("noir_store_op_max_seconds", "Time taken by the slowest store operation", metric_type::gauge,
+        totals.max_ns / 1e9, labels);
+    }
   }
 
   std::unique_ptr<node> node_;
   std::string proxy_app;
+
+  bool trace_enabled{false};
+  std::string trace_file;
+  std::optional<named_thread_pool> trace_thread;
+  std::unique_ptr<boost::asio::signal_set> trace_signals;
+
+  std::chrono::seconds db_stats_interval{0};
+  std::optional<named_thread_pool> db_stats_thread;
+  std::unique_ptr<boost::asio::steady_timer> db_stats_timer;
+
+  std::string prometheus_listen_addr;
+  std::optional<named_thread_pool> metrics_thread;
+  std::shared_ptr<metrics::exposer> metrics_exposer;
 };
 
 } // namespace noir::consensus
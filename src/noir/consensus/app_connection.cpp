@@ -3,18 +3,48 @@
 // Copyright (c) 2022 Haderech Pte. Ltd.
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
+#include <noir/application/kvstore_app.h>
 #include <noir/application/noop_app.h>
+#include <noir/application/parallel_kvstore_app.h>
 #include <noir/application/socket_app.h>
+#include <noir/common/log.h>
 #include <noir/consensus/app_connection.h>
 
 namespace noir::consensus {
 
+metrics::histogram abci_call_duration(const std::string& method) {
+  return metrics::default_registry().make_histogram("noir_abci_call_duration_seconds",
+    "Time taken by abci calls to the app", metrics::latency_buckets, {{"method", method}});
+}
+
+namespace {
+  struct abci_metrics {
+    metrics::histogram begin_block = abci_call_duration("begin_block");
+    metrics::histogram deliver_tx = abci_call_duration("deliver_tx");
+    metrics::histogram deliver_tx_groups = abci_call_duration("deliver_tx_groups");
+    metrics::histogram end_block = abci_call_duration("end_block");
+    metrics::histogram commit = abci_call_duration("commit");
+    metrics::histogram check_tx = abci_call_duration("check_tx");
+  };
+
+  const abci_metrics& get_metrics() {
+    static abci_metrics m;
+    return m;
+  }
+} // namespace
+
 app_connection::app_connection(const std::string& proxy_app) {
   if (proxy_app == "noop") {
     application = std::make_shared<application::noop_app>();
     return;
+  } else if (proxy_app == "kvstore") {
+    application = std::make_shared<application::kvstore_app>();
+    return;
+  } else if (proxy_app == "parallel_kvstore") {
+    application = std::make_shared<application::parallel_kvstore_app>();
+    return;
   } else if (proxy_app.starts_with("tcp://")) {
-    auto address = proxy_app.substr(proxy_app.find("tcp://") + 6);
+    address = proxy_app.substr(proxy_app.find("tcp://") + 6);
     application = std::make_shared<application::socket_app>(address);
     is_socket = true;
     return;
@@ -33,31 +63,58 @@ Result<void> app_connection::start() {
 std::unique_ptr<tendermint::abci::ResponseBeginBlock> app_connection::begin_block_sync(
   const tendermint::abci::RequestBeginBlock& req) {
   std::scoped_lock g(mtx);
+  auto t = get_metrics().begin_block.time();
   return std::move(application->begin_block(req));
 }
 std::unique_ptr<tendermint::abci::ResponseEndBlock> app_connection::end_block_sync(
   const tendermint::abci::RequestEndBlock& req) {
   std::scoped_lock g(mtx);
+  auto t = get_metrics().end_block.time();
   return std::move(application->end_block(req));
 }
 std::unique_ptr<tendermint::abci::ResponseDeliverTx> app_connection::deliver_tx_async(
   const tendermint::abci::RequestDeliverTx& req) {
   std::scoped_lock g(mtx);
+  auto t = get_metrics().deliver_tx.time();
   return std::move(application->deliver_tx_async(req));
 }
+std::vector<std::unique_ptr<tendermint::abci::ResponseDeliverTx>> app_connection::deliver_tx_groups(
+  const std::vector<tx>& txs, const std::vector<uint32_t>& group_sizes) {
+  std::vector<tendermint::abci::RequestDeliverTx> reqs(txs.size());
+  for (size_t i = 0; i < txs.size(); i++)
+    reqs[i].set_tx({txs[i].begin(), txs[i].end()});
+  std::scoped_lock g(mtx);
+  auto t = get_metrics().deliver_tx_groups.time();
+  return application->deliver_tx_groups(reqs, group_sizes);
+}
 std::unique_ptr<tendermint::abci::ResponseCommit> app_connection::commit_sync() {
   std::scoped_lock g(mtx);
+  auto t = get_metrics().commit.time();
   return std::move(application->commit());
 }
 
+namespace {
+  tendermint::abci::RequestCheckTx to_request(const request_check_tx& req) {
+    tendermint::abci::RequestCheckTx ret;
+    ret.set_tx({req.tx.begin(), req.tx.end()});
+    ret.set_type(req.type == check_tx_type::recheck ? tendermint::abci::CheckTxType::RECHECK
+                                                      : tendermint::abci::CheckTxType::NEW);
+    return ret;
+  }
+} // namespace
+
 std::unique_ptr<tendermint::abci::ResponseCheckTx> app_connection::check_tx_sync(request_check_tx req) {
+  auto r = to_request(req);
   std::scoped_lock g(mtx);
-  return {};
+  auto t = get_metrics().check_tx.time();
+  return application->check_tx_sync(r);
 }
 
 std::unique_ptr<tendermint::abci::ResponseCheckTx> app_connection::check_tx_async(request_check_tx req) {
+  auto r = to_request(req);
   std::scoped_lock g(mtx);
-  return {};
+  auto t = get_metrics().check_tx.time();
+  return application->check_tx_async(r);
 }
 
 void app_connection::flush_async() {
@@ -68,4 +125,15 @@ void app_connection::flush_sync() {
   std::scoped_lock g(mtx);
 }
 
+std::shared_ptr<query_connection> app_connection::new_query_connection(size_t num_conns) {
+  std::vector<std::shared_ptr<application::base_application>> conns;
+  for (size_t i = 0; i < num_conns; i++) {
+    if (is_socket)
+      conns.push_back(std::make_shared<application::socket_app>(address));
+    else
+      conns.push_back(application);
+  }
+  return std::make_shared<query_connection>(std::move(conns));
+}
+
 } // namespace noir::consensus
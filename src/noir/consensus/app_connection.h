@@ -5,6 +5,9 @@
 //
 #pragma once
 #include <noir/application/app.h>
+#include <noir/consensus/query_connection.h>
+#include <noir/consensus/tx.h>
+#include <noir/metrics/metrics.h>
 
 namespace noir::consensus {
 
@@ -16,6 +19,9 @@ struct app_connection {
   std::unique_ptr<tendermint::abci::ResponseBeginBlock> begin_block_sync(const tendermint::abci::RequestBeginBlock&);
   std::unique_ptr<tendermint::abci::ResponseEndBlock> end_block_sync(const tendermint::abci::RequestEndBlock&);
   std::unique_ptr<tendermint::abci::ResponseDeliverTx> deliver_tx_async(const tendermint::abci::RequestDeliverTx&);
+  /// \brief delivers txs in groups of txs not conflicting with each other, or returns empty if the app doesn't
+  std::vector<std::unique_ptr<tendermint::abci::ResponseDeliverTx>> deliver_tx_groups(
+    const std::vector<tx>& txs, const std::vector<uint32_t>& group_sizes);
   std::unique_ptr<tendermint::abci::ResponseCommit> commit_sync();
 
   std::unique_ptr<tendermint::abci::ResponseCheckTx> check_tx_sync(request_check_tx req);
@@ -24,11 +30,18 @@ struct app_connection {
   void flush_async();
   void flush_sync();
 
+  /// \brief opens num_conns connections for queries; in-process apps are shared by all of them instead
+  std::shared_ptr<query_connection> new_query_connection(size_t num_conns);
+
   std::shared_ptr<application::base_application> application;
   bool is_socket{}; // FIXME: remove later; for now it's used for ease
+  std::string address;
 
 private:
   std::mutex mtx;
 };
 
+/// \brief latencies of abci calls of the given method, e.g. commit
+metrics::histogram abci_call_duration(const std::string& method);
+
 } // namespace noir::consensus
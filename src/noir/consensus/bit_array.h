@@ -35,7 +35,8 @@ struct bit_array : public std::enable_shared_from_this<bit_array> {
     if (other == nullptr) {
       return nullptr;
     }
-    return new_bit_array(other->bits);
+    std::scoped_lock g(other->mtx);
+    return std::make_shared<bit_array>(*other);
   }
 
   int size() const {
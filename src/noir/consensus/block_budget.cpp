@@ -0,0 +1,57 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <noir/common/check.h>
+#include <noir/common/log.h>
+#include <noir/consensus/block_budget.h>
+#include <fmt/core.h>
+
+#include <algorithm>
+
+namespace noir::consensus {
+
+block_budget::block_budget(std::chrono::microseconds target)
+  : target(target),
+    fraction_gauge(metrics::default_registry().make_gauge(
+      "noir_block_budget_permille", "Budget of proposed blocks in permille of the consensus limits")) {
+  check(target.count() > 0, "target time of block_budget must be positive");
+  fraction_gauge.set(1000);
+}
+
+block_budget::limits block_budget::scale(int64_t max_bytes, int64_t max_gas) const {
+  auto f = fraction();
+  auto scaled = [f](int64_t limit) { return limit < 0 ? limit : std::max<int64_t>(1, limit * f); };
+  return {scaled(max_bytes), scaled(max_gas)};
+}
+
+void block_budget::on_proposed(int64_t reaped_bytes, int64_t budget_bytes) {
+  std::scoped_lock g{mtx};
+  last_proposal_filled = budget_bytes >= 0 && reaped_bytes >= budget_bytes * filled;
+}
+
+void block_budget::on_executed(std::chrono::microseconds elapsed) {
+  std::scoped_lock g{mtx};
+  auto ratio = double(elapsed.count()) / target.count();
+  auto prev = fraction_;
+  if (ratio > shrink_above) {
+    // aims the next block at shrink_above of the target, assuming time proportional to the txs
+    fraction_ *= std::max(max_shrink, shrink_above / ratio);
+  } else if (ratio < grow_below && last_proposal_filled) {
+    fraction_ *= grow_step;
+  }
+  fraction_ = std::clamp(fraction_, min_fraction, 1.0);
+  if (fraction_ != prev) {
+    dlog(fmt::format("block budget: {:.3f} -> {:.3f}, execution took {}us of target {}us", prev, fraction_,
+      elapsed.count(), target.count()));
+    fraction_gauge.set(static_cast<int64_t>(fraction_ * 1000));
+  }
+}
+
+double block_budget::fraction() const {
+  std::scoped_lock g{mtx};
+  return fraction_;
+}
+
+} // namespace noir::consensus
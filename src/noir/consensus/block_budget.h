@@ -0,0 +1,58 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/metrics/metrics.h>
+#include <chrono>
+#include <mutex>
+
+namespace noir::consensus {
+
+/// \brief proposer-side budget of block bytes and gas, adapted to the time recent blocks took to execute and commit
+/// A block taking nearly the target time or longer shrinks the budget in proportion, as execution time grows with the
+/// txs of a block. A block well within the target grows the budget back by a step, but only while proposals fill it,
+/// so that a quiet mempool doesn't inflate the budget. The budget never exceeds the consensus limits.
+class block_budget {
+public:
+  /// shrinks once a block takes more than this fraction of the target
+  static constexpr double shrink_above = 0.8;
+  /// grows once a block takes less than this fraction of the target
+  static constexpr double grow_below = 0.5;
+  static constexpr double max_shrink = 0.5;
+  static constexpr double grow_step = 1.25;
+  /// proposals reaping at least this fraction of the budget are limited by it
+  static constexpr double filled = 0.9;
+  static constexpr double min_fraction = 1.0 / 64;
+
+  struct limits {
+    int64_t max_bytes;
+    int64_t max_gas;
+  };
+
+  explicit block_budget(std::chrono::microseconds target);
+
+  /// \brief consensus limits scaled down to the budget; unlimited ones stay unlimited
+  limits scale(int64_t max_bytes, int64_t max_gas) const;
+
+  /// \brief records the bytes of txs reaped for a proposal out of the bytes the budget allowed
+  void on_proposed(int64_t reaped_bytes, int64_t budget_bytes);
+
+  /// \brief records the time a block took to execute and commit, and adapts the budget
+  void on_executed(std::chrono::microseconds elapsed);
+
+  /// \return fraction of the consensus limits in the budget, from min_fraction up to 1
+  double fraction() const;
+
+private:
+  const std::chrono::microseconds target;
+
+  mutable std::mutex mtx;
+  double fraction_{1};
+  bool last_proposal_filled{false};
+
+  metrics::gauge fraction_gauge;
+};
+
+} // namespace noir::consensus
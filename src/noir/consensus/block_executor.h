@@ -4,16 +4,23 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 #pragma once
+#include <noir/codec/protobuf.h>
+#include <noir/common/thread_pool.h>
+#include <noir/common/trace.h>
 #include <noir/consensus/abci_types.h>
 #include <noir/consensus/app_connection.h>
+#include <noir/consensus/block_budget.h>
 #include <noir/consensus/common.h>
 #include <noir/consensus/ev/evidence_pool.h>
+#include <noir/consensus/mempool.h>
 #include <noir/consensus/store/block_store.h>
 #include <noir/consensus/store/state_store.h>
+#include <noir/consensus/tx_schedule.h>
 #include <noir/consensus/types/event_bus.h>
 #include <noir/consensus/types/events.h>
 #include <noir/consensus/types/protobuf.h>
 #include <noir/consensus/types/results.h>
+#include <noir/consensus/types/validation.h>
 #include <tendermint/state/types.pb.h>
 
 #include <utility>
@@ -37,6 +44,19 @@ struct block_executor {
   // todo - we may not need to handle events for tendermint but only for app?
   std::shared_ptr<events::event_bus> event_bus_{};
 
+  // txs are only proposed and removed once committed if a mempool is set
+  std::shared_ptr<mempool_interface> mempool_{};
+
+  // proposals are limited by consensus params only unless a budget is set
+  std::shared_ptr<block_budget> budget_{};
+
+  // txs, last commit signatures and evidence of blocks are checked on this many threads; 0 checks them one by one
+  uint32_t validation_threads{};
+  std::unique_ptr<named_thread_pool> validation_pool{};
+
+  metrics::histogram validation_duration = metrics::default_registry().make_histogram(
+    "noir_block_validation_duration_seconds", "Time taken to validate blocks", metrics::latency_buckets);
+
   std::map<std::string, bool> cache; // storing verification result for a single height
 
   block_executor(std::shared_ptr<db_store> new_store,
@@ -59,6 +79,19 @@ struct block_executor {
     return res;
   }
 
+  void set_mempool(std::shared_ptr<mempool_interface> new_mempool) {
+    mempool_ = std::move(new_mempool);
+  }
+
+  void set_block_budget(std::shared_ptr<block_budget> new_budget) {
+    budget_ = std::move(new_budget);
+  }
+
+  void set_validation_threads(uint32_t num_threads) {
+    validation_threads = num_threads;
+    validation_pool = num_threads > 0 ? std::make_unique<named_thread_pool>("validate", num_threads) : nullptr;
+  }
+
   std::tuple<std::shared_ptr<block>, std::shared_ptr<part_set>> create_proposal_block(int64_t height,
     state& state_,
     const std::shared_ptr<commit>& commit_,
@@ -72,11 +105,32 @@ struct block_executor {
     // Fetch a limited amount of valid txs
     auto max_data_bytes_ = max_data_bytes(max_bytes, ev_size, state_.validators->size());
 
-    // TODO : retrieve txs from mempool
+    if (budget_) {
+      auto limits = budget_->scale(max_data_bytes_, max_gas);
+      max_data_bytes_ = limits.max_bytes;
+      max_gas = limits.max_gas;
+    }
+
     std::vector<Bytes> txs;
+    if (mempool_)
+      txs = mempool_->reap_max_bytes_max_gas(max_data_bytes_, max_gas);
+
+    if (budget_) {
+      int64_t reaped_bytes = 0;
+      for (const auto& tx : txs)
+        reaped_bytes += codec::protobuf::message_field_size(1, tx.size());
+      budget_->on_proposed(reaped_bytes, max_data_bytes_);
+    }
+
+    // groups of txs which cooperating apps may deliver in parallel
+    std::vector<uint32_t> tx_groups;
+    if (mempool_) {
+      if (auto accesses = mempool_->tx_accesses(txs); accesses.size() == txs.size())
+        tx_groups = schedule_tx_groups(accesses);
+    }
 
-    return state_.make_block(
-      height, txs, commit_, std::make_shared<evidence_list>(evidence_list{.list = evidence}), proposer_addr);
+    return state_.make_block(height, txs, commit_, std::make_shared<evidence_list>(evidence_list{.list = evidence}),
+      proposer_addr, std::move(tx_groups));
   }
 
   bool validate_block(state& state_, const std::shared_ptr<block>& block_) {
@@ -84,84 +138,116 @@ struct block_executor {
     if (cache.find(hex::encode(hash)) != cache.end())
       return true;
 
-    /// Validate block
-    if (auto err = block_->validate_basic(); err.has_value()) {
-      elog(fmt::format("invalid header: {}", err.value()));
+    trace::span span("validate_block");
+    auto timer = validation_duration.time();
+    if (auto err = check_block(state_, *block_); err.has_value()) {
+      elog(err.value());
       return false;
     }
 
-    /// todo - activate all of the following validations
-    // Check basic info
-    // if (block_->version != state_.version) {
-    //  elog("wrong block_header_version");
-    //  return false;
-    // }
-    if (state_.last_block_height == 0 && block_->header.height != state_.initial_height) {
-      elog("wrong block_header_height");
-      return false;
-    }
-    if (state_.last_block_height > 0 && block_->header.height != state_.last_block_height + 1) {
-      elog("wrong block_header_height");
-      return false;
+    cache[hex::encode(hash)] = true;
+    return true;
+  }
+
+  /// \brief checks block_ against state_
+  /// Evidence is checked on validation_pool while the header is, and txs and signatures of the last commit are then
+  /// hashed and verified in batches on the pool. Hashes of txs, the last commit and evidence are kept in block_, so
+  /// that they are not computed again as the block is applied or stored.
+  /// \return error of the first check failed, as if checks were run one by one
+  std::optional<std::string> check_block(state& state_, block& block_) {
+    auto pool = validation_pool ? &validation_pool->get_executor() : nullptr;
+    auto check_evidence = [&]() -> std::optional<std::string> {
+      if (block_.header.evidence_hash != block_.evidence.get_hash())
+        return "wrong block_header_evidence_hash";
+      if (auto ok = ev_pool->check_evidence(*block_.evidence.evs); !ok)
+        return ok.error().message();
+      return {};
+    };
+    std::future<std::optional<std::string>> evidence_checked;
+    if (pool)
+      evidence_checked = async_thread_pool(*pool, check_evidence);
+
+    auto err = check_header(state_, block_);
+    if (!err.has_value() && block_.header.data_hash != block_.data.get_hash(pool, validation_threads))
+      err = "wrong block_header_data_hash";
+    if (!err.has_value())
+      err = check_last_commit(state_, block_, pool);
+
+    // evidence checked on the pool refers to block_, so it must finish before returning anyway
+    if (pool) {
+      auto evidence_err = evidence_checked.get();
+      return err.has_value() ? err : evidence_err;
     }
+    return err.has_value() ? err : check_evidence();
+  }
 
-    // if (block_->header.last_block_id != state_.last_block_id) {
-    //   elog("wrong block_header_last_block_id");
-    //   return false;
-    // }
+  std::optional<std::string> check_header(state& state_, block& block_) {
+    /// Validate block
+    if (auto err = block_.validate_basic(); err.has_value())
+      return fmt::format("invalid header: {}", err.value());
+
+    /// todo - activate all of the following validations
+    // Check basic info
+    // if (block_.version != state_.version)
+    //   return "wrong block_header_version";
+    if (state_.last_block_height == 0 && block_.header.height != state_.initial_height)
+      return "wrong block_header_height";
+    if (state_.last_block_height > 0 && block_.header.height != state_.last_block_height + 1)
+      return "wrong block_header_height";
+
+    // if (block_.header.last_block_id != state_.last_block_id)
+    //   return "wrong block_header_last_block_id";
+    if (!block_.last_commit)
+      return "missing last_commit";
+    if (block_.header.last_commit_hash != block_.last_commit->get_hash())
+      return "wrong block_header_last_commit_hash";
 
     // Check app info
-    if (block_->header.app_hash != state_.app_hash) {
-      elog("wrong block_header_app_hash");
-      return false;
-    }
-    auto hash_cp = state_.consensus_params_.hash_consensus_params();
-    if (block_->header.consensus_hash != hash_cp) {
-      elog("wrong block_header_consensus_hash");
-      return false;
-    }
-    if (block_->header.last_results_hash != state_.last_result_hash) {
-      elog("wrong block_header_last_results_hash");
-      return false;
-    }
+    if (block_.header.app_hash != state_.app_hash)
+      return "wrong block_header_app_hash";
+    if (block_.header.consensus_hash != state_.consensus_params_.hash_consensus_params())
+      return "wrong block_header_consensus_hash";
+    if (block_.header.last_results_hash != state_.last_result_hash)
+      return "wrong block_header_last_results_hash";
+    if (block_.header.validators_hash != state_.validators->get_hash())
+      return "wrong block_header_validators_hash";
+    if (block_.header.next_validators_hash != state_.next_validators->get_hash())
+      return "wrong block_header_next_validators_hash";
     // todo - more
 
     // Check block time
-    if (block_->header.height > state_.initial_height) {
-      // if (block_->header.time > state_.last_block_time) {
-      //   elog("block time is not greater than last block time");
-      //   return false;
-      // }
-      // auto median_time = get_median_time(block_->last_commit, state_.last_validators);
-      // if (block_->header.time != median_time) {
-      //   elog("invalid block time");
-      //   return false;
-      // }
-    } else if (block_->header.height == state_.initial_height) {
-      auto genesis_time = state_.last_block_time;
-      // if (block_->header.time != genesis_time) {
-      //   elog("block time is not equal to genesis time");
-      //   return false;
-      // }
+    if (block_.header.height > state_.initial_height) {
+      // if (block_.header.time <= state_.last_block_time)
+      //   return "block time is not greater than last block time";
+      // auto median_time = get_median_time(block_.last_commit, state_.last_validators);
+      // if (block_.header.time != median_time)
+      //   return "invalid block time";
+    } else if (block_.header.height == state_.initial_height) {
+      // auto genesis_time = state_.last_block_time;
+      // if (block_.header.time != genesis_time)
+      //   return "block time is not equal to genesis time";
     } else {
-      elog("block height is lower than initial height");
-      return false;
+      return "block height is lower than initial height";
     }
     /// End of validate block
+    return {};
+  }
 
-    // check evidence
-    if (block_->evidence.evs) {
-      if (auto ok = ev_pool->check_evidence(*block_->evidence.evs); !ok) {
-        elog(ok.error().message());
-        return false;
-      }
+  std::optional<std::string> check_last_commit(state& state_, block& block_, boost::asio::io_context* pool) {
+    if (block_.header.height == state_.initial_height) {
+      if (!block_.last_commit->signatures.empty())
+        return "block at the initial height has a last commit";
+      return {};
     }
-
-    cache[hex::encode(hash)] = true;
-    return true;
+    if (auto err = verify_commit(state_.chain_id, state_.last_validators, state_.last_block_id,
+          block_.header.height - 1, std::make_shared<commit>(*block_.last_commit), pool, validation_threads);
+        err.has_value())
+      return fmt::format("invalid last commit: {}", err.value());
+    return {};
   }
 
   std::optional<state> apply_block(state& state_, p2p::block_id block_id_, std::shared_ptr<block> block_) {
+    trace::span span("apply_block");
     if (!validate_block(state_, block_)) {
       elog("apply block failed: invalid block");
       return {};
@@ -204,13 +290,19 @@ struct block_executor {
     // mempool: flush_app_conn() - todo - maybe not needed for noir?
 
     // Commit block and get hash
+    auto commit_start_time = get_time();
     auto commit_res = proxyApp_->commit_sync();
+    if (budget_)
+      budget_->on_executed(std::chrono::microseconds(end_time - start_time + get_time() - commit_start_time));
 
     ilog(fmt::format(
       "committed state: height={}, num_txs... app_hash={}", block_->header.height, hex::encode(commit_res->data())));
 
     // Update mempool
-    std::vector<consensus::tx> block_txs;
+    if (mempool_) {
+      if (auto ok = mempool_->update(block_->header.height, block_->data.txs, abci_responses_->deliver_txs()); !ok)
+        elog(fmt::format("failed to update mempool: {}", ok.error().message()));
+    }
 
     Bytes app_hash = commit_res->data();
     int64_t retain_height = commit_res->retain_height();
@@ -247,6 +339,7 @@ struct block_executor {
     std::shared_ptr<block> block_,
     std::shared_ptr<db_store> db_store,
     int64_t initial_height) {
+    trace::span span("exec_block_on_proxy_app");
     uint valid_txs = 0, invalid_txs = 0;
     auto abci_responses_ = std::make_shared<tendermint::state::ABCIResponses>();
     std::vector<tendermint::abci::ResponseDeliverTx> dtxs;
@@ -278,11 +371,29 @@ struct block_executor {
         abci_responses_->set_allocated_begin_block(res.release());
     }
 
-    // Deliver Tx
+    // Deliver Tx, in groups if the proposer gave them and the app delivers groups, and one by one otherwise
+    std::vector<std::unique_ptr<tendermint::abci::ResponseDeliverTx>> grouped_res;
+    if (const auto& groups = block_->data.tx_groups; !groups.empty()) {
+      if (valid_tx_groups(groups, block_->data.txs.size()))
+        grouped_res = proxyAppConn->deliver_tx_groups(block_->data.txs, groups);
+      else
+        dlog(fmt::format("ignoring invalid tx groups: height={}", block_->header.height));
+    }
+    // the app may have delivered some of the txs, so they can't be delivered one by one again
+    if (!grouped_res.empty() && grouped_res.size() != block_->data.txs.size()) {
+      elog(fmt::format("app delivered {} txs out of {}: height={}", grouped_res.size(), block_->data.txs.size(),
+        block_->header.height));
+      return nullptr;
+    }
     for (int idx = 0; const auto& tx : block_->data.txs) {
-      tendermint::abci::RequestDeliverTx deliver_tx_req;
-      deliver_tx_req.set_tx({tx.begin(), tx.end()});
-      auto deliver_res = proxyAppConn->deliver_tx_async(deliver_tx_req);
+      std::unique_ptr<tendermint::abci::ResponseDeliverTx> deliver_res;
+      if (!grouped_res.empty()) {
+        deliver_res = std::move(grouped_res[idx]);
+      } else {
+        tendermint::abci::RequestDeliverTx deliver_tx_req;
+        deliver_tx_req.set_tx({tx.begin(), tx.end()});
+        deliver_res = proxyAppConn->deliver_tx_async(deliver_tx_req);
+      }
       /* todo - verify if implementation is correct;
        *        basically removed the original callback func and directly applied it here */
       if (!deliver_res || deliver_res->code() != code_type_ok) {
@@ -313,6 +424,23 @@ struct block_executor {
     return abci_responses_;
   }
 
+  /// \brief executes and commits a block on the proxy app without validating it or mutating state.
+  /// Used by the handshaker to bring an application up to the block store; blocks in the store are already committed,
+  /// so neither block validation nor commit signature verification is repeated.
+  /// \param[in] block_ block to execute
+  /// \param[in] initial_height initial height of the chain
+  /// \return app hash returned by Commit
+  Result<Bytes> exec_commit_block(const std::shared_ptr<block>& block_, int64_t initial_height) {
+    auto abci_responses_ = exec_block_on_proxy_app(proxyApp_, block_, store_, initial_height);
+    if (abci_responses_ == nullptr)
+      return Error::format("exec_commit_block failed: proxy app at height={}", block_->header.height);
+
+    auto commit_res = proxyApp_->commit_sync();
+    if (!commit_res)
+      return Error::format("exec_commit_block failed: commit at height={}", block_->header.height);
+    return Bytes{commit_res->data()};
+  }
+
   std::unique_ptr<tendermint::abci::LastCommitInfo> get_begin_block_validator_info(
     const std::shared_ptr<block>& block_, const std::shared_ptr<db_store>& store_, int64_t initial_height) {
     std::vector<tendermint::abci::VoteInfo> vote_infos;
@@ -7,6 +7,7 @@
 #include <noir/common/log.h>
 #include <noir/common/overloaded.h>
 #include <noir/consensus/block_sync/block_pool.h>
+#include <noir/metrics/metrics.h>
 #include <tendermint/blocksync/types.pb.h>
 
 namespace noir::consensus::block_sync {
@@ -33,6 +34,7 @@ void block_pool::pop_request() {
     requesters.erase(r);
     height++;
     last_advance = get_time();
+    update_height_metrics();
 
     // last_sync_rate will be updated every 100 blocks
     if ((height - start_height) % 100 == 0) {
@@ -88,6 +90,16 @@ void block_pool::update_max_peer_height() {
       max = peer->height;
   }
   max_peer_height = max;
+  update_height_metrics();
+}
+
+void block_pool::update_height_metrics() {
+  static auto synced_height =
+    metrics::default_registry().make_gauge("noir_block_sync_height", "Height of the next block to be synced");
+  static auto height_lag = metrics::default_registry().make_gauge(
+    "noir_block_sync_height_lag", "Number of blocks the highest peer is ahead of the block being synced");
+  synced_height.set(height);
+  height_lag.set(std::max<int64_t>(max_peer_height - height, 0));
 }
 
 std::shared_ptr<bp_peer> block_pool::pick_incr_available_peer(int64_t height_) {
@@ -154,6 +166,7 @@ void block_pool::set_peer_range(std::string peer_id_, int64_t base, int64_t heig
   }
   if (height_ > max_peer_height)
     max_peer_height = height_;
+  update_height_metrics();
 }
 
 void block_pool::make_next_requester() {
@@ -124,6 +124,7 @@ struct block_pool : std::enable_shared_from_this<block_pool> {
   void remove_timed_out_peers();
   void remove_peer(std::string peer_id);
   void update_max_peer_height();
+  void update_height_metrics();
   std::shared_ptr<bp_peer> pick_incr_available_peer(int64_t height_);
 
   std::string redo_request(int64_t height_);
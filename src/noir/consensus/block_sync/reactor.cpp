@@ -131,7 +131,8 @@ void reactor::try_sync_ticker() {
       if (!first || !second)
         continue;
 
-      auto first_parts = first->make_part_set(block_part_size_bytes);
+      auto first_parts =
+        first->make_part_set(block_part_size_bytes, latest_state.consensus_params_.block.part_parity_percent);
       auto first_part_set_header = first_parts->header();
       auto first_id = p2p::block_id{first->get_hash(), first_part_set_header};
 
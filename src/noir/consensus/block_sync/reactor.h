@@ -37,8 +37,8 @@ struct reactor {
   std::function<void(state&, bool)> callback_switch_to_cs_sync{};
 
   // Receive an envelope from peers [via p2p]
-  plugin_interface::incoming::channels::bs_reactor_message_queue::channel_type::handle bs_reactor_mq_subscription =
-    app.get_channel<plugin_interface::incoming::channels::bs_reactor_message_queue>().subscribe(
+  plugin_interface::incoming::methods::bs_reactor_message::method_type::handle bs_reactor_msg_provider =
+    app.get_method<plugin_interface::incoming::methods::bs_reactor_message>().register_provider(
       std::bind(&reactor::process_peer_msg, this, std::placeholders::_1));
 
   // Receive peer_status update from p2p
@@ -230,6 +230,47 @@ inline noir::consensus::commit make_commit(int64_t height, noir::tstamp timestam
   };
 }
 
+/// \brief commit for block_id_ at height signed by all validators of vals
+inline std::shared_ptr<commit> make_signed_commit(const std::string& chain_id,
+  int64_t height,
+  const p2p::block_id& block_id_,
+  const std::shared_ptr<validator_set>& vals,
+  const std::vector<std::shared_ptr<priv_validator>>& priv_vals) {
+  std::map<Bytes, std::shared_ptr<priv_validator>> priv_vals_by_address;
+  for (const auto& priv_val : priv_vals)
+    priv_vals_by_address[priv_val->get_pub_key().address()] = priv_val;
+
+  std::vector<commit_sig> sigs;
+  for (auto i = 0; i < vals->size(); i++) {
+    vote vote_;
+    vote_.type = p2p::Precommit;
+    vote_.height = height;
+    vote_.round = 0;
+    vote_.block_id_ = block_id_;
+    vote_.timestamp = get_time();
+    vote_.validator_address = vals->validators[i].address;
+    vote_.validator_index = i;
+    priv_vals_by_address.at(vote_.validator_address)->sign_vote(chain_id, vote_);
+    sigs.push_back(vote_.to_commit_sig());
+  }
+  return commit::new_commit(height, 0, block_id_, sigs);
+}
+
+/// \brief state of num_vals validators after height - 1, and a block of txs at height, which is valid on the state
+/// The block is encoded and decoded, so that nothing of it is cached, as for blocks received from peers.
+inline std::tuple<state, std::shared_ptr<block>> make_signed_block(
+  config& config_, int num_vals, int64_t height, std::vector<tx> txs) {
+  auto [state_, priv_vals] = rand_genesis_state(config_, num_vals, false, test_min_power);
+  state_.last_block_height = height - 1;
+  state_.last_block_id = {.hash = random_hash(), .parts = {.total = 1, .hash = random_hash()}};
+  state_.last_validators = state_.validators->copy();
+
+  auto commit_ =
+    make_signed_commit(state_.chain_id, height - 1, state_.last_block_id, state_.last_validators, priv_vals);
+  auto [block_, part_set_] = state_.make_block(height, txs, commit_, {}, state_.validators->validators[0].address);
+  return {state_, block::from_proto(*block::to_proto(*block_))};
+}
+
 class status_monitor {
 public:
   status_monitor() = default;
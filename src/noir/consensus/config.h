@@ -49,6 +49,7 @@ struct base_config {
   std::string node_key;
   std::string abci;
   bool filter_peers;
+  int query_conns;
 
   static base_config get_default() {
     base_config cfg;
@@ -58,6 +59,7 @@ struct base_config {
     cfg.abci = "local";
     cfg.log_level = "info";
     cfg.db_path = "data";
+    cfg.query_conns = 4;
     return cfg;
   }
 };
@@ -85,6 +87,18 @@ struct consensus_config {
 
   int64_t double_sign_check_height;
 
+  /// adapts bytes and gas of proposed blocks so that executing and committing one takes about this long; 0 disables
+  std::chrono::system_clock::duration target_block_exec_time;
+
+  /// gossips votes a peer is missing in messages of up to this many bytes, rather than one by one; 0 disables
+  uint32_t vote_batch_bytes;
+  /// announces votes received within this interval in a bitmap per height, round and type, rather than one by one;
+  /// 0 disables
+  std::chrono::system_clock::duration has_votes_interval;
+
+  /// checks txs, last commit signatures and evidence of a block on this many threads; 0 checks them one by one
+  uint32_t block_validation_threads;
+
   static consensus_config get_default() {
     consensus_config cfg;
     cfg.wal_path = std::string(default_data_dir) + "/" + "cs.wal";
@@ -101,6 +115,10 @@ struct consensus_config {
     cfg.peer_gossip_sleep_duration = std::chrono::milliseconds{100};
     cfg.peer_query_maj_23_sleep_duration = std::chrono::milliseconds{2000};
     cfg.double_sign_check_height = 0;
+    cfg.target_block_exec_time = std::chrono::seconds{0};
+    cfg.vote_batch_bytes = 0;
+    cfg.has_votes_interval = std::chrono::milliseconds{0};
+    cfg.block_validation_threads = 4;
     return cfg;
   }
 
@@ -181,9 +199,10 @@ struct config {
 } // namespace noir::consensus
 
 NOIR_REFLECT(noir::consensus::base_config, chain_id, root_dir, proxy_app, moniker, mode, fast_sync_mode, db_backend,
-  db_path, log_level, log_format, genesis, node_key, abci, filter_peers);
+  db_path, log_level, log_format, genesis, node_key, abci, filter_peers, query_conns);
 NOIR_REFLECT(noir::consensus::consensus_config, root_dir, wal_path, wal_file, timeout_propose, timeout_propose_delta,
   timeout_prevote, timeout_prevote_delta, timeout_precommit, timeout_precommit_delta, timeout_commit,
   skip_timeout_commit, create_empty_blocks, create_empty_blocks_interval, peer_gossip_sleep_duration,
-  peer_query_maj_23_sleep_duration, double_sign_check_height);
+  peer_query_maj_23_sleep_duration, double_sign_check_height, target_block_exec_time,
+  vote_batch_bytes, has_votes_interval, block_validation_threads);
 NOIR_REFLECT(noir::consensus::config, base, consensus, priv_validator);
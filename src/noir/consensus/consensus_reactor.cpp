@@ -6,11 +6,73 @@
 #include <noir/common/overloaded.h>
 #include <noir/consensus/consensus_reactor.h>
 #include <noir/consensus/types/proposal.h>
+#include <noir/consensus/types/wire.h>
 #include <noir/core/codec.h>
 #include <tendermint/consensus/types.pb.h>
 
 namespace noir::consensus {
 
+namespace {
+
+using codec::protobuf::message_field_size;
+using codec::protobuf::wire_reader;
+using codec::protobuf::wire_type;
+using codec::protobuf::wire_writer;
+
+/// \brief returns the number and payload of the last length delimited field, i.e. the field set in a oneof
+/// \note field number is 0 if no such field is found or input is malformed
+std::pair<uint32_t, std::span<const unsigned char>> read_oneof(std::span<const unsigned char> bz) {
+  std::pair<uint32_t, std::span<const unsigned char>> ret{};
+  wire_reader r(bz);
+  uint32_t field;
+  wire_type type;
+  while (r.next(field, type)) {
+    if (type == wire_type::length_delimited)
+      ret = {field, r.bytes()};
+    else
+      r.skip(type);
+  }
+  if (r.error())
+    return {};
+  return ret;
+}
+
+/// \brief encodes msg as tendermint.consensus.Message with field set, optionally wrapped as field of a message
+template<typename T>
+Bytes encode_cs_message(uint32_t field, std::optional<uint32_t> wrapper, const T& msg) {
+  auto size = wire::encoded_size(msg);
+  auto inner = wrapper ? message_field_size(*wrapper, size) : size;
+  Bytes bz(message_field_size(field, inner));
+  wire_writer w(std::span<unsigned char>(bz.data(), bz.size()));
+  w.message_field(field, inner);
+  if (wrapper)
+    w.message_field(*wrapper, size);
+  wire::write(w, msg);
+  return bz;
+}
+
+/// \brief names of consensus messages, in the order of p2p::cs_reactor_message alternatives
+constexpr auto cs_message_types = std::to_array<const char*>({"new_round_step", "new_valid_block", "proposal",
+  "proposal_pol", "block_part", "vote", "has_vote", "vote_set_maj23", "vote_set_bits", "votes", "has_votes"});
+static_assert(cs_message_types.size() == std::variant_size_v<p2p::cs_reactor_message>);
+
+const metrics::counter& messages_sent(size_t index) {
+  static const auto counters = []() {
+    std::array<metrics::counter, cs_message_types.size()> ret;
+    for (size_t i = 0; i < ret.size(); i++)
+      ret[i] = consensus_messages_sent(cs_message_types[i]);
+    return ret;
+  }();
+  return counters[index];
+}
+
+} // namespace
+
+metrics::counter consensus_messages_sent(const std::string& type) {
+  return metrics::default_registry().make_counter(
+    "noir_consensus_messages_sent_total", "Number of consensus messages handed to p2p", {{"type", type}});
+}
+
 void consensus_reactor::process_peer_update(plugin_interface::peer_status_info_ptr info) {
   dlog(fmt::format("peer update: peer_id={}, status={}", info->peer_id, p2p::peer_status_to_str(info->status)));
   std::scoped_lock g(mtx);
@@ -95,19 +157,17 @@ void consensus_reactor::process_peer_msg(p2p::envelope_ptr info) {
       /***************************************************************************************************/
       ///< state messages: new_round_step, new_valid_block, has_vote, vote_set_maj23
       [this, &ps](p2p::new_round_step_message& msg) {
-        std::unique_lock<std::mutex> lock(cs_state->mtx);
-        auto initial_height = cs_state->local_state.initial_height;
-        lock.unlock();
+        auto initial_height = cs_state->get_state()->initial_height;
         // msg.validate() // TODO
         ps->apply_new_round_step_message(msg);
       },
       [&ps](p2p::new_valid_block_message& msg) { ps->apply_new_valid_block_message(msg); },
       [&ps](p2p::has_vote_message& msg) { ps->apply_has_vote_message(msg); },
+      [&ps](p2p::has_votes_message& msg) { ps->apply_has_votes_message(msg); },
       [this, &ps, &from](p2p::vote_set_maj23_message& msg) {
-        std::unique_lock<std::mutex> lock(cs_state->mtx);
-        auto height = cs_state->rs.height;
-        auto votes = cs_state->rs.votes;
-        lock.unlock();
+        auto rs = cs_state->get_round_state();
+        auto height = rs->height;
+        auto votes = rs->votes;
         if (height != msg.height)
           return;
 
@@ -147,13 +207,12 @@ void consensus_reactor::process_peer_msg(p2p::envelope_ptr info) {
           appbase::priority::medium, std::make_shared<p2p::internal_msg_info>(p2p::internal_msg_info{msg, from}));
       },
       /***************************************************************************************************/
-      ///< vote message: vote
+      ///< vote messages: vote, votes
       [this, &ps, &from](p2p::vote_message& msg) {
-        std::unique_lock<std::mutex> lock(cs_state->mtx);
-        auto height = cs_state->rs.height;
-        auto val_size = cs_state->rs.validators->size();
-        auto last_commit_size = cs_state->rs.last_commit->get_size();
-        lock.unlock();
+        auto rs = cs_state->get_round_state();
+        auto height = rs->height;
+        auto val_size = rs->validators->size();
+        auto last_commit_size = rs->last_commit->get_size();
 
         ps->ensure_vote_bit_arrays(height, val_size);
         ps->ensure_vote_bit_arrays(height - 1, last_commit_size);
@@ -162,13 +221,26 @@ void consensus_reactor::process_peer_msg(p2p::envelope_ptr info) {
         internal_mq_channel.publish(
           appbase::priority::medium, std::make_shared<p2p::internal_msg_info>(p2p::internal_msg_info{msg, from}));
       },
+      [this, &ps, &from](p2p::votes_message& msg) {
+        auto rs = cs_state->get_round_state();
+        auto height = rs->height;
+        auto val_size = rs->validators->size();
+        auto last_commit_size = rs->last_commit->get_size();
+
+        ps->ensure_vote_bit_arrays(height, val_size);
+        ps->ensure_vote_bit_arrays(height - 1, last_commit_size);
+        for (auto& vote_ : msg.votes) {
+          ps->set_has_vote(vote_);
+          internal_mq_channel.publish(appbase::priority::medium,
+            std::make_shared<p2p::internal_msg_info>(p2p::internal_msg_info{std::move(vote_), from}));
+        }
+      },
       /***************************************************************************************************/
       ///< vote_set_bits message: vote_set_bits
       [this, &ps](p2p::vote_set_bits_message& msg) {
-        std::unique_lock<std::mutex> lock(cs_state->mtx);
-        auto height = cs_state->rs.height;
-        auto votes = cs_state->rs.votes;
-        lock.unlock();
+        auto rs = cs_state->get_round_state();
+        auto height = rs->height;
+        auto votes = rs->votes;
 
         if (height == msg.height) {
           std::shared_ptr<bit_array> our_votes{};
@@ -217,6 +289,11 @@ p2p::cs_reactor_message consensus_reactor::process_state_ch(const Bytes& msg) {
     const auto& m = pb_msg.has_vote_();
     return p2p::has_vote_message{m.height(), m.round(), static_cast<p2p::signed_msg_type>(m.type()), m.index()};
   }
+  case tendermint::consensus::Message::kHasVotes: {
+    const auto& m = pb_msg.has_votes_();
+    return p2p::has_votes_message{
+      m.height(), m.round(), static_cast<p2p::signed_msg_type>(m.type()), bit_array::from_proto(m.votes())};
+  }
   case tendermint::consensus::Message::kVoteSetMaj23: {
     const auto& m = pb_msg.vote_set_maj23();
     return p2p::vote_set_maj23_message{
@@ -226,6 +303,27 @@ p2p::cs_reactor_message consensus_reactor::process_state_ch(const Bytes& msg) {
   return {};
 }
 p2p::cs_reactor_message consensus_reactor::process_data_ch(const Bytes& msg) {
+  // proposals and block parts are decoded directly from wire format
+  switch (auto [field, payload] = read_oneof(msg); field) {
+  case tendermint::consensus::Message::kProposalFieldNumber: {
+    proposal ret;
+    auto [_, pb_proposal] = read_oneof(payload); // tendermint.consensus.Proposal has only one field
+    if (auto ok = wire::decode(pb_proposal, ret); !ok) {
+      elog(fmt::format("unable to decode proposal: {}", ok.error().message()));
+      return {};
+    }
+    return p2p::proposal_message{ret};
+  }
+  case tendermint::consensus::Message::kBlockPartFieldNumber: {
+    p2p::block_part_message ret;
+    if (auto ok = wire::decode(payload, ret); !ok) {
+      elog(fmt::format("unable to decode block part: {}", ok.error().message()));
+      return {};
+    }
+    return ret;
+  }
+  }
+
   ::tendermint::consensus::Message pb_msg;
   pb_msg.ParseFromArray(msg.data(), msg.size());
   if (!pb_msg.IsInitialized()) {
@@ -233,38 +331,31 @@ p2p::cs_reactor_message consensus_reactor::process_data_ch(const Bytes& msg) {
     return {};
   }
   switch (pb_msg.sum_case()) {
-  case tendermint::consensus::Message::kProposal: {
-    const auto& m = pb_msg.proposal();
-    return p2p::proposal_message{*proposal::from_proto(m.proposal())};
-  }
   case tendermint::consensus::Message::kProposalPol: {
     const auto& m = pb_msg.proposal_pol();
     return p2p::proposal_pol_message{m.height(), m.proposal_pol_round(), bit_array::from_proto(m.proposal_pol())};
   }
-  case tendermint::consensus::Message::kBlockPart: {
-    const auto& m = pb_msg.block_part();
-    p2p::block_part_message ret;
-    ret.height = m.height();
-    ret.round = m.round();
-    const auto& m_part = m.part();
-    ret.index = m_part.index();
-    ret.bytes_ = m_part.bytes();
-    ret.proof = *merkle::proof::from_proto(m_part.proof());
-    return ret;
-  }
   }
   return {};
 }
 p2p::cs_reactor_message consensus_reactor::process_vote_ch(const Bytes& msg) {
-  ::tendermint::consensus::Message pb_msg;
-  pb_msg.ParseFromArray(msg.data(), msg.size());
-  if (!pb_msg.IsInitialized()) {
-    elog("unable to parse envelop message: size=${size}", ("size", msg.size()));
-    return {};
+  auto [field, payload] = read_oneof(msg);
+  if (field == tendermint::consensus::Message::kVoteFieldNumber) {
+    vote ret;
+    auto [_, pb_vote] = read_oneof(payload); // tendermint.consensus.Vote has only one field
+    if (auto ok = wire::decode(pb_vote, ret); !ok) {
+      elog(fmt::format("unable to decode vote: {}", ok.error().message()));
+      return {};
+    }
+    return p2p::vote_message{ret};
   }
-  if (pb_msg.sum_case() == tendermint::consensus::Message::kVote) {
-    const auto& m = pb_msg.vote();
-    return p2p::vote_message{*vote::from_proto(m.vote())};
+  if (field == tendermint::consensus::Message::kVotesFieldNumber) {
+    p2p::votes_message ret;
+    if (auto ok = wire::decode(payload, ret); !ok) {
+      elog(fmt::format("unable to decode votes: {}", ok.error().message()));
+      return {};
+    }
+    return ret;
   }
   return {};
 }
@@ -297,19 +388,18 @@ void consensus_reactor::gossip_data_routine(std::shared_ptr<peer_state> ps) {
     auto rs = cs_state->get_round_state();
     auto prs = ps->get_round_state();
 
-    int index{0};
-    bool ok{false};
+    // parts sent to fewer peers go first, so peers get distinct parts to exchange, and any of them rebuild coded sets
+    std::optional<uint32_t> index;
     if (rs->proposal_block_parts && rs->proposal_block_parts->has_header(prs->proposal_block_part_set_header)) {
-      std::tie(index, ok) =
-        rs->proposal_block_parts->get_bit_array()->sub(bit_array::copy(prs->proposal_block_parts))->pick_random();
+      index = rs->proposal_block_parts->pick_part_to_send(prs->proposal_block_parts);
     }
-    if (ok) {
+    if (index) {
       // Send proposal_block_parts
-      auto part = rs->proposal_block_parts->get_part(index);
+      auto part = rs->proposal_block_parts->get_part(*index);
       dlog(fmt::format("sending block_part: height={} round={}", prs->height, prs->round));
       transmit_new_envelope(
         "", ps->peer_id, p2p::block_part_message{rs->height, rs->round, part->index, part->bytes_, part->proof_});
-      ps->set_has_proposal_block_part(prs->height, prs->round, index);
+      ps->set_has_proposal_block_part(prs->height, prs->round, *index);
       gossip_data_routine(ps);
 
     } else if (auto block_store_base = cs_state->block_store_->base();
@@ -360,7 +450,7 @@ void consensus_reactor::gossip_data_routine(std::shared_ptr<peer_state> ps) {
   });
 }
 
-void consensus_reactor::gossip_data_for_catchup(const std::shared_ptr<round_state>& rs,
+void consensus_reactor::gossip_data_for_catchup(const std::shared_ptr<const round_state>& rs,
   const std::shared_ptr<peer_round_state>& prs,
   const std::shared_ptr<peer_state>& ps) {
   if (auto [index, ok] = prs->proposal_block_parts->not_op()->pick_random(); ok) {
@@ -405,7 +495,7 @@ void consensus_reactor::gossip_votes_routine(std::shared_ptr<peer_state> ps) {
       gossip_votes_routine(ps);
 
     } else if ((prs->height != 0 && rs->height == prs->height + 1) &&
-      pick_send_vote(ps, vote_set_reader(*rs->last_commit))) {
+      pick_send_votes(ps, vote_set_reader(*rs->last_commit))) {
       // Special catchup - if peer is lagged by 1, send last_commit
       dlog("picked last_commit to send");
       gossip_votes_routine(ps);
@@ -414,7 +504,7 @@ void consensus_reactor::gossip_votes_routine(std::shared_ptr<peer_state> ps) {
                (block_store_base > 0 && prs->height != 0 && rs->height >= prs->height + 2 &&
                  prs->height >= block_store_base) &&
                cs_state->block_store_->load_block_commit(prs->height, commit_) &&
-               pick_send_vote(ps, vote_set_reader(commit_))) {
+               pick_send_votes(ps, vote_set_reader(commit_))) {
       // Catchup logic - if peer is lagged by more than 1, send commit
       // Load block_commit for prs->height which contains precommit sig
       dlog("picked catchup commit to send");
@@ -428,12 +518,12 @@ void consensus_reactor::gossip_votes_routine(std::shared_ptr<peer_state> ps) {
   });
 }
 
-bool consensus_reactor::gossip_votes_for_height(const std::shared_ptr<round_state>& rs,
+bool consensus_reactor::gossip_votes_for_height(const std::shared_ptr<const round_state>& rs,
   const std::shared_ptr<peer_round_state>& prs,
   const std::shared_ptr<peer_state>& ps) {
   // If there are last_commits to send
   if (prs->step == p2p::round_step_type::NewHeight) {
-    if (pick_send_vote(ps, vote_set_reader(*rs->last_commit))) {
+    if (pick_send_votes(ps, vote_set_reader(*rs->last_commit))) {
       dlog("picked last_commit to send");
       return true;
     }
@@ -443,7 +533,7 @@ bool consensus_reactor::gossip_votes_for_height(const std::shared_ptr<round_stat
   if (prs->step <= p2p::round_step_type::Propose && prs->round != -1 && prs->round <= rs->round &&
     prs->proposal_pol_round != -1) {
     if (auto pol_prevotes = rs->votes->prevotes(prs->proposal_pol_round); pol_prevotes != nullptr) {
-      if (pick_send_vote(ps, vote_set_reader(*pol_prevotes))) {
+      if (pick_send_votes(ps, vote_set_reader(*pol_prevotes))) {
         dlog("picked prevotes(proposal_pol_round) to send");
         return true;
       }
@@ -452,7 +542,7 @@ bool consensus_reactor::gossip_votes_for_height(const std::shared_ptr<round_stat
 
   // If there are prevotes to send
   if (prs->step <= p2p::round_step_type::PrevoteWait && prs->round != -1 && prs->round <= rs->round) {
-    if (pick_send_vote(ps, vote_set_reader(*rs->votes->prevotes(prs->round)))) {
+    if (pick_send_votes(ps, vote_set_reader(*rs->votes->prevotes(prs->round)))) {
       dlog("picked prevotes(round) to send");
       return true;
     }
@@ -460,7 +550,7 @@ bool consensus_reactor::gossip_votes_for_height(const std::shared_ptr<round_stat
 
   // If there are precommits to send
   if (prs->step <= p2p::round_step_type::PrecommitWait && prs->round != -1 && prs->round <= rs->round) {
-    if (pick_send_vote(ps, vote_set_reader(*rs->votes->precommits(prs->round)))) {
+    if (pick_send_votes(ps, vote_set_reader(*rs->votes->precommits(prs->round)))) {
       dlog("picked precommits(round) to send");
       return true;
     }
@@ -468,7 +558,7 @@ bool consensus_reactor::gossip_votes_for_height(const std::shared_ptr<round_stat
 
   // If there are prevotes to send, b/c of valid_block
   if (prs->round != -1 && prs->round <= rs->round) {
-    if (pick_send_vote(ps, vote_set_reader(*rs->votes->prevotes(prs->round)))) {
+    if (pick_send_votes(ps, vote_set_reader(*rs->votes->prevotes(prs->round)))) {
       dlog("picked prevotes(round) to send");
       return true;
     }
@@ -477,7 +567,7 @@ bool consensus_reactor::gossip_votes_for_height(const std::shared_ptr<round_stat
   // If there are pol_prevotes to send
   if (prs->proposal_pol_round != -1) {
     if (auto pol_prevotes = rs->votes->prevotes(prs->proposal_pol_round); pol_prevotes != nullptr) {
-      if (pick_send_vote(ps, vote_set_reader(*pol_prevotes))) {
+      if (pick_send_votes(ps, vote_set_reader(*pol_prevotes))) {
         dlog("picked prevotes(proposal_pol_round) to send");
         return true;
       }
@@ -487,14 +577,29 @@ bool consensus_reactor::gossip_votes_for_height(const std::shared_ptr<round_stat
   return false;
 }
 
-bool consensus_reactor::pick_send_vote(const std::shared_ptr<peer_state>& ps, const vote_set_reader& votes_) {
-  if (auto [vote_, ok] = ps->pick_vote_to_send(const_cast<vote_set_reader&>(votes_)); ok) {
-    dlog("cs_reactor: sending vote message");
-    transmit_new_envelope("", ps->peer_id, p2p::vote_message{*vote_});
-    ps->set_has_vote(*vote_);
-    return true;
+bool consensus_reactor::pick_send_votes(const std::shared_ptr<peer_state>& ps, const vote_set_reader& votes_) {
+  auto votes = ps->pick_votes_to_send(const_cast<vote_set_reader&>(votes_));
+  if (votes.empty())
+    return false;
+
+  // votes left out of a full batch are sent as the gossip routine runs again right away
+  p2p::votes_message msg;
+  size_t size = 0;
+  for (const auto& vote_ : votes) {
+    auto vote_size = message_field_size(tendermint::consensus::Votes::kVotesFieldNumber, wire::encoded_size(*vote_));
+    if (!msg.votes.empty() && size + vote_size > cs_state->cs_config.vote_batch_bytes)
+      break;
+    size += vote_size;
+    msg.votes.push_back(*vote_);
   }
-  return false;
+  dlog(fmt::format("cs_reactor: sending {} votes", msg.votes.size()));
+  if (msg.votes.size() == 1)
+    transmit_new_envelope("", ps->peer_id, msg.votes.front());
+  else
+    transmit_new_envelope("", ps->peer_id, msg);
+  for (const auto& vote_ : msg.votes)
+    ps->set_has_vote(vote_);
+  return true;
 }
 
 /// \brief detect and react when there is a signature DDoS attack in progress
@@ -560,6 +665,34 @@ void consensus_reactor::query_maj23_routine(std::shared_ptr<peer_state> ps) {
   });
 }
 
+void consensus_reactor::add_pending_has_vote(const p2p::vote_message& vote_) {
+  std::scoped_lock g(has_votes_mtx);
+  auto was_empty = pending_has_votes.empty();
+  pending_has_votes[{vote_.height, vote_.round, vote_.type}].push_back(vote_.validator_index);
+  if (!was_empty)
+    return;
+  has_votes_timer->expires_from_now(cs_state->cs_config.has_votes_interval);
+  has_votes_timer->async_wait([this](const boost::system::error_code& ec) {
+    if (!ec)
+      broadcast_has_votes_messages();
+  });
+}
+
+void consensus_reactor::broadcast_has_votes_messages() {
+  decltype(pending_has_votes) pending;
+  {
+    std::scoped_lock g(has_votes_mtx);
+    pending.swap(pending_has_votes);
+  }
+  for (const auto& [key, indices] : pending) {
+    auto [height, round, type] = key;
+    auto votes = bit_array::new_bit_array(*std::max_element(indices.begin(), indices.end()) + 1);
+    for (auto index : indices)
+      votes->set_index(index, true);
+    transmit_new_envelope("", "", p2p::has_votes_message{height, round, type, votes}, true);
+  }
+}
+
 void consensus_reactor::send_new_round_step_message(std::string peer_id) {
   auto rs = cs_state->get_round_state();
   auto msg = make_round_step_message(*rs);
@@ -608,8 +741,8 @@ void consensus_reactor::transmit_new_envelope(
       },
       [&](const p2p::proposal_message& msg) {
         new_env->id = p2p::Data;
-        auto m = pb_msg.mutable_proposal();
-        m->set_allocated_proposal(proposal::to_proto(proposal{msg}).release());
+        new_env->message = encode_cs_message(tendermint::consensus::Message::kProposalFieldNumber,
+          tendermint::consensus::Proposal::kProposalFieldNumber, msg);
       },
       [&](const p2p::proposal_pol_message& msg) {
         new_env->id = p2p::Data;
@@ -620,19 +753,12 @@ void consensus_reactor::transmit_new_envelope(
       },
       [&](const p2p::block_part_message& msg) {
         new_env->id = p2p::Data;
-        auto m = pb_msg.mutable_block_part();
-        m->set_height(msg.height);
-        m->set_round(msg.round);
-        auto pb_part = std::make_unique<::tendermint::types::Part>();
-        pb_part->set_index(msg.index);
-        pb_part->set_bytes({msg.bytes_.begin(), msg.bytes_.end()});
-        pb_part->set_allocated_proof(merkle::proof::to_proto(msg.proof).release());
-        m->set_allocated_part(pb_part.release());
+        new_env->message = encode_cs_message(tendermint::consensus::Message::kBlockPartFieldNumber, std::nullopt, msg);
       },
       [&](const p2p::vote_message& msg) {
         new_env->id = p2p::Vote;
-        auto m = pb_msg.mutable_vote();
-        m->set_allocated_vote(vote::to_proto(vote{msg}).release());
+        new_env->message = encode_cs_message(
+          tendermint::consensus::Message::kVoteFieldNumber, tendermint::consensus::Vote::kVoteFieldNumber, msg);
       },
       [&](const p2p::has_vote_message& msg) {
         new_env->id = p2p::State;
@@ -642,6 +768,18 @@ void consensus_reactor::transmit_new_envelope(
         m->set_type(static_cast<tendermint::types::SignedMsgType>(msg.type));
         m->set_index(msg.index);
       },
+      [&](const p2p::votes_message& msg) {
+        new_env->id = p2p::Vote;
+        new_env->message = encode_cs_message(tendermint::consensus::Message::kVotesFieldNumber, std::nullopt, msg);
+      },
+      [&](const p2p::has_votes_message& msg) {
+        new_env->id = p2p::State;
+        auto m = pb_msg.mutable_has_votes_();
+        m->set_height(msg.height);
+        m->set_round(msg.round);
+        m->set_type(static_cast<tendermint::types::SignedMsgType>(msg.type));
+        m->set_allocated_votes(bit_array::to_proto(*msg.votes).release());
+      },
       [&](const p2p::vote_set_maj23_message& msg) {
         new_env->id = p2p::State;
         auto m = pb_msg.mutable_vote_set_maj23();
@@ -662,9 +800,13 @@ void consensus_reactor::transmit_new_envelope(
       //[&](const auto& msg) {},
     },
     cs_msg);
-  new_env->message.resize(pb_msg.ByteSizeLong());
-  pb_msg.SerializeToArray(new_env->message.data(), pb_msg.ByteSizeLong());
+  // proposals, block parts and votes are already encoded directly into wire format
+  if (pb_msg.sum_case() != tendermint::consensus::Message::SUM_NOT_SET) {
+    new_env->message.resize(pb_msg.ByteSizeLong());
+    pb_msg.SerializeToArray(new_env->message.data(), pb_msg.ByteSizeLong());
+  }
 
+  messages_sent(cs_msg.index()).inc();
   xmt_mq_channel.publish(priority, new_env);
 }
 
@@ -11,6 +11,9 @@
 #include <noir/consensus/store/store_test.h>
 #include <noir/consensus/types/event_bus.h>
 #include <noir/consensus/types/events.h>
+#include <noir/metrics/metrics.h>
+
+#include <boost/asio/steady_timer.hpp>
 
 namespace noir::consensus {
 
@@ -30,6 +33,11 @@ struct consensus_reactor {
   std::optional<named_thread_pool> thread_pool_gossip;
   std::optional<named_thread_pool> thread_pool_query_maj23;
 
+  // votes received but not announced to peers yet, by height, round and type
+  std::mutex has_votes_mtx;
+  std::map<std::tuple<int64_t, int32_t, p2p::signed_msg_type>, std::vector<int32_t>> pending_has_votes;
+  std::unique_ptr<boost::asio::steady_timer> has_votes_timer;
+
   // Receive an event from consensus_state
   plugin_interface::egress::channels::event_switch_message_queue::channel_type::handle event_switch_mq_subscription =
     app.get_channel<plugin_interface::egress::channels::event_switch_message_queue>().subscribe(
@@ -41,8 +49,8 @@ struct consensus_reactor {
       std::bind(&consensus_reactor::process_peer_update, this, std::placeholders::_1));
 
   // Receive an envelope from peers [via p2p]
-  plugin_interface::incoming::channels::cs_reactor_message_queue::channel_type::handle cs_reactor_mq_subscription =
-    app.get_channel<plugin_interface::incoming::channels::cs_reactor_message_queue>().subscribe(
+  plugin_interface::incoming::methods::cs_reactor_message::method_type::handle cs_reactor_msg_provider =
+    app.get_method<plugin_interface::incoming::methods::cs_reactor_message>().register_provider(
       std::bind(&consensus_reactor::process_peer_msg, this, std::placeholders::_1));
 
   // Send an envelope to peers [via p2p]
@@ -63,6 +71,7 @@ struct consensus_reactor {
       xmt_mq_channel(app.get_channel<plugin_interface::egress::channels::transmit_message_queue>()) {
     thread_pool_gossip.emplace("gossip", thread_pool_size);
     thread_pool_query_maj23.emplace("query_maj23", thread_pool_size);
+    has_votes_timer = std::make_unique<boost::asio::steady_timer>(thread_pool_gossip->get_executor());
   }
 
   static std::shared_ptr<consensus_reactor> new_consensus_reactor(appbase::application& app,
@@ -84,6 +93,10 @@ struct consensus_reactor {
       if (peer.second->is_running)
         peer.second->is_running = false;
     }
+    {
+      std::scoped_lock g(has_votes_mtx);
+      has_votes_timer->cancel();
+    }
     thread_pool_gossip->stop();
     thread_pool_query_maj23->stop();
     cs_state->on_stop();
@@ -135,17 +148,18 @@ struct consensus_reactor {
 
   void gossip_data_routine(std::shared_ptr<peer_state> ps);
 
-  void gossip_data_for_catchup(const std::shared_ptr<round_state>& rs,
+  void gossip_data_for_catchup(const std::shared_ptr<const round_state>& rs,
     const std::shared_ptr<peer_round_state>& prs,
     const std::shared_ptr<peer_state>& ps);
 
   void gossip_votes_routine(std::shared_ptr<peer_state> ps);
 
-  bool gossip_votes_for_height(const std::shared_ptr<round_state>& rs,
+  bool gossip_votes_for_height(const std::shared_ptr<const round_state>& rs,
     const std::shared_ptr<peer_round_state>& prs,
     const std::shared_ptr<peer_state>& ps);
 
-  bool pick_send_vote(const std::shared_ptr<peer_state>& ps, const vote_set_reader& votes_);
+  /// \brief sends votes the peer is missing, in messages of up to vote_batch_bytes
+  bool pick_send_votes(const std::shared_ptr<peer_state>& ps, const vote_set_reader& votes_);
 
   void query_maj23_routine(std::shared_ptr<peer_state> ps);
 
@@ -168,10 +182,20 @@ struct consensus_reactor {
   }
 
   void broadcast_has_vote_message(const p2p::vote_message& vote_) {
+    if (cs_state->cs_config.has_votes_interval.count() > 0) {
+      add_pending_has_vote(vote_);
+      return;
+    }
     auto msg = p2p::has_vote_message{vote_.height, vote_.round, vote_.type, vote_.validator_index};
     transmit_new_envelope("", "", msg, true);
   }
 
+  /// \brief queues vote_ to be announced in a has_votes_message, within has_votes_interval
+  void add_pending_has_vote(const p2p::vote_message& vote_);
+
+  /// \brief broadcasts a has_votes_message for each height, round and type of votes queued
+  void broadcast_has_votes_messages();
+
   p2p::new_round_step_message make_round_step_message(const round_state& rs) {
     return p2p::new_round_step_message{
       rs.height, rs.round, rs.step, rs.start_time /* TODO: find elapsed seconds*/, rs.last_commit->round};
@@ -186,4 +210,7 @@ struct consensus_reactor {
     int priority = appbase::priority::medium);
 };
 
+/// \brief consensus messages handed to p2p of the given type, e.g. vote; a broadcast counts once
+metrics::counter consensus_messages_sent(const std::string& type);
+
 } // namespace noir::consensus
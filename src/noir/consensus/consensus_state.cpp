@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 #include <noir/common/helper/go.h>
+#include <noir/common/trace.h>
 #include <noir/consensus/consensus_state.h>
 #include <noir/consensus/types/proposal.h>
 #include <noir/core/codec.h>
@@ -18,20 +19,31 @@ namespace fs = std::filesystem;
 using p2p::round_step_to_str;
 using p2p::round_step_type;
 
+/// holds mtx while a message or timeout is handled, and publishes the resulting round state before releasing it
+struct snapshot_lock {
+  consensus_state& cs;
+  std::scoped_lock<std::mutex> g;
+
+  explicit snapshot_lock(consensus_state& cs_): cs(cs_), g(cs_.mtx) {}
+  ~snapshot_lock() {
+    cs.publish_snapshots();
+  }
+};
+
 struct message_handler {
   std::shared_ptr<consensus_state> cs;
 
   explicit message_handler(std::shared_ptr<consensus_state> cs_): cs(std::move(cs_)) {}
 
   void operator()(p2p::proposal_message& msg) {
-    std::scoped_lock g(cs->mtx);
+    snapshot_lock g(*cs);
     // will not cause transition.
     // once proposal is set, we can receive block parts
     cs->set_proposal(msg);
   }
 
   void operator()(p2p::block_part_message& msg) {
-    std::scoped_lock g(cs->mtx);
+    snapshot_lock g(*cs);
     // if the proposal is complete, we'll enter_prevote or try_finalize_commit
     auto added = cs->add_proposal_block_part(msg, node_id{});
     if (msg.round != cs->rs.round) {
@@ -41,7 +53,7 @@ struct message_handler {
   }
 
   void operator()(p2p::vote_message& msg) {
-    std::scoped_lock g(cs->mtx);
+    snapshot_lock g(*cs);
     // attempt to add the vote and dupeout the validator if its a duplicate signature
     // if the vote gives us a 2/3-any or 2/3-one, we transition
     cs->try_add_vote(msg, node_id{});
@@ -94,21 +106,23 @@ std::shared_ptr<consensus_state> consensus_state::new_state(appbase::application
   return consensus_state_;
 }
 
-state consensus_state::get_state() {
-  std::scoped_lock g(mtx);
-  return local_state;
+std::shared_ptr<const state> consensus_state::get_state() const {
+  return std::atomic_load(&state_snapshot);
 }
 
-int64_t consensus_state::get_last_height() {
-  std::scoped_lock g(mtx);
-  return rs.height - 1;
+int64_t consensus_state::get_last_height() const {
+  return get_round_state()->height - 1;
 }
 
-std::shared_ptr<round_state> consensus_state::get_round_state() {
-  std::scoped_lock g(mtx);
-  auto rs_copy = std::make_shared<round_state>();
-  *rs_copy = rs;
-  return rs_copy;
+std::shared_ptr<const round_state> consensus_state::get_round_state() const {
+  return std::atomic_load(&rs_snapshot);
+}
+
+void consensus_state::publish_snapshots(bool state_changed) {
+  // copies are shallow but for local_state, which only changes once a height
+  if (state_changed || !state_snapshot)
+    std::atomic_store(&state_snapshot, std::make_shared<const state>(local_state));
+  std::atomic_store(&rs_snapshot, std::make_shared<const round_state>(rs));
 }
 
 void consensus_state::set_priv_validator(const std::shared_ptr<priv_validator>& priv) {
@@ -379,6 +393,7 @@ void consensus_state::update_to_state(state& state_) {
   rs.triggered_timeout_precommit = false;
 
   local_state = state_;
+  publish_snapshots(true);
 
   // Finally, broadcast RoundState
   new_step();
@@ -390,6 +405,7 @@ void consensus_state::new_step() {
     elog("failed writing to WAL");
   }
   n_steps++;
+  publish_snapshots();
 
   // newStep is called by updateToState in NewState before the eventBus is set!
   event_bus_->publish_event_new_round_step(event);
@@ -467,7 +483,7 @@ void consensus_state::tock(timeout_info_ptr ti) {
 }
 
 void consensus_state::handle_timeout(timeout_info_ptr ti) {
-  std::scoped_lock g(mtx);
+  snapshot_lock g(*this);
   dlog(fmt::format("Received tock: hrs={}/{}/{}, timeout={}", ti->height, ti->round, round_step_to_str(ti->step),
     ti->duration_.count()));
 
@@ -858,7 +874,8 @@ void consensus_state::enter_precommit(int64_t height, int32_t round) {
 
   if (!rs.proposal_block_parts->has_header(block_id_->parts)) {
     rs.proposal_block = {};
-    rs.proposal_block_parts = part_set::new_part_set_from_header(block_id_->parts);
+    rs.proposal_block_parts =
+      part_set::new_part_set_from_header(block_id_->parts, local_state.consensus_params_.block.part_parity_percent);
   }
 
   // publish event unlock
@@ -930,7 +947,8 @@ void consensus_state::enter_commit(int64_t height, int32_t round) {
       // We're getting the wrong block.
       // Set up ProposalBlockParts and keep waiting.
       rs.proposal_block = {};
-      rs.proposal_block_parts = part_set::new_part_set_from_header(block_id_->parts);
+      rs.proposal_block_parts =
+        part_set::new_part_set_from_header(block_id_->parts, local_state.consensus_params_.block.part_parity_percent);
 
       event_bus_->publish_event_valid_block(events::event_data_round_state{rs});
       event_switch_mq_channel.publish(appbase::priority::medium,
@@ -957,6 +975,7 @@ void consensus_state::try_finalize_commit(int64_t height) {
 }
 
 void consensus_state::finalize_commit(int64_t height) {
+  trace::span span("finalize_commit");
   if (rs.height != height || rs.step != round_step_type::Commit) {
     dlog(fmt::format(
       "entering finalize commit step with invalid args: {}/{}/{}", rs.height, rs.round, round_step_to_str(rs.step)));
@@ -1055,7 +1074,8 @@ void consensus_state::set_proposal(p2p::proposal_message& msg) {
   // We don't update cs.ProposalBlockParts if it is already set.
   // This happens if we're already in cstypes.RoundStepCommit or if there is a valid block in the current round.
   if (!rs.proposal_block_parts) {
-    rs.proposal_block_parts = part_set::new_part_set_from_header(msg.block_id_.parts);
+    rs.proposal_block_parts =
+      part_set::new_part_set_from_header(msg.block_id_.parts, local_state.consensus_params_.block.part_parity_percent);
   }
 
   ilog(fmt::format("received proposal; {}", msg.type));
@@ -1085,6 +1105,13 @@ bool consensus_state::add_proposal_block_part(p2p::block_part_message& msg, node
   }
 
   auto added = rs.proposal_block_parts->add_part(part_);
+  if (added && rs.proposal_block_parts->invalid) {
+    elog(fmt::format("received invalid proposal block parts: height={} round={}", height_, round_));
+    // the proposal never completes, so prevote nil rather than waiting for the propose timeout
+    if (rs.step <= round_step_type::Propose)
+      enter_prevote(height_, rs.round);
+    return added;
+  }
 
   if (rs.proposal_block_parts->byte_size > local_state.consensus_params_.block.max_bytes) {
     elog(fmt::format("total size of proposal block parts exceeds maximum block Bytes ({} > {})",
@@ -1256,7 +1283,8 @@ std::pair<bool, Error> consensus_state::add_vote(const std::shared_ptr<vote>& vo
         }
 
         if (!rs.proposal_block_parts->has_header(block_id_->parts)) {
-          rs.proposal_block_parts = part_set::new_part_set_from_header(block_id_->parts);
+          rs.proposal_block_parts = part_set::new_part_set_from_header(
+            block_id_->parts, local_state.consensus_params_.block.part_parity_percent);
         }
 
         event_switch_mq_channel.publish(appbase::priority::medium,
@@ -37,9 +37,12 @@ struct consensus_state : public std::enable_shared_from_this<consensus_state> {
     const std::shared_ptr<ev::evidence_pool>& new_ev_pool,
     const std::shared_ptr<events::event_bus>& event_bus_);
 
-  state get_state();
-  int64_t get_last_height();
-  std::shared_ptr<round_state> get_round_state();
+  /// \brief snapshot of the state until height-1, published on each height; never blocks on mtx
+  std::shared_ptr<const state> get_state() const;
+  int64_t get_last_height() const;
+  /// \brief snapshot of the round state, published on each transition; never blocks on mtx
+  /// Fields shared with the state machine, e.g. votes and proposal_block_parts, are still updated in place.
+  std::shared_ptr<const round_state> get_round_state() const;
   void set_priv_validator(const std::shared_ptr<priv_validator>& priv);
   void update_priv_validator_pub_key();
   void reconstruct_last_commit(state& state_);
@@ -56,6 +59,8 @@ struct consensus_state : public std::enable_shared_from_this<consensus_state> {
   void schedule_round_0(round_state& rs_);
   void update_to_state(state& state_);
   void new_step();
+  /// \brief publishes rs, and local_state if state_changed, as snapshots for readers; must be called with mtx held
+  void publish_snapshots(bool state_changed = false);
 
   void receive_routine(p2p::internal_msg_info_ptr mi);
   void handle_msg();
@@ -118,6 +123,9 @@ struct consensus_state : public std::enable_shared_from_this<consensus_state> {
   std::mutex mtx;
   round_state rs{};
   state local_state; // State until height-1.
+  // immutable copies of rs and local_state, swapped by publish_snapshots so that readers never take mtx
+  std::shared_ptr<const round_state> rs_snapshot;
+  std::shared_ptr<const state> state_snapshot;
   pub_key local_priv_validator_pub_key;
 
   ///< no need for peer_mq; we have one at consensus_reactor which handles all messages from peers
@@ -201,6 +209,11 @@ struct handshaker {
 
   int n_blocks{};
 
+  /// \brief number of blocks loaded from block_store ahead of the one being executed during replay
+  static constexpr size_t replay_prefetch_depth = 64;
+  /// \brief number of replayed blocks between progress checkpoints
+  static constexpr int64_t replay_checkpoint_interval = 1000;
+
   static std::shared_ptr<handshaker> new_handshaker(const std::shared_ptr<block_store>& b_store_,
     state& i_state,
     const std::shared_ptr<noir::consensus::db_store>& s_store,
@@ -236,7 +249,8 @@ struct handshaker {
         initial_state.version.cs.app = res->app_version();
 
       // Replay blocks up to latest in block_store
-      replay_blocks(initial_state, from_hex(app_hash), block_height, proxy_app);
+      if (auto ok = replay_blocks(initial_state, from_hex(app_hash), block_height, proxy_app); !ok)
+        return ok.error();
 
       ilog(fmt::format(
         "Completed ABCI Handshake - Tendermint and App are synced: app_height={} app_hash={}", block_height, app_hash));
@@ -267,7 +281,8 @@ struct handshaker {
       auto pb_vals = req.mutable_validators();
       for (auto& val : next_vals)
         *req.mutable_validators()->Add() = val;
-      req.set_app_state_bytes({gen_doc->app_state.begin(), gen_doc->app_state.end()});
+      auto app_state = gen_doc->get_app_state();
+      req.set_app_state_bytes(app_state.data(), app_state.size());
 
       auto res = proxy_app->application->init_chain(req);
       if (!res)
@@ -310,7 +325,8 @@ struct handshaker {
 
     if (store_block_height == state_block_height) {
       if (app_block_height < store_block_height) {
-        // return replay_blocks_internal(); // TODO : implement
+        // the app is behind, so replay blocks, but no need to go through WAL (state is already synced to store)
+        return replay_blocks_internal(state_, app_hash, proxy_app, app_block_height, store_block_height);
       } else if (app_block_height == store_block_height) {
         return app_hash;
       }
@@ -318,6 +334,21 @@ struct handshaker {
 
     return app_hash; // TODO : remove this and continue implementation
   }
+
+  /// \brief replays blocks (app_block_height, store_block_height] from block_store against the app.
+  /// Blocks are loaded and decoded by a background reader while the app executes the previous ones. Each Commit is a
+  /// checkpoint of the app, so an interrupted replay resumes from the app's last height on the next handshake.
+  /// \param[in] state_ state synced to block_store
+  /// \param[in] app_hash_ app hash reported by the app, checked against the first replayed block if not empty
+  /// \param[in] proxy_app connection to the app
+  /// \param[in] app_block_height last height committed by the app
+  /// \param[in] store_block_height last height in block_store
+  /// \return app hash after replaying the final block
+  Result<Bytes> replay_blocks_internal(state& state_,
+    const Bytes& app_hash_,
+    const std::shared_ptr<app_connection>& proxy_app,
+    int64_t app_block_height,
+    int64_t store_block_height);
 };
 
 /// \brief repair wal file until first error is encountered
@@ -9,6 +9,7 @@
 namespace noir::consensus::ev {
 
 void evidence_pool::mark_evidence_as_committed(const evidence_list& evs, int64_t height) {
+  noir::db::perf_scope perf("evidence_pool::mark_evidence_as_committed");
   std::set<std::string> block_evidence_map;
   std::vector<Bytes> batch_delete;
 
@@ -11,6 +11,7 @@
 #include <noir/consensus/store/block_store.h>
 #include <noir/consensus/store/state_store.h>
 #include <noir/consensus/types/evidence.h>
+#include <noir/db/rocks_metrics.h>
 #include <noir/db/rocks_session.h>
 #include <noir/db/session.h>
 
@@ -176,6 +177,7 @@ struct evidence_pool {
   }
 
   Result<void> add_pending_evidence(std::shared_ptr<evidence> ev) {
+    noir::db::perf_scope perf("evidence_pool::add_pending_evidence");
     auto evpb = evidence::to_proto(*ev);
     if (!evpb)
       return evpb.error();
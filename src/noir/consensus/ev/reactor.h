@@ -22,8 +22,8 @@ struct reactor {
   eo::sync::WaitGroup peer_wg;
 
   // Receive an envelope from peers [via p2p]
-  plugin_interface::incoming::channels::es_reactor_message_queue::channel_type::handle es_reactor_mq_subscription =
-    app.get_channel<plugin_interface::incoming::channels::es_reactor_message_queue>().subscribe(
+  plugin_interface::incoming::methods::es_reactor_message::method_type::handle es_reactor_msg_provider =
+    app.get_method<plugin_interface::incoming::methods::es_reactor_message>().register_provider(
       std::bind(&reactor::process_peer_msg, this, std::placeholders::_1));
 
   // Receive peer_status update from p2p
@@ -0,0 +1,34 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/consensus/tx.h>
+#include <noir/consensus/tx_schedule.h>
+#include <noir/core/result.h>
+#include <tendermint/abci/types.pb.h>
+
+namespace noir::consensus {
+
+/// \brief mempool as seen by block_executor, which fills proposals from it and drops txs once they are committed
+struct mempool_interface {
+  virtual ~mempool_interface() = default;
+
+  /// \brief returns txs in the order they should be proposed, limited by the total protobuf size and gas of a block
+  /// \param max_bytes max size of txs, unlimited if negative
+  /// \param max_gas max gas of txs, unlimited if negative
+  virtual std::vector<tx> reap_max_bytes_max_gas(int64_t max_bytes, int64_t max_gas) = 0;
+
+  /// \brief returns keys declared by CheckTx of txs, in the same order, or empty if the mempool doesn't keep them
+  virtual std::vector<tx_access> tx_accesses(const std::vector<tx>& txs) {
+    return {};
+  }
+
+  /// \brief removes txs committed in a block of block_height
+  virtual Result<void> update(int64_t block_height,
+    const std::vector<tx>& block_txs,
+    const google::protobuf::RepeatedPtrField<tendermint::abci::ResponseDeliverTx>& deliver_tx_responses) = 0;
+};
+
+} // namespace noir::consensus
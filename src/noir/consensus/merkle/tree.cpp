@@ -87,4 +87,28 @@ Bytes compute_hash_from_aunts(int64_t index, int64_t total, Bytes leaf_hash, byt
   return inner_hash_opt(inner_hashes[inner_hashes.size() - 1], right_hash);
 }
 
+digest leaf_hash(crypto::Sha256& sha, std::span<const unsigned char> leaf) {
+  const unsigned char prefix = leaf_prefix;
+  digest out;
+  sha.init().update({&prefix, 1}).update(leaf).final(std::span<unsigned char>(out));
+  return out;
+}
+
+digest hash_from_leaf_hashes(crypto::Sha256& sha, std::span<const digest> leaves) {
+  digest out;
+  switch (leaves.size()) {
+  case 0:
+    sha.init().final(std::span<unsigned char>(out));
+    return out;
+  case 1:
+    return leaves[0];
+  }
+  auto k = get_split_point(leaves.size());
+  auto left = hash_from_leaf_hashes(sha, leaves.first(k));
+  auto right = hash_from_leaf_hashes(sha, leaves.subspan(k));
+  const unsigned char prefix = inner_prefix;
+  sha.init().update({&prefix, 1}).update(left).update(right).final(std::span<unsigned char>(out));
+  return out;
+}
+
 } // namespace noir::consensus::merkle
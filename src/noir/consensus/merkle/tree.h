@@ -9,6 +9,7 @@
 #include <noir/common/hex.h>
 #include <noir/crypto/hash.h>
 
+#include <array>
 #include <bit>
 
 namespace noir::consensus::merkle {
@@ -27,4 +28,13 @@ Bytes hash_from_bytes_list(const bytes_list& list);
 
 Bytes compute_hash_from_aunts(int64_t index, int64_t total, Bytes leaf_hash, bytes_list inner_hashes);
 
+/// \brief fixed size hash used by the allocation free functions below
+using digest = std::array<unsigned char, 32>;
+
+/// \brief same as leaf_hash_opt, but hashes into a digest with the given hasher
+digest leaf_hash(crypto::Sha256& sha, std::span<const unsigned char> leaf);
+
+/// \brief same as hash_from_bytes_list, but over already computed leaf hashes
+digest hash_from_leaf_hashes(crypto::Sha256& sha, std::span<const digest> leaves);
+
 } // namespace noir::consensus::merkle
@@ -85,16 +85,26 @@ std::unique_ptr<node> node::make_node(appbase::application& app,
 
   // Create handshaker
   auto handshaker_ = handshaker::new_handshaker(bls, state_, dbs, event_bus_, new_genesis_doc);
-  handshaker_->handshake(proxy_app);
+  if (auto ok = handshaker_->handshake(proxy_app); !ok)
+    check(false, fmt::format("unable to start node: handshake failed: {}", ok.error().message()));
 
   log_node_startup_info(state_, pub_key_, new_config->base.mode);
 
+  // the app has caught up with the block store through the handshake
+  auto query_conn = proxy_app->new_query_connection(new_config->base.query_conns);
+  query_conn->set_height(bls->height());
+  query_conn->subscribe(*event_bus_);
+
   auto ok_ev_reactor = create_evidence_reactor(app, new_config, session, bls);
   if (!ok_ev_reactor)
     check(false, fmt::format("unable to start node: {}", ok_ev_reactor.error().message()));
   auto [new_ev_reactor, new_ev_pool] = ok_ev_reactor.value();
 
   auto block_exec = block_executor::new_block_executor(dbs, proxy_app, new_ev_pool, bls, ev_bus);
+  if (auto target = new_config->consensus.target_block_exec_time; target.count() > 0)
+    block_exec->set_block_budget(
+      std::make_shared<block_budget>(std::chrono::duration_cast<std::chrono::microseconds>(target)));
+  block_exec->set_validation_threads(new_config->consensus.block_validation_threads);
 
   auto [new_cs_reactor, new_cs_state] = create_consensus_reactor(app, new_config, std::make_shared<state>(state_),
     block_exec, bls, new_ev_pool, new_priv_validator, event_bus_, block_sync);
@@ -110,11 +120,13 @@ std::unique_ptr<node> node::make_node(appbase::application& app,
   node_->genesis_doc_ = new_genesis_doc;
   node_->priv_validator_ = new_priv_validator;
   node_->node_key_ = new_node_key;
+  node_->db_session_ = session;
   node_->store_ = dbs;
   node_->block_store_ = bls;
   node_->event_bus_ = event_bus_;
   node_->event_sink_ = event_sinks_.value();
   node_->indexer_service_ = indexer_service_;
+  node_->query_conn_ = query_conn;
   node_->state_sync_on = new_state_sync_on;
   node_->bs_reactor = new_bs_reactor;
   node_->cs_reactor = new_cs_reactor;
@@ -32,11 +32,13 @@ struct node {
   std::shared_ptr<node_key> node_key_{};
   bool is_listening{};
 
+  std::shared_ptr<noir::db::session::session<noir::db::session::rocksdb_t>> db_session_{};
   std::shared_ptr<db_store> store_{};
   std::shared_ptr<block_store> block_store_{};
   std::shared_ptr<events::event_bus> event_bus_{};
   std::shared_ptr<indexer::event_sink> event_sink_{};
   std::shared_ptr<indexer::indexer_service> indexer_service_{};
+  std::shared_ptr<query_connection> query_conn_{};
   bool state_sync_on{};
 
   std::shared_ptr<consensus_reactor> cs_reactor{};
@@ -116,6 +116,14 @@ struct peer_state {
     set_has_vote_(msg.height, msg.round, msg.type, msg.index);
   }
 
+  void apply_has_votes_message(const p2p::has_votes_message& msg) {
+    std::scoped_lock g(mtx);
+    if (prs.height != msg.height || !msg.votes)
+      return;
+    for (auto index : msg.votes->get_true_indices())
+      set_has_vote_(msg.height, msg.round, msg.type, index);
+  }
+
   void apply_vote_set_bits_message(const p2p::vote_set_bits_message& msg, std::shared_ptr<bit_array> our_votes) {
     std::scoped_lock g(mtx);
     auto votes = get_vote_bit_array(msg.height, msg.round, msg.type);
@@ -275,11 +283,12 @@ public:
       prs.catchup_commit = bit_array::new_bit_array(num_validators);
   }
 
-  std::tuple<std::shared_ptr<vote>, bool> pick_vote_to_send(vote_set_reader& votes) {
+  /// \brief picks votes the peer doesn't have, in the order of validator indices
+  std::vector<std::shared_ptr<vote>> pick_votes_to_send(vote_set_reader& votes) {
     std::scoped_lock g(mtx);
 
     if (votes.size == 0)
-      return {nullptr, false};
+      return {};
 
     auto height = votes.height;
     auto round = votes.round;
@@ -294,15 +303,14 @@ public:
 
     auto ps_votes = get_vote_bit_array(height, round, votes_type);
     if (!ps_votes)
-      return {nullptr, false};
+      return {};
 
-    if (auto [index, ok] = votes.bit_array_->sub(ps_votes)->pick_random(); ok) {
-      if (!votes.get_by_index(index))
-        return {nullptr, false};
-      return {votes.get_by_index(index), true};
+    std::vector<std::shared_ptr<vote>> ret;
+    for (auto index : votes.bit_array_->sub(ps_votes)->get_true_indices()) {
+      if (auto vote_ = votes.get_by_index(index); vote_)
+        ret.push_back(vote_);
     }
-
-    return {nullptr, false};
+    return ret;
   }
 };
 
@@ -0,0 +1,93 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <noir/common/check.h>
+#include <noir/common/log.h>
+#include <noir/consensus/app_connection.h>
+#include <noir/consensus/query_connection.h>
+#include <fmt/core.h>
+
+namespace noir::consensus {
+
+query_connection::query_connection(
+  std::vector<std::shared_ptr<application::base_application>> conns, int64_t cached_heights)
+  : num_conns(conns.size()), cached_heights(cached_heights), idle_conns(std::move(conns)) {
+  check(num_conns > 0, "query_connection requires at least one connection");
+}
+
+Result<query_connection::response_ptr> query_connection::query(const tendermint::abci::RequestQuery& req) {
+  auto versioned = req;
+  if (!versioned.height())
+    versioned.set_height(latest);
+  auto height = versioned.height();
+
+  // the path is length prefixed, so that keys of different requests never collide
+  auto key = fmt::format("{}\n{}\n{}", req.path().size(), req.path(), req.prove()) + req.data();
+  std::promise<Result<response_ptr>> promise;
+  {
+    std::unique_lock g{cache_mtx};
+    // responses of heights not yet committed or already dropped are neither cached nor coalesced
+    if (height > latest || height <= latest - cached_heights) {
+      g.unlock();
+      return run(versioned);
+    }
+    auto& responses = cache[height];
+    if (auto it = responses.find(key); it != responses.end()) {
+      auto f = it->second;
+      g.unlock();
+      return f.get();
+    }
+    responses.emplace(key, promise.get_future().share());
+  }
+
+  auto res = run(versioned);
+  // errors are not cached, so that the next query retries, nor are responses at another height, as apps answer at
+  // their current state, which runs ahead of the latest height between commit and NewBlock
+  if (!res || res.value()->height() != height) {
+    std::scoped_lock g{cache_mtx};
+    if (auto it = cache.find(height); it != cache.end())
+      it->second.erase(key);
+  }
+  promise.set_value(res);
+  return res;
+}
+
+void query_connection::set_height(int64_t height) {
+  std::scoped_lock g{cache_mtx};
+  if (height <= latest)
+    return;
+  latest = height;
+  cache.erase(cache.begin(), cache.upper_bound(height - cached_heights));
+}
+
+Result<query_connection::response_ptr> query_connection::run(const tendermint::abci::RequestQuery& req) {
+  std::shared_ptr<application::base_application> conn;
+  {
+    std::unique_lock g{conns_mtx};
+    conns_cv.wait(g, [&]() { return !idle_conns.empty(); });
+    conn = std::move(idle_conns.back());
+    idle_conns.pop_back();
+  }
+  std::unique_ptr<tendermint::abci::ResponseQuery> res;
+  try {
+    static auto call_duration = abci_call_duration("query");
+    auto t = call_duration.time();
+    res = conn->query_sync(req);
+  } catch (const std::exception& e) {
+    res.reset();
+    elog(fmt::format("query {} failed: {}", req.path(), e.what()));
+  }
+  {
+    std::scoped_lock g{conns_mtx};
+    idle_conns.push_back(std::move(conn));
+  }
+  conns_cv.notify_one();
+
+  if (!res)
+    return Error::format("unable to query {} at height {}", req.path(), req.height());
+  return response_ptr(std::move(res));
+}
+
+} // namespace noir::consensus
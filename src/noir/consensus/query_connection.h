@@ -0,0 +1,68 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/application/app.h>
+#include <noir/consensus/types/event_bus.h>
+#include <noir/core/result.h>
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace noir::consensus {
+
+/// \brief pool of app connections serving read-only abci queries, apart from the connection used by consensus
+/// Responses are cached per height for the last cached_heights committed heights, and identical queries in flight at
+/// the same height are coalesced, so that the app serves each of them once. A query at height 0 is run at the latest
+/// committed height, which follows NewBlock events once subscribed. Responses answered at another height than
+/// requested are not cached.
+class query_connection {
+public:
+  using response_ptr = std::shared_ptr<const tendermint::abci::ResponseQuery>;
+
+  explicit query_connection(
+    std::vector<std::shared_ptr<application::base_application>> conns, int64_t cached_heights = 2);
+
+  Result<response_ptr> query(const tendermint::abci::RequestQuery& req);
+
+  /// \brief makes height the latest committed one, dropping cached responses of heights no longer kept
+  void set_height(int64_t height);
+
+  int64_t height() const {
+    return latest;
+  }
+
+  size_t num_connections() const {
+    return num_conns;
+  }
+
+  void subscribe(events::event_bus& bus) {
+    subscription = bus.subscribe("query_connection", [this](const events::message& msg) {
+      if (auto data = std::get_if<events::event_data_new_block>(&msg.data))
+        set_height(data->block.header.height);
+    });
+  }
+
+private:
+  Result<response_ptr> run(const tendermint::abci::RequestQuery& req);
+
+  const size_t num_conns;
+  const int64_t cached_heights;
+  std::atomic<int64_t> latest{0};
+
+  std::mutex conns_mtx;
+  std::condition_variable conns_cv;
+  std::vector<std::shared_ptr<application::base_application>> idle_conns;
+
+  std::mutex cache_mtx;
+  std::map<int64_t, std::unordered_map<std::string, std::shared_future<Result<response_ptr>>>> cache;
+
+  events::event_bus::subscription subscription;
+};
+
+} // namespace noir::consensus
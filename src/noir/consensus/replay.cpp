@@ -4,10 +4,13 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 #include <noir/common/helper/go.h>
+#include <noir/common/thread_pool.h>
 #include <noir/consensus/consensus_state.h>
 #include <noir/consensus/wal.h>
 #include <fmt/core.h>
 
+#include <deque>
+
 namespace noir::consensus {
 using namespace noir::p2p;
 
@@ -154,4 +157,79 @@ bool consensus_state::read_replay_message(const timed_wal_message& msg) {
   return std::visit(wal_replay_handler{shared_from_this()}, msg.msg.msg);
 }
 
+//---------------------------------------------------
+// 2. Recover from failure while applying the block.
+// (by handshaking with the app to figure out where
+//  we were last, and using the WAL to recover there)
+//---------------------------------------------------
+
+Result<Bytes> handshaker::replay_blocks_internal(state& state_,
+  const Bytes& app_hash_,
+  const std::shared_ptr<app_connection>& proxy_app,
+  int64_t app_block_height,
+  int64_t store_block_height) {
+  auto first_block = app_block_height + 1;
+  if (first_block == 1)
+    first_block = state_.initial_height;
+  auto final_block = store_block_height;
+
+  // Blocks in block_store are already committed, so the executor is used only to drive the app
+  auto block_exec = block_executor::new_block_executor(state_store, proxy_app, nullptr, block_store_, event_bus_);
+
+  // Loading a block means reading all of its parts and decoding them, which is as expensive as executing it on a
+  // fast app. A background reader keeps a window of decoded blocks ahead of the one being executed.
+  named_thread_pool reader("replay", 1);
+  std::deque<std::future<std::shared_ptr<block>>> prefetched;
+  auto next_height = first_block;
+  auto prefetch = [&]() {
+    while (next_height <= final_block && prefetched.size() < replay_prefetch_depth) {
+      prefetched.push_back(async_thread_pool(reader.get_executor(), [this, height = next_height]() {
+        auto block_ = std::make_shared<block>();
+        if (!block_store_->load_block(height, *block_))
+          return std::shared_ptr<block>{};
+        block_->get_hash(); // fills data/evidence/last_commit hashes off the execution path
+        return block_;
+      }));
+      ++next_height;
+    }
+  };
+
+  ilog(fmt::format("Applying blocks to catch up app: from={} to={}", first_block, final_block));
+  auto start_time = get_time();
+  auto checkpoint_time = start_time;
+  auto app_hash = app_hash_;
+  for (auto height = first_block; height <= final_block; ++height) {
+    prefetch();
+    auto block_ = prefetched.front().get();
+    prefetched.pop_front();
+    if (!block_)
+      return Error::format("replay_blocks failed: unable to load block at height={}", height);
+
+    // Extra check to ensure the app was not changed in a way it shouldn't have.
+    if (!app_hash.empty() && block_->header.app_hash != app_hash)
+      return Error::format("app_hash mismatch at height={}: expected={} got={}", height,
+        hex::encode(block_->header.app_hash), hex::encode(app_hash));
+
+    auto ok = block_exec->exec_commit_block(block_, state_.initial_height);
+    if (!ok)
+      return ok.error();
+    app_hash = ok.value();
+    n_blocks++;
+
+    if ((height - first_block + 1) % replay_checkpoint_interval == 0) {
+      auto now = get_time();
+      ilog(fmt::format("Replay checkpoint: height={} remaining={} blocks_per_sec={:.1f}", height, final_block - height,
+        replay_checkpoint_interval * 1'000'000.0 / std::max<int64_t>(now - checkpoint_time, 1)));
+      checkpoint_time = now;
+    }
+  }
+
+  if (app_hash != state_.app_hash)
+    return Error::format(
+      "app_hash mismatch after replay: state={} app={}", hex::encode(state_.app_hash), hex::encode(app_hash));
+
+  ilog(fmt::format("Replayed blocks: n_blocks={} elapsed_ms={}", n_blocks, (get_time() - start_time) / 1000));
+  return app_hash;
+}
+
 } // namespace noir::consensus
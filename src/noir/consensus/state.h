@@ -89,9 +89,11 @@ struct state {
     std::vector<Bytes>& txs,
     const std::shared_ptr<commit>& commit_,
     const std::shared_ptr<evidence_list>& evs,
-    Bytes proposal_address) {
+    Bytes proposal_address,
+    std::vector<uint32_t> tx_groups = {}) {
     // Build base block
     auto block_ = block::make_block(height, txs, commit_, evs);
+    block_->data.tx_groups = std::move(tx_groups);
 
     // Set time
     tstamp timestamp;
@@ -106,7 +108,7 @@ struct state {
       next_validators->get_hash(), consensus_params_.hash_consensus_params(), app_hash, last_result_hash,
       proposal_address);
 
-    return {block_, block_->make_part_set(block_part_size_bytes)};
+    return {block_, block_->make_part_set(block_part_size_bytes, consensus_params_.block.part_parity_percent)};
   }
 
   tstamp get_median_time(const std::shared_ptr<commit>& commit_, const std::shared_ptr<validator_set>& validators) {
@@ -6,11 +6,13 @@
 #pragma once
 #include <noir/common/for_each.h>
 #include <noir/common/hex.h>
+#include <noir/common/trace.h>
 #include <noir/consensus/common.h>
 #include <noir/consensus/types/block.h>
 #include <noir/consensus/types/block_meta.h>
 #include <noir/consensus/types/light_block.h>
 #include <noir/core/codec.h>
+#include <noir/db/rocks_metrics.h>
 #include <noir/db/rocks_session.h>
 #include <noir/db/session.h>
 
@@ -119,6 +121,7 @@ public:
     }
     // bl = decode<block>(data);
     // Note : data is always serialized using protobuf via block::make_part_set
+    data = part_set::unframe(std::move(data));
     ::tendermint::types::Block pb;
     pb.ParseFromArray(data.data(), data.size());
     bl = *block::from_proto(pb);
@@ -203,6 +206,8 @@ public:
   /// \param[in] seen_commit commit object
   /// \return true on success, false otherwise
   bool save_block(const block& bl, const part_set& bl_parts, const commit& seen_commit) {
+    trace::span span("save_block");
+    noir::db::perf_scope perf("block_store::save_block");
     auto height_ = bl.header.height;
     auto hash_ = const_cast<block&>(bl).get_hash();
     auto parts_ = const_cast<part_set&>(bl_parts);
@@ -11,6 +11,7 @@
 #include <noir/consensus/abci_types.h>
 #include <noir/consensus/state.h>
 #include <noir/core/codec.h>
+#include <noir/db/rocks_metrics.h>
 #include <noir/db/rocks_session.h>
 #include <noir/db/session.h>
 
@@ -140,10 +141,12 @@ public:
   // Save persists the State, the ValidatorsInfo, and the ConsensusParamsInfo to the database.
   // This flushes the writes (e.g. calls SetSync).
   bool save(const state& st) override {
+    noir::db::perf_scope perf("state_store::save");
     return save_internal(st);
   }
 
   bool save_abci_responses(int64_t height, const tendermint::state::ABCIResponses& rsp) override {
+    noir::db::perf_scope perf("state_store::save_abci_responses");
     return save_abci_responses_internal(height, rsp);
   }
 
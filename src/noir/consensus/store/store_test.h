@@ -5,6 +5,7 @@
 //
 #pragma once
 #include <noir/crypto/rand.h>
+#include <noir/db/rocks_metrics.h>
 #include <noir/db/rocks_session.h>
 #include <noir/db/session.h>
 
@@ -22,6 +23,7 @@ inline std::shared_ptr<rocksdb::DB> make_rocks_db(bool destroy = true, const std
   options.bytes_per_sync = 1048576;
   options.IncreaseParallelism();
   options.OptimizeLevelStyleCompaction(256ull << 20);
+  noir::db::enable_statistics(options);
 
   auto status = rocksdb::DB::Open(options, name.c_str(), &cache_ptr);
   cache.reset(cache_ptr);
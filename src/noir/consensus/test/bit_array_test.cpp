@@ -45,6 +45,11 @@ TEST_CASE("bit_array: Check operations", "[noir][consensus]") {
     auto bc = std::move(bb);
     CHECK(bc->size() == 10);
     CHECK(bc->get_index(4));
+    auto bd = bit_array::copy(bc);
+    bc->set_index(5, true);
+    CHECK(bd->size() == 10);
+    CHECK(bd->get_index(4));
+    CHECK(!bd->get_index(5));
   }
 
   SECTION("size_words") {
@@ -0,0 +1,62 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/consensus/block_budget.h>
+
+using namespace noir::consensus;
+using namespace std::chrono_literals;
+
+TEST_CASE("block_budget: shrink when execution nears the target", "[noir][consensus]") {
+  block_budget budget(100ms);
+  CHECK(budget.fraction() == 1);
+  CHECK(budget.scale(1000, 500).max_bytes == 1000);
+  CHECK(budget.scale(1000, 500).max_gas == 500);
+
+  // within the target, nothing changes
+  budget.on_executed(70ms);
+  CHECK(budget.fraction() == 1);
+
+  // aims the next block at 80% of the target
+  budget.on_executed(100ms);
+  CHECK(budget.fraction() == Catch::Approx(0.8));
+  CHECK(budget.scale(1000, 500).max_bytes == 800);
+  CHECK(budget.scale(1000, 500).max_gas == 400);
+
+  // halves at most at once, and never goes below the floor
+  budget.on_executed(1s);
+  CHECK(budget.fraction() == Catch::Approx(0.4));
+  for (auto i = 0; i < 10; i++)
+    budget.on_executed(1s);
+  CHECK(budget.fraction() == block_budget::min_fraction);
+
+  // unlimited limits stay unlimited, and limited ones keep at least one byte or gas
+  CHECK(budget.scale(-1, -1).max_bytes == -1);
+  CHECK(budget.scale(-1, -1).max_gas == -1);
+  CHECK(budget.scale(10, 10).max_bytes == 1);
+}
+
+TEST_CASE("block_budget: grow only while proposals fill the budget", "[noir][consensus]") {
+  block_budget budget(100ms);
+  budget.on_executed(200ms);
+  CHECK(budget.fraction() == Catch::Approx(0.5));
+
+  // headroom alone doesn't grow the budget unless there are txs to fill it
+  budget.on_proposed(100, 500);
+  budget.on_executed(10ms);
+  CHECK(budget.fraction() == Catch::Approx(0.5));
+
+  budget.on_proposed(480, 500);
+  budget.on_executed(10ms);
+  CHECK(budget.fraction() == Catch::Approx(0.625));
+
+  // some headroom, but not enough to grow
+  budget.on_executed(60ms);
+  CHECK(budget.fraction() == Catch::Approx(0.625));
+
+  for (auto i = 0; i < 10; i++)
+    budget.on_executed(10ms);
+  CHECK(budget.fraction() == 1);
+}
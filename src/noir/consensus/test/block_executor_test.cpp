@@ -57,3 +57,95 @@ TEST_CASE("block_executor: Apply block", "[noir][consensus]") {
 
   CHECK(block_exec->apply_block(state_, block_id_, block_) != std::nullopt);
 }
+
+TEST_CASE("block_executor: Validate block", "[noir][consensus]") {
+  auto local_config = config_setup();
+  std::vector<tx> txs;
+  for (auto i = 0; i < 100; i++)
+    txs.push_back(random_hash());
+  auto [state_, block_] = make_signed_block(local_config, 4, 2, txs);
+
+  auto session = make_session();
+  auto block_exec = block_executor::new_block_executor(std::make_shared<noir::consensus::db_store>(session),
+    std::make_shared<app_connection>(), std::make_shared<ev::empty_evidence_pool>(),
+    std::make_shared<noir::consensus::block_store>(session), std::make_shared<events::event_bus>(app));
+
+  auto num_threads = GENERATE(0, 4);
+  block_exec->set_validation_threads(num_threads);
+
+  auto received = [&](const std::function<void(block&)>& tamper) {
+    auto received_ = block::from_proto(*block::to_proto(*block_));
+    tamper(*received_);
+    return received_;
+  };
+
+  SECTION("valid") {
+    CHECK(!block_exec->check_block(state_, *received([](block&) {})).has_value());
+    CHECK(block_exec->validate_block(state_, block_));
+  }
+  SECTION("wrong tx") {
+    auto err = block_exec->check_block(state_, *received([](block& b) { b.data.txs[50][0] ^= 1; }));
+    CHECK(err == "wrong block_header_data_hash");
+  }
+  SECTION("wrong signature of last commit") {
+    auto err = block_exec->check_block(state_, *received([](block& b) {
+      b.last_commit->signatures[2].signature[0] ^= 1;
+      b.header.last_commit_hash = b.last_commit->get_hash();
+    }));
+    REQUIRE(err.has_value());
+    CHECK(err->starts_with("invalid last commit"));
+  }
+  SECTION("wrong app hash") {
+    auto err = block_exec->check_block(state_, *received([](block& b) { b.header.app_hash = random_hash(); }));
+    CHECK(err == "wrong block_header_app_hash");
+  }
+}
+
+TEST_CASE("block_executor: Executors share validation metrics", "[noir][consensus]") {
+  auto local_config = config_setup();
+  auto [state_, block_] = make_signed_block(local_config, 4, 2, {});
+
+  auto session = make_session();
+  auto new_block_exec = [&]() {
+    return block_executor::new_block_executor(std::make_shared<noir::consensus::db_store>(session),
+      std::make_shared<app_connection>(), std::make_shared<ev::empty_evidence_pool>(),
+      std::make_shared<noir::consensus::block_store>(session), std::make_shared<events::event_bus>(app));
+  };
+  auto block_exec = new_block_exec();
+  auto other_block_exec = new_block_exec();
+
+  auto validated = block_exec->validation_duration.count();
+  CHECK(block_exec->validate_block(state_, block_));
+  CHECK(other_block_exec->validate_block(state_, block_));
+  CHECK(block_exec->validation_duration.count() == validated + 2);
+  CHECK(other_block_exec->validation_duration.count() == validated + 2);
+}
+
+TEST_CASE("block_executor: Fail a block of which the app delivers some tx groups", "[noir][consensus]") {
+  struct grouping_app : application::base_application {
+    std::vector<std::unique_ptr<application::ResponseDeliverTx>> deliver_tx_groups(
+      const std::vector<application::RequestDeliverTx>& reqs, const std::vector<uint32_t>& group_sizes) override {
+      std::vector<std::unique_ptr<application::ResponseDeliverTx>> res;
+      for (size_t i = 0; i < reqs.size() - num_missing; i++)
+        res.push_back(std::make_unique<application::ResponseDeliverTx>());
+      return res;
+    }
+    size_t num_missing = 0;
+  };
+
+  auto local_config = config_setup();
+  auto [state_, block_] = make_signed_block(local_config, 4, 2, {random_hash(), random_hash(), random_hash()});
+  block_->data.tx_groups = {2, 1};
+
+  auto session = make_session();
+  auto grouping = std::make_shared<grouping_app>();
+  auto proxy_app = std::make_shared<app_connection>();
+  proxy_app->application = grouping;
+  auto block_exec = block_executor::new_block_executor(std::make_shared<noir::consensus::db_store>(session),
+    proxy_app, std::make_shared<ev::empty_evidence_pool>(), std::make_shared<noir::consensus::block_store>(session),
+    std::make_shared<events::event_bus>(app));
+
+  CHECK(block_exec->exec_commit_block(block_, block_->header.height));
+  grouping->num_missing = 1;
+  CHECK(!block_exec->exec_commit_block(block_, block_->header.height));
+}
@@ -0,0 +1,185 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/consensus/common_test.h>
+#include <noir/consensus/consensus_reactor.h>
+#include <noir/consensus/types/wire.h>
+
+using namespace noir;
+using namespace noir::consensus;
+
+namespace {
+
+constexpr int64_t test_height = 5;
+constexpr int test_num_vals = 7;
+
+/// \brief precommits of test_num_vals validators at test_height and round 0
+std::shared_ptr<commit> make_precommits() {
+  auto local_config = config_setup();
+  auto [state_, priv_vals] = rand_genesis_state(local_config, test_num_vals, false, test_min_power);
+  p2p::block_id block_id_{.hash = random_hash(), .parts = {.total = 1, .hash = random_hash()}};
+  return make_signed_commit(state_.chain_id, test_height, block_id_, state_.validators, priv_vals);
+}
+
+/// \brief peer at test_height and round 0, which has no votes yet
+std::shared_ptr<peer_state> make_peer(boost::asio::io_context& ioc) {
+  auto ps = peer_state::new_peer_state("peer", ioc);
+  ps->prs.height = test_height;
+  ps->prs.round = 0;
+  ps->ensure_vote_bit_arrays(test_height, test_num_vals);
+  return ps;
+}
+
+p2p::has_votes_message make_has_votes(int64_t height, std::initializer_list<int> indices) {
+  auto votes = bit_array::new_bit_array(test_num_vals);
+  for (auto index : indices)
+    votes->set_index(index, true);
+  return {height, 0, p2p::Precommit, votes};
+}
+
+std::vector<int32_t> indices_of(const std::vector<std::shared_ptr<vote>>& votes) {
+  std::vector<int32_t> ret;
+  for (const auto& vote_ : votes)
+    ret.push_back(vote_->validator_index);
+  return ret;
+}
+
+std::shared_ptr<consensus_reactor> make_reactor() {
+  auto local_config = config_setup();
+  auto [cs, vss] = rand_cs(local_config, 1);
+  auto ev_bus = std::make_shared<events::event_bus>(app);
+  return consensus_reactor::new_consensus_reactor(app, cs, ev_bus, false);
+}
+
+} // namespace
+
+TEST_CASE("peer_state: Pick votes to send", "[noir][consensus]") {
+  boost::asio::io_context ioc;
+  auto precommits = make_precommits();
+  vote_set_reader votes(*precommits);
+  auto ps = make_peer(ioc);
+
+  CHECK(indices_of(ps->pick_votes_to_send(votes)) == std::vector<int32_t>{0, 1, 2, 3, 4, 5, 6});
+
+  ps->apply_has_votes_message(make_has_votes(test_height, {1, 4}));
+  CHECK(indices_of(ps->pick_votes_to_send(votes)) == std::vector<int32_t>{0, 2, 3, 5, 6});
+
+  // announcements of another height or without votes are ignored
+  ps->apply_has_votes_message(make_has_votes(test_height + 1, {0, 2}));
+  ps->apply_has_votes_message({test_height, 0, p2p::Precommit, nullptr});
+  CHECK(indices_of(ps->pick_votes_to_send(votes)) == std::vector<int32_t>{0, 2, 3, 5, 6});
+
+  // a bitmap shorter than the validator set, as broadcast_has_votes_messages sends
+  auto short_votes = bit_array::new_bit_array(4);
+  short_votes->set_index(3, true);
+  ps->apply_has_votes_message({test_height, 0, p2p::Precommit, short_votes});
+  CHECK(indices_of(ps->pick_votes_to_send(votes)) == std::vector<int32_t>{0, 2, 5, 6});
+
+  ps->apply_has_votes_message(make_has_votes(test_height, {0, 2, 5, 6}));
+  CHECK(ps->pick_votes_to_send(votes).empty());
+}
+
+TEST_CASE("consensus_reactor: Split votes into batches of vote_batch_bytes", "[noir][consensus]") {
+  boost::asio::io_context ioc;
+  auto precommits = make_precommits();
+  vote_set_reader votes(*precommits);
+  auto ps = make_peer(ioc);
+  auto reactor = make_reactor();
+  auto votes_sent = consensus_messages_sent("votes");
+  auto vote_sent = consensus_messages_sent("vote");
+  auto sent_before = std::pair{votes_sent.value(), vote_sent.value()};
+  auto sent = [&]() {
+    return std::pair{votes_sent.value() - sent_before.first, vote_sent.value() - sent_before.second};
+  };
+
+  SECTION("batches") {
+    // votes of the same encoded size but that of index 0, which omits the index; room for exactly three of them
+    for (auto& vote_ : votes.votes)
+      vote_->timestamp = votes.votes[0]->timestamp;
+    p2p::votes_message batch;
+    for (auto i = 1; i <= 3; i++)
+      batch.votes.push_back(*votes.votes[i]);
+    reactor->cs_state->cs_config.vote_batch_bytes = wire::encoded_size(batch);
+
+    CHECK(reactor->pick_send_votes(ps, votes));
+    CHECK(indices_of(ps->pick_votes_to_send(votes)) == std::vector<int32_t>{3, 4, 5, 6});
+    CHECK(reactor->pick_send_votes(ps, votes));
+    CHECK(indices_of(ps->pick_votes_to_send(votes)) == std::vector<int32_t>{6});
+    CHECK(sent() == std::pair<uint64_t, uint64_t>{2, 0});
+
+    // a single vote left goes out as a vote_message
+    CHECK(reactor->pick_send_votes(ps, votes));
+    CHECK(sent() == std::pair<uint64_t, uint64_t>{2, 1});
+    CHECK(!reactor->pick_send_votes(ps, votes));
+  }
+
+  SECTION("a vote larger than a batch") {
+    reactor->cs_state->cs_config.vote_batch_bytes = 1;
+    CHECK(reactor->pick_send_votes(ps, votes));
+    CHECK(indices_of(ps->pick_votes_to_send(votes)) == std::vector<int32_t>{1, 2, 3, 4, 5, 6});
+    CHECK(sent() == std::pair<uint64_t, uint64_t>{0, 1});
+  }
+
+  SECTION("disabled") {
+    reactor->cs_state->cs_config.vote_batch_bytes = 0;
+    for (auto i = 0; i < test_num_vals; i++)
+      CHECK(reactor->pick_send_votes(ps, votes));
+    CHECK(!reactor->pick_send_votes(ps, votes));
+    CHECK(sent() == std::pair<uint64_t, uint64_t>{0, test_num_vals});
+  }
+}
+
+TEST_CASE("consensus_reactor: Announce votes in has_votes messages", "[noir][consensus]") {
+  auto precommits = make_precommits();
+  vote_set_reader votes(*precommits);
+  auto reactor = make_reactor();
+  auto has_votes_sent = consensus_messages_sent("has_votes");
+  auto has_vote_sent = consensus_messages_sent("has_vote");
+  auto has_votes_before = has_votes_sent.value();
+  auto has_vote_before = has_vote_sent.value();
+
+  SECTION("disabled") {
+    reactor->cs_state->cs_config.has_votes_interval = std::chrono::milliseconds{0};
+    reactor->broadcast_has_vote_message(*votes.votes[0]);
+    reactor->broadcast_has_vote_message(*votes.votes[1]);
+    CHECK(has_vote_sent.value() - has_vote_before == 2);
+    CHECK(reactor->pending_has_votes.empty());
+  }
+
+  SECTION("flushed by broadcast_has_votes_messages") {
+    reactor->cs_state->cs_config.has_votes_interval = std::chrono::hours{1};
+    auto next_round = *votes.votes[4];
+    next_round.round = 1;
+    reactor->broadcast_has_vote_message(*votes.votes[2]);
+    reactor->broadcast_has_vote_message(*votes.votes[5]);
+    reactor->broadcast_has_vote_message(next_round);
+    CHECK(has_vote_sent.value() == has_vote_before);
+    CHECK(has_votes_sent.value() == has_votes_before);
+    REQUIRE(reactor->pending_has_votes.size() == 2);
+    CHECK(reactor->pending_has_votes[{test_height, 0, p2p::Precommit}] == std::vector<int32_t>{2, 5});
+
+    reactor->broadcast_has_votes_messages();
+    CHECK(has_votes_sent.value() - has_votes_before == 2);
+    CHECK(reactor->pending_has_votes.empty());
+
+    // nothing queued, nothing sent
+    reactor->broadcast_has_votes_messages();
+    CHECK(has_votes_sent.value() - has_votes_before == 2);
+    reactor->has_votes_timer->cancel();
+  }
+
+  SECTION("flushed by the timer") {
+    reactor->cs_state->cs_config.has_votes_interval = std::chrono::milliseconds{10};
+    reactor->add_pending_has_vote(*votes.votes[0]);
+    reactor->add_pending_has_vote(*votes.votes[3]);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    while (has_votes_sent.value() == has_votes_before && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    CHECK(has_votes_sent.value() - has_votes_before == 1);
+    std::scoped_lock g(reactor->has_votes_mtx);
+    CHECK(reactor->pending_has_votes.empty());
+  }
+}
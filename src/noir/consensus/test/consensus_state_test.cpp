@@ -59,6 +59,27 @@ TEST_CASE("consensus_state: No Priv Validator", "[noir][consensus]") {
   CHECK(!cs1->get_round_state()->proposal);
 }
 
+TEST_CASE("consensus_state: Round state snapshots", "[noir][consensus]") {
+  auto local_config = config_setup();
+  auto [cs1, vss] = rand_cs(local_config, 1);
+
+  auto before = cs1->get_round_state();
+  REQUIRE(before);
+  CHECK(before->step == p2p::round_step_type::NewHeight);
+  CHECK(cs1->get_last_height() == cs1->get_state()->last_block_height);
+
+  start_test_round(cs1, cs1->rs.height, cs1->rs.round);
+
+  // snapshots are read while the state machine holds its lock, and don't change once published
+  std::scoped_lock g(cs1->mtx);
+  auto after = cs1->get_round_state();
+  CHECK(after != before);
+  CHECK(after->step == cs1->rs.step);
+  CHECK(after->proposal == cs1->rs.proposal);
+  CHECK(before->step == p2p::round_step_type::NewHeight);
+  CHECK(cs1->get_state()->chain_id == cs1->local_state.chain_id);
+}
+
 TEST_CASE("consensus_state: Verify proposal signature", "[noir][consensus]") {
   auto local_config = config_setup();
   auto [cs1, vss] = rand_cs(local_config, 1);
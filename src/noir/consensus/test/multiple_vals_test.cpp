@@ -7,6 +7,7 @@
 #include <noir/common/plugin_interface.h>
 #include <noir/consensus/common_test.h>
 #include <noir/consensus/node.h>
+#include <noir/p2p/dispatcher.h>
 #include <noir/p2p/types.h>
 #include <appbase/application.hpp>
 
@@ -21,16 +22,14 @@ public:
   plugin_interface::channels::update_peer_status::channel_type& update_peer_status_channel;
   plugin_interface::egress::channels::transmit_message_queue::channel_type::handle xmt_mq_subscription;
 
-  plugin_interface::incoming::channels::bs_reactor_message_queue::channel_type& bs_reactor_mq_channel;
-  plugin_interface::incoming::channels::cs_reactor_message_queue::channel_type& cs_reactor_mq_channel;
-  plugin_interface::incoming::channels::es_reactor_message_queue::channel_type& es_reactor_mq_channel;
+  p2p::dispatcher inbound;
 
   channel_stub() = delete;
   explicit channel_stub(appbase::application& app)
-    : update_peer_status_channel(app.get_channel<plugin_interface::channels::update_peer_status>()),
-      bs_reactor_mq_channel(app.get_channel<plugin_interface::incoming::channels::bs_reactor_message_queue>()),
-      cs_reactor_mq_channel(app.get_channel<plugin_interface::incoming::channels::cs_reactor_message_queue>()),
-      es_reactor_mq_channel(app.get_channel<plugin_interface::incoming::channels::es_reactor_message_queue>()) {}
+    : update_peer_status_channel(app.get_channel<plugin_interface::channels::update_peer_status>()) {
+    p2p::add_reactor_inboxes(inbound, app);
+    inbound.start();
+  }
 };
 
 std::atomic<int> node_tokens = 0;
@@ -75,6 +74,7 @@ public:
   }
 
   ~test_node() {
+    channel_stub_->inbound.stop();
     app_->quit();
     thread_->stop();
   }
@@ -108,27 +108,7 @@ public:
 
   void handle_message(const p2p::envelope_ptr& env) {
     ilog(fmt::format("receive msg. from={}, to={}, id={}, broadcast={}", env->from, env->to, env->id, env->broadcast));
-    switch (env->id) {
-    case p2p::State:
-    case p2p::Data:
-    case p2p::Vote:
-    case p2p::VoteSetBits:
-      channel_stub_->cs_reactor_mq_channel.publish(appbase::priority::medium, env);
-      break;
-
-    case p2p::BlockSync:
-      channel_stub_->bs_reactor_mq_channel.publish(appbase::priority::medium, env);
-      break;
-
-    case p2p::Evidence:
-      channel_stub_->es_reactor_mq_channel.publish(appbase::priority::medium, env);
-      break;
-
-    case p2p::PeerError:
-    default:
-      // TODO : handling error case?
-      break;
-    }
+    channel_stub_->inbound.dispatch(env); // TODO : handling error case?
   }
 
   void route_message(const p2p::envelope_ptr& env) {
@@ -0,0 +1,565 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+// Runs a network of in-process validators on a kvstore app, submits txs at a target rate and reports committed tx/s,
+// submit to commit latency percentiles, block intervals and the CPU time of each subsystem as JSON.
+//
+// Validators exchange p2p envelopes through their appbase channels, as in multiple_vals_test, so the whole network
+// runs in a single process without sockets or external services. All validators propose from and commit to a single
+// shared pool, which stands in for the mempool and its gossip; TxMempool itself is covered by mempool_replay_bench.
+//
+// With --exec-us-per-tx, the app takes a fixed time per tx in end_block, so that execution dominates the block time,
+// and --target-block-exec-ms then shows how block_budget trades block size for block interval.
+//
+// --proxy-app parallel_kvstore runs parallel_kvstore_app instead, which delivers groups of txs of a block in parallel.
+// The pool checks txs on the app once submitted, and proposers group txs by the keys CheckTx declared. Bench txs
+// write keys of their own, so a block is a single group, and --exec-us-per-tx is then spent in each tx on the threads
+// of the app.
+//
+// --block-part-loss-percent drops block parts sent between validators at random, and proposal_ms reports how long
+// validators take to complete a proposal after the first of them, i.e. its proposer, does. --block-part-parity-percent
+// erasure codes proposals, so that they complete from any as many parts as data parts despite the loss.
+//
+// messages_per_height reports consensus messages each validator hands to p2p per block, by type. --vote-batch-bytes 0
+// and --has-votes-interval-ms 0 go back to a message per vote and a has_vote per vote received, for comparison.
+//
+// CPU time is read from /proc/self/task and grouped by thread name, e.g. consensus, node (appbase and reactors) or
+// submit, with the numeric suffix of named_thread_pool threads stripped.
+#include <noir/application/kvstore_app.h>
+#include <noir/application/parallel_kvstore_app.h>
+#include <noir/codec/protobuf.h>
+#include <noir/common/plugin_interface.h>
+#include <noir/consensus/common_test.h>
+#include <noir/consensus/mempool.h>
+#include <noir/consensus/node.h>
+#include <noir/p2p/dispatcher.h>
+#include <noir/p2p/types.h>
+#include <appbase/CLI11.hpp>
+#include <appbase/application.hpp>
+#include <fc/log/logger_config.hpp>
+#include <tendermint/consensus/types.pb.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+
+using namespace noir;
+using namespace noir::consensus;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+/// FIFO pool shared by all validators, recording when each tx was submitted and when its block was first committed
+/// Txs are checked on check_app once submitted, and the keys they declare are handed to proposers for tx groups.
+class bench_pool : public mempool_interface {
+public:
+  explicit bench_pool(std::shared_ptr<app_connection> check_app): check_app(std::move(check_app)) {}
+
+  void submit(tx new_tx) {
+    auto res = check_app->check_tx_sync({new_tx, check_tx_type::new_check});
+    auto access = res ? tx_access::from_check_tx(*res) : tx_access{};
+    auto key = std::string(new_tx.begin(), new_tx.end());
+    std::scoped_lock g{mtx};
+    auto seq = next_seq++;
+    submitted_at.emplace(std::move(key), submitted_tx{seq, clock_type::now(), std::move(access)});
+    pending.emplace(seq, std::move(new_tx));
+  }
+
+  std::vector<tx> reap_max_bytes_max_gas(int64_t max_bytes, int64_t max_gas) override {
+    std::scoped_lock g{mtx};
+    std::vector<tx> txs;
+    int64_t total_bytes = 0;
+    for (const auto& [_, pending_tx] : pending) {
+      // every tx is a length-delimited field of the block data
+      auto size = static_cast<int64_t>(codec::protobuf::message_field_size(1, pending_tx.size()));
+      if (max_bytes > -1 && total_bytes + size > max_bytes)
+        break;
+      // kvstore txs have no gas, so max_gas never limits a block
+      total_bytes += size;
+      txs.push_back(pending_tx);
+    }
+    return txs;
+  }
+
+  std::vector<tx_access> tx_accesses(const std::vector<tx>& txs) override {
+    std::scoped_lock g{mtx};
+    std::vector<tx_access> accesses;
+    accesses.reserve(txs.size());
+    for (const auto& block_tx : txs) {
+      // a tx which is no longer pending declares no keys, and so is a group of its own
+      auto it = submitted_at.find(std::string(block_tx.begin(), block_tx.end()));
+      accesses.push_back(it != submitted_at.end() ? it->second.access : tx_access{});
+    }
+    return accesses;
+  }
+
+  Result<void> update(int64_t block_height,
+    const std::vector<tx>& block_txs,
+    const google::protobuf::RepeatedPtrField<tendermint::abci::ResponseDeliverTx>& deliver_tx_responses) override {
+    auto now = clock_type::now();
+    std::scoped_lock g{mtx};
+    // every validator commits the same block; only the first one to do so is recorded
+    if (block_height <= last_height)
+      return success();
+    last_height = block_height;
+    block_times.push_back(now);
+    block_sizes.push_back(block_txs.size());
+
+    for (const auto& block_tx : block_txs) {
+      auto it = submitted_at.find(std::string(block_tx.begin(), block_tx.end()));
+      if (it == submitted_at.end())
+        continue;
+      latencies_ns.push_back((now - it->second.at).count());
+      pending.erase(it->second.seq);
+      submitted_at.erase(it);
+    }
+    return success();
+  }
+
+  auto num_pending() -> size_t {
+    std::scoped_lock g{mtx};
+    return pending.size();
+  }
+
+  std::mutex mtx;
+  int64_t last_height{0};
+  std::vector<clock_type::time_point> block_times;
+  std::vector<size_t> block_sizes;
+  std::vector<int64_t> latencies_ns;
+
+private:
+  struct submitted_tx {
+    uint64_t seq;
+    clock_type::time_point at;
+    tx_access access;
+  };
+
+  std::shared_ptr<app_connection> check_app;
+  uint64_t next_seq{0};
+  std::map<uint64_t, tx> pending;
+  std::unordered_map<std::string, submitted_tx> submitted_at;
+};
+
+/// kvstore taking a fixed time per tx of a block, which stands in for an app whose execution is costly
+class costly_kvstore : public application::kvstore_app {
+public:
+  explicit costly_kvstore(std::chrono::microseconds cost_per_tx): cost_per_tx(cost_per_tx) {}
+
+  std::unique_ptr<tendermint::abci::ResponseDeliverTx> deliver_tx_async(
+    const tendermint::abci::RequestDeliverTx& req) override {
+    num_txs++;
+    return kvstore_app::deliver_tx_async(req);
+  }
+
+  // sleeps once per block, as sleeping for a few microseconds per tx would oversleep
+  std::unique_ptr<tendermint::abci::ResponseEndBlock> end_block(const tendermint::abci::RequestEndBlock& req) override {
+    std::this_thread::sleep_for(cost_per_tx * num_txs);
+    num_txs = 0;
+    return kvstore_app::end_block(req);
+  }
+
+private:
+  std::chrono::microseconds cost_per_tx;
+  int64_t num_txs{0};
+};
+
+/// time each proposal is first completed at a validator, i.e. at its proposer, and how long the others take after it
+class proposal_tracker {
+public:
+  void on_complete(int64_t height, int32_t round) {
+    auto now = clock_type::now();
+    std::scoped_lock g{mtx};
+    auto [it, first] = first_completed_at.try_emplace({height, round}, now);
+    if (!first)
+      latencies_ns.push_back((now - it->second).count());
+  }
+
+  std::mutex mtx;
+  std::vector<int64_t> latencies_ns;
+
+private:
+  std::map<std::pair<int64_t, int32_t>, clock_type::time_point> first_completed_at;
+};
+
+struct channel_stub {
+  plugin_interface::channels::update_peer_status::channel_type& update_peer_status_channel;
+  plugin_interface::egress::channels::transmit_message_queue::channel_type::handle xmt_mq_subscription;
+
+  p2p::dispatcher inbound;
+
+  explicit channel_stub(appbase::application& app)
+    : update_peer_status_channel(app.get_channel<plugin_interface::channels::update_peer_status>()) {
+    p2p::add_reactor_inboxes(inbound, app);
+    inbound.start();
+  }
+};
+
+std::atomic<int> node_tokens = 0;
+
+class bench_node {
+public:
+  bench_node(int num,
+    const std::string& root_dir,
+    const consensus_config& cs_config,
+    const std::shared_ptr<genesis_doc>& gen_doc,
+    const std::shared_ptr<priv_validator>& priv_val,
+    const std::shared_ptr<bench_pool>& pool,
+    const std::shared_ptr<proposal_tracker>& proposals,
+    const std::string& proxy_app,
+    std::chrono::microseconds exec_cost_per_tx,
+    double block_part_loss)
+    : app_(std::make_unique<appbase::application>()),
+      channel_stub_(*app_),
+      block_part_loss_(block_part_loss),
+      rng_(num) {
+    node_name_ = "node_" + std::to_string(num);
+
+    channel_stub_.xmt_mq_subscription =
+      app_->get_channel<plugin_interface::egress::channels::transmit_message_queue>().subscribe(
+        [this](auto&& arg) { route_message(std::forward<decltype(arg)>(arg)); });
+
+    auto cfg = std::make_shared<config>(config::get_default());
+    cfg->base.chain_id = gen_doc->chain_id;
+    cfg->base.mode = Validator;
+    cfg->base.node_key = node_name_;
+    cfg->base.proxy_app = proxy_app;
+    cfg->base.root_dir = (std::filesystem::path{root_dir} / node_name_).string();
+    cfg->consensus = cs_config;
+    cfg->consensus.root_dir = cfg->base.root_dir;
+    cfg->priv_validator.root_dir = cfg->base.root_dir;
+
+    std::filesystem::remove_all(cfg->consensus.root_dir);
+    std::filesystem::create_directories(std::filesystem::path{cfg->consensus.root_dir} / "data");
+    auto db_dir = std::filesystem::path{cfg->consensus.root_dir} / std::string(default_data_dir);
+    auto session = make_session(true, db_dir);
+
+    node_ = node::make_node(*app_, cfg, priv_val, node_key::gen_node_key(), gen_doc, session);
+    node_->cs_reactor->cs_state->block_exec->set_mempool(pool);
+    if (exec_cost_per_tx.count() > 0 && proxy_app == "parallel_kvstore")
+      node_->cs_reactor->cs_state->block_exec->proxyApp_->application =
+        std::make_shared<application::parallel_kvstore_app>(std::thread::hardware_concurrency(), exec_cost_per_tx);
+    else if (exec_cost_per_tx.count() > 0)
+      node_->cs_reactor->cs_state->block_exec->proxyApp_->application =
+        std::make_shared<costly_kvstore>(exec_cost_per_tx);
+    complete_proposal_subscription_ =
+      node_->event_bus_->subscribe(node_name_, [proposals](const events::message& msg) {
+        if (auto* complete = std::get_if<events::event_data_complete_proposal>(&msg.data))
+          proposals->on_complete(complete->height, complete->round);
+      });
+
+    thread_ = std::make_unique<named_thread_pool>("node", 2);
+  }
+
+  ~bench_node() {
+    channel_stub_.inbound.stop();
+    app_->quit();
+    thread_->stop();
+  }
+
+  void start() {
+    async_thread_pool(thread_->get_executor(), [this]() {
+      app_->register_plugin<test_plugin>();
+      app_->initialize<test_plugin>();
+      app_->startup();
+      app_->exec();
+    });
+    async_thread_pool(thread_->get_executor(), [this]() {
+      node_tokens.fetch_sub(1, std::memory_order_acquire);
+      while (node_tokens.load(std::memory_order_acquire)) {
+        usleep(1000);
+      }
+      node_->on_start();
+    });
+  }
+
+  void stop() {
+    node_->on_stop();
+  }
+
+  void peer_update(const std::shared_ptr<bench_node>& other_node) {
+    peers_.push_back(other_node);
+    channel_stub_.update_peer_status_channel.publish(appbase::priority::medium,
+      std::make_shared<plugin_interface::peer_status_info>(
+        plugin_interface::peer_status_info{other_node->node_name(), p2p::peer_status::up}));
+  }
+
+  void handle_message(const p2p::envelope_ptr& env) {
+    channel_stub_.inbound.dispatch(env);
+  }
+
+  void route_message(const p2p::envelope_ptr& env) {
+    env->from = node_name_;
+    auto lossy = block_part_loss_ > 0 && is_block_part(env);
+    for (auto& n : peers_) {
+      auto node = n.lock();
+      if (node && (env->broadcast || node->node_name() == env->to)) {
+        if (!lossy || std::bernoulli_distribution(1 - block_part_loss_)(rng_))
+          node->handle_message(env);
+        if (!env->broadcast)
+          return;
+      }
+    }
+  }
+
+  std::string node_name() const {
+    return node_name_;
+  }
+
+  /// \return fraction of consensus limits proposed, which is 1 unless a target block execution time is set
+  double block_budget() const {
+    auto& budget = node_->cs_reactor->cs_state->block_exec->budget_;
+    return budget ? budget->fraction() : 1;
+  }
+
+private:
+  static bool is_block_part(const p2p::envelope_ptr& env) {
+    if (env->id != p2p::Data)
+      return false;
+    ::tendermint::consensus::Message msg;
+    return msg.ParseFromArray(env->message.data(), env->message.size()) && msg.has_block_part();
+  }
+
+  std::string node_name_;
+  std::unique_ptr<appbase::application> app_;
+  channel_stub channel_stub_;
+  std::unique_ptr<node> node_;
+  events::event_bus::subscription complete_proposal_subscription_;
+  std::unique_ptr<named_thread_pool> thread_;
+  std::vector<std::weak_ptr<bench_node>> peers_;
+  double block_part_loss_;
+  std::mt19937 rng_; ///< used by the thread routing messages of this validator only
+};
+
+/// CPU time in clock ticks per thread name, e.g. `consensus` for consensus-0 and consensus-1
+auto cpu_ticks_by_thread() -> std::map<std::string, int64_t> {
+  std::map<std::string, int64_t> ticks;
+  for (const auto& task : std::filesystem::directory_iterator("/proc/self/task")) {
+    std::ifstream stat_file(task.path() / "stat");
+    std::string stat;
+    std::getline(stat_file, stat);
+    auto open = stat.find('('), close = stat.rfind(')');
+    if (open == std::string::npos || close == std::string::npos)
+      continue;
+
+    auto name = stat.substr(open + 1, close - open - 1);
+    if (auto dash = name.find_last_of('-');
+        dash != std::string::npos && dash + 1 < name.size() &&
+        std::all_of(name.begin() + dash + 1, name.end(), [](char c) { return std::isdigit(c); })) {
+      name.resize(dash);
+    }
+
+    // fields following the name start from state; utime and stime are the 12th and 13th of them
+    std::istringstream fields(stat.substr(close + 2));
+    std::string field;
+    int64_t utime = 0, stime = 0;
+    for (auto i = 0; i < 11 && fields >> field; i++) {}
+    fields >> utime >> stime;
+    ticks[name] += utime + stime;
+  }
+  return ticks;
+}
+
+auto percentile(std::vector<int64_t>& values, double p) -> int64_t {
+  if (values.empty())
+    return 0;
+  std::sort(values.begin(), values.end());
+  return values[std::min(values.size() - 1, size_t(p * values.size()))];
+}
+
+auto make_tx(uint64_t seq, uint32_t size) -> tx {
+  auto body = fmt::format("bench{}=", seq);
+  body.resize(std::max<size_t>(body.size(), size), 'x');
+  return tx{body.begin(), body.end()};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  CLI::App cli{"Measures end-to-end throughput of in-process validators on a kvstore app"};
+
+  int num_validators = 4;
+  double rate = 1'000;
+  uint32_t tx_size = 250;
+  int64_t duration_sec = 30, drain_sec = 30;
+  int64_t timeout_commit_ms = 1'000, timeout_propose_ms = 3'000;
+  int64_t exec_us_per_tx = 0, target_block_exec_ms = 0;
+  uint32_t block_part_parity_percent = 0;
+  double block_part_loss_percent = 0;
+  uint32_t vote_batch_bytes = 64 * 1024;
+  int64_t has_votes_interval_ms = 10;
+  bool skip_timeout_commit = false;
+  bool verbose = false;
+  std::string proxy_app = "kvstore";
+  std::string root_dir = "/tmp/noir_bench/node_bench", output_path;
+
+  cli.add_option("--validators", num_validators, "Number of validators");
+  cli.add_option("--rate", rate, "Txs submitted per second");
+  cli.add_option("--tx-size", tx_size, "Size of a tx");
+  cli.add_option("--duration", duration_sec, "Seconds to submit txs for");
+  cli.add_option("--drain", drain_sec, "Max seconds to wait for submitted txs to be committed");
+  cli.add_option("--timeout-commit-ms", timeout_commit_ms, "Time to wait after committing a block");
+  cli.add_option("--timeout-propose-ms", timeout_propose_ms, "Time to wait for a proposal");
+  cli.add_option("--skip-timeout-commit", skip_timeout_commit, "Start the next height as soon as all votes arrive");
+  cli.add_option("--proxy-app", proxy_app, "App of the validators: kvstore or parallel_kvstore");
+  cli.add_option("--exec-us-per-tx", exec_us_per_tx, "Time the app takes to execute a tx");
+  cli.add_option("--target-block-exec-ms", target_block_exec_ms,
+    "Adapt proposed blocks to take about this long to execute and commit (0 disables)");
+  cli.add_option("--block-part-parity-percent", block_part_parity_percent,
+    "Erasure code proposals with this many parity parts per hundred data parts (0 disables)");
+  cli.add_option("--block-part-loss-percent", block_part_loss_percent, "Chance of a block part sent being lost");
+  cli.add_option("--vote-batch-bytes", vote_batch_bytes, "Max bytes of votes gossiped at once (0 sends one by one)");
+  cli.add_option("--has-votes-interval-ms", has_votes_interval_ms,
+    "Interval of announcing votes received in a bitmap (0 announces one by one)");
+  cli.add_option("--root-dir", root_dir, "Directory of the validators' data, removed before each run");
+  cli.add_option("--output", output_path, "Path of the JSON results, written to stdout if empty");
+  cli.add_flag("--verbose", verbose, "Logs consensus progress of the validators");
+  CLI11_PARSE(cli, argc, argv);
+
+  if (num_validators < 1 || rate <= 0) {
+    std::cerr << "validators and rate must be positive" << std::endl;
+    return 1;
+  }
+  if (proxy_app != "kvstore" && proxy_app != "parallel_kvstore") {
+    std::cerr << "proxy app must be kvstore or parallel_kvstore" << std::endl;
+    return 1;
+  }
+  if (block_part_loss_percent < 0 || block_part_loss_percent >= 100) {
+    std::cerr << "block part loss must be at least 0 and less than 100 percent" << std::endl;
+    return 1;
+  }
+  fc::logger::get(DEFAULT_LOGGER).set_log_level(verbose ? fc::log_level::info : fc::log_level::warn);
+
+  auto cs_config = consensus_config::get_default();
+  cs_config.timeout_commit = std::chrono::milliseconds{timeout_commit_ms};
+  cs_config.timeout_propose = std::chrono::milliseconds{timeout_propose_ms};
+  cs_config.skip_timeout_commit = skip_timeout_commit;
+  cs_config.target_block_exec_time = std::chrono::milliseconds{target_block_exec_ms};
+  cs_config.vote_batch_bytes = vote_batch_bytes;
+  cs_config.has_votes_interval = std::chrono::milliseconds{has_votes_interval_ms};
+
+  auto cfg = config::get_default();
+  cfg.base.chain_id = "bench_chain";
+  auto [gen_doc, priv_vals] = rand_genesis_doc(cfg, num_validators, false, 100 / num_validators + 1);
+  gen_doc.cs_params = consensus_params::get_default();
+  gen_doc.cs_params->block.part_parity_percent = block_part_parity_percent;
+  auto gen_doc_ptr = std::make_shared<genesis_doc>(gen_doc);
+
+  auto pool = std::make_shared<bench_pool>(std::make_shared<app_connection>(proxy_app));
+  auto proposals = std::make_shared<proposal_tracker>();
+  node_tokens = num_validators;
+  std::vector<std::shared_ptr<bench_node>> nodes;
+  for (auto i = 0; i < num_validators; i++) {
+    nodes.push_back(std::make_shared<bench_node>(i, root_dir, cs_config, gen_doc_ptr, priv_vals[i], pool, proposals,
+      proxy_app, std::chrono::microseconds(exec_us_per_tx), block_part_loss_percent / 100));
+  }
+  for (auto& n : nodes) {
+    n->start();
+  }
+  for (auto& n : nodes) {
+    for (auto& other : nodes) {
+      if (n != other)
+        other->peer_update(n);
+    }
+  }
+
+  auto cpu_start = cpu_ticks_by_thread();
+  auto start = clock_type::now();
+  uint64_t num_submitted = 0;
+  std::thread submitter([&]() {
+    fc::set_os_thread_name("submit");
+    auto interval = std::chrono::duration<double>(1.0 / rate);
+    auto end = start + std::chrono::seconds(duration_sec);
+    for (auto next = start; next < end; num_submitted++) {
+      std::this_thread::sleep_until(next);
+      pool->submit(make_tx(num_submitted, tx_size));
+      next = start + std::chrono::duration_cast<clock_type::duration>(interval * (num_submitted + 1));
+    }
+  });
+  submitter.join();
+
+  auto drain_end = clock_type::now() + std::chrono::seconds(drain_sec);
+  while (pool->num_pending() > 0 && clock_type::now() < drain_end) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  auto cpu_end = cpu_ticks_by_thread();
+
+  auto block_budget = nodes.front()->block_budget();
+  for (auto& n : nodes) {
+    n->stop();
+  }
+
+  // abci calls of all validators, from begin_block to commit
+  double exec_sec = 0;
+  for (auto method : {"begin_block", "deliver_tx", "deliver_tx_groups", "end_block", "commit"}) {
+    exec_sec += abci_call_duration(method).sum();
+  }
+  auto num_execs = abci_call_duration("commit").count();
+
+  std::scoped_lock g{pool->mtx, proposals->mtx};
+  auto num_committed = pool->latencies_ns.size();
+  auto last_commit = pool->block_times.empty() ? start : std::max(start, pool->block_times.back());
+  auto elapsed = std::chrono::duration<double>(last_commit - start).count();
+
+  std::vector<int64_t> intervals_ns;
+  for (size_t i = 1; i < pool->block_times.size(); i++) {
+    intervals_ns.push_back((pool->block_times[i] - pool->block_times[i - 1]).count());
+  }
+  auto mean_interval = intervals_ns.empty()
+    ? 0.0
+    : std::accumulate(intervals_ns.begin(), intervals_ns.end(), int64_t(0)) / 1e6 / intervals_ns.size();
+  auto block_txs = std::accumulate(pool->block_sizes.begin(), pool->block_sizes.end(), size_t(0));
+
+  std::string cpu;
+  auto ticks_per_sec = static_cast<double>(::sysconf(_SC_CLK_TCK));
+  for (const auto& [name, ticks] : cpu_end) {
+    auto it = cpu_start.find(name);
+    auto used = ticks - (it != cpu_start.end() ? it->second : 0);
+    cpu += fmt::format(R"({}"{}": {:.2f})", cpu.empty() ? "" : ", ", name, used / ticks_per_sec);
+  }
+
+  std::string messages;
+  auto num_blocks = pool->block_times.size();
+  for (auto type : {"new_round_step", "new_valid_block", "proposal", "proposal_pol", "block_part", "vote", "votes",
+         "has_vote", "has_votes", "vote_set_maj23", "vote_set_bits"}) {
+    auto sent = consensus_messages_sent(type).value();
+    messages += fmt::format(R"({}"{}": {:.1f})", messages.empty() ? "" : ", ", type,
+      num_blocks ? double(sent) / num_blocks / num_validators : 0.0);
+  }
+
+  auto& latencies = pool->latencies_ns;
+  auto& proposal_latencies = proposals->latencies_ns;
+  auto results = fmt::format(
+    R"({{"validators": {}, "proxy_app": "{}", "target_rate": {:.1f}, "submitted": {}, "committed": {}, )"
+    R"("elapsed_sec": {:.3f}, "committed_per_sec": {:.1f}, )"
+    R"("latency_ms": {{"p50": {:.1f}, "p90": {:.1f}, "p99": {:.1f}, "max": {:.1f}}}, )"
+    R"("blocks": {}, "txs_per_block": {:.1f}, "block_interval_ms": {{"mean": {:.1f}, "p50": {:.1f}, "p99": {:.1f}}}, )"
+    R"("exec_ms_per_block": {:.1f}, "block_budget": {:.3f}, "block_part_parity_percent": {}, )"
+    R"("block_part_loss_percent": {:.1f}, "proposal_ms": {{"p50": {:.1f}, "p90": {:.1f}, "p99": {:.1f}}}, )"
+    R"("vote_batch_bytes": {}, "has_votes_interval_ms": {}, "messages_per_height": {{{}}}, "cpu_sec": {{{}}}}})",
+    num_validators, proxy_app, rate, num_submitted, num_committed, elapsed, elapsed > 0 ? num_committed / elapsed : 0.0,
+    percentile(latencies, 0.5) / 1e6, percentile(latencies, 0.9) / 1e6, percentile(latencies, 0.99) / 1e6,
+    percentile(latencies, 1.0) / 1e6, pool->block_times.size(),
+    pool->block_sizes.empty() ? 0.0 : double(block_txs) / pool->block_sizes.size(), mean_interval,
+    percentile(intervals_ns, 0.5) / 1e6, percentile(intervals_ns, 0.99) / 1e6,
+    num_execs ? exec_sec * 1e3 / num_execs : 0.0, block_budget, block_part_parity_percent, block_part_loss_percent,
+    percentile(proposal_latencies, 0.5) / 1e6, percentile(proposal_latencies, 0.9) / 1e6,
+    percentile(proposal_latencies, 0.99) / 1e6, vote_batch_bytes, has_votes_interval_ms, messages, cpu);
+
+  if (output_path.empty()) {
+    std::cout << results << std::endl;
+  } else {
+    std::ofstream(output_path, std::ios::trunc) << results << std::endl;
+  }
+  return 0;
+}
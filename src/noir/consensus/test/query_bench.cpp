@@ -0,0 +1,100 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+// Measures the queries per second served by query_connection as the number of connections grows, and reports them as
+// JSON, one line per number of connections.
+//
+// The app stands in for a socket app serving queries concurrently: each query takes a fixed latency without using the
+// CPU, as a round trip to an external process would. Clients draw keys uniformly from a key space, so a small key
+// space shows the effect of the per-height cache and of coalescing, and a large one the scaling of the pool itself.
+#include <noir/consensus/query_connection.h>
+#include <appbase/CLI11.hpp>
+#include <fmt/core.h>
+
+#include <iostream>
+#include <random>
+#include <thread>
+
+using namespace noir;
+using namespace noir::consensus;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+class latency_app : public application::base_application {
+public:
+  explicit latency_app(std::chrono::microseconds latency): latency(latency) {}
+
+  std::unique_ptr<tendermint::abci::ResponseQuery> query_sync(const tendermint::abci::RequestQuery& req) override {
+    std::this_thread::sleep_for(latency);
+    num_queries++;
+    auto res = std::make_unique<tendermint::abci::ResponseQuery>();
+    res->set_value(req.data());
+    res->set_height(req.height());
+    return res;
+  }
+
+  std::chrono::microseconds latency;
+  std::atomic<uint64_t> num_queries = 0;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  CLI::App cli{"Measures queries per second of query_connection by the number of connections"};
+
+  std::vector<int> conns = {1, 2, 4, 8, 16};
+  int num_clients = 32;
+  int64_t latency_us = 500, duration_ms = 2'000, block_interval_ms = 1'000;
+  uint64_t num_keys = 1'000'000;
+
+  cli.add_option("--conns", conns, "Numbers of connections to measure");
+  cli.add_option("--clients", num_clients, "Number of client threads");
+  cli.add_option("--latency-us", latency_us, "Time the app takes to serve a query");
+  cli.add_option("--duration-ms", duration_ms, "Time to measure each number of connections for");
+  cli.add_option("--block-interval-ms", block_interval_ms, "Interval of committed heights, which drop the cache");
+  cli.add_option("--keys", num_keys, "Number of distinct keys queried");
+  CLI11_PARSE(cli, argc, argv);
+
+  for (auto num_conns : conns) {
+    auto app = std::make_shared<latency_app>(std::chrono::microseconds(latency_us));
+    auto conn = query_connection(std::vector<std::shared_ptr<application::base_application>>(num_conns, app));
+    conn.set_height(1);
+
+    std::atomic<bool> done = false;
+    std::atomic<uint64_t> num_served = 0, num_failed = 0;
+    auto start = clock_type::now();
+    std::vector<std::thread> clients;
+    for (auto i = 0; i < num_clients; i++) {
+      clients.emplace_back([&, i]() {
+        std::mt19937_64 rng(i);
+        std::uniform_int_distribution<uint64_t> key(0, num_keys - 1);
+        tendermint::abci::RequestQuery req;
+        req.set_path("/key");
+        while (!done) {
+          req.set_data(std::to_string(key(rng)));
+          conn.query(req) ? num_served++ : num_failed++;
+        }
+      });
+    }
+    for (auto height = 2; clock_type::now() - start < std::chrono::milliseconds(duration_ms); height++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(std::min(block_interval_ms, duration_ms)));
+      conn.set_height(height);
+    }
+    done = true;
+    for (auto& t : clients) {
+      t.join();
+    }
+
+    auto elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+    std::cout << fmt::format(R"({{"conns": {}, "clients": {}, "latency_us": {}, "keys": {}, "served_per_sec": {:.1f}, )"
+                             R"("app_queries_per_sec": {:.1f}, "failed": {}}})",
+                   num_conns, num_clients, latency_us, num_keys, num_served / elapsed, app->num_queries / elapsed,
+                   num_failed.load())
+              << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,148 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/consensus/query_connection.h>
+#include <thread>
+
+using namespace noir;
+using namespace noir::consensus;
+
+namespace {
+
+/// answers data@height, fails queries of /fail, answers queries of /ahead at the next height and holds queries of
+/// /hold until released
+class query_app : public application::base_application {
+public:
+  std::unique_ptr<tendermint::abci::ResponseQuery> query_sync(const tendermint::abci::RequestQuery& req) override {
+    num_queries++;
+    auto running = ++num_running;
+    for (auto m = max_running.load(); m < running && !max_running.compare_exchange_weak(m, running);) {}
+    if (req.path() == "/hold")
+      released.wait();
+    num_running--;
+    if (req.path() == "/fail")
+      return {};
+    auto res = std::make_unique<tendermint::abci::ResponseQuery>();
+    auto height = req.path() == "/ahead" ? req.height() + 1 : req.height();
+    res->set_value(fmt::format("{}@{}", req.data(), height));
+    res->set_height(height);
+    return res;
+  }
+
+  std::atomic<int> num_queries = 0;
+  std::atomic<int> num_running = 0;
+  std::atomic<int> max_running = 0;
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+};
+
+auto make_query(const std::string& path, const std::string& data, int64_t height = 0) {
+  tendermint::abci::RequestQuery req;
+  req.set_path(path);
+  req.set_data(data);
+  req.set_height(height);
+  return req;
+}
+
+} // namespace
+
+TEST_CASE("query_connection: cache by height", "[noir][consensus]") {
+  auto app = std::make_shared<query_app>();
+  auto conn = query_connection({app}, 2);
+  conn.set_height(5);
+
+  auto res = conn.query(make_query("/key", "a"));
+  REQUIRE(res);
+  CHECK(res.value()->value() == "a@5");
+  CHECK(conn.query(make_query("/key", "a", 5)).value() == res.value());
+  CHECK(app->num_queries == 1);
+
+  // keys differ by path, data and prove
+  CHECK(conn.query(make_query("/key/a", "")).value()->value() == "@5");
+  CHECK(conn.query(make_query("/key", "b")).value()->value() == "b@5");
+  CHECK(app->num_queries == 3);
+
+  // heights not committed yet or no longer kept are not cached
+  CHECK(conn.query(make_query("/key", "a", 6)));
+  CHECK(conn.query(make_query("/key", "a", 6)));
+  CHECK(conn.query(make_query("/key", "a", 3)));
+  CHECK(conn.query(make_query("/key", "a", 3)));
+  CHECK(app->num_queries == 7);
+
+  conn.set_height(6);
+  CHECK(conn.height() == 6);
+  CHECK(conn.query(make_query("/key", "a", 5)).value() == res.value());
+  CHECK(conn.query(make_query("/key", "a")).value()->value() == "a@6");
+  CHECK(app->num_queries == 8);
+  conn.set_height(7);
+  CHECK(conn.query(make_query("/key", "a", 5)).value() != res.value());
+  CHECK(app->num_queries == 9);
+
+  // errors are not cached
+  CHECK(!conn.query(make_query("/fail", "")));
+  CHECK(!conn.query(make_query("/fail", "")));
+  CHECK(app->num_queries == 11);
+
+  // nor are responses at another height than requested, as of an app that committed a block not announced yet
+  CHECK(conn.query(make_query("/ahead", "a")).value()->value() == "a@8");
+  CHECK(conn.query(make_query("/ahead", "a")).value()->value() == "a@8");
+  CHECK(app->num_queries == 13);
+}
+
+TEST_CASE("query_connection: coalesce queries in flight", "[noir][consensus]") {
+  constexpr int num_threads = 8;
+  auto app = std::make_shared<query_app>();
+  auto conn = query_connection({app, app, app, app});
+  conn.set_height(1);
+
+  std::atomic<int> num_started = 0;
+  std::vector<std::thread> threads;
+  std::vector<Result<query_connection::response_ptr>> results(num_threads, Error("not run"));
+  for (auto i = 0; i < num_threads; i++) {
+    threads.emplace_back([&, i]() {
+      num_started++;
+      results[i] = conn.query(make_query("/hold", std::to_string(i % 2)));
+    });
+  }
+  while (num_started < num_threads || app->num_running < 2) {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  app->release.set_value();
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  // identical queries are served once, and distinct ones concurrently on separate connections
+  CHECK(app->num_queries == 2);
+  CHECK(app->max_running == 2);
+  for (auto i = 0; i < num_threads; i++) {
+    REQUIRE(results[i]);
+    CHECK(results[i].value() == results[i % 2].value());
+  }
+}
+
+TEST_CASE("query_connection: bounded connections", "[noir][consensus]") {
+  constexpr int num_threads = 8;
+  auto app = std::make_shared<query_app>();
+  auto conn = query_connection({app, app});
+  conn.set_height(1);
+
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < num_threads; i++) {
+    threads.emplace_back([&, i]() { CHECK(conn.query(make_query("/hold", std::to_string(i)))); });
+  }
+  while (app->num_running < 2) {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  app->release.set_value();
+  for (auto& t : threads) {
+    t.join();
+  }
+  CHECK(app->num_queries == num_threads);
+  CHECK(app->max_running == 2);
+}
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 #include <catch2/catch_all.hpp>
+#include <noir/application/kvstore_app.h>
 #include <noir/common/helper/go.h>
 #include <noir/consensus/common_test.h>
 #include <noir/consensus/consensus_state.h>
@@ -174,4 +175,77 @@ TEST_CASE("state_wal: repair_wal_file", "[noir][consensus]") {
   });
 }
 
+TEST_CASE("handshaker: Replay blocks to an app behind the store", "[noir][consensus]") {
+  constexpr int64_t num_blocks = 10;
+  constexpr int64_t app_height = 3;
+  auto local_config = config_setup();
+  auto [state_, priv_vals] = rand_genesis_state(local_config, 4, false, test_min_power);
+  auto session = make_session();
+  auto dbs = std::make_shared<noir::consensus::db_store>(session);
+  auto bls = std::make_shared<noir::consensus::block_store>(session);
+  auto ev_bus = std::make_shared<noir::consensus::events::event_bus>(app);
+  REQUIRE(dbs->save(state_));
+
+  // commit blocks to the store, running a reference app for the app hash each block carries
+  auto ref_app = std::make_shared<app_connection>("kvstore");
+  auto behind_app = std::make_shared<app_connection>("kvstore");
+  auto ref_exec = block_executor::new_block_executor(dbs, ref_app, nullptr, bls, ev_bus);
+  auto behind_exec = block_executor::new_block_executor(dbs, behind_app, nullptr, bls, ev_bus);
+  auto proposer = state_.validators->validators[0].address;
+  for (int64_t height = 1; height <= num_blocks; height++) {
+    std::vector<Bytes> txs;
+    for (auto i = 0; i < 5; i++) {
+      auto tx_ = fmt::format("k{}_{}=v", height, i);
+      txs.emplace_back(tx_.begin(), tx_.end());
+    }
+    auto last_commit = height == 1
+      ? std::make_shared<commit>()
+      : make_signed_commit(state_.chain_id, height - 1, state_.last_block_id, state_.last_validators, priv_vals);
+    auto [block_, part_set_] = state_.make_block(height, txs, last_commit, {}, proposer);
+    p2p::block_id block_id_{block_->get_hash(), part_set_->header()};
+    auto seen_commit = make_signed_commit(state_.chain_id, height, block_id_, state_.validators, priv_vals);
+    bls->save_block(*block_, *part_set_, *seen_commit);
+
+    auto app_hash = ref_exec->exec_commit_block(block_, state_.initial_height);
+    REQUIRE(app_hash);
+    if (height <= app_height)
+      REQUIRE(behind_exec->exec_commit_block(block_, state_.initial_height));
+
+    state_.last_block_height = height;
+    state_.last_block_id = block_id_;
+    state_.last_validators = state_.validators;
+    state_.app_hash = app_hash.value();
+    REQUIRE(dbs->save(state_));
+  }
+  auto behind_kvstore = std::dynamic_pointer_cast<noir::application::kvstore_app>(behind_app->application);
+  REQUIRE(behind_kvstore->size() == app_height * 5);
+
+  auto h = handshaker::new_handshaker(bls, state_, dbs, ev_bus, nullptr);
+  auto app_hash = h->replay_blocks(state_, {}, app_height, behind_app);
+  REQUIRE(app_hash);
+  CHECK(app_hash.value() == state_.app_hash);
+  CHECK(h->n_blocks == num_blocks - app_height);
+  CHECK(behind_kvstore->size() == num_blocks * 5);
+  CHECK(behind_kvstore->get(fmt::format("k{}_4", num_blocks)) == "v");
+
+  SECTION("app of a different chain") {
+    // the app runs ahead of what the store says it ran, so app hashes of stored blocks no longer match
+    auto other_app = std::make_shared<app_connection>("kvstore");
+    auto other_exec = block_executor::new_block_executor(dbs, other_app, nullptr, bls, ev_bus);
+    auto block_ = std::make_shared<block>();
+    for (int64_t height = 1; height <= app_height; height++) {
+      REQUIRE(bls->load_block(height, *block_));
+      REQUIRE(other_exec->exec_commit_block(block_, state_.initial_height));
+    }
+    tendermint::abci::RequestDeliverTx req;
+    req.set_tx("extra=v");
+    other_app->deliver_tx_async(req);
+    auto res = other_app->commit_sync();
+    auto other_hash = noir::from_hex(noir::to_hex(res->data()));
+    auto other_h = handshaker::new_handshaker(bls, state_, dbs, ev_bus, nullptr);
+    CHECK(!other_h->replay_blocks(state_, other_hash, app_height, other_app));
+    // the hash the app reported is checked against the first replayed block, before it is executed
+    CHECK(other_h->n_blocks == 0);
+  }
+}
 } // namespace
@@ -0,0 +1,107 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/consensus/tx_commit_waiters.h>
+#include <thread>
+
+using namespace noir;
+using namespace noir::consensus;
+
+namespace {
+
+auto make_tx_result(const std::string& tx, int64_t height = 1) {
+  tendermint::abci::TxResult res;
+  res.set_tx(tx);
+  res.set_height(height);
+  return res;
+}
+
+auto hash_of(const std::string& tx) {
+  return get_tx_hash(Bytes(std::span(reinterpret_cast<const unsigned char*>(tx.data()), tx.size())));
+}
+
+} // namespace
+
+TEST_CASE("tx_commit_waiters: notify, expire and cancel", "[noir][consensus]") {
+  auto waiters = tx_commit_waiters(1'000'000);
+  std::vector<std::string> completed;
+  auto record = [&](const std::string& name) {
+    return [&completed, name](Result<tendermint::abci::TxResult> res) {
+      completed.push_back(res ? fmt::format("{}:{}", name, res.value().height()) : name + ":timeout");
+    };
+  };
+
+  auto now = get_time();
+  waiters.wait(hash_of("a"), now + 1000, record("a1"));
+  waiters.wait(hash_of("a"), now + 1000, record("a2"));
+  waiters.wait(hash_of("b"), now + 1000, record("b"));
+  auto c = waiters.wait(hash_of("c"), now + 1000, record("c"));
+  CHECK(waiters.size() == 4);
+
+  waiters.notify(make_tx_result("a", 7));
+  CHECK(completed == std::vector<std::string>{"a1:7", "a2:7"});
+  waiters.notify(make_tx_result("a", 8));
+  CHECK(completed.size() == 2);
+
+  CHECK(waiters.cancel(hash_of("c"), c));
+  CHECK(!waiters.cancel(hash_of("c"), c));
+
+  CHECK(waiters.expire(now + 999) == 0);
+  CHECK(waiters.expire(now + 1000) == 1);
+  CHECK(completed.back() == "b:timeout");
+  CHECK(waiters.size() == 0);
+
+  // late commits of expired txs are ignored
+  waiters.notify(make_tx_result("b"));
+  CHECK(completed.size() == 3);
+}
+
+TEST_CASE("tx_commit_waiters: load", "[noir][consensus]") {
+  constexpr int num_threads = 4;
+  constexpr int waiters_per_thread = 25'000;
+  auto waiters = tx_commit_waiters(10'000'000);
+  std::vector<std::atomic<int>> completions(num_threads * waiters_per_thread);
+  std::atomic<int> num_committed = 0, num_timed_out = 0;
+
+  auto now = get_time();
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (auto t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      for (auto i = t * waiters_per_thread; i < (t + 1) * waiters_per_thread; i++) {
+        waiters.wait(hash_of(std::to_string(i)), now + 1'000'000, [&, i](auto res) {
+          completions[i]++;
+          res ? num_committed++ : num_timed_out++;
+        });
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  auto registered = std::chrono::steady_clock::now();
+  CHECK(waiters.size() == num_threads * waiters_per_thread);
+
+  // txs of even waiters are committed while waiters of odd ones time out
+  std::thread notifier([&]() {
+    for (auto i = 0; i < num_threads * waiters_per_thread; i += 2) {
+      waiters.notify(make_tx_result(std::to_string(i)));
+    }
+  });
+  notifier.join();
+  auto notified = std::chrono::steady_clock::now();
+  CHECK(waiters.expire(now + 1'000'000) == num_threads * waiters_per_thread / 2);
+  auto expired = std::chrono::steady_clock::now();
+
+  CHECK(num_committed == num_threads * waiters_per_thread / 2);
+  CHECK(num_timed_out == num_threads * waiters_per_thread / 2);
+  CHECK(std::all_of(completions.begin(), completions.end(), [](const auto& n) { return n == 1; }));
+  CHECK(waiters.size() == 0);
+
+  auto ms = [](auto d) { return std::chrono::duration<double, std::milli>(d).count(); };
+  WARN(fmt::format("{} waiters: wait {:.1f}ms, notify {:.1f}ms, expire {:.1f}ms", num_threads * waiters_per_thread,
+    ms(registered - start), ms(notified - registered), ms(expired - notified)));
+}
@@ -0,0 +1,90 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+// Measures blocks delivered one tx at a time against blocks delivered in groups of txs not conflicting with each other,
+// on parallel_kvstore_app, and reports them as JSON, one line per number of threads.
+//
+// Txs write a key drawn from a key space, and some copy the value of another key. A small key space makes txs
+// conflict, and so groups small, showing how much of a block runs in parallel as txs contend for the same keys.
+#include <noir/application/parallel_kvstore_app.h>
+#include <noir/consensus/tx_schedule.h>
+#include <appbase/CLI11.hpp>
+#include <fmt/core.h>
+
+#include <iostream>
+#include <random>
+
+using namespace noir;
+using namespace noir::consensus;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+/// \return microseconds taken to deliver blocks
+template<typename F>
+int64_t measure(int num_blocks, F&& deliver_block) {
+  auto start = clock_type::now();
+  for (auto i = 0; i < num_blocks; i++)
+    deliver_block();
+  return std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  CLI::App cli{"Measures blocks delivered in groups of txs by the number of threads"};
+
+  std::vector<size_t> threads = {1, 2, 4, 8};
+  int num_txs = 2'000, num_blocks = 10, num_keys = 100'000, copy_percent = 30;
+  int64_t cost_us = 20;
+
+  cli.add_option("--threads", threads, "Numbers of threads to measure");
+  cli.add_option("--txs", num_txs, "Number of txs of a block");
+  cli.add_option("--blocks", num_blocks, "Number of blocks to deliver");
+  cli.add_option("--keys", num_keys, "Number of distinct keys txs write");
+  cli.add_option("--copy-percent", copy_percent, "Percentage of txs reading another key");
+  cli.add_option("--cost-us", cost_us, "Time a tx takes to run");
+  CLI11_PARSE(cli, argc, argv);
+
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> key_dist(0, num_keys - 1);
+  std::uniform_int_distribution<int> percent(0, 99);
+  std::vector<application::RequestDeliverTx> reqs(num_txs);
+  std::vector<tx_access> accesses;
+  application::parallel_kvstore_app checker(1);
+  for (auto i = 0; auto& req : reqs) {
+    auto k = key_dist(rng);
+    req.set_tx(percent(rng) < copy_percent ? fmt::format("k{}=@k{}", k, key_dist(rng)) : fmt::format("k{}={}", k, i++));
+    application::RequestCheckTx check_req;
+    check_req.set_tx(req.tx());
+    accesses.push_back(tx_access::from_check_tx(*checker.check_tx_sync(check_req)));
+  }
+
+  auto schedule_start = clock_type::now();
+  auto groups = schedule_tx_groups(accesses);
+  auto schedule_us =
+    std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - schedule_start).count();
+  if (groups.empty())
+    groups.assign(num_txs, 1);
+
+  auto cost = std::chrono::microseconds(cost_us);
+  application::parallel_kvstore_app sequential_app(1, cost);
+  auto sequential_us = measure(num_blocks, [&]() {
+    for (const auto& req : reqs)
+      sequential_app.deliver_tx_async(req);
+  });
+
+  for (auto n : threads) {
+    application::parallel_kvstore_app app(n, cost);
+    auto grouped_us = measure(num_blocks, [&]() { app.deliver_tx_groups(reqs, groups); });
+    std::cout << fmt::format(R"({{"threads": {}, "txs": {}, "groups": {}, "schedule_us": {}, "sequential_ms": {:.1f}, )"
+                             R"("grouped_ms": {:.1f}, "speedup": {:.2f}, "reruns": {}}})",
+                   n, num_txs, groups.size(), schedule_us, sequential_us / 1000.0 / num_blocks,
+                   grouped_us / 1000.0 / num_blocks, double(sequential_us) / grouped_us, app.num_reruns())
+              << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,107 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/application/parallel_kvstore_app.h>
+#include <noir/consensus/app_connection.h>
+#include <noir/consensus/tx_schedule.h>
+#include <fmt/core.h>
+#include <random>
+
+using namespace noir;
+using namespace noir::consensus;
+
+using groups = std::vector<uint32_t>;
+
+TEST_CASE("tx_schedule: groups of txs not conflicting", "[noir][consensus]") {
+  auto w = [](std::string k) { return tx_access{{}, {std::move(k)}}; };
+  auto rw = [](std::string r, std::string k) { return tx_access{{std::move(r)}, {std::move(k)}}; };
+
+  // disjoint writes make a single group
+  CHECK(schedule_tx_groups({w("a"), w("b"), w("c")}) == groups{3});
+
+  // a write to a key written or read before in the group, or a read of a key written before, starts a new group
+  CHECK((schedule_tx_groups({w("a"), w("b"), w("a"), w("c")}) == groups{2, 2}));
+  CHECK((schedule_tx_groups({rw("a", "b"), w("c"), w("a"), w("d")}) == groups{2, 2}));
+  CHECK((schedule_tx_groups({w("a"), w("b"), rw("b", "c"), w("d")}) == groups{2, 2}));
+  // reads of the same key don't conflict
+  CHECK(schedule_tx_groups({rw("a", "b"), rw("a", "c")}) == groups{2});
+
+  // a tx without declared keys is a group of its own
+  CHECK((schedule_tx_groups({w("a"), w("b"), {}, w("c"), w("d")}) == groups{2, 1, 2}));
+
+  // no hint if nothing runs in parallel
+  CHECK(schedule_tx_groups({}).empty());
+  CHECK(schedule_tx_groups({w("a"), w("a"), {}}).empty());
+
+  CHECK(valid_tx_groups({2, 1, 2}, 5));
+  CHECK(!valid_tx_groups({2, 1, 2}, 6));
+  CHECK(!valid_tx_groups({2, 0, 3}, 5));
+}
+
+TEST_CASE("tx_schedule: keys declared through CheckTx", "[noir][consensus]") {
+  app_connection proxy_app("parallel_kvstore");
+  auto access = [&](const std::string& s) {
+    tx tx_{s.begin(), s.end()};
+    auto res = proxy_app.check_tx_sync({tx_, check_tx_type::new_check});
+    REQUIRE(res);
+    return tx_access::from_check_tx(*res);
+  };
+  CHECK(access("a=1").read_keys.empty());
+  CHECK(access("a=1").write_keys == std::vector<std::string>{"a"});
+  CHECK(access("a=@b").read_keys == std::vector<std::string>{"b"});
+  CHECK(access("a=@b").write_keys == std::vector<std::string>{"a"});
+
+  // apps declaring no keys
+  app_connection kvstore("kvstore");
+  std::string s = "a=1";
+  tx tx_{s.begin(), s.end()};
+  CHECK(!kvstore.check_tx_sync({tx_, check_tx_type::new_check}));
+}
+
+TEST_CASE("tx_schedule: parallel_kvstore_app delivers groups as txs one by one", "[noir][consensus]") {
+  std::mt19937 rng(1);
+
+  // few keys make most txs conflict, and many keys make large groups
+  for (auto num_keys : {8, 1000}) {
+    auto key = [&]() { return fmt::format("k{}", std::uniform_int_distribution(0, num_keys - 1)(rng)); };
+    std::vector<application::RequestDeliverTx> reqs(500);
+    std::vector<tx_access> accesses;
+    application::parallel_kvstore_app checker(1);
+    for (auto i = 0; auto& req : reqs) {
+      auto k = key();
+      req.set_tx(i++ % 3 == 0 ? fmt::format("{}=@{}", k, key()) : fmt::format("{}={}", k, i));
+      application::RequestCheckTx check_req;
+      check_req.set_tx(req.tx());
+      accesses.push_back(tx_access::from_check_tx(*checker.check_tx_sync(check_req)));
+    }
+
+    application::parallel_kvstore_app expected(1);
+    for (const auto& req : reqs)
+      expected.deliver_tx_async(req);
+
+    auto check_same = [&](application::parallel_kvstore_app& app) {
+      REQUIRE(app.size() == expected.size());
+      for (auto i = 0; i < num_keys; i++) {
+        auto k = fmt::format("k{}", i);
+        CHECK(app.get(k) == expected.get(k));
+      }
+    };
+
+    // groups from declared keys never run a tx again
+    application::parallel_kvstore_app app(4);
+    auto tx_groups = schedule_tx_groups(accesses);
+    REQUIRE(valid_tx_groups(tx_groups, reqs.size()));
+    CHECK(app.deliver_tx_groups(reqs, tx_groups).size() == reqs.size());
+    check_same(app);
+    CHECK(app.num_reruns() == 0);
+
+    // wrong groups still give the same results, running conflicting txs again
+    application::parallel_kvstore_app wrong(4);
+    wrong.deliver_tx_groups(reqs, {uint32_t(reqs.size())});
+    check_same(wrong);
+    CHECK(wrong.num_reruns() > 0);
+  }
+}
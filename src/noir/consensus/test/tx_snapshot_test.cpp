@@ -0,0 +1,145 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/tx_pool/tx_snapshot.h>
+#include <atomic>
+#include <thread>
+
+using namespace noir;
+using namespace noir::consensus;
+using namespace noir::tx_pool;
+
+namespace {
+
+std::vector<std::shared_ptr<const tx>> make_txs(size_t count) {
+  std::vector<std::shared_ptr<const tx>> txs;
+  for (size_t i = 0; i < count; i++) {
+    auto s = "tx" + std::to_string(i);
+    txs.push_back(std::make_shared<const tx>(s.begin(), s.end()));
+  }
+  return txs;
+}
+
+std::vector<tx_hash> collect(const tx_snapshot& snapshot, uint64_t cursor, size_t page_size) {
+  std::vector<tx_hash> hashes;
+  do {
+    cursor = snapshot.for_each(cursor, page_size, [&](const auto& e) { hashes.push_back(e.hash); });
+  } while (cursor);
+  return hashes;
+}
+
+} // namespace
+
+TEST_CASE("tx_snapshot: Pagination", "[noir][consensus]") {
+  constexpr size_t tx_count = 1000; // spans several chunks
+  tx_snapshot_index index;
+  auto txs = make_txs(tx_count);
+  for (const auto& tx_ : txs)
+    index.add(get_tx_hash(*tx_), tx_);
+  index.publish();
+
+  auto snapshot = index.current();
+  CHECK(snapshot->size == tx_count);
+  CHECK(snapshot->chunks.size() > 1);
+
+  // pages of a snapshot are unaffected by txs removed later
+  for (size_t i = 0; i < tx_count / 2; i++)
+    CHECK(index.erase(get_tx_hash(*txs[i])));
+  CHECK(!index.erase(get_tx_hash(*txs[0])));
+  index.publish();
+  CHECK(index.current()->size == tx_count / 2);
+  CHECK(index.current()->epoch > snapshot->epoch);
+
+  auto hashes = collect(*snapshot, 0, 64);
+  REQUIRE(hashes.size() == tx_count);
+  for (size_t i = 0; i < tx_count; i++)
+    CHECK(hashes[i] == get_tx_hash(*txs[i]));
+
+  // cursors of an older snapshot stay valid on a newer one
+  auto cursor = snapshot->for_each(0, tx_count / 2 + 1, [](const auto&) {});
+  hashes = collect(*index.current(), cursor, tx_count);
+  REQUIRE(hashes.size() == tx_count / 2 - 1);
+  CHECK(hashes.front() == get_tx_hash(*txs[tx_count / 2 + 1]));
+
+  // nothing is republished without changes
+  auto epoch = index.current()->epoch;
+  index.publish();
+  CHECK(index.current()->epoch == epoch);
+
+  index.clear();
+  index.publish();
+  CHECK(index.current()->size == 0);
+  CHECK(index.current()->bytes == 0);
+  CHECK(index.current()->for_each(0, tx_count, [](const auto&) {}) == 0);
+  CHECK(snapshot->size == tx_count);
+}
+
+TEST_CASE("tx_snapshot: Underfull chunks are merged", "[noir][consensus]") {
+  constexpr size_t tx_count = 100 * tx_snapshot_index::chunk_size;
+  tx_snapshot_index index;
+  auto txs = make_txs(tx_count);
+  for (const auto& tx_ : txs)
+    index.add(get_tx_hash(*tx_), tx_);
+  CHECK(index.num_chunks() == 100);
+
+  // churn leaving a few txs of every chunk, published in between so that chunks are copied on write
+  std::vector<tx_hash> kept;
+  for (size_t i = 0; i < tx_count; i++) {
+    if (i % tx_snapshot_index::chunk_size < 8) {
+      kept.push_back(get_tx_hash(*txs[i]));
+      continue;
+    }
+    CHECK(index.erase(get_tx_hash(*txs[i])));
+    if (i % 100 == 0)
+      index.publish();
+  }
+  index.publish();
+  CHECK(index.current()->size == kept.size());
+  CHECK(index.num_chunks() <= 2 * kept.size() / (tx_snapshot_index::chunk_size / 2) + 1);
+  CHECK(index.current()->chunks.size() == index.num_chunks());
+  CHECK(collect(*index.current(), 0, 64) == kept);
+}
+
+TEST_CASE("tx_snapshot: Concurrent readers", "[noir][consensus]") {
+  tx_snapshot_index index;
+  auto txs = make_txs(2000);
+  std::atomic<bool> done{false};
+  std::atomic<bool> consistent{true};
+
+  // Catch assertions aren't thread-safe, so readers only flag what they saw
+  std::vector<std::thread> readers;
+  for (auto i = 0; i < 4; i++) {
+    readers.emplace_back([&]() {
+      while (!done.load()) {
+        auto snapshot = index.current();
+        size_t count = 0;
+        uint64_t bytes = 0, last_seq = 0;
+        snapshot->for_each(0, snapshot->size + 1, [&](const auto& e) {
+          if (e.seq <= last_seq)
+            consistent = false;
+          last_seq = e.seq;
+          bytes += e.tx->size();
+          count++;
+        });
+        if (count != snapshot->size || bytes != snapshot->bytes)
+          consistent = false;
+      }
+    });
+  }
+
+  // the index is written by a single thread, as the pool does under its mutex
+  for (size_t i = 0; i < txs.size(); i++) {
+    index.add(get_tx_hash(*txs[i]), txs[i]);
+    if (i % 3 == 2)
+      index.erase(get_tx_hash(*txs[i - 1]));
+    index.publish();
+  }
+  done = true;
+  for (auto& t : readers)
+    t.join();
+  CHECK(consistent);
+  CHECK(index.current()->size == txs.size() - txs.size() / 3);
+}
@@ -0,0 +1,84 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+// Measures how long a block received from a peer takes to be validated, by the number of validation threads, and
+// reports it as JSON, one line per number of threads.
+//
+// Blocks are decoded again before each measurement, so that hashes of txs and the last commit are computed as they
+// would be for a block just received, and every signature of the last commit is verified.
+#include <noir/consensus/block_executor.h>
+#include <noir/consensus/common_test.h>
+#include <appbase/CLI11.hpp>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+using namespace noir;
+using namespace noir::consensus;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+double percentile(const std::vector<double>& sorted, double p) {
+  return sorted[std::min<size_t>(sorted.size() - 1, sorted.size() * p)];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  CLI::App cli{"Measures validation latency of blocks by the number of validation threads"};
+
+  std::vector<uint32_t> threads = {0, 1, 2, 4, 8};
+  int num_vals = 150, num_txs = 10'000, tx_size = 250, num_blocks = 20;
+
+  cli.add_option("--threads", threads, "Numbers of validation threads to measure; 0 validates on the caller thread");
+  cli.add_option("--validators", num_vals, "Number of validators signing the last commit");
+  cli.add_option("--txs", num_txs, "Number of txs of a block");
+  cli.add_option("--tx-size", tx_size, "Size of a tx in bytes");
+  cli.add_option("--blocks", num_blocks, "Number of blocks to validate");
+  CLI11_PARSE(cli, argc, argv);
+
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> byte_dist(0, 255);
+  std::vector<tx> txs(num_txs);
+  for (auto& tx_ : txs) {
+    tx_.resize(tx_size);
+    std::generate(tx_.begin(), tx_.end(), [&]() { return byte_dist(rng); });
+  }
+
+  auto local_config = config_setup();
+  auto [state_, block_] = make_signed_block(local_config, num_vals, 2, txs);
+  auto encoded = block::to_proto(*block_);
+
+  auto session = make_session();
+  auto block_exec = block_executor::new_block_executor(std::make_shared<noir::consensus::db_store>(session),
+    std::make_shared<app_connection>(), std::make_shared<ev::empty_evidence_pool>(),
+    std::make_shared<noir::consensus::block_store>(session), std::make_shared<events::event_bus>(app));
+
+  for (auto n : threads) {
+    block_exec->set_validation_threads(n);
+    std::vector<double> latencies_ms;
+    for (auto i = 0; i < num_blocks; i++) {
+      auto received = block::from_proto(*encoded);
+      auto start = clock_type::now();
+      if (auto err = block_exec->check_block(state_, *received); err.has_value()) {
+        std::cerr << "invalid block: " << err.value() << std::endl;
+        return 1;
+      }
+      latencies_ms.push_back(std::chrono::duration<double, std::milli>(clock_type::now() - start).count());
+    }
+    std::sort(latencies_ms.begin(), latencies_ms.end());
+    std::cout << fmt::format(R"({{"threads": {}, "validators": {}, "txs": {}, "tx_size": {}, "p50_ms": {:.2f}, )"
+                             R"("p99_ms": {:.2f}, "mean_ms": {:.2f}}})",
+                   n, num_vals, num_txs, tx_size, percentile(latencies_ms, 0.5), percentile(latencies_ms, 0.99),
+                   std::accumulate(latencies_ms.begin(), latencies_ms.end(), 0.0) / latencies_ms.size())
+              << std::endl;
+  }
+  return 0;
+}
@@ -5,6 +5,7 @@
 //
 #pragma once
 #include <noir/p2p/protocol.h>
+#include <cstring>
 
 namespace noir::consensus {
 
@@ -24,6 +25,15 @@ static tx_hash get_tx_hash(const tx& tx) {
   return tx_hash{hash(tx)}; // FIXME
 }
 
+/// \brief hasher of tx_hash for unordered containers, taking its leading bytes as they are already uniformly spread
+struct tx_hash_hash {
+  size_t operator()(const tx_hash& hash) const {
+    size_t h;
+    std::memcpy(&h, hash.data(), sizeof(h));
+    return h;
+  }
+};
+
 struct wrapped_tx {
   // TODO : constructor
   address_type sender;
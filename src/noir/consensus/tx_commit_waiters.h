@@ -0,0 +1,130 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/common/expiry_wheel.h>
+#include <noir/consensus/tx.h>
+#include <noir/consensus/types/event_bus.h>
+#include <noir/core/result.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+
+namespace noir::consensus {
+
+/// \brief callbacks waiting for txs to be committed, keyed by tx hash
+/// A single event bus subscription serves all waiters, so a waiter costs a table entry rather than a subscription or
+/// a thread. Each waiter is completed exactly once, either with the result of its tx or with an error once its
+/// deadline passes; expire() must be called periodically for the latter.
+class tx_commit_waiters {
+public:
+  using callback = std::function<void(Result<tendermint::abci::TxResult>)>;
+
+  /// \param span deadlines are expected to be within span of now, e.g. the timeout of broadcast_tx_commit
+  explicit tx_commit_waiters(int64_t span = std::chrono::microseconds(std::chrono::seconds(60)).count())
+    : deadlines(span) {}
+
+  void subscribe(events::event_bus& bus) {
+    subscription = bus.subscribe("tx_commit_waiters", [this](const events::message& msg) {
+      if (auto data = std::get_if<events::event_data_tx>(&msg.data))
+        notify(data->tx_result);
+    });
+  }
+
+  /// \param deadline time in microseconds, as get_time()
+  /// \return id of the waiter, to be passed to cancel()
+  uint64_t wait(const tx_hash& hash, tstamp deadline, callback cb) {
+    std::scoped_lock g{mtx};
+    auto id = next_id++;
+    waiters[hash].push_back({id, std::move(cb)});
+    deadlines.add(deadline, {hash, id});
+    num_waiters++;
+    return id;
+  }
+
+  /// \brief removes a waiter without calling it, e.g. when its tx is rejected by check_tx
+  bool cancel(const tx_hash& hash, uint64_t id) {
+    std::scoped_lock g{mtx};
+    return take(hash, id).has_value();
+  }
+
+  /// \brief completes the waiters of a committed tx
+  void notify(const tendermint::abci::TxResult& tx_result) {
+    const auto& raw_tx = tx_result.tx();
+    auto hash = get_tx_hash(Bytes(std::span(reinterpret_cast<const unsigned char*>(raw_tx.data()), raw_tx.size())));
+    std::vector<waiter> done;
+    {
+      std::scoped_lock g{mtx};
+      auto it = waiters.find(hash);
+      if (it == waiters.end())
+        return;
+      done = std::move(it->second);
+      waiters.erase(it);
+      num_waiters -= done.size();
+    }
+    for (auto& w : done) {
+      w.cb(tx_result);
+    }
+  }
+
+  /// \brief fails waiters whose deadline is at or before now
+  /// \return number of waiters failed
+  size_t expire(tstamp now) {
+    std::vector<waiter> expired;
+    {
+      std::scoped_lock g{mtx};
+      deadlines.expire(now, [&](const auto& key) {
+        // waiters already completed or cancelled are no longer in the table
+        if (auto w = take(key.first, key.second))
+          expired.push_back(std::move(*w));
+      });
+    }
+    for (auto& w : expired) {
+      w.cb(Error("timed out waiting for tx to be included in a block"));
+    }
+    return expired.size();
+  }
+
+  size_t size() {
+    std::scoped_lock g{mtx};
+    return num_waiters;
+  }
+
+private:
+  struct waiter {
+    uint64_t id;
+    callback cb;
+  };
+
+  std::optional<waiter> take(const tx_hash& hash, uint64_t id) {
+    auto it = waiters.find(hash);
+    if (it == waiters.end())
+      return std::nullopt;
+    auto& list = it->second;
+    auto w = std::find_if(list.begin(), list.end(), [&](const auto& w) { return w.id == id; });
+    if (w == list.end())
+      return std::nullopt;
+    auto ret = std::move(*w);
+    list.erase(w);
+    if (list.empty())
+      waiters.erase(it);
+    num_waiters--;
+    return ret;
+  }
+
+  std::mutex mtx;
+  uint64_t next_id{0};
+  size_t num_waiters{0};
+  // waiters of the same tx are usually a single one, so a vector is cheaper than a nested map
+  std::unordered_map<tx_hash, std::vector<waiter>, tx_hash_hash> waiters;
+  expiry_wheel<std::pair<tx_hash, uint64_t>> deadlines;
+  events::event_bus::subscription subscription;
+};
+
+} // namespace noir::consensus
@@ -0,0 +1,60 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <noir/consensus/tx_schedule.h>
+#include <algorithm>
+#include <unordered_set>
+
+namespace noir::consensus {
+
+std::vector<uint32_t> schedule_tx_groups(const std::vector<tx_access>& accesses) {
+  std::vector<uint32_t> groups;
+  std::unordered_set<std::string_view> reads;
+  std::unordered_set<std::string_view> writes;
+  uint32_t size = 0;
+
+  auto close_group = [&]() {
+    if (size > 0)
+      groups.push_back(size);
+    size = 0;
+    reads.clear();
+    writes.clear();
+  };
+
+  for (const auto& a : accesses) {
+    if (!a.declared()) {
+      close_group();
+      groups.push_back(1);
+      continue;
+    }
+    auto conflicts = std::any_of(a.read_keys.begin(), a.read_keys.end(), [&](const auto& k) {
+      return writes.contains(k);
+    }) || std::any_of(a.write_keys.begin(), a.write_keys.end(), [&](const auto& k) {
+      return writes.contains(k) || reads.contains(k);
+    });
+    if (conflicts)
+      close_group();
+    reads.insert(a.read_keys.begin(), a.read_keys.end());
+    writes.insert(a.write_keys.begin(), a.write_keys.end());
+    size++;
+  }
+  close_group();
+
+  if (std::all_of(groups.begin(), groups.end(), [](auto n) { return n == 1; }))
+    return {};
+  return groups;
+}
+
+bool valid_tx_groups(const std::vector<uint32_t>& groups, size_t num_txs) {
+  size_t total = 0;
+  for (auto n : groups) {
+    if (n == 0)
+      return false;
+    total += n;
+  }
+  return total == num_txs;
+}
+
+} // namespace noir::consensus
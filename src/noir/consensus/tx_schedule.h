@@ -0,0 +1,38 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <tendermint/abci/types.pb.h>
+#include <string>
+#include <vector>
+
+namespace noir::consensus {
+
+/// \brief state keys a tx reads and writes, as declared by CheckTx
+struct tx_access {
+  std::vector<std::string> read_keys;
+  std::vector<std::string> write_keys;
+
+  /// \brief false if CheckTx declared no keys, in which case the tx conflicts with every other tx
+  bool declared() const {
+    return !read_keys.empty() || !write_keys.empty();
+  }
+
+  static tx_access from_check_tx(const tendermint::abci::ResponseCheckTx& res) {
+    return {{res.read_keys().begin(), res.read_keys().end()}, {res.write_keys().begin(), res.write_keys().end()}};
+  }
+};
+
+/// \brief splits txs into consecutive groups, in none of which a tx writes a key another tx of the group accesses
+/// Txs keep their order, so delivering groups one after another, and txs of a group in any order, gives the same
+/// results as delivering txs one by one. A tx without declared keys is a group of its own.
+/// \return sizes of the groups, or empty if no group has more than one tx
+std::vector<uint32_t> schedule_tx_groups(const std::vector<tx_access>& accesses);
+
+/// \brief checks that groups are non-empty and cover exactly num_txs txs
+/// Groups come from the proposer and aren't covered by the data hash, so they are checked before use.
+bool valid_tx_groups(const std::vector<uint32_t>& groups, size_t num_txs);
+
+} // namespace noir::consensus
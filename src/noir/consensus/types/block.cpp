@@ -5,14 +5,24 @@
 //
 #include <noir/codec/protobuf.h>
 #include <noir/common/log.h>
+#include <noir/common/reed_solomon.h>
+#include <noir/common/thread_pool.h>
 #include <noir/consensus/types/block.h>
 #include <noir/consensus/types/encoding_helper.h>
 #include <noir/consensus/types/evidence.h>
 #include <noir/consensus/types/vote.h>
+#include <noir/consensus/types/wire.h>
 #include <fmt/core.h>
 
 namespace noir::consensus {
 
+namespace {
+
+  /// coded block bytes start with a zero, which a serialized block never does, and their size in little endian
+  constexpr size_t coded_prefix_size = 1 + sizeof(uint64_t);
+
+} // namespace
+
 std::shared_ptr<vote> commit::get_vote(int32_t val_idx) {
   auto& commit_sig = signatures[val_idx];
   auto ret = std::make_shared<vote>();
@@ -46,46 +56,99 @@ std::shared_ptr<vote_set> commit_to_vote_set(
   return std::move(vote_set_);
 }
 
+namespace {
+
+using codec::protobuf::wire_writer;
+
+/// scratch buffer large enough for a leaf of a well formed header or commit; larger ones are encoded on the heap
+using leaf_buffer = std::array<unsigned char, 256>;
+
+} // namespace
+
 Bytes commit::get_hash() {
   if (hash.empty()) {
-    merkle::bytes_list items;
-    for (const auto& sig : signatures) {
-      auto pb = commit_sig::to_proto(sig);
-      auto bz = codec::protobuf::encode(*pb);
-      items.push_back(bz);
+    crypto::Sha256 sha;
+    std::vector<merkle::digest> leaves(signatures.size());
+    for (auto i = 0; i < signatures.size(); i++) {
+      leaf_buffer buf;
+      if (auto size = wire::encode(signatures[i], buf); size) {
+        leaves[i] = merkle::leaf_hash(sha, std::span(buf).first(*size));
+      } else {
+        auto bz = wire::encode(signatures[i]);
+        leaves[i] = merkle::leaf_hash(sha, bz);
+      }
     }
-    hash = merkle::hash_from_bytes_list(items);
+    auto root = merkle::hash_from_leaf_hashes(sha, leaves);
+    hash = Bytes{root.begin(), root.end()};
   }
   return hash;
 }
 
-std::shared_ptr<part_set> part_set::new_part_set_from_header(const p2p::part_set_header& header) {
+std::shared_ptr<part_set> part_set::new_part_set_from_header(
+  const p2p::part_set_header& header, uint32_t parity_percent) {
   std::vector<std::shared_ptr<part>> parts_;
   parts_.resize(header.total);
   auto ret = std::make_shared<part_set>();
   ret->total = header.total;
   ret->hash = header.hash;
+  ret->data_parts = header.total;
+  // a set of k data parts has total = k + num_parity_parts(k), which grows with k
+  for (uint32_t k = header.total; parity_percent && k > 0; k--) {
+    if (k + num_parity_parts(k, parity_percent) == header.total) {
+      ret->data_parts = k;
+      break;
+    }
+  }
   ret->parts = parts_;
   ret->parts_bit_array = bit_array::new_bit_array(header.total);
   ret->count = 0;
   ret->byte_size = 0;
+  ret->num_sent.resize(header.total);
   return ret;
 }
 
-std::shared_ptr<part_set> part_set::new_part_set_from_data(const Bytes& data, uint32_t part_size) {
-  // Divide data into 4KB parts
-  uint32_t total = (data.size() + part_size - 1) / part_size;
+std::shared_ptr<part_set> part_set::new_part_set_from_data(
+  const Bytes& data, uint32_t part_size, uint32_t parity_percent) {
+  std::vector<Bytes> parts_bytes;
+  uint32_t data_parts;
+  int64_t byte_size;
+  if (!parity_percent) {
+    // Divide data into 4KB parts
+    data_parts = (data.size() + part_size - 1) / part_size;
+    for (auto i = 0; i < data_parts; i++) {
+      auto first = data.begin() + (i * part_size);
+      auto last = data.begin() + (std::min((uint32_t)data.size(), (i + 1) * part_size));
+      auto& bz = parts_bytes.emplace_back();
+      std::copy(first, last, std::back_inserter(bz.raw()));
+    }
+    byte_size = data.size();
+  } else {
+    Bytes framed(coded_prefix_size + data.size());
+    for (size_t i = 0; i < sizeof(uint64_t); i++)
+      framed[1 + i] = static_cast<uint64_t>(data.size()) >> (8 * i);
+    std::copy(data.begin(), data.end(), framed.begin() + coded_prefix_size);
+
+    // parts of a large block grow beyond part_size, as a Reed-Solomon code has 256 parts at most
+    data_parts = (framed.size() + part_size - 1) / part_size;
+    while (data_parts > 1 && data_parts + num_parity_parts(data_parts, parity_percent) > reed_solomon::max_shards)
+      data_parts--;
+    auto shard_size = (framed.size() + data_parts - 1) / data_parts;
+    framed.raw().resize(data_parts * shard_size);
+    for (auto i = 0; i < data_parts; i++)
+      parts_bytes.emplace_back(std::span(framed.data() + i * shard_size, shard_size));
+    auto parity = reed_solomon::encode(parts_bytes, num_parity_parts(data_parts, parity_percent));
+    std::move(parity.begin(), parity.end(), std::back_inserter(parts_bytes));
+    byte_size = framed.size();
+  }
+
+  uint32_t total = parts_bytes.size();
   std::vector<std::shared_ptr<part>> parts(total);
-  std::vector<Bytes> parts_bytes(total);
   auto parts_bit_array = bit_array::new_bit_array(total);
   for (auto i = 0; i < total; i++) {
-    auto first = data.begin() + (i * part_size);
-    auto last = data.begin() + (std::min((uint32_t)data.size(), (i + 1) * part_size));
     auto part_ = std::make_shared<part>();
     part_->index = i;
-    std::copy(first, last, std::back_inserter(part_->bytes_.raw()));
+    part_->bytes_ = parts_bytes[i];
     parts[i] = part_;
-    parts_bytes[i] = part_->bytes_;
     parts_bit_array->set_index(i, true);
   }
 
@@ -98,16 +161,38 @@ std::shared_ptr<part_set> part_set::new_part_set_from_data(const Bytes& data, ui
   auto ret = std::make_shared<part_set>();
   ret->total = total;
   ret->hash = root;
+  ret->data_parts = data_parts;
   ret->parts = parts;
   ret->parts_bit_array = parts_bit_array;
   ret->count = total;
-  ret->byte_size = data.size();
+  ret->byte_size = byte_size;
+  ret->num_sent.resize(total);
   return ret;
 }
 
+uint32_t part_set::num_parity_parts(uint32_t data_parts, uint32_t parity_percent) {
+  if (!parity_percent)
+    return 0;
+  return std::max<uint32_t>(1, (uint64_t(data_parts) * parity_percent + 99) / 100);
+}
+
+Bytes part_set::unframe(Bytes bz) {
+  if (bz.size() < coded_prefix_size || bz[0] != 0)
+    return bz;
+  uint64_t size = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); i++)
+    size |= uint64_t(bz[1 + i]) << (8 * i);
+  if (size > bz.size() - coded_prefix_size)
+    return {};
+  return {std::span(bz.data() + coded_prefix_size, size)};
+}
+
 bool part_set::add_part(std::shared_ptr<part> part_) {
   std::scoped_lock g(mtx);
 
+  if (invalid)
+    return false;
+
   if (part_->index >= total) {
     elog("error part set unexpected index");
     return false;
@@ -130,53 +215,195 @@ bool part_set::add_part(std::shared_ptr<part> part_) {
   parts_bit_array->set_index(part_->index, true);
   count++;
   byte_size += part_->bytes_.size();
+
+  // Any data_parts parts of a coded set rebuild the rest. Rebuilding also checks that the parts are one code, as a
+  // proposer may commit to parity parts which other sets of data_parts parts would decode to another block
+  if (is_coded() && count == data_parts && !reconstruct()) {
+    elog("error part set parts are not one code");
+    invalid = true;
+  }
   return true;
 }
 
+bool part_set::reconstruct() {
+  std::vector<Bytes> shards(total);
+  std::optional<size_t> shard_size;
+  for (auto i = 0; i < total; i++) {
+    if (!parts[i])
+      continue;
+    if (shard_size && *shard_size != parts[i]->bytes_.size()) {
+      elog("error part set parts of different sizes");
+      return false;
+    }
+    shard_size = parts[i]->bytes_.size();
+    shards[i] = parts[i]->bytes_;
+  }
+  if (!shard_size || !*shard_size || !reed_solomon::reconstruct(shards, data_parts))
+    return false;
+
+  // Parts rebuilt are only taken if all of them are the ones committed to by the merkle root
+  auto [root, proofs] = merkle::proofs_from_bytes_list(shards);
+  if (root != hash) {
+    elog("error part set parts rebuilt don't match the merkle root");
+    return false;
+  }
+  for (auto i = 0; i < total; i++) {
+    if (parts[i])
+      continue;
+    parts[i] = std::make_shared<part>(part{static_cast<uint32_t>(i), std::move(shards[i]), *proofs[i]});
+    parts_bit_array->set_index(i, true);
+  }
+  count = total;
+  byte_size = int64_t(data_parts) * *shard_size;
+  return true;
+}
+
+std::optional<uint32_t> part_set::pick_part_to_send(const std::shared_ptr<bit_array>& peer_parts) {
+  std::scoped_lock g(mtx);
+  std::vector<uint32_t> candidates;
+  uint32_t peer_count = 0;
+  for (uint32_t i = 0; i < total; i++) {
+    if (peer_parts->get_index(i))
+      peer_count++;
+    else if (parts[i])
+      candidates.push_back(i);
+  }
+  if (candidates.empty() || (is_coded() && peer_count >= data_parts))
+    return {};
+
+  auto least = num_sent[*std::min_element(
+    candidates.begin(), candidates.end(), [&](auto a, auto b) { return num_sent[a] < num_sent[b]; })];
+  std::erase_if(candidates, [&](auto i) { return num_sent[i] > least; });
+  static thread_local std::mt19937 rng{std::random_device{}()};
+  auto index = candidates[std::uniform_int_distribution<size_t>(0, candidates.size() - 1)(rng)];
+  num_sent[index]++;
+  return index;
+}
+
+Bytes part_set::get_data() {
+  std::scoped_lock g(mtx);
+  if (count != total)
+    return {};
+  Bytes bz;
+  bz.raw().reserve(byte_size);
+  for (auto i = 0; i < data_parts; i++)
+    std::copy(parts[i]->bytes_.begin(), parts[i]->bytes_.end(), std::back_inserter(bz.raw()));
+  return unframe(std::move(bz));
+}
+
 Bytes part_set::get_hash() {
   if (this == nullptr) ///< NOT a very nice way of coding; need to refactor later
     return merkle::hash_from_bytes_list({});
   return hash;
 }
 
-Bytes block_data::get_hash() {
+Bytes block_data::get_hash(boost::asio::io_context* thread_pool, size_t num_tasks) {
   if (this == nullptr) ///< NOT a very nice way of coding; need to refactor later
     return merkle::hash_from_bytes_list({});
   if (hash.empty()) {
-    merkle::bytes_list items;
-    for (const auto& tx : txs)
-      items.push_back(crypto::Sha256()(tx));
-    hash = merkle::hash_from_bytes_list(items);
+    std::vector<merkle::digest> leaves(txs.size());
+    auto hash_leaves = [&](size_t begin, size_t end) {
+      crypto::Sha256 sha;
+      for (auto i = begin; i < end; i++) {
+        merkle::digest tx_hash;
+        sha.init().update(txs[i]).final(std::span<unsigned char>(tx_hash));
+        leaves[i] = merkle::leaf_hash(sha, tx_hash);
+      }
+    };
+    if (thread_pool)
+      parallel_for(*thread_pool, txs.size(), num_tasks, hash_leaves);
+    else
+      hash_leaves(0, txs.size());
+    crypto::Sha256 sha;
+    auto root = merkle::hash_from_leaf_hashes(sha, leaves);
+    hash = Bytes{root.begin(), root.end()};
   }
   return hash;
 }
 
 Bytes block_header::get_hash() {
+  if (sealed_hash)
+    return *sealed_hash;
+  return compute_hash();
+}
+
+Bytes block_header::compute_hash() const {
   if (validators_hash.empty())
     return {};
 
-  auto pb_v = consensus_version::to_proto(version);
-  auto bz_v = codec::protobuf::encode(*pb_v);
-
-  auto pb_lbi = p2p::block_id::to_proto(last_block_id);
-  auto bz_lbi = codec::protobuf::encode(*pb_lbi);
-
-  merkle::bytes_list items;
-  items.push_back(bz_v);
-  items.push_back(cdc_encode(chain_id));
-  items.push_back(cdc_encode(height));
-  items.push_back(cdc_encode_time(time));
-  items.push_back(bz_lbi);
-  items.push_back(cdc_encode(last_commit_hash));
-  items.push_back(cdc_encode(data_hash));
-  items.push_back(cdc_encode(validators_hash));
-  items.push_back(cdc_encode(next_validators_hash));
-  items.push_back(cdc_encode(consensus_hash));
-  items.push_back(cdc_encode(app_hash));
-  items.push_back(cdc_encode(last_results_hash));
-  items.push_back(cdc_encode(evidence_hash));
-  items.push_back(cdc_encode(proposer_address));
-  return merkle::hash_from_bytes_list(items);
+  // Each field is encoded straight into a stack buffer as the corresponding protobuf message would be, and hashed as a
+  // merkle leaf; see cdc_encode for the wrapper types used.
+  crypto::Sha256 sha;
+  std::array<merkle::digest, 14> leaves;
+  auto leaf = [&](size_t i, auto&& encode, auto&& fallback) {
+    leaf_buffer buf;
+    wire_writer w(buf);
+    if (encode(w) && !w.overflow()) {
+      leaves[i] = merkle::leaf_hash(sha, w.data());
+    } else {
+      auto bz = fallback();
+      leaves[i] = merkle::leaf_hash(sha, bz);
+    }
+  };
+  auto bytes_leaf = [&](size_t i, const Bytes& v) {
+    leaf(
+      i,
+      [&](wire_writer& w) {
+        w.bytes_field(1, v);
+        return true;
+      },
+      [&]() { return cdc_encode(v); });
+  };
+
+  leaf(
+    0,
+    [&](wire_writer& w) {
+      wire::write(w, version);
+      return true;
+    },
+    [&]() { return wire::encode(version); });
+  leaf(
+    1,
+    [&](wire_writer& w) {
+      w.bytes_field(1, chain_id);
+      return true;
+    },
+    [&]() { return cdc_encode(chain_id); });
+  leaf(
+    2,
+    [&](wire_writer& w) {
+      w.int_field(1, height);
+      return true;
+    },
+    [&]() { return cdc_encode(height); });
+  leaf(
+    3,
+    [&](wire_writer& w) {
+      // same as cdc_encode_time, which doesn't normalize negative nanos
+      w.int_field(1, time / 1'000'000);
+      w.int_field(2, static_cast<int32_t>((time % 1'000'000) * 1'000));
+      return true;
+    },
+    [&]() { return cdc_encode_time(time); });
+  leaf(
+    4,
+    [&](wire_writer& w) {
+      wire::write(w, last_block_id);
+      return true;
+    },
+    [&]() { return wire::encode(last_block_id); });
+  bytes_leaf(5, last_commit_hash);
+  bytes_leaf(6, data_hash);
+  bytes_leaf(7, validators_hash);
+  bytes_leaf(8, next_validators_hash);
+  bytes_leaf(9, consensus_hash);
+  bytes_leaf(10, app_hash);
+  bytes_leaf(11, last_results_hash);
+  bytes_leaf(12, evidence_hash);
+  bytes_leaf(13, proposer_address);
+
+  auto root = merkle::hash_from_leaf_hashes(sha, leaves);
+  return {root.begin(), root.end()};
 }
 
 Bytes evidence_data::get_hash() {
@@ -210,17 +437,14 @@ Result<std::shared_ptr<evidence_data>> evidence_data::from_proto(const ::tenderm
 std::shared_ptr<block> block::new_block_from_part_set(const std::shared_ptr<part_set>& ps) {
   if (!ps->is_complete())
     return {};
-  Bytes bz;
-  bz.raw().reserve(ps->byte_size);
-  for (const auto& p : ps->parts)
-    std::copy(p->bytes_.begin(), p->bytes_.end(), std::back_inserter(bz.raw()));
+  auto bz = ps->get_data();
   return block::from_proto(codec::protobuf::decode<::tendermint::types::Block>(bz));
 }
 
-std::shared_ptr<part_set> block::make_part_set(uint32_t part_size) {
+std::shared_ptr<part_set> block::make_part_set(uint32_t part_size, uint32_t parity_percent) {
   std::scoped_lock g(mtx);
   auto bz = codec::protobuf::encode(*block::to_proto(*this));
-  return part_set::new_part_set_from_data(bz, part_size);
+  return part_set::new_part_set_from_data(bz, part_size, parity_percent);
 }
 
 std::unique_ptr<::tendermint::types::Block> block::to_proto(const block& b) {
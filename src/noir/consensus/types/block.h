@@ -20,8 +20,13 @@
 #include <fmt/core.h>
 
 #include <memory>
+#include <optional>
 #include <utility>
 
+namespace boost::asio {
+class io_context;
+}
+
 namespace noir::consensus {
 
 constexpr int64_t max_header_bytes{626};
@@ -205,28 +210,48 @@ struct part {
   merkle::proof proof_;
 };
 
+/// \brief parts of a serialized block, each of which is verified against the merkle root of all parts
+/// With a parity percent, the block is erasure coded: the first data_parts parts carry the block, padded and prefixed
+/// by its size, and the rest carry Reed-Solomon parity, so that any data_parts parts rebuild all of them. The merkle
+/// root covers coded parts, so the parity percent is a consensus param. Rebuilding the rest once data_parts parts
+/// arrive also checks that all parts are one code.
 struct part_set {
   uint32_t total{};
   Bytes hash{};
+  uint32_t data_parts{};
 
   std::vector<std::shared_ptr<part>> parts{};
   std::shared_ptr<bit_array> parts_bit_array{};
   uint32_t count{};
   int64_t byte_size{};
+  std::vector<uint32_t> num_sent{}; ///< number of times each part is picked to be sent to peers
+  /// set once parts of a coded set, each proven by the merkle root, are not one code, so that the proposal is invalid
+  bool invalid{};
   std::mutex mtx;
 
   part_set() = default;
   part_set(const part_set& p)
     : total(p.total),
       hash(p.hash),
+      data_parts(p.data_parts),
       parts(p.parts),
       parts_bit_array(p.parts_bit_array),
       count(p.count),
-      byte_size(p.byte_size) {}
+      byte_size(p.byte_size),
+      num_sent(p.num_sent),
+      invalid(p.invalid) {}
+
+  static std::shared_ptr<part_set> new_part_set_from_header(
+    const p2p::part_set_header& header, uint32_t parity_percent = 0);
 
-  static std::shared_ptr<part_set> new_part_set_from_header(const p2p::part_set_header& header);
+  static std::shared_ptr<part_set> new_part_set_from_data(
+    const Bytes& data, uint32_t part_size, uint32_t parity_percent = 0);
 
-  static std::shared_ptr<part_set> new_part_set_from_data(const Bytes& data, uint32_t part_size);
+  /// \return number of parity parts added to data_parts parts
+  static uint32_t num_parity_parts(uint32_t data_parts, uint32_t parity_percent);
+
+  /// \return bytes of a block from bytes of its parts concatenated in order, without framing of coded sets
+  static Bytes unframe(Bytes bz);
 
   bool add_part(std::shared_ptr<part> part_);
 
@@ -234,6 +259,10 @@ struct part_set {
     return count == total;
   }
 
+  bool is_coded() const {
+    return data_parts < total;
+  }
+
   p2p::part_set_header header() {
     return p2p::part_set_header{total, hash};
   }
@@ -254,20 +283,37 @@ struct part_set {
     return parts_bit_array;
   }
 
+  /// \brief picks a part missing at a peer, preferring ones sent to fewer peers so that peers get distinct parts
+  /// \return nothing if the peer has all parts, or as many as data_parts of a coded set
+  std::optional<uint32_t> pick_part_to_send(const std::shared_ptr<bit_array>& peer_parts);
+
+  /// \return bytes of the block carried by a complete set
+  Bytes get_data();
+
   Bytes get_hash();
+
+private:
+  /// \brief rebuilds all parts of a coded set from data_parts of them
+  /// \return false if the parts rebuilt are not the ones committed to by the merkle root
+  bool reconstruct();
 };
 
 struct block_data {
   std::vector<tx> txs;
   Bytes hash; // may continuously change
+  /// sizes of consecutive groups of txs not conflicting with each other, empty if the proposer gave no hint;
+  /// not covered by hash, see tx_schedule.h
+  std::vector<uint32_t> tx_groups;
 
-  Bytes get_hash();
+  /// \param[in] thread_pool txs are hashed in num_tasks batches on it, if given
+  Bytes get_hash(boost::asio::io_context* thread_pool = nullptr, size_t num_tasks = 1);
 
   static std::unique_ptr<::tendermint::types::Data> to_proto(const block_data& b) {
     auto ret = std::make_unique<::tendermint::types::Data>();
     auto pb_txs = ret->mutable_txs();
     for (const auto& tx : b.txs)
       pb_txs->Add({tx.begin(), tx.end()});
+    ret->mutable_tx_groups()->Add(b.tx_groups.begin(), b.tx_groups.end());
     return ret;
   }
 
@@ -276,6 +322,7 @@ struct block_data {
     auto pb_txs = pb.txs();
     for (const auto& tx : pb_txs)
       ret->txs.push_back({tx.begin(), tx.end()});
+    ret->tx_groups = {pb.tx_groups().begin(), pb.tx_groups().end()};
     return ret;
   }
 };
@@ -303,8 +350,17 @@ struct block_header {
   Bytes evidence_hash;
   Bytes proposer_address; // todo - use address type?
 
+  /// \brief hash computed by seal(); shared by copies of a sealed header
+  /// \note NOT to be serialized; fields must not be changed once sealed
+  std::shared_ptr<const Bytes> sealed_hash{};
+
   Bytes get_hash();
 
+  /// \brief computes and caches the hash of a header that is not going to change, e.g. decoded from peers or store
+  void seal() {
+    sealed_hash = std::make_shared<const Bytes>(compute_hash());
+  }
+
   void populate(consensus::consensus_version& version_,
     std::string& chain_id_,
     tstamp timestamp_,
@@ -325,6 +381,7 @@ struct block_header {
     app_hash = app_hash_;
     last_results_hash = last_results_hash_;
     proposer_address = proposer_address_;
+    sealed_hash.reset();
   }
 
   std::optional<std::string> validate_basic() {
@@ -414,9 +471,13 @@ struct block_header {
     ret->proposer_address = {pb.proposer_address().begin(), pb.proposer_address().end()};
 
     ret->validate_basic(); // TODO
+    ret->seal();
 
     return ret;
   }
+
+private:
+  Bytes compute_hash() const;
 };
 
 struct evidence_list;
@@ -495,12 +556,21 @@ struct block {
   }
 
   void fill_header() {
-    if (header.last_commit_hash.empty() && last_commit)
+    auto filled = false;
+    if (header.last_commit_hash.empty() && last_commit) {
       header.last_commit_hash = last_commit->get_hash();
-    if (header.data_hash.empty())
+      filled = true;
+    }
+    if (header.data_hash.empty()) {
       header.data_hash = data.get_hash();
-    if (header.evidence_hash.empty())
+      filled = true;
+    }
+    if (header.evidence_hash.empty()) {
       header.evidence_hash = evidence.get_hash();
+      filled = true;
+    }
+    if (filled)
+      header.sealed_hash.reset();
   }
 
   static std::shared_ptr<block> make_block(int64_t height,
@@ -520,7 +590,7 @@ struct block {
    * returns a part_set containing parts of a serialized block.
    * This is the form in which a block is gossipped to peers.
    */
-  std::shared_ptr<part_set> make_part_set(uint32_t part_size);
+  std::shared_ptr<part_set> make_part_set(uint32_t part_size, uint32_t parity_percent = 0);
 
   Bytes get_hash() {
     if (this == nullptr)
@@ -12,14 +12,131 @@
 #include <fc/variant_object.hpp>
 #include <fmt/core.h>
 
+#include <cctype>
 #include <ctime>
+#include <map>
 
 namespace noir::consensus {
 
+namespace {
+
+/// \brief locates the raw value of each top-level member of a JSON object without parsing it
+/// \note values are only delimited here; those actually read are validated when parsed by fc::json
+class json_object_scanner {
+public:
+  explicit json_object_scanner(std::string_view doc): doc(doc) {}
+
+  Result<std::map<std::string, std::string_view>> scan() {
+    std::map<std::string, std::string_view> members;
+    skip_ws();
+    if (!consume('{'))
+      return Error::format("expected '{{' at offset {}", pos);
+    skip_ws();
+    if (consume('}'))
+      return members;
+    while (true) {
+      skip_ws();
+      auto key_begin = pos;
+      if (!skip_string())
+        return Error::format("expected member name at offset {}", key_begin);
+      auto key = doc.substr(key_begin + 1, pos - key_begin - 2);
+      skip_ws();
+      if (!consume(':'))
+        return Error::format("expected ':' at offset {}", pos);
+      skip_ws();
+      auto value_begin = pos;
+      if (!skip_value())
+        return Error::format("malformed value of {} at offset {}", key, value_begin);
+      members[std::string(key)] = doc.substr(value_begin, pos - value_begin);
+      skip_ws();
+      if (consume(','))
+        continue;
+      if (consume('}'))
+        return members;
+      return Error::format("expected ',' or '}}' at offset {}", pos);
+    }
+  }
+
+private:
+  void skip_ws() {
+    while (pos < doc.size() && std::isspace(static_cast<unsigned char>(doc[pos])))
+      ++pos;
+  }
+
+  bool consume(char c) {
+    if (pos < doc.size() && doc[pos] == c) {
+      ++pos;
+      return true;
+    }
+    return false;
+  }
+
+  bool skip_string() {
+    if (!consume('"'))
+      return false;
+    while (pos < doc.size()) {
+      auto c = doc[pos++];
+      if (c == '\\')
+        ++pos;
+      else if (c == '"')
+        return true;
+    }
+    return false;
+  }
+
+  // containers are skipped iteratively so that a deeply nested app_state cannot exhaust the stack
+  bool skip_value() {
+    size_t depth = 0;
+    do {
+      if (pos >= doc.size())
+        return false;
+      auto c = doc[pos];
+      if (c == '"') {
+        if (!skip_string())
+          return false;
+      } else if (c == '{' || c == '[') {
+        ++depth;
+        ++pos;
+      } else if (c == '}' || c == ']') {
+        if (depth == 0)
+          return false;
+        --depth;
+        ++pos;
+      } else if (depth > 0) {
+        ++pos;
+      } else {
+        auto begin = pos;
+        while (pos < doc.size() && doc[pos] != ',' && doc[pos] != '}' &&
+          !std::isspace(static_cast<unsigned char>(doc[pos])))
+          ++pos;
+        return pos > begin;
+      }
+    } while (depth > 0);
+    return true;
+  }
+
+  std::string_view doc;
+  size_t pos{0};
+};
+
+} // namespace
+
 Result<std::shared_ptr<genesis_doc>> genesis_doc::genesis_doc_from_file(const std::string& gen_doc_file) {
   auto gen_doc = std::make_shared<genesis_doc>();
+  auto file = mapped_file::open(gen_doc_file);
+  if (!file)
+    return Error::format("error reading genesis from {}: {}", gen_doc_file, file.error());
+  auto members = json_object_scanner(file.value()->view()).scan();
+  if (!members)
+    return Error::format("error reading genesis from {}: {}", gen_doc_file, members.error());
   try {
-    fc::variant obj = fc::json::from_file(gen_doc_file);
+    // everything but app_state is small, so it's parsed as usual
+    fc::mutable_variant_object mvo;
+    for (const auto& [key, value] : members.value()) {
+      if (key != "app_state")
+        mvo(key, fc::json::from_string(std::string(value)));
+    }
+    fc::variant obj(std::move(mvo));
     fc::from_variant(obj, *gen_doc);
     std::string dt;
     fc::from_variant(obj["genesis_time"], dt);
@@ -49,15 +166,15 @@ Result<std::shared_ptr<genesis_doc>> genesis_doc::genesis_doc_from_file(const st
     } catch (std::exception const& ex) {
       dlog("genesis.json: missing consensus_params");
     }
-    try {
-      auto app_state_str = fc::json::to_string(obj["app_state"], fc::json::yield_function_t());
-      gen_doc->app_state = {app_state_str.begin(), app_state_str.end()};
-    } catch (std::exception const& ex) {
-      dlog("genesis.json: missing app_state");
-    }
   } catch (std::exception const& ex) {
     return Error::format("error reading genesis from {}: {}", gen_doc_file, ex.what());
   }
+  if (auto it = members->find("app_state"); it != members->end()) {
+    gen_doc->app_state_view = it->second;
+    gen_doc->app_state_file = file.value();
+  } else {
+    dlog("genesis.json: missing app_state");
+  }
   return gen_doc;
 }
 
@@ -143,7 +260,7 @@ void genesis_doc::save(const std::string& file_path) {
   json_obj.consensus_params = cs_params.value();
 
   json_obj.app_hash = to_string(app_hash);
-  json_obj.app_state = to_string(app_state);
+  json_obj.app_state = to_hex(get_app_state());
 
   fc::variant vo;
   fc::to_variant<json::genesis_json_obj>(json_obj, vo);
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 #pragma once
+#include <noir/common/mapped_file.h>
 #include <noir/common/refl.h>
 #include <noir/consensus/crypto.h>
 #include <noir/consensus/protocol.h>
@@ -54,6 +55,17 @@ struct genesis_doc {
   Bytes app_hash;
   Bytes app_state;
 
+  /// \brief app_state of a genesis loaded from file; a range of the mapped file that is passed to the app as is
+  std::string_view app_state_view;
+  std::shared_ptr<mapped_file> app_state_file; ///< keeps app_state_view valid
+
+  std::string_view get_app_state() const {
+    if (app_state_file)
+      return app_state_view;
+    return {reinterpret_cast<const char*>(app_state.data()), app_state.size()};
+  }
+
+  /// \brief loads genesis from a file without parsing app_state, which may be several GBs for exported chains
   static Result<std::shared_ptr<genesis_doc>> genesis_doc_from_file(const std::string& gen_doc_file);
 
   void save(const std::string& file_path);
@@ -5,8 +5,10 @@
 //
 #pragma once
 #include <noir/codec/protobuf.h>
+#include <noir/common/check.h>
 #include <noir/crypto/hash.h>
 #include <noir/p2p/types.h>
+#include <fc/variant_object.hpp>
 #include <tendermint/types/params.pb.h>
 
 #include <google/protobuf/util/time_util.h>
@@ -19,9 +21,12 @@ constexpr int64_t max_block_size_bytes{104857600};
 struct block_params {
   int64_t max_bytes;
   int64_t max_gas;
+  /// erasure codes proposal block parts with this many parity parts per hundred data parts; 0 disables
+  /// a consensus parameter, as the merkle root of a proposal covers coded parts
+  uint32_t part_parity_percent{};
 
   static block_params get_default() {
-    return block_params{22020096, -1};
+    return block_params{22020096, -1, 0};
   }
 };
 
@@ -64,6 +69,8 @@ struct consensus_params {
       return "block.MaxBytes is too big.";
     if (block.max_gas < -1)
       return "block.MaxGas must be greater or equal to -1.";
+    if (block.part_parity_percent > 100)
+      return "block.PartParityPercent must be at most 100.";
     // check evidence // todo - necessary?
     // if (validator.pub_key_types.empty())
     //  return "validator.pub_key_types must not be empty.";
@@ -80,6 +87,7 @@ struct consensus_params {
     ::tendermint::types::HashedParams pb;
     pb.set_block_max_bytes(block.max_bytes);
     pb.set_block_max_gas(block.max_gas);
+    pb.set_block_part_parity_percent(block.part_parity_percent);
     auto bz = codec::protobuf::encode(pb);
     return crypto::Sha256()(bz);
   }
@@ -90,6 +98,7 @@ struct consensus_params {
     if (params2.has_block()) {
       res.block.max_bytes = params2.block().max_bytes();
       res.block.max_gas = params2.block().max_gas();
+      res.block.part_parity_percent = params2.block().part_parity_percent();
     }
     if (params2.has_evidence()) {
       res.evidence.max_age_num_blocks = params2.evidence().max_age_num_blocks();
@@ -113,6 +122,7 @@ struct consensus_params {
     auto block_ = ret->mutable_block();
     block_->set_max_bytes(v.block.max_bytes);
     block_->set_max_gas(v.block.max_gas);
+    block_->set_part_parity_percent(v.block.part_parity_percent);
     auto ev_ = ret->mutable_evidence();
     ev_->set_max_age_num_blocks(v.evidence.max_age_num_blocks);
     *ev_->mutable_max_age_duration() =
@@ -129,8 +139,23 @@ struct consensus_params {
 
 } // namespace noir::consensus
 
-NOIR_REFLECT(noir::consensus::block_params, max_bytes, max_gas);
+NOIR_REFLECT(noir::consensus::block_params, max_bytes, max_gas, part_parity_percent);
 NOIR_REFLECT(noir::consensus::evidence_params, max_age_num_blocks, max_age_duration, max_bytes);
 NOIR_REFLECT(noir::consensus::validator_params, pub_key_types);
 NOIR_REFLECT(noir::consensus::version_params, app_version);
 NOIR_REFLECT(noir::consensus::consensus_params, block, evidence, validator, version);
+
+namespace fc {
+
+/// part_parity_percent is 0 if absent, as in consensus params written before it was added
+inline void from_variant(const variant& in, noir::consensus::block_params& out) {
+  noir::check(in.is_object());
+  const auto& obj = in.get_object();
+  from_variant(obj["max_bytes"], out.max_bytes);
+  from_variant(obj["max_gas"], out.max_gas);
+  out.part_parity_percent = 0;
+  if (obj.contains("part_parity_percent"))
+    from_variant(obj["part_parity_percent"], out.part_parity_percent);
+}
+
+} // namespace fc
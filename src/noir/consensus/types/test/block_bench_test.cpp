@@ -0,0 +1,27 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/consensus/types/test/block_test_common.h>
+
+using namespace noir;
+using namespace noir::consensus;
+
+TEST_CASE("block: header hash benchmarks", "[noir][consensus]") {
+  auto h = make_random_header(100, get_time());
+
+  BENCHMARK("proto_header_hash") {
+    return proto_header_hash(h);
+  };
+
+  BENCHMARK("header_hash") {
+    return h.get_hash();
+  };
+
+  h.seal();
+  BENCHMARK("sealed_header_hash") {
+    return h.get_hash();
+  };
+}
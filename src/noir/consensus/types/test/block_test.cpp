@@ -8,10 +8,14 @@
 #include <noir/consensus/types/block.h>
 #include <noir/consensus/types/encoding_helper.h>
 #include <noir/consensus/types/evidence.h>
+#include <noir/consensus/types/test/block_test_common.h>
 #include <noir/core/codec.h>
 
 #include <date/tz.h>
 
+#include <limits>
+#include <numeric>
+
 using namespace noir;
 using namespace noir::consensus;
 
@@ -33,6 +37,81 @@ TEST_CASE("block: make part_set", "[noir][consensus]") {
   CHECK(restored->data.txs[1] == Bytes{"1234"});
 }
 
+TEST_CASE("block: make coded part_set", "[noir][consensus]") {
+  std::vector<tx> txs;
+  for (auto i = 0; i < 100; i++) {
+    auto& t = txs.emplace_back(20);
+    std::fill(t.begin(), t.end(), i);
+  }
+  block org{block_header{}, block_data{.txs = txs}, {}, nullptr};
+  auto ps = org.make_part_set(256, 50);
+  REQUIRE(ps->is_coded());
+  CHECK(ps->total == ps->data_parts + part_set::num_parity_parts(ps->data_parts, 50));
+  CHECK(block::new_block_from_part_set(ps)->data.get_hash() == org.data.get_hash());
+
+  // parity parts and the last data parts rebuild the rest
+  auto rebuilt = part_set::new_part_set_from_header(ps->header(), 50);
+  CHECK(rebuilt->data_parts == ps->data_parts);
+  for (auto i = ps->total; i > ps->total - ps->data_parts; i--) {
+    CHECK(!rebuilt->is_complete());
+    CHECK(rebuilt->add_part(ps->get_part(i - 1)));
+  }
+  REQUIRE(rebuilt->is_complete());
+  CHECK(rebuilt->get_part(0)->bytes_ == ps->get_part(0)->bytes_);
+  auto restored = block::new_block_from_part_set(rebuilt);
+  CHECK(restored->data.get_hash() == org.data.get_hash());
+  CHECK(restored->data.txs[99] == txs[99]);
+
+  // peers stop needing parts once they have as many as data parts
+  auto peer_parts = bit_array::new_bit_array(ps->total);
+  uint32_t num_sent = 0;
+  while (auto index = ps->pick_part_to_send(peer_parts)) {
+    peer_parts->set_index(*index, true);
+    num_sent++;
+  }
+  CHECK(num_sent == ps->data_parts);
+}
+
+TEST_CASE("block: coded part_set of parts which are not one code", "[noir][consensus]") {
+  std::vector<tx> txs;
+  for (auto i = 0; i < 100; i++) {
+    auto& t = txs.emplace_back(20);
+    std::fill(t.begin(), t.end(), i);
+  }
+  block org{block_header{}, block_data{.txs = txs}, {}, nullptr};
+  auto ps = org.make_part_set(256, 50);
+  REQUIRE(ps->is_coded());
+
+  // a proposer commits to a parity part which doesn't match data parts
+  std::vector<Bytes> shards;
+  for (auto i = 0; i < ps->total; i++)
+    shards.push_back(ps->get_part(i)->bytes_);
+  shards.back()[0] ^= 1;
+  auto [root, proofs] = merkle::proofs_from_bytes_list(shards);
+  auto make_part = [&](uint32_t i) { return std::make_shared<part>(part{i, shards[i], *proofs[i]}); };
+
+  auto check_invalid = [&](const std::vector<uint32_t>& indices) {
+    auto received = part_set::new_part_set_from_header({ps->total, root}, 50);
+    for (auto i : indices)
+      CHECK(received->add_part(make_part(i)));
+    CHECK(received->invalid);
+    CHECK(!received->is_complete());
+    CHECK(!received->add_part(make_part(ps->data_parts)));
+  };
+
+  SECTION("data parts") {
+    std::vector<uint32_t> indices(ps->data_parts);
+    std::iota(indices.begin(), indices.end(), 0);
+    check_invalid(indices);
+  }
+
+  SECTION("parity parts and the last data parts") {
+    std::vector<uint32_t> indices(ps->data_parts);
+    std::iota(indices.begin(), indices.end(), ps->total - ps->data_parts);
+    check_invalid(indices);
+  }
+}
+
 TEST_CASE("block: encode using datastream", "[noir][consensus]") {
   block org{block_header{}, block_data{.txs = {{0}, {1}, {2}}}, {}, std::make_unique<commit>()};
   auto data = encode(org);
@@ -220,3 +299,53 @@ TEST_CASE("block: verify header hash", "[noir][consensus]") {
   };
   CHECK(h.get_hash() == Bytes("f740121f553b5418c3efbd343c2dbfe9e007bb67b0d020a0741374bab65242a4"));
 }
+
+TEST_CASE("block: header hash matches protobuf encoding", "[noir][consensus]") {
+  auto tests = std::to_array<std::pair<int64_t, tstamp>>({
+    {1, 0},
+    {100, 1'656'000'000'123'456},
+    {std::numeric_limits<int64_t>::max(), -1'000'001}, // negative nanos are not normalized
+  });
+  for (const auto& [height, time] : tests) {
+    auto h = make_random_header(height, time);
+    CHECK(h.get_hash() == proto_header_hash(h));
+  }
+
+  auto h = make_random_header(1, 0);
+  h.chain_id = std::string(300, 'c'); // too large for the stack buffer
+  CHECK(h.get_hash() == proto_header_hash(h));
+}
+
+TEST_CASE("block: sealed header hash", "[noir][consensus]") {
+  auto h = make_random_header(1, get_time());
+  auto hash = h.get_hash();
+  h.seal();
+  auto copy = h;
+  CHECK(copy.sealed_hash == h.sealed_hash);
+  CHECK(copy.get_hash() == hash);
+
+  auto pb = block_header::to_proto(h);
+  auto decoded = block_header::from_proto(*pb);
+  CHECK(decoded->sealed_hash != nullptr);
+  CHECK(decoded->get_hash() == hash);
+
+  Bytes proposer = random_address();
+  decoded->populate(h.version, h.chain_id, h.time, h.last_block_id, h.validators_hash, h.next_validators_hash,
+    h.consensus_hash, h.app_hash, h.last_results_hash, proposer);
+  CHECK(decoded->sealed_hash == nullptr);
+  CHECK(decoded->get_hash() != hash);
+}
+
+TEST_CASE("block: commit hash matches protobuf encoding", "[noir][consensus]") {
+  commit c{.height = 10, .round = 1, .my_block_id = make_block_id(random_hash(), 3, random_hash())};
+  for (auto i = 0; i < 10; i++) {
+    c.signatures.push_back(commit_sig{
+      .flag = FlagCommit, .validator_address = random_address(), .timestamp = get_time(), .signature = Bytes(64)});
+  }
+  c.signatures.push_back(commit_sig::new_commit_sig_absent());
+
+  merkle::bytes_list items;
+  for (const auto& sig : c.signatures)
+    items.push_back(codec::protobuf::encode(*commit_sig::to_proto(sig)));
+  CHECK(c.get_hash() == merkle::hash_from_bytes_list(items));
+}
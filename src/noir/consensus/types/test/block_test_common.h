@@ -0,0 +1,37 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/codec/protobuf.h>
+#include <noir/consensus/types/block.h>
+#include <noir/consensus/types/encoding_helper.h>
+
+namespace noir::consensus {
+
+/// \brief hashes header fields through protobuf messages, as block_header::get_hash did originally
+inline Bytes proto_header_hash(const block_header& h) {
+  merkle::bytes_list items;
+  items.push_back(codec::protobuf::encode(*consensus_version::to_proto(h.version)));
+  items.push_back(cdc_encode(h.chain_id));
+  items.push_back(cdc_encode(h.height));
+  items.push_back(cdc_encode_time(h.time));
+  items.push_back(codec::protobuf::encode(*p2p::block_id::to_proto(h.last_block_id)));
+  items.push_back(cdc_encode(h.last_commit_hash));
+  items.push_back(cdc_encode(h.data_hash));
+  items.push_back(cdc_encode(h.validators_hash));
+  items.push_back(cdc_encode(h.next_validators_hash));
+  items.push_back(cdc_encode(h.consensus_hash));
+  items.push_back(cdc_encode(h.app_hash));
+  items.push_back(cdc_encode(h.last_results_hash));
+  items.push_back(cdc_encode(h.evidence_hash));
+  items.push_back(cdc_encode(h.proposer_address));
+  return merkle::hash_from_bytes_list(items);
+}
+
+inline block_header make_random_header(int64_t height, tstamp time) {
+  return block_header::make_header({.height = height, .time = time}).value();
+}
+
+} // namespace noir::consensus
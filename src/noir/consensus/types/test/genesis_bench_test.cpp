@@ -0,0 +1,61 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/consensus/types/genesis.h>
+
+#include <sys/resource.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+using namespace noir;
+using namespace noir::consensus;
+
+namespace {
+
+/// writes a genesis whose app_state is a list of accounts of about `size` bytes in total
+void write_synthetic_genesis(const std::string& file_path, size_t size) {
+  std::filesystem::create_directories(std::filesystem::path{file_path}.remove_filename());
+  std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+  out << R"({"genesis_time": "2022-06-01T00:00:00Z", "chain_id": "bench-chain", "initial_height": "1",)"
+      << R"( "app_hash": "", "app_state": {"accounts": [)";
+  size_t written = 0;
+  for (uint64_t i = 0; written < size; ++i) {
+    auto account = fmt::format(R"({}{{"address": "{:040x}", "balance": "{}", "data": "{}"}})", i ? ", " : "", i,
+      i * 1'000'003, std::string(64, 'a' + i % 26));
+    out << account;
+    written += account.size();
+  }
+  out << "]}}\n";
+}
+
+long peak_rss_kb() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+} // namespace
+
+// NOIR_GENESIS_BENCH_SIZE overrides the size of app_state, which defaults to 2GB
+TEST_CASE("GenesisBenchmarks", "[noir][consensus]") {
+  size_t size = 2ull * 1024 * 1024 * 1024;
+  if (auto env = std::getenv("NOIR_GENESIS_BENCH_SIZE"))
+    size = std::stoull(env);
+  auto file_path = "/tmp/noir_bench/genesis.json";
+  write_synthetic_genesis(file_path, size);
+
+  auto rss_before = peak_rss_kb();
+  BENCHMARK("GenesisLoadTime") {
+    auto ok = genesis_doc::genesis_doc_from_file(file_path);
+    return ok.value()->get_app_state().size();
+  };
+  WARN(fmt::format("genesis size={} peak_rss_before={}KB peak_rss_after={}KB",
+    std::filesystem::file_size(file_path), rss_before, peak_rss_kb()));
+
+  std::filesystem::remove(file_path);
+}
@@ -0,0 +1,97 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/common/time.h>
+#include <noir/consensus/types/genesis.h>
+
+#include <filesystem>
+#include <fstream>
+
+using namespace noir;
+using namespace noir::consensus;
+
+namespace {
+
+void write_file(const std::string& file_path, std::string_view content) {
+  std::filesystem::create_directories(std::filesystem::path{file_path}.remove_filename());
+  std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+  out << content;
+}
+
+} // namespace
+
+TEST_CASE("genesis: load from file", "[noir][consensus]") {
+  auto file_path = "/tmp/noir_test/genesis.json";
+  std::string app_state = R"({"accounts": [{"name": "a}\"]{", "balance": 100}, {"name": "b", "balance": [1, 2]}]})";
+  write_file(file_path,
+    std::string(R"({
+  "genesis_time": "2022-06-01T00:00:00Z",
+  "chain_id": "test-chain",
+  "initial_height": "1",
+  "app_hash": "",
+  "app_state": )") +
+      app_state + "\n}\n");
+
+  auto ok = genesis_doc::genesis_doc_from_file(file_path);
+  REQUIRE(ok);
+  auto gen_doc = ok.value();
+  CHECK(gen_doc->chain_id == "test-chain");
+  CHECK(gen_doc->initial_height == 1);
+  CHECK(gen_doc->genesis_time == genesis_time_to_tstamp("2022-06-01T00:00:00Z").value());
+  CHECK(gen_doc->get_app_state() == app_state);
+}
+
+TEST_CASE("genesis: consensus_params without part_parity_percent", "[noir][consensus]") {
+  auto file_path = "/tmp/noir_test/genesis.json";
+  write_file(file_path, R"({
+  "genesis_time": "2022-06-01T00:00:00Z",
+  "chain_id": "test-chain",
+  "initial_height": "1",
+  "consensus_params": {
+    "block": {"max_bytes": "1048576", "max_gas": "1000"},
+    "evidence": {"max_age_num_blocks": "1000", "max_age_duration": "3600000000000", "max_bytes": "4096"},
+    "validator": {"pub_key_types": ["ed25519"]},
+    "version": {"app_version": "1"}
+  }
+})");
+
+  auto ok = genesis_doc::genesis_doc_from_file(file_path);
+  REQUIRE(ok);
+  auto cs_params = ok.value()->cs_params;
+  REQUIRE(cs_params.has_value());
+  CHECK(cs_params->block.max_bytes == 1048576);
+  CHECK(cs_params->block.max_gas == 1000);
+  CHECK(cs_params->block.part_parity_percent == 0);
+  CHECK(cs_params->evidence.max_age_num_blocks == 1000);
+  CHECK(cs_params->evidence.max_bytes == 4096);
+  CHECK(cs_params->version.app_version == 1);
+}
+
+TEST_CASE("genesis: missing app_state", "[noir][consensus]") {
+  auto file_path = "/tmp/noir_test/genesis.json";
+  write_file(file_path, R"({"genesis_time": "2022-06-01T00:00:00Z", "chain_id": "test-chain", "initial_height": "1"})");
+
+  auto ok = genesis_doc::genesis_doc_from_file(file_path);
+  REQUIRE(ok);
+  CHECK(ok.value()->get_app_state().empty());
+}
+
+TEST_CASE("genesis: malformed file", "[noir][consensus]") {
+  auto file_path = "/tmp/noir_test/genesis.json";
+  auto tests = std::to_array<std::string_view>({
+    "",
+    "[]",
+    R"({"chain_id": "test-chain")",
+    R"({"chain_id" "test-chain"})",
+    R"({"app_state": {"a": [1, 2}})",
+    R"({"app_state": {"a": "unterminated}})",
+  });
+  for (const auto& t : tests) {
+    write_file(file_path, t);
+    CHECK(!genesis_doc::genesis_doc_from_file(file_path));
+  }
+  CHECK(!genesis_doc::genesis_doc_from_file("/tmp/noir_test/no_such_genesis.json"));
+}
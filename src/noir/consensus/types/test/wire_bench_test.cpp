@@ -0,0 +1,61 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/codec/protobuf.h>
+#include <noir/consensus/types/wire.h>
+#include <tendermint/types/types.pb.h>
+
+using namespace noir;
+using namespace noir::consensus;
+
+TEST_CASE("wire: benchmarks", "[noir][consensus]") {
+  p2p::block_id block_id_{.hash = random_hash(), .parts = {.total = 3, .hash = random_hash()}};
+  vote v;
+  v.type = p2p::Precommit;
+  v.height = 12345;
+  v.round = 2;
+  v.block_id_ = block_id_;
+  v.timestamp = get_time();
+  v.validator_address = random_address();
+  v.validator_index = 56789;
+  v.signature = Bytes(64);
+  commit c{.height = 10, .round = 1, .my_block_id = block_id_};
+  for (auto i = 0; i < 100; i++) {
+    c.signatures.push_back(commit_sig{
+      .flag = FlagCommit, .validator_address = random_address(), .timestamp = get_time(), .signature = Bytes(64)});
+  }
+
+  auto vote_bz = wire::encode(v);
+  auto commit_bz = wire::encode(c);
+  std::vector<unsigned char> buf(commit_bz.size());
+
+  BENCHMARK("vote: protobuf encode") {
+    return codec::protobuf::encode(*vote::to_proto(v));
+  };
+  BENCHMARK("vote: wire encode") {
+    return wire::encode(v, buf);
+  };
+  BENCHMARK("vote: protobuf decode") {
+    return vote::from_proto(codec::protobuf::decode<::tendermint::types::Vote>(vote_bz));
+  };
+  BENCHMARK("vote: wire decode") {
+    vote decoded;
+    return wire::decode(vote_bz, decoded);
+  };
+  BENCHMARK("commit: protobuf encode") {
+    return codec::protobuf::encode(*commit::to_proto(c));
+  };
+  BENCHMARK("commit: wire encode") {
+    return wire::encode(c, buf);
+  };
+  BENCHMARK("commit: protobuf decode") {
+    return commit::from_proto(codec::protobuf::decode<::tendermint::types::Commit>(commit_bz));
+  };
+  BENCHMARK("commit: wire decode") {
+    commit decoded;
+    return wire::decode(commit_bz, decoded);
+  };
+}
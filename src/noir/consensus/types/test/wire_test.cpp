@@ -0,0 +1,218 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/codec/protobuf.h>
+#include <noir/consensus/types/wire.h>
+#include <tendermint/consensus/types.pb.h>
+
+using namespace noir;
+using namespace noir::consensus;
+
+namespace {
+
+p2p::block_id make_block_id(uint32_t total) {
+  if (!total)
+    return {};
+  return {.hash = random_hash(), .parts = {.total = total, .hash = random_hash()}};
+}
+
+vote make_vote(tstamp timestamp, p2p::block_id block_id_) {
+  vote v;
+  v.type = p2p::Precommit;
+  v.height = 12345;
+  v.round = 2;
+  v.block_id_ = std::move(block_id_);
+  v.timestamp = timestamp;
+  v.validator_address = random_address();
+  v.validator_index = 56789;
+  v.signature = Bytes(64);
+  return v;
+}
+
+commit make_commit(size_t num_sigs) {
+  commit c{.height = 10, .round = 1, .my_block_id = make_block_id(3)};
+  for (auto i = 0; i < num_sigs; i++) {
+    c.signatures.push_back(commit_sig{
+      .flag = FlagCommit, .validator_address = random_address(), .timestamp = get_time(), .signature = Bytes(64)});
+  }
+  c.signatures.push_back(commit_sig::new_commit_sig_absent());
+  return c;
+}
+
+std::unique_ptr<::tendermint::types::Part> part_to_proto(const part& p) {
+  auto ret = std::make_unique<::tendermint::types::Part>();
+  ret->set_index(p.index);
+  ret->set_bytes({p.bytes_.begin(), p.bytes_.end()});
+  ret->set_allocated_proof(merkle::proof::to_proto(p.proof_).release());
+  return ret;
+}
+
+/// checks that v encodes as to_proto(v) does, and decodes as from_proto does
+template<typename Pb, typename T, typename ToProto, typename FromProto>
+void check_conformance(const T& v, ToProto&& to_proto, FromProto&& from_proto) {
+  auto expected = codec::protobuf::encode(*to_proto(v));
+  CHECK(wire::encoded_size(v) == expected.size());
+  CHECK(wire::encode(v) == expected);
+
+  std::vector<unsigned char> buf(expected.size());
+  auto size = wire::encode(v, buf);
+  REQUIRE(size);
+  CHECK(*size == expected.size());
+  CHECK(Bytes{buf} == expected);
+
+  T decoded;
+  REQUIRE(wire::decode(expected, decoded));
+  auto pb = codec::protobuf::decode<Pb>(expected);
+  CHECK(wire::encode(decoded) == codec::protobuf::encode(*to_proto(from_proto(pb))));
+}
+
+} // namespace
+
+TEST_CASE("wire: vote", "[noir][consensus]") {
+  auto tests = std::to_array<std::pair<tstamp, uint32_t>>({
+    {get_time(), 3},
+    {0, 0},
+    {-1'000'001, 1}, // negative nanos are normalized
+  });
+  for (const auto& [timestamp, total] : tests) {
+    auto v = make_vote(timestamp, make_block_id(total));
+    check_conformance<::tendermint::types::Vote>(
+      v, [](const vote& v) { return vote::to_proto(v); }, [](const auto& pb) { return *vote::from_proto(pb); });
+
+    vote decoded;
+    REQUIRE(wire::decode(codec::protobuf::encode(*vote::to_proto(v)), decoded));
+    CHECK(decoded.type == v.type);
+    CHECK(decoded.height == v.height);
+    CHECK(decoded.round == v.round);
+    CHECK(decoded.block_id_ == v.block_id_);
+    CHECK(decoded.timestamp == v.timestamp);
+    CHECK(decoded.validator_address == v.validator_address);
+    CHECK(decoded.validator_index == v.validator_index);
+    CHECK(decoded.signature == v.signature);
+  }
+}
+
+TEST_CASE("wire: votes", "[noir][consensus]") {
+  p2p::votes_message msg;
+  ::tendermint::consensus::Votes pb;
+  for (auto i = 0; i < 3; i++) {
+    auto v = make_vote(get_time(), make_block_id(i));
+    v.validator_index = i;
+    msg.votes.push_back(v);
+    *pb.add_votes() = *vote::to_proto(v);
+  }
+  auto expected = codec::protobuf::encode(pb);
+  CHECK(wire::encoded_size(msg) == expected.size());
+  CHECK(wire::encode(msg) == expected);
+
+  p2p::votes_message decoded;
+  REQUIRE(wire::decode(expected, decoded));
+  REQUIRE(decoded.votes.size() == msg.votes.size());
+  for (auto i = 0; i < msg.votes.size(); i++) {
+    CHECK(decoded.votes[i].validator_index == i);
+    CHECK(wire::encode(decoded.votes[i]) == wire::encode(msg.votes[i]));
+  }
+}
+
+TEST_CASE("wire: proposal", "[noir][consensus]") {
+  auto p = *proposal::new_proposal(100, 1, -1, make_block_id(5));
+  p.signature = Bytes(64);
+  check_conformance<::tendermint::types::Proposal>(p, [](const proposal& p) { return proposal::to_proto(p); },
+    [](const auto& pb) { return *proposal::from_proto(pb); });
+
+  proposal decoded;
+  REQUIRE(wire::decode(wire::encode(p), decoded));
+  CHECK(decoded.pol_round == -1);
+  CHECK(decoded.block_id_ == p.block_id_);
+  CHECK(decoded.timestamp == p.timestamp);
+}
+
+TEST_CASE("wire: commit", "[noir][consensus]") {
+  for (auto num_sigs : {0, 1, 100}) {
+    auto c = make_commit(num_sigs);
+    check_conformance<::tendermint::types::Commit>(
+      c, [](const commit& c) { return commit::to_proto(c); }, [](const auto& pb) { return *commit::from_proto(pb); });
+  }
+
+  // an absent signature has a zero timestamp, which decodes as from_proto does
+  auto c = make_commit(1);
+  commit decoded;
+  REQUIRE(wire::decode(wire::encode(c), decoded));
+  auto expected = commit::from_proto(*commit::to_proto(c));
+  REQUIRE(decoded.signatures.size() == expected->signatures.size());
+  CHECK(decoded.signatures[0].timestamp == c.signatures[0].timestamp);
+  CHECK(decoded.signatures[1].flag == FlagAbsent);
+  CHECK(decoded.signatures[1].timestamp == expected->signatures[1].timestamp);
+  CHECK(decoded.get_hash() == c.get_hash());
+}
+
+TEST_CASE("wire: header", "[noir][consensus]") {
+  auto h = block_header::make_header({.height = 100, .time = get_time()}).value();
+  check_conformance<::tendermint::types::Header>(h, [](const block_header& h) { return block_header::to_proto(h); },
+    [](const auto& pb) { return *block_header::from_proto(pb); });
+
+  block_header decoded;
+  REQUIRE(wire::decode(wire::encode(h), decoded));
+  CHECK(decoded.sealed_hash != nullptr);
+  CHECK(decoded.get_hash() == h.get_hash());
+  CHECK(decoded.chain_id == h.chain_id);
+  CHECK(decoded.last_block_id == h.last_block_id);
+}
+
+TEST_CASE("wire: part", "[noir][consensus]") {
+  block b{block_header{}, block_data{.txs = {Bytes(1000), Bytes(2000)}}, {}, nullptr};
+  auto ps = b.make_part_set(1024);
+  REQUIRE(ps->total > 1);
+  for (const auto& p : ps->parts) {
+    check_conformance<::tendermint::types::Part>(
+      *p, [](const part& p) { return part_to_proto(p); }, [](const auto& pb) {
+        return part{pb.index(), pb.bytes(), *merkle::proof::from_proto(pb.proof())};
+      });
+
+    p2p::block_part_message msg{.height = 10, .round = 0, .index = p->index, .bytes_ = p->bytes_, .proof = p->proof_};
+    ::tendermint::consensus::BlockPart pb;
+    pb.set_height(msg.height);
+    pb.set_round(msg.round);
+    pb.set_allocated_part(part_to_proto(*p).release());
+    CHECK(wire::encode(msg) == codec::protobuf::encode(pb));
+
+    p2p::block_part_message decoded;
+    REQUIRE(wire::decode(codec::protobuf::encode(pb), decoded));
+    CHECK(decoded.index == p->index);
+    CHECK(decoded.bytes_ == p->bytes_);
+    CHECK(!decoded.proof.verify(ps->hash, decoded.bytes_).has_value());
+  }
+}
+
+TEST_CASE("wire: decode", "[noir][consensus]") {
+  auto v = make_vote(get_time(), make_block_id(3));
+  auto bz = wire::encode(v);
+
+  SECTION("unknown fields are skipped") {
+    std::vector<unsigned char> buf(bz.begin(), bz.end());
+    std::array<unsigned char, 32> extra;
+    codec::protobuf::wire_writer x(extra);
+    x.uint_field(100, 1);
+    x.bytes_field(101, std::string_view("unknown"));
+    buf.insert(buf.end(), x.data().begin(), x.data().end());
+
+    vote decoded;
+    REQUIRE(wire::decode(buf, decoded));
+    CHECK(wire::encode(decoded) == bz);
+  }
+
+  SECTION("truncated input") {
+    for (auto size : {bz.size() - 1, size_t(1)}) {
+      vote decoded;
+      CHECK(!wire::decode(std::span(bz.data(), size), decoded));
+    }
+  }
+
+  SECTION("buffer too small") {
+    std::vector<unsigned char> buf(bz.size() - 1);
+    CHECK(!wire::encode(v, buf));
+  }
+}
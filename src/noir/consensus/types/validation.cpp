@@ -3,6 +3,7 @@
 // Copyright (c) 2022 Haderech Pte. Ltd.
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
+#include <noir/common/thread_pool.h>
 #include <noir/consensus/types/block.h>
 #include <noir/consensus/types/canonical.h>
 #include <noir/consensus/types/validation.h>
@@ -11,6 +12,19 @@
 
 namespace noir::consensus {
 
+namespace {
+
+std::optional<std::string> verify_commit_sig(
+  const std::string& chain_id_, validator& val, const std::shared_ptr<commit>& commit_, int32_t index) {
+  auto vote_ = commit_->get_vote(index);
+  auto vote_sign_bytes = vote::vote_sign_bytes(chain_id_, *vote::to_proto(*vote_));
+  if (!val.pub_key_.verify_signature(vote_sign_bytes, commit_->signatures[index].signature))
+    return fmt::format("verification failed: wrong signature - index={}", index);
+  return {};
+}
+
+} // namespace
+
 std::optional<std::string> verify_basic_vals_and_commit(const std::shared_ptr<validator_set>& vals,
   std::shared_ptr<commit> commit_,
   int64_t height,
@@ -40,7 +54,6 @@ std::optional<std::string> verify_commit_single(const std::string& chain_id_,
   int32_t val_idx{0};
   int64_t tallied_voting_power{0};
   std::map<int32_t, int> seen_vals;
-  Bytes vote_sign_bytes;
 
   for (auto i = 0; i < commit_->signatures.size(); i++) {
     auto& commit_sig_ = commit_->signatures[i];
@@ -64,10 +77,8 @@ std::optional<std::string> verify_commit_single(const std::string& chain_id_,
       seen_vals[val_index] = i;
     }
 
-    auto vote_ = commit_->get_vote(i);
-    vote_sign_bytes = vote::vote_sign_bytes(chain_id_, *vote::to_proto(*vote_));
-    if (!val.pub_key_.verify_signature(vote_sign_bytes, commit_sig_.signature))
-      return fmt::format("verification failed: wrong signature - index={}", i);
+    if (auto err = verify_commit_sig(chain_id_, val, commit_, i); err.has_value())
+      return err;
 
     tallied_voting_power += val.voting_power;
     if (!count_all_signatures && tallied_voting_power > voting_power_needed)
@@ -79,6 +90,42 @@ std::optional<std::string> verify_commit_single(const std::string& chain_id_,
   return {};
 }
 
+std::optional<std::string> verify_commit(const std::string& chain_id_,
+  const std::shared_ptr<validator_set>& vals,
+  const p2p::block_id& block_id_,
+  int64_t height,
+  const std::shared_ptr<commit>& commit_,
+  boost::asio::io_context* thread_pool,
+  size_t num_tasks) {
+  if (auto err = verify_basic_vals_and_commit(vals, commit_, height, block_id_); err.has_value())
+    return err;
+
+  auto voting_power_needed = vals->total_voting_power * 2 / 3;
+  if (!thread_pool || num_tasks <= 1)
+    return verify_commit_single(chain_id_, vals, commit_, voting_power_needed, true, true);
+
+  // signatures are checked in batches, and the first invalid one is reported as if checked one by one
+  auto size = commit_->signatures.size();
+  std::vector<std::optional<std::string>> errs(size);
+  parallel_for(*thread_pool, size, num_tasks, [&](size_t begin, size_t end) {
+    for (auto i = begin; i < end; i++) {
+      if (commit_->signatures[i].for_block())
+        errs[i] = verify_commit_sig(chain_id_, vals->validators[i], commit_, i);
+    }
+  });
+
+  int64_t tallied_voting_power{0};
+  for (auto i = 0; i < size; i++) {
+    if (errs[i].has_value())
+      return errs[i];
+    if (commit_->signatures[i].for_block())
+      tallied_voting_power += vals->validators[i].voting_power;
+  }
+  if (tallied_voting_power <= voting_power_needed)
+    return "verification failed: not enough votes were signed";
+  return {};
+}
+
 /// \brief verifies +2/3 of set has signed given commit
 /// Used by the light client and does not check all signatures
 std::optional<std::string> verify_commit_light(const std::string& chain_id_,
@@ -3,9 +3,14 @@
 // Copyright (c) 2022 Haderech Pte. Ltd.
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
+#pragma once
 #include <noir/consensus/types/validator.h>
 #include <noir/p2p/protocol.h>
 
+namespace boost::asio {
+class io_context;
+}
+
 namespace noir::consensus {
 
 std::optional<std::string> verify_basic_vals_and_commit(const std::shared_ptr<validator_set>& vals,
@@ -21,6 +26,17 @@ std::optional<std::string> verify_commit_single(const std::string& chain_id_,
   bool count_all_signatures,
   bool lookup_by_index);
 
+/// \brief verifies +2/3 of set has signed given commit, checking all signatures
+/// Used to validate the last commit of a block
+/// \param[in] thread_pool signatures are checked in num_tasks batches on it, if given
+std::optional<std::string> verify_commit(const std::string& chain_id_,
+  const std::shared_ptr<validator_set>& vals,
+  const p2p::block_id& block_id_,
+  int64_t height,
+  const std::shared_ptr<struct commit>& commit_,
+  boost::asio::io_context* thread_pool = nullptr,
+  size_t num_tasks = 1);
+
 /// \brief verifies +2/3 of set has signed given commit
 /// Used by the light client and does not check all signatures
 std::optional<std::string> verify_commit_light(const std::string& chain_id_,
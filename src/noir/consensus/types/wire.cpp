@@ -0,0 +1,527 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <noir/consensus/types/wire.h>
+
+namespace noir::consensus::wire {
+
+using codec::protobuf::bytes_field_size;
+using codec::protobuf::int_field_size;
+using codec::protobuf::message_field_size;
+using codec::protobuf::uint_field_size;
+using codec::protobuf::wire_type;
+
+namespace {
+
+struct timestamp {
+  int64_t seconds;
+  int64_t nanos;
+};
+
+/// splits microseconds as TimeUtil::MicrosecondsToTimestamp does
+timestamp to_timestamp(tstamp us) {
+  timestamp ts{us / 1'000'000, (us % 1'000'000) * 1'000};
+  if (ts.nanos < 0) {
+    ts.seconds -= 1;
+    ts.nanos += 1'000'000'000;
+  }
+  return ts;
+}
+
+/// commit_sig::to_proto encodes a zero timestamp as "0001-01-01T00:00:00Z"
+timestamp to_timestamp(const commit_sig& v) {
+  if (v.timestamp == 0)
+    return {::google::protobuf::util::TimeUtil::kTimestampMinSeconds, 0};
+  return to_timestamp(v.timestamp);
+}
+
+size_t timestamp_size(const timestamp& ts) {
+  return int_field_size(1, ts.seconds) + int_field_size(2, ts.nanos);
+}
+
+void write_timestamp(wire_writer& w, uint32_t field, const timestamp& ts) {
+  w.message_field(field, timestamp_size(ts));
+  w.int_field(1, ts.seconds);
+  w.int_field(2, ts.nanos);
+}
+
+/// reads google.protobuf.Timestamp as TimeUtil::TimestampToMicroseconds does
+Result<void> read_timestamp(wire_reader& r, tstamp& v) {
+  auto bz = r.bytes();
+  if (r.error())
+    return Error::format("truncated timestamp");
+  wire_reader sub(bz);
+  int64_t seconds = 0;
+  int32_t nanos = 0;
+  uint32_t field;
+  wire_type type;
+  while (sub.next(field, type)) {
+    if (field == 1 && type == wire_type::varint)
+      seconds = static_cast<int64_t>(sub.varint());
+    else if (field == 2 && type == wire_type::varint)
+      nanos = static_cast<int32_t>(sub.varint());
+    else
+      sub.skip(type);
+  }
+  if (sub.error())
+    return Error::format("malformed timestamp");
+  v = seconds * 1'000'000 + nanos / 1'000;
+  return success();
+}
+
+Result<void> done(const wire_reader& r, std::string_view name) {
+  if (r.error())
+    return Error::format("malformed {}", name);
+  return success();
+}
+
+} // namespace
+
+size_t encoded_size(const consensus_version& v) {
+  return uint_field_size(1, v.block) + uint_field_size(2, v.app);
+}
+
+void write(wire_writer& w, const consensus_version& v) {
+  w.uint_field(1, v.block);
+  w.uint_field(2, v.app);
+}
+
+Result<void> read(wire_reader& r, consensus_version& v) {
+  uint32_t field;
+  wire_type type;
+  while (r.next(field, type)) {
+    if (field == 1 && type == wire_type::varint)
+      v.block = r.varint();
+    else if (field == 2 && type == wire_type::varint)
+      v.app = r.varint();
+    else
+      r.skip(type);
+  }
+  return done(r, "Consensus");
+}
+
+size_t encoded_size(const p2p::part_set_header& v) {
+  return uint_field_size(1, v.total) + bytes_field_size(2, v.hash.size());
+}
+
+void write(wire_writer& w, const p2p::part_set_header& v) {
+  w.uint_field(1, v.total);
+  w.bytes_field(2, v.hash);
+}
+
+Result<void> read(wire_reader& r, p2p::part_set_header& v) {
+  uint32_t field;
+  wire_type type;
+  while (r.next(field, type)) {
+    if (field == 1 && type == wire_type::varint)
+      v.total = static_cast<uint32_t>(r.varint());
+    else if (field == 2 && type == wire_type::length_delimited)
+      v.hash = r.bytes();
+    else
+      r.skip(type);
+  }
+  return done(r, "PartSetHeader");
+}
+
+size_t encoded_size(const p2p::block_id& v) {
+  return bytes_field_size(1, v.hash.size()) + message_field_size(2, encoded_size(v.parts));
+}
+
+void write(wire_writer& w, const p2p::block_id& v) {
+  w.bytes_field(1, v.hash);
+  write_message(w, 2, v.parts);
+}
+
+Result<void> read(wire_reader& r, p2p::block_id& v) {
+  uint32_t field;
+  wire_type type;
+  while (r.next(field, type)) {
+    if (field == 1 && type == wire_type::length_delimited) {
+      v.hash = r.bytes();
+    } else if (field == 2 && type == wire_type::length_delimited) {
+      if (auto ok = read_message(r, v.parts); !ok)
+        return ok.error();
+    } else {
+      r.skip(type);
+    }
+  }
+  return done(r, "BlockID");
+}
+
+size_t encoded_size(const merkle::proof& v) {
+  auto size = int_field_size(1, v.total) + int_field_size(2, v.index) + bytes_field_size(3, v.leaf_hash.size());
+  for (const auto& aunt : v.aunts)
+    size += message_field_size(4, aunt.size()); // elements of repeated fields are written even if empty
+  return size;
+}
+
+void write(wire_writer& w, const merkle::proof& v) {
+  w.int_field(1, v.total);
+  w.int_field(2, v.index);
+  w.bytes_field(3, v.leaf_hash);
+  for (const auto& aunt : v.aunts)
+    w.message_field(4, aunt);
+}
+
+Result<void> read(wire_reader& r, merkle::proof& v) {
+  uint32_t field;
+  wire_type type;
+  while (r.next(field, type)) {
+    if (field == 1 && type == wire_type::varint)
+      v.total = static_cast<int64_t>(r.varint());
+    else if (field == 2 && type == wire_type::varint)
+      v.index = static_cast<int64_t>(r.varint());
+    else if (field == 3 && type == wire_type::length_delimited)
+      v.leaf_hash = r.bytes();
+    else if (field == 4 && type == wire_type::length_delimited)
+      v.aunts.emplace_back(r.bytes());
+    else
+      r.skip(type);
+  }
+  return done(r, "Proof");
+}
+
+size_t encoded_size(const commit_sig& v) {
+  return int_field_size(1, v.flag) + bytes_field_size(2, v.validator_address.size()) +
+    message_field_size(3, timestamp_size(to_timestamp(v))) + bytes_field_size(4, v.signature.size());
+}
+
+void write(wire_writer& w, const commit_sig& v) {
+  w.int_field(1, v.flag);
+  w.bytes_field(2, v.validator_address);
+  write_timestamp(w, 3, to_timestamp(v));
+  w.bytes_field(4, v.signature);
+}
+
+Result<void> read(wire_reader& r, commit_sig& v) {
+  uint32_t field;
+  wire_type type;
+  while (r.next(field, type)) {
+    if (field == 1 && type == wire_type::varint) {
+      v.flag = static_cast<block_id_flag>(static_cast<int32_t>(r.varint()));
+    } else if (field == 2 && type == wire_type::length_delimited) {
+      v.validator_address = r.bytes();
+    } else if (field == 3 && type == wire_type::length_delimited) {
+      if (auto ok = read_timestamp(r, v.timestamp); !ok)
+        return ok.error();
+    } else if (field == 4 && type == wire_type::length_delimited) {
+      v.signature = r.bytes();
+    } else {
+      r.skip(type);
+    }
+  }
+  return done(r, "CommitSig");
+}
+
+size_t encoded_size(const commit& v) {
+  auto size =
+    int_field_size(1, v.height) + int_field_size(2, v.round) + message_field_size(3, encoded_size(v.my_block_id));
+  for (const auto& sig : v.signatures)
+    size += message_field_size(4, encoded_size(sig));
+  return size;
+}
+
+void write(wire_writer& w, const commit& v) {
+  w.int_field(1, v.height);
+  w.int_field(2, v.round);
+  write_message(w, 3, v.my_block_id);
+  for (const auto& sig : v.signatures)
+    write_message(w, 4, sig);
+}
+
+Result<void> read(wire_reader& r, commit& v) {
+  uint32_t field;
+  wire_type type;
+  while (r.next(field, type)) {
+    if (field == 1 && type == wire_type::varint) {
+      v.height = static_cast<int64_t>(r.varint());
+    } else if (field == 2 && type == wire_type::varint) {
+      v.round = static_cast<int32_t>(r.varint());
+    } else if (field == 3 && type == wire_type::length_delimited) {
+      if (auto ok = read_message(r, v.my_block_id); !ok)
+        return ok.error();
+    } else if (field == 4 && type == wire_type::length_delimited) {
+      if (auto ok = read_message(r, v.signatures.emplace_back()); !ok)
+        return ok.error();
+    } else {
+      r.skip(type);
+    }
+  }
+  return done(r, "Commit");
+}
+
+size_t encoded_size(const block_header& v) {
+  return message_field_size(1, encoded_size(v.version)) + bytes_field_size(2, v.chain_id.size()) +
+    int_field_size(3, v.height) + message_field_size(4, timestamp_size(to_timestamp(v.time))) +
+    message_field_size(5, encoded_size(v.last_block_id)) + bytes_field_size(6, v.last_commit_hash.size()) +
+    bytes_field_size(7, v.data_hash.size()) + bytes_field_size(8, v.validators_hash.size()) +
+    bytes_field_size(9, v.next_validators_hash.size()) + bytes_field_size(10, v.consensus_hash.size()) +
+    bytes_field_size(11, v.app_hash.size()) + bytes_field_size(12, v.last_results_hash.size()) +
+    bytes_field_size(13, v.evidence_hash.size()) + bytes_field_size(14, v.proposer_address.size());
+}
+
+void write(wire_writer& w, const block_header& v) {
+  write_message(w, 1, v.version);
+  w.bytes_field(2, v.chain_id);
+  w.int_field(3, v.height);
+  write_timestamp(w, 4, to_timestamp(v.time));
+  write_message(w, 5, v.last_block_id);
+  w.bytes_field(6, v.last_commit_hash);
+  w.bytes_field(7, v.data_hash);
+  w.bytes_field(8, v.validators_hash);
+  w.bytes_field(9, v.next_validators_hash);
+  w.bytes_field(10, v.consensus_hash);
+  w.bytes_field(11, v.app_hash);
+  w.bytes_field(12, v.last_results_hash);
+  w.bytes_field(13, v.evidence_hash);
+  w.bytes_field(14, v.proposer_address);
+}
+
+Result<void> read(wire_reader& r, block_header& v) {
+  uint32_t field;
+  wire_type type;
+  auto bytes_member = [&](uint32_t f) -> Bytes* {
+    switch (f) {
+    case 6:
+      return &v.last_commit_hash;
+    case 7:
+      return &v.data_hash;
+    case 8:
+      return &v.validators_hash;
+    case 9:
+      return &v.next_validators_hash;
+    case 10:
+      return &v.consensus_hash;
+    case 11:
+      return &v.app_hash;
+    case 12:
+      return &v.last_results_hash;
+    case 13:
+      return &v.evidence_hash;
+    case 14:
+      return &v.proposer_address;
+    default:
+      return nullptr;
+    }
+  };
+  while (r.next(field, type)) {
+    Result<void> ok = success();
+    if (field == 1 && type == wire_type::length_delimited)
+      ok = read_message(r, v.version);
+    else if (field == 2 && type == wire_type::length_delimited)
+      v.chain_id = r.string();
+    else if (field == 3 && type == wire_type::varint)
+      v.height = static_cast<int64_t>(r.varint());
+    else if (field == 4 && type == wire_type::length_delimited)
+      ok = read_timestamp(r, v.time);
+    else if (field == 5 && type == wire_type::length_delimited)
+      ok = read_message(r, v.last_block_id);
+    else if (auto member = bytes_member(field); member && type == wire_type::length_delimited)
+      *member = r.bytes();
+    else
+      r.skip(type);
+    if (!ok)
+      return ok.error();
+  }
+  if (auto ok = done(r, "Header"); !ok)
+    return ok.error();
+  v.seal();
+  return success();
+}
+
+size_t encoded_size(const part& v) {
+  return uint_field_size(1, v.index) + bytes_field_size(2, v.bytes_.size()) +
+    message_field_size(3, encoded_size(v.proof_));
+}
+
+void write(wire_writer& w, const part& v) {
+  w.uint_field(1, v.index);
+  w.bytes_field(2, v.bytes_);
+  write_message(w, 3, v.proof_);
+}
+
+Result<void> read(wire_reader& r, part& v) {
+  uint32_t field;
+  wire_type type;
+  while (r.next(field, type)) {
+    if (field == 1 && type == wire_type::varint) {
+      v.index = static_cast<uint32_t>(r.varint());
+    } else if (field == 2 && type == wire_type::length_delimited) {
+      v.bytes_ = r.bytes();
+    } else if (field == 3 && type == wire_type::length_delimited) {
+      if (auto ok = read_message(r, v.proof_); !ok)
+        return ok.error();
+    } else {
+      r.skip(type);
+    }
+  }
+  return done(r, "Part");
+}
+
+namespace {
+
+/// size of tendermint.types.Part within tendermint.consensus.BlockPart, which is flattened in block_part_message
+size_t part_size(const p2p::block_part_message& v) {
+  return uint_field_size(1, v.index) + bytes_field_size(2, v.bytes_.size()) +
+    message_field_size(3, encoded_size(v.proof));
+}
+
+} // namespace
+
+size_t encoded_size(const p2p::block_part_message& v) {
+  return int_field_size(1, v.height) + int_field_size(2, v.round) + message_field_size(3, part_size(v));
+}
+
+void write(wire_writer& w, const p2p::block_part_message& v) {
+  w.int_field(1, v.height);
+  w.int_field(2, v.round);
+  w.message_field(3, part_size(v));
+  w.uint_field(1, v.index);
+  w.bytes_field(2, v.bytes_);
+  write_message(w, 3, v.proof);
+}
+
+Result<void> read(wire_reader& r, p2p::block_part_message& v) {
+  uint32_t field;
+  wire_type type;
+  while (r.next(field, type)) {
+    if (field == 1 && type == wire_type::varint) {
+      v.height = static_cast<int64_t>(r.varint());
+    } else if (field == 2 && type == wire_type::varint) {
+      v.round = static_cast<int32_t>(r.varint());
+    } else if (field == 3 && type == wire_type::length_delimited) {
+      part p{v.index, std::move(v.bytes_), std::move(v.proof)};
+      auto ok = read_message(r, p);
+      v.index = p.index;
+      v.bytes_ = std::move(p.bytes_);
+      v.proof = std::move(p.proof_);
+      if (!ok)
+        return ok.error();
+    } else {
+      r.skip(type);
+    }
+  }
+  return done(r, "BlockPart");
+}
+
+size_t encoded_size(const p2p::vote_message& v) {
+  return int_field_size(1, v.type) + int_field_size(2, v.height) + int_field_size(3, v.round) +
+    message_field_size(4, encoded_size(v.block_id_)) +
+    message_field_size(5, timestamp_size(to_timestamp(v.timestamp))) + bytes_field_size(6, v.validator_address.size()) +
+    int_field_size(7, v.validator_index) + bytes_field_size(8, v.signature.size());
+}
+
+void write(wire_writer& w, const p2p::vote_message& v) {
+  w.int_field(1, v.type);
+  w.int_field(2, v.height);
+  w.int_field(3, v.round);
+  write_message(w, 4, v.block_id_);
+  write_timestamp(w, 5, to_timestamp(v.timestamp));
+  w.bytes_field(6, v.validator_address);
+  w.int_field(7, v.validator_index);
+  w.bytes_field(8, v.signature);
+}
+
+Result<void> read(wire_reader& r, p2p::vote_message& v) {
+  uint32_t field;
+  wire_type type;
+  while (r.next(field, type)) {
+    Result<void> ok = success();
+    if (field == 1 && type == wire_type::varint)
+      v.type = static_cast<p2p::signed_msg_type>(static_cast<int32_t>(r.varint()));
+    else if (field == 2 && type == wire_type::varint)
+      v.height = static_cast<int64_t>(r.varint());
+    else if (field == 3 && type == wire_type::varint)
+      v.round = static_cast<int32_t>(r.varint());
+    else if (field == 4 && type == wire_type::length_delimited)
+      ok = read_message(r, v.block_id_);
+    else if (field == 5 && type == wire_type::length_delimited)
+      ok = read_timestamp(r, v.timestamp);
+    else if (field == 6 && type == wire_type::length_delimited)
+      v.validator_address = r.bytes();
+    else if (field == 7 && type == wire_type::varint)
+      v.validator_index = static_cast<int32_t>(r.varint());
+    else if (field == 8 && type == wire_type::length_delimited)
+      v.signature = r.bytes();
+    else
+      r.skip(type);
+    if (!ok)
+      return ok.error();
+  }
+  return done(r, "Vote");
+}
+
+size_t encoded_size(const p2p::votes_message& v) {
+  size_t size = 0;
+  for (const auto& vote_ : v.votes)
+    size += message_field_size(1, encoded_size(vote_));
+  return size;
+}
+
+void write(wire_writer& w, const p2p::votes_message& v) {
+  for (const auto& vote_ : v.votes)
+    write_message(w, 1, vote_);
+}
+
+Result<void> read(wire_reader& r, p2p::votes_message& v) {
+  uint32_t field;
+  wire_type type;
+  while (r.next(field, type)) {
+    if (field == 1 && type == wire_type::length_delimited) {
+      p2p::vote_message vote_{};
+      if (auto ok = read_message(r, vote_); !ok)
+        return ok.error();
+      v.votes.push_back(std::move(vote_));
+    } else {
+      r.skip(type);
+    }
+  }
+  return done(r, "Votes");
+}
+
+size_t encoded_size(const p2p::proposal_message& v) {
+  return int_field_size(1, v.type) + int_field_size(2, v.height) + int_field_size(3, v.round) +
+    int_field_size(4, v.pol_round) + message_field_size(5, encoded_size(v.block_id_)) +
+    message_field_size(6, timestamp_size(to_timestamp(v.timestamp))) + bytes_field_size(7, v.signature.size());
+}
+
+void write(wire_writer& w, const p2p::proposal_message& v) {
+  w.int_field(1, v.type);
+  w.int_field(2, v.height);
+  w.int_field(3, v.round);
+  w.int_field(4, v.pol_round);
+  write_message(w, 5, v.block_id_);
+  write_timestamp(w, 6, to_timestamp(v.timestamp));
+  w.bytes_field(7, v.signature);
+}
+
+Result<void> read(wire_reader& r, p2p::proposal_message& v) {
+  uint32_t field;
+  wire_type type;
+  while (r.next(field, type)) {
+    Result<void> ok = success();
+    if (field == 1 && type == wire_type::varint)
+      v.type = static_cast<p2p::signed_msg_type>(static_cast<int32_t>(r.varint()));
+    else if (field == 2 && type == wire_type::varint)
+      v.height = static_cast<int64_t>(r.varint());
+    else if (field == 3 && type == wire_type::varint)
+      v.round = static_cast<int32_t>(r.varint());
+    else if (field == 4 && type == wire_type::varint)
+      v.pol_round = static_cast<int32_t>(r.varint());
+    else if (field == 5 && type == wire_type::length_delimited)
+      ok = read_message(r, v.block_id_);
+    else if (field == 6 && type == wire_type::length_delimited)
+      ok = read_timestamp(r, v.timestamp);
+    else if (field == 7 && type == wire_type::length_delimited)
+      v.signature = r.bytes();
+    else
+      r.skip(type);
+    if (!ok)
+      return ok.error();
+  }
+  return done(r, "Proposal");
+}
+
+} // namespace noir::consensus::wire
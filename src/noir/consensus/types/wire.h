@@ -0,0 +1,102 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/codec/protobuf.h>
+#include <noir/consensus/types/block.h>
+#include <noir/consensus/types/proposal.h>
+#include <noir/consensus/types/vote.h>
+
+/// Direct protobuf wire encoding of consensus types, without building intermediate protobuf messages.
+/// Encoded bytes are identical to serializing the message returned by to_proto(), and decoding gives the same value as
+/// from_proto() of the parsed message, e.g. headers are sealed after decoding.
+namespace noir::consensus::wire {
+
+using codec::protobuf::wire_reader;
+using codec::protobuf::wire_writer;
+
+size_t encoded_size(const consensus_version& v);
+size_t encoded_size(const p2p::part_set_header& v);
+size_t encoded_size(const p2p::block_id& v);
+size_t encoded_size(const merkle::proof& v);
+size_t encoded_size(const commit_sig& v);
+size_t encoded_size(const commit& v);
+size_t encoded_size(const block_header& v);
+size_t encoded_size(const part& v);
+size_t encoded_size(const p2p::block_part_message& v);
+size_t encoded_size(const p2p::vote_message& v);
+size_t encoded_size(const p2p::votes_message& v);
+size_t encoded_size(const p2p::proposal_message& v);
+
+void write(wire_writer& w, const consensus_version& v);
+void write(wire_writer& w, const p2p::part_set_header& v);
+void write(wire_writer& w, const p2p::block_id& v);
+void write(wire_writer& w, const merkle::proof& v);
+void write(wire_writer& w, const commit_sig& v);
+void write(wire_writer& w, const commit& v);
+void write(wire_writer& w, const block_header& v);
+void write(wire_writer& w, const part& v);
+void write(wire_writer& w, const p2p::block_part_message& v);
+void write(wire_writer& w, const p2p::vote_message& v);
+void write(wire_writer& w, const p2p::votes_message& v);
+void write(wire_writer& w, const p2p::proposal_message& v);
+
+Result<void> read(wire_reader& r, consensus_version& v);
+Result<void> read(wire_reader& r, p2p::part_set_header& v);
+Result<void> read(wire_reader& r, p2p::block_id& v);
+Result<void> read(wire_reader& r, merkle::proof& v);
+Result<void> read(wire_reader& r, commit_sig& v);
+Result<void> read(wire_reader& r, commit& v);
+Result<void> read(wire_reader& r, block_header& v);
+Result<void> read(wire_reader& r, part& v);
+Result<void> read(wire_reader& r, p2p::block_part_message& v);
+Result<void> read(wire_reader& r, p2p::vote_message& v);
+Result<void> read(wire_reader& r, p2p::votes_message& v);
+Result<void> read(wire_reader& r, p2p::proposal_message& v);
+
+/// \brief writes v as a sub-message field
+template<typename T>
+void write_message(wire_writer& w, uint32_t field, const T& v) {
+  w.message_field(field, encoded_size(v));
+  write(w, v);
+}
+
+/// \brief reads a sub-message field into v; fields already set in v are kept unless overwritten, as protobuf does
+template<typename T>
+Result<void> read_message(wire_reader& r, T& v) {
+  auto bz = r.bytes();
+  if (r.error())
+    return Error::format("truncated message");
+  wire_reader sub(bz);
+  return read(sub, v);
+}
+
+/// \brief encodes v into a caller provided buffer
+/// \return number of bytes written
+template<typename T>
+Result<size_t> encode(const T& v, std::span<unsigned char> out) {
+  wire_writer w(out);
+  write(w, v);
+  if (w.overflow())
+    return Error::format("buffer too small: size={}, required={}", out.size(), encoded_size(v));
+  return w.size();
+}
+
+template<typename T>
+Bytes encode(const T& v) {
+  Bytes bz(encoded_size(v));
+  wire_writer w(std::span<unsigned char>(bz.data(), bz.size()));
+  write(w, v);
+  return bz;
+}
+
+template<typename T>
+Result<void> decode(std::span<const unsigned char> in, T& v) {
+  v = T{};
+  wire_reader r(in);
+  return read(r, v);
+}
+
+} // namespace noir::consensus::wire
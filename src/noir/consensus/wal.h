@@ -6,6 +6,7 @@
 #pragma once
 
 #include <noir/common/thread_pool.h>
+#include <noir/common/trace.h>
 #include <noir/consensus/common.h>
 #include <noir/consensus/protocol.h>
 #include <noir/consensus/types/events.h>
@@ -338,6 +339,7 @@ public:
   }
 
   bool write_sync(const wal_message& msg) override {
+    trace::span span("wal_write_sync");
     if (!write(msg)) {
       return false;
     }
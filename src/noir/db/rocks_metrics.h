@@ -0,0 +1,255 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <fmt/core.h>
+#include <rocksdb/db.h>
+#include <rocksdb/iostats_context.h>
+#include <rocksdb/options.h>
+#include <rocksdb/perf_context.h>
+#include <rocksdb/perf_level.h>
+#include <rocksdb/statistics.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace noir::db {
+
+/// \brief enables statistics of the db to be opened with options, which collect_stats() reports
+/// Timers guarded by the db mutex are left out, as they cost more than the rest of the statistics together.
+inline void enable_statistics(rocksdb::Options& options) {
+  options.statistics = rocksdb::CreateDBStatistics();
+  options.statistics->set_stats_level(rocksdb::StatsLevel::kExceptTimeForMutex);
+}
+
+struct rocks_stats {
+  struct column_family {
+    std::string name;
+    uint64_t pending_compaction_bytes{0};
+    uint64_t running_compactions{0};
+    uint64_t memtable_bytes{0};
+    uint64_t sst_bytes{0};
+    uint64_t estimated_keys{0};
+    bool write_stopped{false};
+  };
+
+  struct latency {
+    uint64_t count{0};
+    double p50_us{0};
+    double p99_us{0};
+    double max_us{0};
+  };
+
+  uint64_t block_cache_hits{0};
+  uint64_t block_cache_misses{0};
+  uint64_t block_cache_bytes{0};
+  uint64_t bytes_read{0};
+  uint64_t bytes_written{0};
+  uint64_t compaction_bytes_read{0};
+  uint64_t compaction_bytes_written{0};
+  uint64_t stall_micros{0};
+  uint64_t delayed_write_rate{0};
+  latency get;
+  latency write;
+  latency seek;
+  std::vector<column_family> column_families;
+
+  double block_cache_hit_rate() const {
+    auto total = block_cache_hits + block_cache_misses;
+    return total ? double(block_cache_hits) / total : 0;
+  }
+};
+
+/// \brief counters of db since it was opened, and properties of cfs, or of the default column family if empty
+/// Counters are zero unless statistics were enabled with enable_statistics().
+inline rocks_stats collect_stats(rocksdb::DB& db, std::vector<rocksdb::ColumnFamilyHandle*> cfs = {}) {
+  rocks_stats stats;
+  if (auto statistics = db.GetDBOptions().statistics) {
+    stats.block_cache_hits = statistics->getTickerCount(rocksdb::BLOCK_CACHE_HIT);
+    stats.block_cache_misses = statistics->getTickerCount(rocksdb::BLOCK_CACHE_MISS);
+    stats.bytes_read = statistics->getTickerCount(rocksdb::BYTES_READ);
+    stats.bytes_written = statistics->getTickerCount(rocksdb::BYTES_WRITTEN);
+    stats.compaction_bytes_read = statistics->getTickerCount(rocksdb::COMPACT_READ_BYTES);
+    stats.compaction_bytes_written = statistics->getTickerCount(rocksdb::COMPACT_WRITE_BYTES);
+    stats.stall_micros = statistics->getTickerCount(rocksdb::STALL_MICROS);
+    auto latency = [&](uint32_t histogram) {
+      rocksdb::HistogramData data;
+      statistics->histogramData(histogram, &data);
+      return rocks_stats::latency{data.count, data.median, data.percentile99, data.max};
+    };
+    stats.get = latency(rocksdb::DB_GET);
+    stats.write = latency(rocksdb::DB_WRITE);
+    stats.seek = latency(rocksdb::DB_SEEK);
+  }
+  db.GetIntProperty(rocksdb::DB::Properties::kBlockCacheUsage, &stats.block_cache_bytes);
+  db.GetIntProperty(rocksdb::DB::Properties::kActualDelayedWriteRate, &stats.delayed_write_rate);
+
+  if (cfs.empty())
+    cfs.push_back(db.DefaultColumnFamily());
+  for (auto cf : cfs) {
+    auto& cf_stats = stats.column_families.emplace_back();
+    cf_stats.name = cf->GetName();
+    db.GetIntProperty(cf, rocksdb::DB::Properties::kEstimatePendingCompactionBytes, &cf_stats.pending_compaction_bytes);
+    db.GetIntProperty(cf, rocksdb::DB::Properties::kNumRunningCompactions, &cf_stats.running_compactions);
+    db.GetIntProperty(cf, rocksdb::DB::Properties::kCurSizeAllMemTables, &cf_stats.memtable_bytes);
+    db.GetIntProperty(cf, rocksdb::DB::Properties::kTotalSstFilesSize, &cf_stats.sst_bytes);
+    db.GetIntProperty(cf, rocksdb::DB::Properties::kEstimateNumKeys, &cf_stats.estimated_keys);
+    uint64_t write_stopped = 0;
+    db.GetIntProperty(cf, rocksdb::DB::Properties::kIsWriteStopped, &write_stopped);
+    cf_stats.write_stopped = write_stopped;
+  }
+  return stats;
+}
+
+/// \brief a store operation timed by perf_scope, with the time rocksdb spent on its parts if it was sampled
+struct slow_op {
+  const char* name;
+  int64_t duration_ns;
+  bool sampled;
+  uint64_t block_reads;
+  uint64_t block_read_bytes;
+  uint64_t block_read_ns;
+  uint64_t block_cache_hits;
+  uint64_t memtable_get_ns;
+  uint64_t sst_get_ns;
+  uint64_t wal_write_ns;
+  uint64_t memtable_write_ns;
+  uint64_t write_delay_ns;
+  uint64_t fsync_ns;
+
+  std::string to_string() const {
+    auto s = fmt::format("{} {:.3f}ms", name, duration_ns / 1e6);
+    if (sampled) {
+      s += fmt::format(" (block reads {} of {} bytes {:.3f}ms, cache hits {}, memtable get {:.3f}ms, sst get {:.3f}ms, "
+                       "wal {:.3f}ms, memtable write {:.3f}ms, write delay {:.3f}ms, fsync {:.3f}ms)",
+        block_reads, block_read_bytes, block_read_ns / 1e6, block_cache_hits, memtable_get_ns / 1e6, sst_get_ns / 1e6,
+        wal_write_ns / 1e6, memtable_write_ns / 1e6, write_delay_ns / 1e6, fsync_ns / 1e6);
+    }
+    return s;
+  }
+};
+
+/// \brief totals of the operations timed by perf_scope at a call site
+struct op_stats {
+  uint64_t count{0};
+  int64_t total_ns{0};
+  int64_t max_ns{0};
+};
+
+namespace detail {
+  inline constexpr size_t max_slow_ops = 16;
+
+  inline std::atomic<uint32_t> perf_sample_every{16};
+  inline std::mutex ops_mtx;
+  // min-heap on duration of the slowest ops since the last take_slow_ops()
+  inline std::vector<slow_op> slow_ops;
+  inline std::map<std::string, op_stats, std::less<>> ops;
+
+  inline bool slower(const slow_op& a, const slow_op& b) {
+    return a.duration_ns > b.duration_ns;
+  }
+
+  inline void record(const slow_op& op) {
+    std::scoped_lock g{ops_mtx};
+    auto it = ops.find(std::string_view(op.name));
+    if (it == ops.end())
+      it = ops.emplace(op.name, op_stats{}).first;
+    it->second.count++;
+    it->second.total_ns += op.duration_ns;
+    it->second.max_ns = std::max(it->second.max_ns, op.duration_ns);
+
+    if (slow_ops.size() < max_slow_ops) {
+      slow_ops.push_back(op);
+      std::push_heap(slow_ops.begin(), slow_ops.end(), slower);
+    } else if (op.duration_ns > slow_ops.front().duration_ns) {
+      std::pop_heap(slow_ops.begin(), slow_ops.end(), slower);
+      slow_ops.back() = op;
+      std::push_heap(slow_ops.begin(), slow_ops.end(), slower);
+    }
+  }
+} // namespace detail
+
+/// \brief enables the rocksdb perf context for one of every n outermost perf_scopes of each thread, or none if 0
+inline void set_perf_sample_every(uint32_t n) {
+  detail::perf_sample_every = n;
+}
+
+/// \brief times the enclosing scope as an operation of a store, e.g. block_store::save_block
+/// Sampled scopes also break the time down with the rocksdb perf context, which costs two clock reads per rocksdb
+/// internal step, hence sampling. Nested scopes are timed but never sampled, as the perf context of a thread is
+/// shared. name must outlive the recorded ops, e.g. a string literal.
+class perf_scope {
+public:
+  explicit perf_scope(const char* name) noexcept: name(name), start(std::chrono::steady_clock::now()) {
+    thread_local uint32_t num_scopes = 0;
+    auto every = detail::perf_sample_every.load(std::memory_order_relaxed);
+    sampled = depth()++ == 0 && every && num_scopes++ % every == 0;
+    if (sampled) {
+      rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableTimeExceptForMutex);
+      rocksdb::get_perf_context()->Reset();
+      rocksdb::get_iostats_context()->Reset();
+    }
+  }
+
+  perf_scope(const perf_scope&) = delete;
+  perf_scope& operator=(const perf_scope&) = delete;
+
+  ~perf_scope() {
+    depth()--;
+    slow_op op{.name = name,
+      .duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                       .count(),
+      .sampled = sampled};
+    if (sampled) {
+      const auto& perf = *rocksdb::get_perf_context();
+      op.block_reads = perf.block_read_count;
+      op.block_read_bytes = perf.block_read_byte;
+      op.block_read_ns = perf.block_read_time;
+      op.block_cache_hits = perf.block_cache_hit_count;
+      op.memtable_get_ns = perf.get_from_memtable_time;
+      op.sst_get_ns = perf.get_from_output_files_time;
+      op.wal_write_ns = perf.write_wal_time;
+      op.memtable_write_ns = perf.write_memtable_time;
+      op.write_delay_ns = perf.write_delay_time;
+      op.fsync_ns = rocksdb::get_iostats_context()->fsync_nanos;
+      rocksdb::SetPerfLevel(rocksdb::PerfLevel::kDisable);
+    }
+    detail::record(op);
+  }
+
+private:
+  static uint32_t& depth() {
+    thread_local uint32_t depth = 0;
+    return depth;
+  }
+
+  const char* name;
+  std::chrono::steady_clock::time_point start;
+  bool sampled;
+};
+
+/// \return slowest ops since the last call, slowest first
+inline std::vector<slow_op> take_slow_ops() {
+  std::vector<slow_op> ops;
+  {
+    std::scoped_lock g{detail::ops_mtx};
+    ops.swap(detail::slow_ops);
+  }
+  std::sort(ops.begin(), ops.end(), detail::slower);
+  return ops;
+}
+
+/// \return totals of ops by call site since the process started
+inline std::map<std::string, op_stats, std::less<>> get_op_stats() {
+  std::scoped_lock g{detail::ops_mtx};
+  return detail::ops;
+}
+
+} // namespace noir::db
@@ -168,6 +168,9 @@ public:
   /// \brief The column family associated with this instance of the RocksDB session.
   std::shared_ptr<const rocksdb::ColumnFamilyHandle> column_family() const;
 
+  /// \brief The RocksDB db instance, e.g. for reading its statistics and properties.
+  const std::shared_ptr<rocksdb::DB>& db() const;
+
 protected:
   template<typename Iterable>
   const std::pair<std::vector<std::pair<shared_bytes, shared_bytes>>, std::unordered_set<shared_bytes>> read_(
@@ -503,6 +506,10 @@ inline std::shared_ptr<const rocksdb::ColumnFamilyHandle> session<rocksdb_t>::co
   return m_column_family;
 }
 
+inline const std::shared_ptr<rocksdb::DB>& session<rocksdb_t>::db() const {
+  return m_db;
+}
+
 inline rocksdb::ColumnFamilyHandle* session<rocksdb_t>::column_family_() const {
   if (m_column_family) {
     return m_column_family.get();
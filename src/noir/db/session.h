@@ -5,6 +5,9 @@
 //
 #pragma once
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <queue>
 #include <set>
@@ -26,6 +29,9 @@ struct overloaded : Ts... {
 template<class... Ts>
 overloaded(Ts...) -> overloaded<Ts...>;
 
+template<typename Session>
+class session_fork;
+
 /// \brief Defines a session for reading/write data to a cache and persistent data store.
 /// \tparam Parent The parent type of this session
 /// \remarks Specializations of this type can be created to create new parent types that
@@ -237,6 +243,11 @@ public:
   iterator lower_bound(const shared_bytes& key);
   iterator lower_bound_from_bytes(const Bytes& key);
 
+  /// \brief Returns a copy-on-write overlay of this session, which may be one of many sibling forks.
+  /// \remarks Sibling forks may be used from different threads.  While this session has forks, it must not be used
+  /// other than through them.  Refer to session_fork.
+  session_fork<session> fork();
+
 private:
   /// \brief Sets the lower/upper bounds of the session's cache based on the parent's cache lower/upper bound
   /// \remarks This is only invoked when constructing a session with a parent.  This method prepares the iterator cache
@@ -278,6 +289,8 @@ private:
 private:
   parent_variant_type m_parent{static_cast<Parent*>(nullptr)};
   cache_type m_cache;
+  /// Serializes reads of forks through this session, as reading a session fills its cache.
+  std::shared_ptr<std::mutex> m_fork_mutex;
 };
 
 template<typename Parent>
@@ -326,7 +339,10 @@ session<Parent>::session(session& parent, std::nullptr_t): m_parent{&parent} {
 }
 
 template<typename Parent>
-session<Parent>::session(session&& other): m_parent{std::move(other.m_parent)}, m_cache{std::move(other.m_cache)} {
+session<Parent>::session(session&& other)
+  : m_parent{std::move(other.m_parent)},
+    m_cache{std::move(other.m_cache)},
+    m_fork_mutex{std::move(other.m_fork_mutex)} {
   session* null_parent = nullptr;
   other.m_parent = null_parent;
 }
@@ -339,6 +355,7 @@ session<Parent>& session<Parent>::operator=(session&& other) {
 
   m_parent = std::move(other.m_parent);
   m_cache = std::move(other.m_cache);
+  m_fork_mutex = std::move(other.m_fork_mutex);
 
   session* null_parent = nullptr;
   other.m_parent = null_parent;
@@ -1089,4 +1106,165 @@ bool session<Parent>::session_iterator<Iterator_traits>::operator!=(const sessio
   return !(*this == other);
 }
 
+/// \brief Defines a copy-on-write overlay of a session, which may have other sibling forks on the same session.
+/// \tparam Session The type of the forked session.
+/// \remarks A fork reads through to the forked session and keeps what it writes and erases to itself, recording the
+/// keys it read from the forked session (its read set) and the keys it wrote or erased (its write set).  Sibling forks
+/// may be used from different threads: reads through the forked session are serialized, and a fork keeps the values
+/// it read so that each key is read through at most once.  Changes of siblings are either discarded, or merged into
+/// one fork, which detects read/write conflicts, and committed into the forked session.
+template<typename Session>
+class session_fork {
+public:
+  session_fork(Session& parent, std::shared_ptr<std::mutex> parent_mutex);
+  session_fork(const session_fork&) = delete;
+  session_fork(session_fork&&) = default;
+
+  session_fork& operator=(const session_fork&) = delete;
+  session_fork& operator=(session_fork&&) = default;
+
+  std::optional<shared_bytes> read(const shared_bytes& key);
+  void write(const shared_bytes& key, const shared_bytes& value);
+  bool contains(const shared_bytes& key);
+  void erase(const shared_bytes& key);
+
+  /// \brief Returns the keys read from the forked session, not counting keys read after this fork wrote them.
+  std::unordered_set<shared_bytes> read_set() const;
+
+  /// \brief Returns the keys written or erased in this fork.
+  std::unordered_set<shared_bytes> write_set() const;
+
+  /// \brief Commits the changes in this fork into the forked session, and clears them.
+  /// \remarks No sibling fork may be in use at the same time.
+  void commit();
+
+  /// \brief Discards the changes and the read set of this fork.
+  void undo();
+
+  /// \brief Merges the changes of other into this fork, as if other ran after this fork on the same session.
+  /// \remarks Forks conflict if other read a key this fork wrote, as other may have read a value this fork changed.  A
+  /// key written by both is not a conflict, and takes the value of other.  The merged fork conflicts with later forks
+  /// as both forks would, so forks may be merged one after another in the order they are meant to run.
+  /// \return The keys in conflict, in which case nothing is merged, or an empty set if other was merged.
+  std::unordered_set<shared_bytes> merge(session_fork&& other);
+
+private:
+  Session* m_parent{nullptr};
+  std::shared_ptr<std::mutex> m_parent_mutex;
+  /// Values read from the forked session, std::nullopt for keys it doesn't have.
+  std::unordered_map<shared_bytes, std::optional<shared_bytes>> m_reads;
+  /// Values written in this fork, std::nullopt for erased keys.
+  std::map<shared_bytes, std::optional<shared_bytes>> m_writes;
+};
+
+/// \brief Merges the changes of b into a, as if b ran after a.  Refer to session_fork::merge.
+/// \return The keys in conflict, in which case nothing is merged, or an empty set if b was merged.
+template<typename Session>
+std::unordered_set<shared_bytes> merge(session_fork<Session>& a, session_fork<Session>&& b) {
+  return a.merge(std::move(b));
+}
+
+template<typename Parent>
+session_fork<session<Parent>> session<Parent>::fork() {
+  if (!m_fork_mutex) {
+    m_fork_mutex = std::make_shared<std::mutex>();
+  }
+  return session_fork<session>(*this, m_fork_mutex);
+}
+
+template<typename Session>
+session_fork<Session>::session_fork(Session& parent, std::shared_ptr<std::mutex> parent_mutex)
+  : m_parent{&parent}, m_parent_mutex{std::move(parent_mutex)} {}
+
+template<typename Session>
+std::optional<shared_bytes> session_fork<Session>::read(const shared_bytes& key) {
+  if (auto it = m_writes.find(key); it != std::end(m_writes)) {
+    return it->second;
+  }
+  if (auto it = m_reads.find(key); it != std::end(m_reads)) {
+    return it->second;
+  }
+
+  auto value = std::optional<shared_bytes>{};
+  {
+    auto lock = std::scoped_lock{*m_parent_mutex};
+    value = m_parent->read(key);
+  }
+  m_reads.emplace(key, value);
+  return value;
+}
+
+template<typename Session>
+void session_fork<Session>::write(const shared_bytes& key, const shared_bytes& value) {
+  m_writes.insert_or_assign(key, value);
+}
+
+template<typename Session>
+bool session_fork<Session>::contains(const shared_bytes& key) {
+  return read(key).has_value();
+}
+
+template<typename Session>
+void session_fork<Session>::erase(const shared_bytes& key) {
+  m_writes.insert_or_assign(key, std::nullopt);
+}
+
+template<typename Session>
+std::unordered_set<shared_bytes> session_fork<Session>::read_set() const {
+  auto results = std::unordered_set<shared_bytes>{};
+  for (const auto& it : m_reads) {
+    results.emplace(it.first);
+  }
+  return results;
+}
+
+template<typename Session>
+std::unordered_set<shared_bytes> session_fork<Session>::write_set() const {
+  auto results = std::unordered_set<shared_bytes>{};
+  for (const auto& it : m_writes) {
+    results.emplace(it.first);
+  }
+  return results;
+}
+
+template<typename Session>
+void session_fork<Session>::commit() {
+  auto lock = std::scoped_lock{*m_parent_mutex};
+  for (const auto& [key, value] : m_writes) {
+    if (value) {
+      m_parent->write(key, *value);
+    } else {
+      m_parent->erase(key);
+    }
+  }
+  undo();
+}
+
+template<typename Session>
+void session_fork<Session>::undo() {
+  m_reads.clear();
+  m_writes.clear();
+}
+
+template<typename Session>
+std::unordered_set<shared_bytes> session_fork<Session>::merge(session_fork&& other) {
+  auto conflicts = std::unordered_set<shared_bytes>{};
+  for (const auto& it : other.m_reads) {
+    if (m_writes.contains(it.first)) {
+      conflicts.emplace(it.first);
+    }
+  }
+  if (!conflicts.empty()) {
+    return conflicts;
+  }
+
+  // Keys other read weren't written here, so their values are still those of the forked session.
+  m_reads.merge(other.m_reads);
+  for (auto& [key, value] : other.m_writes) {
+    m_writes.insert_or_assign(key, std::move(value));
+  }
+  other.undo();
+  return conflicts;
+}
+
 } // namespace noir::db::session
@@ -0,0 +1,87 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/db/rocks_metrics.h>
+#include <noir/db/rocks_session.h>
+
+using namespace noir::db;
+
+namespace {
+
+std::shared_ptr<rocksdb::DB> make_db_with_statistics(const std::string& name) {
+  rocksdb::DestroyDB(name, rocksdb::Options{});
+  auto options = rocksdb::Options{};
+  options.create_if_missing = true;
+  enable_statistics(options);
+  rocksdb::DB* db{nullptr};
+  REQUIRE(rocksdb::DB::Open(options, name, &db).ok());
+  return std::shared_ptr<rocksdb::DB>(db);
+}
+
+auto to_bytes(const std::string& s) {
+  return noir::Bytes(std::span(reinterpret_cast<const unsigned char*>(s.data()), s.size()));
+}
+
+} // namespace
+
+TEST_CASE("rocks_metrics: collect_stats", "[noir][db]") {
+  auto db = make_db_with_statistics("/tmp/rocks_metrics");
+  auto s = session::make_session(db, 16);
+  for (auto i = 0; i < 1000; i++) {
+    s.write_from_bytes(to_bytes(std::to_string(i)), to_bytes(std::string(100, 'v')));
+  }
+  s.flush();
+  for (auto i = 0; i < 1000; i++) {
+    CHECK(s.read_from_bytes(to_bytes(std::to_string(i))));
+  }
+
+  auto stats = collect_stats(*db);
+  CHECK(stats.bytes_written > 100 * 1000);
+  CHECK(stats.bytes_read > 100 * 1000);
+  CHECK(stats.get.count == 1000);
+  CHECK(stats.write.count == 1000);
+  CHECK(stats.block_cache_hits + stats.block_cache_misses > 0);
+  REQUIRE(stats.column_families.size() == 1);
+  CHECK(stats.column_families[0].name == "default");
+  CHECK(stats.column_families[0].sst_bytes > 0);
+  CHECK(stats.column_families[0].estimated_keys > 0);
+  CHECK(!stats.column_families[0].write_stopped);
+}
+
+TEST_CASE("rocks_metrics: perf_scope", "[noir][db]") {
+  auto db = make_db_with_statistics("/tmp/rocks_metrics_perf");
+  auto s = session::make_session(db, 16);
+  set_perf_sample_every(1);
+  take_slow_ops();
+  auto before = get_op_stats()["test::write"].count;
+
+  {
+    perf_scope perf("test::write");
+    for (auto i = 0; i < 1000; i++) {
+      perf_scope nested("test::write_one");
+      s.write_from_bytes(to_bytes(std::to_string(i)), to_bytes("v"));
+    }
+  }
+  auto ops = take_slow_ops();
+  REQUIRE(ops.size() == 16);
+  CHECK(std::is_sorted(
+    ops.begin(), ops.end(), [](const auto& a, const auto& b) { return a.duration_ns > b.duration_ns; }));
+  CHECK(std::string(ops.front().name) == "test::write");
+  CHECK(ops.front().sampled);
+  CHECK(ops.front().memtable_write_ns > 0);
+  CHECK(std::none_of(ops.begin() + 1, ops.end(), [](const auto& op) { return op.sampled; }));
+  CHECK(take_slow_ops().empty());
+
+  auto op_stats = get_op_stats();
+  CHECK(op_stats["test::write"].count == before + 1);
+  CHECK(op_stats["test::write_one"].count >= 1000);
+  CHECK(op_stats["test::write"].max_ns >= op_stats["test::write_one"].max_ns);
+
+  set_perf_sample_every(0);
+  { perf_scope perf("test::write"); }
+  CHECK(!take_slow_ops().front().sampled);
+  set_perf_sample_every(16);
+}
@@ -0,0 +1,83 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <noir/db/rocks_session.h>
+#include <noir/db/session.h>
+#include "data_store_tests.h"
+#include <thread>
+
+using namespace noir::db::session;
+using namespace noir::db::session_tests;
+
+namespace {
+
+shared_bytes to_shared_bytes(std::string_view s) {
+  return shared_bytes(s.data(), s.size());
+}
+
+/// reads a key, spends some cpu on its value, and writes the result back, as a tx of an app would
+template<typename Data_store>
+void run_tx(Data_store& ds, const shared_bytes& key) {
+  auto value = ds.read(key);
+  auto h = std::hash<std::string_view>{}(value ? std::string_view(value->data(), value->size()) : "");
+  for (auto i = 0; i < 1000; i++) {
+    h = h * 31 + i;
+  }
+  ds.write(key, to_shared_bytes(std::to_string(h)));
+}
+
+} // namespace
+
+TEST_CASE("session_fork_benchmarks", "session_fork_tests") {
+  constexpr auto num_txs = 4096;
+  auto root_session = make_session("/tmp/session_fork_bench");
+  using session_type = session<decltype(root_session)>;
+  auto keys = std::vector<shared_bytes>{};
+  for (auto i = 0; i < num_txs; i++) {
+    keys.push_back(to_shared_bytes(fmt::format("key{:05}", i)));
+    root_session.write(keys.back(), to_shared_bytes("0"));
+  }
+
+  BENCHMARK_ADVANCED("Sequential")(Catch::Benchmark::Chronometer meter) {
+    auto block_session = session_type(root_session);
+    meter.measure([&]() {
+      auto tx_session = session_type(block_session, nullptr);
+      for (const auto& key : keys) {
+        run_tx(tx_session, key);
+      }
+      tx_session.commit();
+    });
+    block_session.undo();
+  };
+
+  for (auto num_forks : {2, 4, 8}) {
+    BENCHMARK_ADVANCED(fmt::format("Forks{}", num_forks))(Catch::Benchmark::Chronometer meter) {
+      auto block_session = session_type(root_session);
+      meter.measure([&]() {
+        auto forks = std::vector<session_fork<session_type>>{};
+        for (auto i = 0; i < num_forks; i++) {
+          forks.push_back(block_session.fork());
+        }
+        auto threads = std::vector<std::thread>{};
+        for (auto i = 0; i < num_forks; i++) {
+          threads.emplace_back([&, i]() {
+            for (auto j = i * num_txs / num_forks; j < (i + 1) * num_txs / num_forks; j++) {
+              run_tx(forks[i], keys[j]);
+            }
+          });
+        }
+        for (auto& t : threads) {
+          t.join();
+        }
+        for (auto i = 1; i < num_forks; i++) {
+          merge(forks[0], std::move(forks[i]));
+        }
+        forks[0].commit();
+      });
+      block_session.undo();
+    };
+  }
+}
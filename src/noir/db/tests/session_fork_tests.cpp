@@ -0,0 +1,138 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+
+#include <noir/db/rocks_session.h>
+#include <noir/db/session.h>
+#include "data_store_tests.h"
+#include <thread>
+
+using namespace noir::db::session;
+using namespace noir::db::session_tests;
+
+namespace {
+
+shared_bytes to_shared_bytes(std::string_view s) {
+  return shared_bytes(s.data(), s.size());
+}
+
+} // namespace
+
+TEST_CASE("session_fork_read_write_sets", "session_fork_tests") {
+  auto root_session = make_session("/tmp/session_fork1");
+  using session_type = session<decltype(root_session)>;
+  auto block_session = session_type(root_session);
+  block_session.write(to_shared_bytes("x"), to_shared_bytes("1"));
+  block_session.write(to_shared_bytes("y"), to_shared_bytes("2"));
+
+  auto a = block_session.fork();
+  auto b = block_session.fork();
+
+  // forks write privately
+  CHECK(a.read(to_shared_bytes("x")) == to_shared_bytes("1"));
+  a.write(to_shared_bytes("x"), to_shared_bytes("10"));
+  CHECK(a.read(to_shared_bytes("x")) == to_shared_bytes("10"));
+  CHECK(b.read(to_shared_bytes("x")) == to_shared_bytes("1"));
+  b.write(to_shared_bytes("z"), to_shared_bytes("3"));
+  b.erase(to_shared_bytes("y"));
+  CHECK(!b.contains(to_shared_bytes("y")));
+  CHECK(a.contains(to_shared_bytes("y")));
+  CHECK(!block_session.contains(to_shared_bytes("z")));
+
+  // keys written before being read aren't in the read set
+  CHECK((a.read_set() == std::unordered_set<shared_bytes>{to_shared_bytes("x"), to_shared_bytes("y")}));
+  CHECK(a.write_set() == std::unordered_set<shared_bytes>{to_shared_bytes("x")});
+  CHECK(b.read_set() == std::unordered_set<shared_bytes>{to_shared_bytes("x")});
+  CHECK((b.write_set() == std::unordered_set<shared_bytes>{to_shared_bytes("y"), to_shared_bytes("z")}));
+}
+
+TEST_CASE("session_fork_merge", "session_fork_tests") {
+  auto root_session = make_session("/tmp/session_fork2");
+  using session_type = session<decltype(root_session)>;
+  auto block_session = session_type(root_session);
+  block_session.write(to_shared_bytes("x"), to_shared_bytes("1"));
+  block_session.write(to_shared_bytes("y"), to_shared_bytes("2"));
+
+  auto a = block_session.fork();
+  a.write(to_shared_bytes("x"), to_shared_bytes("10"));
+  a.read(to_shared_bytes("y"));
+
+  // b read x, which a wrote, so b can't run after a
+  auto b = block_session.fork();
+  b.read(to_shared_bytes("x"));
+  b.write(to_shared_bytes("w"), to_shared_bytes("4"));
+  CHECK(merge(a, std::move(b)) == std::unordered_set<shared_bytes>{to_shared_bytes("x")});
+  CHECK(!a.contains(to_shared_bytes("w")));
+
+  // c only read y, which a read too, and wrote x after a
+  auto c = block_session.fork();
+  c.read(to_shared_bytes("y"));
+  c.write(to_shared_bytes("x"), to_shared_bytes("20"));
+  c.erase(to_shared_bytes("y"));
+  CHECK(merge(a, std::move(c)).empty());
+  CHECK(a.read(to_shared_bytes("x")) == to_shared_bytes("20"));
+  CHECK(!a.contains(to_shared_bytes("y")));
+
+  // the merged fork conflicts with what either fork wrote
+  auto d = block_session.fork();
+  d.read(to_shared_bytes("y"));
+  CHECK(merge(a, std::move(d)) == std::unordered_set<shared_bytes>{to_shared_bytes("y")});
+
+  a.commit();
+  CHECK(block_session.read(to_shared_bytes("x")) == to_shared_bytes("20"));
+  CHECK(!block_session.contains(to_shared_bytes("y")));
+  CHECK(a.write_set().empty());
+}
+
+TEST_CASE("session_fork_concurrent", "session_fork_tests") {
+  constexpr auto num_forks = 8;
+  constexpr auto num_keys = 100;
+  auto root_session = make_session("/tmp/session_fork3");
+  using session_type = session<decltype(root_session)>;
+  auto block_session = session_type(root_session);
+  block_session.write(to_shared_bytes("total"), to_shared_bytes("0"));
+
+  // each fork sets disjoint keys, and counts them in total, which all forks write
+  auto run = [&](auto& f, int index) {
+    for (auto i = index; i < num_keys; i += num_forks) {
+      f.write(to_shared_bytes(std::to_string(i)), to_shared_bytes(std::to_string(index)));
+      auto total = f.read(to_shared_bytes("total"));
+      auto sum = std::stoi(std::string(total->data(), total->size())) + 1;
+      f.write(to_shared_bytes("total"), to_shared_bytes(std::to_string(sum)));
+    }
+  };
+
+  auto forks = std::vector<session_fork<session_type>>{};
+  for (auto i = 0; i < num_forks; i++) {
+    forks.push_back(block_session.fork());
+  }
+  auto threads = std::vector<std::thread>{};
+  for (auto i = 0; i < num_forks; i++) {
+    threads.emplace_back([&, i]() { run(forks[i], i); });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  // merges in order, and runs a fork in conflict again once the forks merged before it are committed
+  auto reruns = 0;
+  auto merged = std::move(forks[0]);
+  for (auto i = 1; i < num_forks; i++) {
+    if (!merge(merged, std::move(forks[i])).empty()) {
+      merged.commit();
+      forks[i].undo();
+      run(forks[i], i);
+      CHECK(merge(merged, std::move(forks[i])).empty());
+      reruns++;
+    }
+  }
+  merged.commit();
+  CHECK(reruns == num_forks - 1);
+
+  CHECK(block_session.read(to_shared_bytes("total")) == to_shared_bytes(std::to_string(num_keys)));
+  for (auto i = 0; i < num_keys; i++) {
+    CHECK(block_session.read(to_shared_bytes(std::to_string(i))) == to_shared_bytes(std::to_string(i % num_forks)));
+  }
+}
@@ -0,0 +1,43 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/common/bytes.h>
+#include <noir/crypto/hash/keccak.h>
+#include <array>
+#include <span>
+
+namespace noir::eth {
+
+using Bytes256 = BytesN<256>;
+
+constexpr size_t bloom_bit_length = 2048;
+
+/// \brief bits a value sets in a 2048-bit log bloom, numbered from the lowest bit of the last byte
+inline std::array<uint16_t, 3> bloom_bits(std::span<const unsigned char> value) {
+  std::array<unsigned char, 32> hash;
+  crypto::Keccak256().init().update(value).final(hash);
+  std::array<uint16_t, 3> bits;
+  for (auto i = 0; i < 3; i++) {
+    bits[i] = ((hash[i * 2] << 8) | hash[i * 2 + 1]) & (bloom_bit_length - 1);
+  }
+  return bits;
+}
+
+inline void bloom_set(Bytes256& bloom, uint16_t bit) {
+  bloom[bloom.size() - 1 - bit / 8] |= 1 << (bit % 8);
+}
+
+inline bool bloom_test(const Bytes256& bloom, uint16_t bit) {
+  return bloom[bloom.size() - 1 - bit / 8] & (1 << (bit % 8));
+}
+
+inline void bloom_add(Bytes256& bloom, std::span<const unsigned char> value) {
+  for (auto bit : bloom_bits(value)) {
+    bloom_set(bloom, bit);
+  }
+}
+
+} // namespace noir::eth
@@ -0,0 +1,143 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <noir/eth/common/bloom_bits.h>
+#include <bit>
+#include <future>
+#include <mutex>
+
+namespace noir::eth {
+
+void bloom_bits_index::add(uint64_t height, const Bytes256& bloom) {
+  auto index = height / section_size;
+  auto pos = height % section_size;
+
+  std::unique_lock g{mtx};
+  if (sections.size() <= index)
+    sections.resize(index + 1);
+  head_height = std::max(head_height, height);
+
+  for (auto i = 0; i < bloom.size(); i++) {
+    if (!bloom[i])
+      continue;
+    if (!sections[index])
+      sections[index] = std::make_unique<section>();
+    for (auto b = 0; b < 8; b++) {
+      if (!(bloom[i] & (1 << b)))
+        continue;
+      auto& r = sections[index]->rows[(bloom.size() - 1 - i) * 8 + b];
+      if (!r)
+        r = std::make_unique<row>(row{});
+      (*r)[pos / 64] |= uint64_t(1) << (pos % 64);
+    }
+  }
+}
+
+std::vector<uint64_t> bloom_bits_index::candidates(const log_filter& filter) const {
+  // a block matches if, for every group, the bits of any of its values are all set
+  std::vector<std::vector<std::array<uint16_t, 3>>> groups;
+  if (!filter.addresses.empty()) {
+    auto& group = groups.emplace_back();
+    for (const auto& address : filter.addresses) {
+      group.push_back(bloom_bits(address));
+    }
+  }
+  for (const auto& topics : filter.topics) {
+    if (topics.empty())
+      continue;
+    auto& group = groups.emplace_back();
+    for (const auto& topic : topics) {
+      group.push_back(bloom_bits(topic));
+    }
+  }
+
+  std::vector<uint64_t> heights;
+  std::shared_lock g{mtx};
+  auto to_block = std::min(filter.to_block, head_height);
+  if (filter.from_block > to_block)
+    return heights;
+
+  for (auto index = filter.from_block / section_size; index <= to_block / section_size; index++) {
+    // sections not indexed yet or without any bloom bit set have no logs
+    if (index >= sections.size() || !sections[index])
+      continue;
+    const auto& rows = sections[index]->rows;
+
+    row matched{};
+    auto begin = std::max(filter.from_block, index * section_size) - index * section_size;
+    auto end = std::min(to_block, (index + 1) * section_size - 1) - index * section_size + 1;
+    for (auto pos = begin; pos < end; pos++) {
+      matched[pos / 64] |= uint64_t(1) << (pos % 64);
+    }
+
+    for (const auto& group : groups) {
+      row any{};
+      for (const auto& bits : group) {
+        const auto &r0 = rows[bits[0]], &r1 = rows[bits[1]], &r2 = rows[bits[2]];
+        if (!r0 || !r1 || !r2)
+          continue;
+        for (auto w = 0; w < any.size(); w++) {
+          any[w] |= (*r0)[w] & (*r1)[w] & (*r2)[w];
+        }
+      }
+      auto remaining = uint64_t(0);
+      for (auto w = 0; w < matched.size(); w++) {
+        matched[w] &= any[w];
+        remaining |= matched[w];
+      }
+      if (!remaining)
+        break;
+    }
+
+    for (auto w = 0; w < matched.size(); w++) {
+      for (auto bits = matched[w]; bits; bits &= bits - 1) {
+        heights.push_back(index * section_size + w * 64 + std::countr_zero(bits));
+      }
+    }
+  }
+  return heights;
+}
+
+uint64_t bloom_bits_index::head() const {
+  std::shared_lock g{mtx};
+  return head_height;
+}
+
+std::vector<log> find_logs(const bloom_bits_index& index,
+  const log_filter& filter,
+  const receipts_loader& load_receipts,
+  boost::asio::io_context& thread_pool,
+  size_t batch_size) {
+  auto heights = index.candidates(filter);
+
+  std::vector<std::future<std::vector<log>>> batches;
+  for (size_t begin = 0; begin < heights.size(); begin += batch_size) {
+    auto end = std::min(begin + batch_size, heights.size());
+    batches.push_back(async_thread_pool(thread_pool, [&, begin, end]() {
+      std::vector<log> logs;
+      for (auto i = begin; i < end; i++) {
+        for (const auto& r : load_receipts(heights[i])) {
+          std::copy_if(r.logs.begin(), r.logs.end(), std::back_inserter(logs), [&](const auto& l) {
+            return filter.matches(l);
+          });
+        }
+      }
+      return logs;
+    }));
+  }
+
+  // batches refer to heights and filter, so all of them must finish before an error is thrown
+  for (auto& batch : batches) {
+    batch.wait();
+  }
+  std::vector<log> logs;
+  for (auto& batch : batches) {
+    auto found = batch.get();
+    logs.insert(logs.end(), std::make_move_iterator(found.begin()), std::make_move_iterator(found.end()));
+  }
+  return logs;
+}
+
+} // namespace noir::eth
@@ -0,0 +1,57 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/common/thread_pool.h>
+#include <noir/eth/common/bloom.h>
+#include <noir/eth/common/log_filter.h>
+#include <noir/eth/common/receipt.h>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+
+namespace noir::eth {
+
+/// \brief index of block blooms for log range queries
+/// Blooms are stored transposed in sections of section_size blocks: row i of a section holds bit i of the blooms of
+/// all its blocks, so testing a value against a whole section takes the AND of 3 rows. Rows without any bit set are
+/// not allocated, which also lets a section be skipped as soon as one of the rows of a value is missing.
+class bloom_bits_index {
+public:
+  static constexpr uint64_t section_size = 4096;
+
+  /// \brief indexes the bloom of a block; blocks may be added in any order
+  void add(uint64_t height, const Bytes256& bloom);
+
+  /// \brief heights of blocks in [filter.from_block, filter.to_block] whose blooms may match filter, in ascending order
+  std::vector<uint64_t> candidates(const log_filter& filter) const;
+
+  /// \brief height of the highest block added
+  uint64_t head() const;
+
+private:
+  using row = std::array<uint64_t, section_size / 64>;
+
+  struct section {
+    std::array<std::unique_ptr<row>, bloom_bit_length> rows;
+  };
+
+  mutable std::shared_mutex mtx;
+  std::vector<std::unique_ptr<section>> sections;
+  uint64_t head_height{0};
+};
+
+using receipts_loader = std::function<std::vector<receipt>(uint64_t height)>;
+
+/// \brief logs matching filter, in block order
+/// Receipts of candidate blocks are loaded in batches on thread_pool, and only logs of the blocks whose blooms match
+/// are checked against filter. Must not be called from a thread of thread_pool.
+std::vector<log> find_logs(const bloom_bits_index& index,
+  const log_filter& filter,
+  const receipts_loader& load_receipts,
+  boost::asio::io_context& thread_pool,
+  size_t batch_size = 64);
+
+} // namespace noir::eth
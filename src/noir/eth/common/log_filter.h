@@ -0,0 +1,34 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/eth/common/log.h>
+#include <algorithm>
+
+namespace noir::eth {
+
+/// \brief criteria of eth_getLogs
+/// A log matches if it is emitted by any of addresses and, for each position of topics, its topic at the position is
+/// any of the given ones. Empty addresses or an empty list of topics matches anything.
+struct log_filter {
+  uint64_t from_block;
+  uint64_t to_block;
+  std::vector<Bytes20> addresses;
+  std::vector<std::vector<Bytes32>> topics;
+
+  bool matches(const log& l) const {
+    if (!addresses.empty() && std::find(addresses.begin(), addresses.end(), l.address) == addresses.end())
+      return false;
+    if (topics.size() > l.topics.size())
+      return false;
+    for (auto i = 0; i < topics.size(); i++) {
+      if (!topics[i].empty() && std::find(topics[i].begin(), topics[i].end(), l.topics[i]) == topics[i].end())
+        return false;
+    }
+    return true;
+  }
+};
+
+} // namespace noir::eth
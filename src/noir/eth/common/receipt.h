@@ -4,12 +4,11 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 #pragma once
+#include <noir/eth/common/bloom.h>
 #include <noir/eth/common/log.h>
 
 namespace noir::eth {
 
-using Bytes256 = BytesN<256>;
-
 struct receipt {
   uint8_t type;
   uint64_t status;
@@ -24,4 +23,16 @@ struct receipt {
   uint32_t transaction_index;
 };
 
+/// \brief bloom of the addresses and topics of logs
+inline Bytes256 make_bloom(const std::vector<log>& logs) {
+  Bytes256 bloom{};
+  for (const auto& l : logs) {
+    bloom_add(bloom, l.address);
+    for (const auto& topic : l.topics) {
+      bloom_add(bloom, topic);
+    }
+  }
+  return bloom;
+}
+
 } // namespace noir::eth
@@ -0,0 +1,88 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/eth/common/bloom_bits.h>
+#include <cstring>
+
+using namespace noir;
+using namespace noir::eth;
+
+namespace {
+
+constexpr uint64_t num_blocks = 1'000'000;
+constexpr uint64_t num_addresses = 1000;
+constexpr uint64_t num_topics = 100;
+
+// one in every 16 blocks has a log, whose address and topic are derived from the height
+bool has_log(uint64_t height) {
+  return (height * 0x9e3779b97f4a7c15) >> 60 == 0;
+}
+
+Bytes20 address_of(uint64_t height) {
+  Bytes20 address{};
+  auto n = height * 0xff51afd7ed558ccd % num_addresses;
+  std::memcpy(address.data(), &n, sizeof(n));
+  return address;
+}
+
+Bytes32 topic_of(uint64_t height) {
+  Bytes32 topic{};
+  auto n = height * 0xc4ceb9fe1a85ec53 % num_topics;
+  std::memcpy(topic.data(), &n, sizeof(n));
+  return topic;
+}
+
+std::vector<receipt> receipts_of(uint64_t height) {
+  if (!has_log(height))
+    return {};
+  return {receipt{.logs = {eth::log{.address = address_of(height), .topics = {topic_of(height)}}}}};
+}
+
+} // namespace
+
+TEST_CASE("eth:bloom_bits: 1M block range query", "[eth][common]") {
+  bloom_bits_index index;
+  for (uint64_t h = 1; h <= num_blocks; h++) {
+    if (has_log(h))
+      index.add(h, make_bloom(receipts_of(h)[0].logs));
+  }
+
+  auto address = address_of(7);
+  auto topic = topic_of(7);
+  auto scan = [&](const log_filter& filter) {
+    std::vector<eth::log> logs;
+    for (auto h = filter.from_block; h <= filter.to_block; h++) {
+      for (const auto& r : receipts_of(h)) {
+        std::copy_if(r.logs.begin(), r.logs.end(), std::back_inserter(logs), [&](const auto& l) {
+          return filter.matches(l);
+        });
+      }
+    }
+    return logs;
+  };
+
+  named_thread_pool thread_pool("eth_logs", 4);
+  auto by_address = log_filter{.from_block = 1, .to_block = num_blocks, .addresses = {address}};
+  auto by_both = log_filter{.from_block = 1, .to_block = num_blocks, .addresses = {address}, .topics = {{topic}}};
+  auto expected = scan(by_address);
+  auto found = find_logs(index, by_address, receipts_of, thread_pool.get_executor());
+  CHECK(found.size() == expected.size());
+  WARN(fmt::format("{} logs of address over {} blocks, {} candidates", found.size(), num_blocks,
+    index.candidates(by_address).size()));
+
+  BENCHMARK("candidates: address") {
+    return index.candidates(by_address);
+  };
+  BENCHMARK("candidates: address and topic") {
+    return index.candidates(by_both);
+  };
+  BENCHMARK("find_logs: address") {
+    return find_logs(index, by_address, receipts_of, thread_pool.get_executor());
+  };
+  BENCHMARK("scan receipts: address") {
+    return scan(by_address);
+  };
+}
@@ -0,0 +1,100 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/eth/common/bloom_bits.h>
+#include <map>
+
+using namespace noir;
+using namespace noir::eth;
+
+namespace {
+
+Bytes20 address_of(uint8_t n) {
+  Bytes20 address{};
+  address[19] = n;
+  return address;
+}
+
+Bytes32 topic_of(uint8_t n) {
+  Bytes32 topic{};
+  topic[31] = n;
+  return topic;
+}
+
+} // namespace
+
+TEST_CASE("eth:bloom: make_bloom", "[eth][common]") {
+  auto l = eth::log{.address = address_of(1), .topics = {topic_of(1), topic_of(2)}};
+  auto bloom = make_bloom({l});
+  for (auto bit : bloom_bits(address_of(1))) {
+    CHECK(bloom_test(bloom, bit));
+  }
+  for (auto bit : bloom_bits(topic_of(2))) {
+    CHECK(bloom_test(bloom, bit));
+  }
+  CHECK(make_bloom({}) == Bytes256{});
+}
+
+TEST_CASE("eth:bloom_bits: candidates and find_logs", "[eth][common]") {
+  // blocks spanning 3 sections, each with a log of address (height % 3) and topics [height % 5, height % 7]
+  constexpr uint64_t num_blocks = bloom_bits_index::section_size * 2 + 100;
+  std::map<uint64_t, std::vector<receipt>> receipts;
+  bloom_bits_index index;
+  for (uint64_t h = 1; h <= num_blocks; h++) {
+    auto l = eth::log{.address = address_of(h % 3), .topics = {topic_of(h % 5), topic_of(h % 7)}, .block_number = h};
+    receipts[h].push_back(receipt{.logs = {l}});
+    index.add(h, make_bloom({l}));
+  }
+  CHECK(index.head() == num_blocks);
+
+  auto expected = [&](const log_filter& filter) {
+    std::vector<uint64_t> heights;
+    for (auto h = filter.from_block; h <= std::min(filter.to_block, num_blocks); h++) {
+      if (filter.matches(receipts[h][0].logs[0]))
+        heights.push_back(h);
+    }
+    return heights;
+  };
+
+  named_thread_pool thread_pool("eth_logs", 4);
+  auto check_filter = [&](const log_filter& filter) {
+    auto heights = expected(filter);
+    auto candidates = index.candidates(filter);
+    // blooms may give false positives, but never false negatives
+    CHECK(std::includes(candidates.begin(), candidates.end(), heights.begin(), heights.end()));
+
+    auto logs = find_logs(
+      index, filter, [&](uint64_t h) { return receipts[h]; }, thread_pool.get_executor(), 16);
+    std::vector<uint64_t> found;
+    std::transform(logs.begin(), logs.end(), std::back_inserter(found), [](const auto& l) {
+      return static_cast<uint64_t>(l.block_number);
+    });
+    CHECK(found == heights);
+  };
+
+  check_filter({.from_block = 1, .to_block = num_blocks, .addresses = {address_of(1)}});
+  check_filter({.from_block = 1, .to_block = num_blocks, .addresses = {address_of(0), address_of(2)}});
+  check_filter({.from_block = 100, .to_block = 5000, .topics = {{topic_of(3)}}});
+  check_filter({.from_block = 1, .to_block = num_blocks, .topics = {{}, {topic_of(6)}}});
+  check_filter({.from_block = 4000,
+    .to_block = 8300,
+    .addresses = {address_of(2)},
+    .topics = {{topic_of(1), topic_of(4)}, {topic_of(0)}}});
+  check_filter({.from_block = 1, .to_block = 10, .addresses = {address_of(9)}});
+  check_filter({.from_block = num_blocks - 10, .to_block = num_blocks + 1000});
+  CHECK(index.candidates({.from_block = num_blocks + 1, .to_block = num_blocks + 10}).empty());
+}
+
+TEST_CASE("eth:bloom_bits: empty index", "[eth][common]") {
+  bloom_bits_index index;
+  CHECK(index.head() == 0);
+  CHECK(index.candidates({.from_block = 0, .to_block = 0}).empty());
+  CHECK(index.candidates({.from_block = 0, .to_block = 1000, .addresses = {address_of(1)}}).empty());
+
+  // a block without logs leaves its section unallocated
+  index.add(1, Bytes256{});
+  CHECK(index.candidates({.from_block = 0, .to_block = 1}).empty());
+}
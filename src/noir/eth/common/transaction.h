@@ -6,6 +6,7 @@
 #pragma once
 #include <noir/common/bytes.h>
 #include <noir/common/inttypes.h>
+#include <noir/crypto/hash/keccak.h>
 #include <memory>
 
 namespace noir::eth {
@@ -29,6 +30,13 @@ struct transaction {
 
 using transaction_p = std::shared_ptr<transaction>;
 
+/// \brief eth tx hash, keccak256 of the rlp encoded signed tx
+inline Bytes32 get_tx_hash(std::span<const unsigned char> raw_tx) {
+  Bytes32 hash;
+  crypto::Keccak256().init().update(raw_tx).final(hash);
+  return hash;
+}
+
 struct rpc_transaction : public transaction {
   Bytes32 block_hash;
   uint256_t block_number;
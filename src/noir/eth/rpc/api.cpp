@@ -9,12 +9,40 @@
 #include <noir/eth/common/block.h>
 #include <noir/eth/common/receipt.h>
 #include <noir/eth/rpc/api.h>
+#include <fc/io/json.hpp>
 #include <fmt/core.h>
 
 namespace noir::eth::api {
 
 using namespace noir::codec;
 
+namespace {
+  fc::variant log_to_json(const log& l) {
+    fc::variants topics;
+    for (const auto& t : l.topics) {
+      topics.emplace_back(to_data(t));
+    }
+    fc::mutable_variant_object l_mvo;
+    l_mvo("address", to_data(l.address));
+    l_mvo("topics", topics);
+    l_mvo("data", to_data(l.data));
+    l_mvo("blockNumber", to_quantity(static_cast<uint64_t>(l.block_number)));
+    l_mvo("transactionHash", to_data(l.tx_hash));
+    l_mvo("transactionIndex", to_quantity(l.tx_index));
+    l_mvo("blockHash", to_data(l.block_hash));
+    l_mvo("logIndex", to_quantity(l.index));
+    l_mvo("removed", l.removed);
+    return l_mvo;
+  }
+
+  /// big-endian integer as a quantity, without leading zeros
+  std::string bytes_to_quantity(const std::string& v) {
+    auto hex = to_hex(v);
+    auto pos = hex.find_first_not_of('0');
+    return pos == std::string::npos ? "0x0" : "0x" + hex.substr(pos);
+  }
+} // namespace
+
 void api::check_params_size(const fc::variants& params, const uint32_t size) {
   check(!(params.size() < size), fmt::format("missing value for required argument {}", params.size()));
   check(!(params.size() > size), fmt::format("too many arguments, want at most {}", size));
@@ -38,6 +66,18 @@ void api::check_hash(const std::string& hash, const uint32_t index) {
     fmt::format("invalid argument {}: hex string has length {}, want 64 for hash", index, (hash.size() - 2)));
 }
 
+int64_t api::parse_block_number(const std::string& block_number, const uint32_t index) {
+  if (block_number == "latest" || block_number == "pending")
+    return 0;
+  if (block_number == "earliest")
+    return 1;
+  check(block_number.starts_with("0x"),
+    fmt::format("invalid argument {}: json: cannot unmarshal hex string without 0x prefix", index));
+  auto height = std::stoll(block_number, nullptr, 16);
+  check(height > 0, fmt::format("invalid argument {}: block number must be positive", index));
+  return height;
+}
+
 fc::variant api::send_raw_tx(const fc::variant& req) {
   check(req.is_array(), "invalid json request");
   auto& params = req.get_array();
@@ -55,8 +95,7 @@ fc::variant api::send_raw_tx(const fc::variant& req) {
   // TODO: add tx pool and return tx_hash
   consensus::tx tx(from_hex(rlp));
   tx_pool_ptr->check_tx_sync(std::make_shared<consensus::tx>(tx));
-  auto tx_hash = noir::consensus::get_tx_hash(tx);
-  return fc::variant(fmt::format("0x{}", tx_hash.to_string()));
+  return fc::variant(to_data(get_tx_hash(tx)));
 }
 
 fc::variant api::chain_id(const fc::variant& req) {
@@ -84,11 +123,9 @@ fc::variant api::get_balance(const fc::variant& req) {
   auto address = params[0].get_string();
   check_address(address, 0);
   check(params[1].is_string(), "invalid argument 1: json: cannot unmarshal non-string");
-  auto block_number = params[1].get_string();
-  check(block_number == "latest", "invalid argument 1: not supported block_number: only support latest");
-
-  // TODO: get balance
-  return fc::variant("0x0");
+  auto height = parse_block_number(params[1].get_string(), 1);
+  auto addr = from_hex(address);
+  return fc::variant(bytes_to_quantity(query("/eth/balance", {addr.begin(), addr.end()}, height)));
 }
 
 fc::variant api::get_tx_count(const fc::variant& req) {
@@ -99,11 +136,9 @@ fc::variant api::get_tx_count(const fc::variant& req) {
   auto address = params[0].get_string();
   check_address(address, 0);
   check(params[1].is_string(), "invalid argument 1: json: cannot unmarshal non-string");
-  auto block_number = params[1].get_string();
-  check(block_number == "latest", "invalid argument 1: not supported block_number: only support latest");
-
-  // TODO: get tx count
-  return fc::variant("0x0");
+  auto height = parse_block_number(params[1].get_string(), 1);
+  auto addr = from_hex(address);
+  return fc::variant(bytes_to_quantity(query("/eth/nonce", {addr.begin(), addr.end()}, height)));
 }
 
 fc::variant api::block_number(const fc::variant& req) {
@@ -132,9 +167,14 @@ fc::variant api::get_tx_by_hash(const fc::variant& req) {
   check(params[0].is_string(), "invalid argument 0: json: cannot unmarshal non-string");
   auto hash = params[0].get_string();
   check_hash(hash, 0);
-  // TODO: get tx by hash
-  rpc_transaction t;
-  return fc::variant(nullptr);
+  check(views != nullptr, "eth views are not available");
+  auto loc = views->find_tx(Bytes32(std::string_view(hash).substr(2)));
+  if (!loc)
+    return fc::variant(nullptr);
+  auto view = views->load_block(loc->height);
+  if (!view || loc->index >= view->txs.size())
+    return fc::variant(nullptr);
+  return view->txs[loc->index];
 }
 
 fc::variant api::get_block_by_number(const fc::variant& req) {
@@ -148,15 +188,18 @@ fc::variant api::get_block_by_number(const fc::variant& req) {
     "invalid argument 0: json: cannot unmarshal hex string without 0x prefix");
   check(params[1].is_bool(), "invalid argument 1: json: cannot unmarshal into bool");
   auto full_tx = params[1].as_bool();
-  auto height = std::stoull(block_number, nullptr, 16);
-  consensus::block cb;
-  if (block_store_ptr->load_block((int64_t)height, cb)) {
-    // TODO: get block by number
-    block b(cb);
-    return fc::variant(b.to_json());
+  check(views != nullptr, "eth views are not available");
+  uint64_t height;
+  if (block_number == "earliest") {
+    height = block_store_ptr->base();
+  } else if (block_number == "pending" || block_number == "latest") {
+    height = block_store_ptr->height();
   } else {
-    return fc::variant(nullptr);
+    height = std::stoull(block_number, nullptr, 16);
   }
+  if (auto view = views->load_block(height))
+    return view->to_json(full_tx);
+  return fc::variant(nullptr);
 }
 
 fc::variant api::get_block_by_hash(const fc::variant& req) {
@@ -168,14 +211,13 @@ fc::variant api::get_block_by_hash(const fc::variant& req) {
   check_hash(hash, 0);
   check(params[1].is_bool(), "invalid argument 1: json: cannot unmarshal into bool");
   auto full_tx = params[1].as_bool();
-  consensus::block cb;
-  if (block_store_ptr->load_block_by_hash(from_hex(hash), cb)) {
-    // TODO: get block by hash
-    block b(cb);
-    return fc::variant(b.to_json());
-  } else {
+  check(views != nullptr, "eth views are not available");
+  auto height = views->find_block(Bytes32(std::string_view(hash).substr(2)));
+  if (!height)
     return fc::variant(nullptr);
-  }
+  if (auto view = views->load_block(*height))
+    return view->to_json(full_tx);
+  return fc::variant(nullptr);
 }
 
 fc::variant api::get_tx_receipt(const fc::variant& req) {
@@ -185,15 +227,131 @@ fc::variant api::get_tx_receipt(const fc::variant& req) {
   check(params[0].is_string(), "invalid argument 0: json: cannot unmarshal non-string");
   auto hash = params[0].get_string();
   check_hash(hash, 0);
-  // TODO: get tx receipt
-  receipt r;
-  return fc::variant(nullptr);
+  check(views != nullptr, "eth views are not available");
+  auto loc = views->find_tx(Bytes32(std::string_view(hash).substr(2)));
+  if (!loc)
+    return fc::variant(nullptr);
+  auto receipts = views->load_receipts(loc->height);
+  if (loc->index >= receipts.size())
+    return fc::variant(nullptr);
+  const auto& r = receipts[loc->index];
+
+  fc::variants logs;
+  for (const auto& l : r.logs) {
+    logs.push_back(log_to_json(l));
+  }
+  fc::mutable_variant_object r_mvo;
+  r_mvo("type", to_quantity(r.type));
+  r_mvo("status", to_quantity(r.status));
+  r_mvo("cumulativeGasUsed", to_quantity(r.cumulative_gas_used));
+  r_mvo("logsBloom", to_data(r.bloom));
+  r_mvo("logs", logs);
+  r_mvo("transactionHash", to_data(r.tx_hash));
+  r_mvo("contractAddress", nullptr);
+  r_mvo("gasUsed", to_quantity(r.gas_used));
+  r_mvo("blockHash", to_data(r.block_hash));
+  r_mvo("blockNumber", to_quantity(static_cast<uint64_t>(r.block_number)));
+  r_mvo("transactionIndex", to_quantity(r.transaction_index));
+  return r_mvo;
+}
+
+fc::variant api::get_logs(const fc::variant& req) {
+  check(req.is_array(), "invalid json request");
+  auto& params = req.get_array();
+  check_params_size(params, 1);
+  check(params[0].is_object(), "invalid argument 0: json: cannot unmarshal non-object");
+  check(log_index != nullptr, "eth_getLogs is not available");
+  auto& crit = params[0].get_object();
+  check(!crit.contains("blockHash"), "invalid argument 0: not supported blockHash: only support block range");
+
+  auto latest = block_store_ptr ? static_cast<uint64_t>(block_store_ptr->height()) : log_index->head();
+  auto parse_block_number = [&](const char* key, uint64_t def) -> uint64_t {
+    if (!crit.contains(key))
+      return def;
+    check(crit[key].is_string(), "invalid argument 0: json: cannot unmarshal non-string into {}", key);
+    auto block_number = crit[key].get_string();
+    if (block_number == "latest" || block_number == "pending")
+      return latest;
+    if (block_number == "earliest")
+      return 0;
+    check(block_number.starts_with("0x"), "invalid argument 0: json: cannot unmarshal hex string without 0x prefix");
+    return std::stoull(block_number, nullptr, 16);
+  };
+  auto parse_hash = [&](const fc::variant& v) {
+    check(v.is_string(), "invalid argument 0: json: cannot unmarshal non-string into topic");
+    check_hash(v.get_string(), 0);
+    return Bytes32(std::string_view(v.get_string()).substr(2));
+  };
+
+  log_filter filter{
+    .from_block = parse_block_number("fromBlock", latest), .to_block = parse_block_number("toBlock", latest)};
+  if (crit.contains("address")) {
+    auto addresses = crit["address"].is_array() ? crit["address"].get_array() : fc::variants{crit["address"]};
+    for (const auto& a : addresses) {
+      check(a.is_string(), "invalid argument 0: json: cannot unmarshal non-string into address");
+      check_address(a.get_string(), 0);
+      filter.addresses.emplace_back(std::string_view(a.get_string()).substr(2));
+    }
+  }
+  if (crit.contains("topics")) {
+    check(crit["topics"].is_array(), "invalid argument 0: json: cannot unmarshal non-array into topics");
+    for (const auto& position : crit["topics"].get_array()) {
+      auto& topics = filter.topics.emplace_back();
+      if (position.is_array()) {
+        for (const auto& t : position.get_array()) {
+          topics.push_back(parse_hash(t));
+        }
+      } else if (!position.is_null()) {
+        topics.push_back(parse_hash(position));
+      }
+    }
+  }
+
+  fc::variants logs;
+  for (const auto& l : find_logs(*log_index, filter, load_receipts, log_thread_pool->get_executor())) {
+    logs.push_back(log_to_json(l));
+  }
+  return fc::variant(logs);
 }
 
 fc::variant api::call(const fc::variant& req) {
   check(req.is_array(), "invalid json request");
-  // TODO: call
-  return fc::variant("0x0");
+  auto& params = req.get_array();
+  check_params_size(params, std::clamp<uint32_t>(params.size(), 1, 2));
+  check(params[0].is_object(), "invalid argument 0: json: cannot unmarshal non-object");
+  auto& args = params[0].get_object();
+  int64_t height = 0;
+  if (params.size() > 1) {
+    check(params[1].is_string(), "invalid argument 1: json: cannot unmarshal non-string");
+    height = parse_block_number(params[1].get_string(), 1);
+  }
+
+  // fields are ordered and unknown ones dropped, so that identical calls share a cache entry of the query
+  fc::mutable_variant_object call_mvo;
+  for (const std::string key : {"from", "to", "gas", "gasPrice", "value", "data"}) {
+    auto field = key == "data" && !args.contains(key) ? "input" : key;
+    if (!args.contains(field))
+      continue;
+    check(args[field].is_string(), fmt::format("invalid argument 0: json: cannot unmarshal non-string into {}", field));
+    if (key == "from" || key == "to")
+      check_address(args[field].get_string(), 0);
+    call_mvo(key, args[field]);
+  }
+  auto data = fc::json::to_string(fc::variant(call_mvo), fc::time_point::maximum());
+  return fc::variant("0x" + to_hex(query("/eth/call", data, height)));
+}
+
+std::string api::query(const std::string& path, const std::string& data, int64_t height) {
+  check(query_conn != nullptr, "eth queries are not available");
+  tendermint::abci::RequestQuery req;
+  req.set_path(path);
+  req.set_data(data);
+  req.set_height(height);
+  auto res = query_conn->query(req);
+  if (!res)
+    check(false, res.error().message());
+  check((*res)->code() == 0, fmt::format("execution reverted: {}", (*res)->log()));
+  return (*res)->value();
 }
 
 } // namespace noir::eth::api
@@ -4,7 +4,10 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 #pragma once
+#include <noir/common/thread_pool.h>
 #include <noir/consensus/abci.h>
+#include <noir/eth/common/bloom_bits.h>
+#include <noir/eth/rpc/view_store.h>
 #include <noir/tx_pool/tx_pool.h>
 #include <fc/variant.hpp>
 
@@ -25,11 +28,14 @@ public:
   fc::variant get_block_by_number(const fc::variant& req);
   fc::variant get_block_by_hash(const fc::variant& req);
   fc::variant get_tx_receipt(const fc::variant& req);
+  fc::variant get_logs(const fc::variant& req);
   fc::variant call(const fc::variant& req);
 
   static void check_params_size(const fc::variants& params, const uint32_t size);
   static void check_address(const std::string& address, const uint32_t index);
   static void check_hash(const std::string& hash, const uint32_t index);
+  /// \return height of block_number, where 0 stands for the latest block
+  static int64_t parse_block_number(const std::string& block_number, const uint32_t index);
 
   void set_tx_fee_cap(const uint256_t& tx_fee_cap) {
     this->tx_fee_cap = tx_fee_cap;
@@ -47,12 +53,38 @@ public:
     this->block_store_ptr = block_store_ptr;
   }
 
+  void set_view_store(const std::shared_ptr<view_store>& views) {
+    this->views = views;
+  }
+
+  /// \brief enables get_balance, get_tx_count and call, which are served by abci queries of paths under /eth
+  void set_query_connection(const std::shared_ptr<noir::consensus::query_connection>& query_conn) {
+    this->query_conn = query_conn;
+  }
+
+  /// \brief enables get_logs, which looks up index and then loads receipts of candidate blocks on num_threads threads
+  void set_log_index(
+    const std::shared_ptr<bloom_bits_index>& log_index, receipts_loader load_receipts, size_t num_threads = 4) {
+    this->log_index = log_index;
+    this->load_receipts = std::move(load_receipts);
+    log_thread_pool = std::make_unique<named_thread_pool>("eth_logs", num_threads);
+  }
+
 private:
+  /// \param height 0 for the latest block
+  std::string query(const std::string& path, const std::string& data, int64_t height);
+
   uint256_t tx_fee_cap;
   bool allow_unprotected_txs;
 
   noir::tx_pool::tx_pool* tx_pool_ptr;
   std::shared_ptr<noir::consensus::block_store> block_store_ptr;
+
+  std::shared_ptr<view_store> views;
+  std::shared_ptr<noir::consensus::query_connection> query_conn;
+  std::shared_ptr<bloom_bits_index> log_index;
+  receipts_loader load_receipts;
+  std::unique_ptr<named_thread_pool> log_thread_pool;
 };
 
 } // namespace noir::eth::api
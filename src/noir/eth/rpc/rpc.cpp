@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 #include <noir/common/helper/cli.h>
+#include <noir/consensus/store/store_test.h>
 #include <noir/eth/rpc/api.h>
 #include <noir/eth/rpc/rpc.h>
 
@@ -37,13 +38,35 @@ void rpc::plugin_initialize(const CLI::App& config) {
   auto tx_poor_ptr = app.find_plugin<tx_pool::tx_pool>();
   api->set_tx_pool_ptr(tx_poor_ptr);
 
-  auto& block_store_ptr = app.get_plugin<consensus::abci>().node_->block_store_;
-  api->set_block_store(block_store_ptr);
+  auto& node = app.get_plugin<consensus::abci>().node_;
+  api->set_block_store(node->block_store_);
+  api->set_query_connection(node->query_conn_);
+
+  auto db_dir = std::filesystem::path{node->config_->consensus.root_dir} / std::string(consensus::default_data_dir);
+  views = std::make_shared<view_store>(make_session(false, db_dir / "eth"), node->block_store_);
+  api->set_view_store(views);
+
+  // blooms are kept in memory only, so they are rebuilt from the stored receipts
+  log_index = std::make_shared<bloom_bits_index>();
+  for (auto height = node->block_store_->base(); height > 0 && height <= node->block_store_->height(); height++) {
+    Bytes256 bloom{};
+    for (const auto& r : views->load_receipts(height)) {
+      std::transform(bloom.begin(), bloom.end(), r.bloom.begin(), bloom.begin(), std::bit_or<>());
+    }
+    log_index->add(height, bloom);
+  }
+  api->set_log_index(log_index, [views{views}](uint64_t height) { return views->load_receipts(height); });
 }
 
 void rpc::plugin_startup() {
   ilog("starting ethereum rpc");
 
+  auto& node = app.get_plugin<consensus::abci>().node_;
+  new_block_subscription = node->event_bus_->subscribe("eth_rpc", [this](const consensus::events::message& msg) {
+    if (auto data = std::get_if<consensus::events::event_data_new_block>(&msg.data))
+      index_block(data->block);
+  });
+
   auto& endpoint = app.get_plugin<noir::rpc::jsonrpc>().get_or_create_endpoint("/eth");
   endpoint.add_handler("eth_sendRawTransaction", [&](auto& req) { return api->send_raw_tx(req); });
   endpoint.add_handler("eth_chainId", [&](auto& req) { return api->chain_id(req); });
@@ -58,9 +81,26 @@ void rpc::plugin_startup() {
   endpoint.add_handler("eth_getBlockByNumber", [&](auto& req) { return api->get_block_by_number(req); });
   endpoint.add_handler("eth_getBlockByHash", [&](auto& req) { return api->get_block_by_hash(req); });
   endpoint.add_handler("eth_getTransactionReceipt", [&](auto& req) { return api->get_tx_receipt(req); });
+  endpoint.add_handler("eth_getLogs", [&](auto& req) { return api->get_logs(req); });
   endpoint.add_handler("eth_call", [&](auto& req) { return api->call(req); });
 }
 
-void rpc::plugin_shutdown() {}
+void rpc::plugin_shutdown() {
+  new_block_subscription.unsubscribe();
+}
+
+void rpc::index_block(const consensus::block& bl) {
+  // abci responses are saved before events of the block are fired
+  tendermint::state::ABCIResponses abci_responses;
+  if (!app.get_plugin<consensus::abci>().node_->store_->load_abci_responses(bl.header.height, abci_responses)) {
+    elog(fmt::format("unable to load abci responses of block {}", bl.header.height));
+    return;
+  }
+  Bytes256 bloom{};
+  for (const auto& r : views->save_block(bl, abci_responses.deliver_txs())) {
+    std::transform(bloom.begin(), bloom.end(), r.bloom.begin(), bloom.begin(), std::bit_or<>());
+  }
+  log_index->add(bl.header.height, bloom);
+}
 
 } // namespace noir::eth::rpc
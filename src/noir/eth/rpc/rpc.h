@@ -24,7 +24,13 @@ public:
   void plugin_shutdown();
 
 private:
+  /// \brief records eth views and log blooms of a committed block
+  void index_block(const consensus::block& bl);
+
   std::unique_ptr<api::api> api;
+  std::shared_ptr<view_store> views;
+  std::shared_ptr<bloom_bits_index> log_index;
+  consensus::events::event_bus::subscription new_block_subscription;
 };
 
 } // namespace noir::eth::rpc
@@ -5,6 +5,7 @@
 //
 #include <catch2/catch_all.hpp>
 #include <noir/eth/rpc/api.h>
+#include <fc/variant_object.hpp>
 
 using namespace std;
 using namespace noir::eth::api;
@@ -41,3 +42,91 @@ TEST_CASE("eth:params: send_raw_tx", "[eth][api]") {
     CHECK_THROWS_WITH(a.send_raw_tx(params), "invalid parameters: json: cannot unmarshal");
   }
 }
+
+TEST_CASE("eth:params: get_logs", "[eth][api]") {
+  fc::variant params;
+  api a;
+
+  SECTION("check params fail") {
+    params = fc::variant(1);
+    CHECK_THROWS_WITH(a.get_logs(params), "invalid json request");
+    params = fc::variant(fc::variants{fc::variant("0x1")});
+    CHECK_THROWS_WITH(a.get_logs(params), "invalid argument 0: json: cannot unmarshal non-object");
+    params = fc::variant(fc::variants{fc::variant(fc::mutable_variant_object())});
+    CHECK_THROWS_WITH(a.get_logs(params), "eth_getLogs is not available");
+  }
+
+  SECTION("filter logs") {
+    auto address = std::string("0x00000000000000000000000000000000000000aa");
+    auto topic = std::string("0x00000000000000000000000000000000000000000000000000000000000000bb");
+    auto l = noir::eth::log{.address = noir::Bytes20(std::string_view(address).substr(2)),
+      .topics = {noir::Bytes32(std::string_view(topic).substr(2))},
+      .block_number = 10};
+    auto index = std::make_shared<noir::eth::bloom_bits_index>();
+    index->add(10, noir::eth::make_bloom({l}));
+    a.set_log_index(index, [&](uint64_t height) {
+      return height == 10 ? std::vector<noir::eth::receipt>{{.logs = {l}}} : std::vector<noir::eth::receipt>{};
+    });
+
+    auto get_logs = [&](const fc::mutable_variant_object& crit) {
+      return a.get_logs(fc::variant(fc::variants{fc::variant(crit)})).get_array();
+    };
+    auto found = get_logs(fc::mutable_variant_object("fromBlock", "0x1")("toBlock", "latest"));
+    REQUIRE(found.size() == 1);
+    CHECK(found[0].get_object()["blockNumber"].as_string() == "0xa");
+    CHECK(found[0].get_object()["logIndex"].as_string() == "0x0");
+    CHECK(get_logs(fc::mutable_variant_object("fromBlock", "0xb")).empty());
+    CHECK(get_logs(fc::mutable_variant_object("fromBlock", "earliest")("address", address)).size() == 1);
+    auto by_topic = [&](const std::string& t) {
+      return get_logs(fc::mutable_variant_object("fromBlock", "earliest")("topics", fc::variants{fc::variant(t)}));
+    };
+    CHECK(by_topic(topic).size() == 1);
+    CHECK(by_topic("0x00000000000000000000000000000000000000000000000000000000000000cc").empty());
+  }
+}
+
+TEST_CASE("eth:params: queries", "[eth][api]") {
+  struct eth_app : noir::application::base_application {
+    std::unique_ptr<tendermint::abci::ResponseQuery> query_sync(const tendermint::abci::RequestQuery& req) override {
+      num_queries++;
+      auto res = std::make_unique<tendermint::abci::ResponseQuery>();
+      if (req.path() == "/eth/balance")
+        res->set_value(std::string("\x00\x01\x00", 3));
+      else if (req.path() == "/eth/call")
+        res->set_value("\xca\xfe");
+      else
+        res->set_code(1);
+      return res;
+    }
+    int num_queries = 0;
+  };
+  auto app = std::make_shared<eth_app>();
+  auto query_conn = std::make_shared<noir::consensus::query_connection>(
+    std::vector<std::shared_ptr<noir::application::base_application>>{app});
+  query_conn->set_height(10);
+  api a;
+  auto address = std::string("0x00000000000000000000000000000000000000aa");
+
+  SECTION("not available") {
+    CHECK_THROWS_WITH(a.get_balance(fc::variant(fc::variants{fc::variant(address), fc::variant("latest")})),
+      "eth queries are not available");
+  }
+
+  SECTION("versioned queries") {
+    a.set_query_connection(query_conn);
+    CHECK(a.get_balance(fc::variant(fc::variants{fc::variant(address), fc::variant("latest")})).as_string() ==
+      "0x100");
+    CHECK_THROWS_WITH(a.get_tx_count(fc::variant(fc::variants{fc::variant(address), fc::variant("0xa")})),
+      "execution reverted: ");
+    CHECK_THROWS_WITH(a.get_balance(fc::variant(fc::variants{fc::variant(address), fc::variant("10")})),
+      "invalid argument 1: json: cannot unmarshal hex string without 0x prefix");
+
+    auto call = [&](const fc::mutable_variant_object& args, const std::string& block_number) {
+      return a.call(fc::variant(fc::variants{fc::variant(args), fc::variant(block_number)})).as_string();
+    };
+    CHECK(call(fc::mutable_variant_object("to", address)("data", "0x01"), "latest") == "0xcafe");
+    // identical calls at the same height are served from the cache, regardless of the order of fields
+    CHECK(call(fc::mutable_variant_object("input", "0x01")("to", address), "0xa") == "0xcafe");
+    CHECK(app->num_queries == 3);
+  }
+}
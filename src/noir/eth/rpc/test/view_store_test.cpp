@@ -0,0 +1,112 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/consensus/common_test.h>
+#include <noir/consensus/store/store_test.h>
+#include <noir/eth/rpc/view_store.h>
+#include <atomic>
+#include <thread>
+
+using namespace noir;
+using namespace noir::eth;
+
+TEST_CASE("eth:view_store: save/load", "[eth][rpc]") {
+  auto bls = std::make_shared<consensus::block_store>(make_session(true, "/tmp/test_eth_block_store"));
+  auto views = view_store(make_session(true, "/tmp/test_eth_view_store"), bls, 2);
+
+  std::vector<Bytes32> tx_hashes;
+  for (auto height = 1; height <= 3; height++) {
+    std::vector<consensus::tx> txs = {gen_random_bytes(32), gen_random_bytes(64)};
+    auto bl = consensus::block::make_block(
+      height, txs, std::make_shared<consensus::commit>(), std::make_shared<consensus::evidence_list>());
+    REQUIRE(bls->save_block(*bl, *bl->make_part_set(64), consensus::make_commit(10, tstamp{})));
+
+    google::protobuf::RepeatedPtrField<::tendermint::abci::ResponseDeliverTx> deliver_txs;
+    deliver_txs.Add()->set_gas_used(21000);
+    deliver_txs.Add()->set_gas_used(50000);
+    deliver_txs.Mutable(1)->set_code(1);
+    auto receipts = views.save_block(*bl, deliver_txs);
+    REQUIRE(receipts.size() == 2);
+    CHECK(receipts[0].status);
+    CHECK(!receipts[1].status);
+    CHECK(receipts[1].cumulative_gas_used == 71000);
+
+    auto block_hash = Bytes32(bl->get_hash());
+    CHECK(views.find_block(block_hash) == height);
+    for (uint32_t i = 0; i < txs.size(); i++) {
+      tx_hashes.push_back(get_tx_hash(txs[i]));
+      auto loc = views.find_tx(tx_hashes.back());
+      REQUIRE(loc);
+      CHECK(loc->height == height);
+      CHECK(loc->index == i);
+    }
+    CHECK(views.load_receipts(height).size() == 2);
+    CHECK(views.load_receipts(height)[1].block_hash == block_hash);
+  }
+  CHECK(!views.find_block(Bytes32{}));
+  CHECK(!views.find_tx(Bytes32{}));
+  CHECK(views.load_receipts(4).empty());
+
+  auto view = views.load_block(2);
+  REQUIRE(view);
+  CHECK(view->tx_hashes == std::vector<Bytes32>{tx_hashes[2], tx_hashes[3]});
+  CHECK(view->to_json(false)["number"].as_string() == "0x2");
+  CHECK(view->to_json(true)["transactions"].get_array().size() == 2);
+  CHECK(views.load_block(2) == view);
+  CHECK(!views.load_block(4));
+
+  // least recently used blocks are evicted beyond cache_size
+  views.load_block(1);
+  views.load_block(3);
+  CHECK(views.load_block(2) != view);
+}
+
+TEST_CASE("eth:view_store: concurrent reads and saves", "[eth][rpc]") {
+  constexpr auto num_blocks = 200;
+  auto bls = std::make_shared<consensus::block_store>(make_session(true, "/tmp/test_eth_block_store_concurrent"));
+  auto views = view_store(make_session(true, "/tmp/test_eth_view_store_concurrent"), bls);
+
+  std::vector<std::shared_ptr<consensus::block>> blocks;
+  std::vector<Bytes32> block_hashes;
+  for (auto height = 1; height <= num_blocks; height++) {
+    std::vector<consensus::tx> txs = {gen_random_bytes(32)};
+    blocks.push_back(consensus::block::make_block(
+      height, txs, std::make_shared<consensus::commit>(), std::make_shared<consensus::evidence_list>()));
+    block_hashes.emplace_back(blocks.back()->get_hash());
+  }
+
+  // rpc handlers and the eth_logs pool read while blocks are saved at commit; Catch assertions aren't thread-safe, so
+  // readers only flag what they saw
+  std::atomic<bool> done{false};
+  std::atomic<bool> consistent{true};
+  std::vector<std::thread> readers;
+  for (auto i = 0; i < 4; i++) {
+    readers.emplace_back([&, i]() {
+      for (auto n = 0; !done.load(); n++) {
+        auto height = (n * 4 + i) % num_blocks + 1;
+        if (auto found = views.find_block(block_hashes[height - 1]); found && *found != height)
+          consistent = false;
+        auto receipts = views.load_receipts(height);
+        if (!receipts.empty() && static_cast<uint64_t>(receipts[0].block_number) != height)
+          consistent = false;
+      }
+    });
+  }
+
+  google::protobuf::RepeatedPtrField<::tendermint::abci::ResponseDeliverTx> deliver_txs;
+  deliver_txs.Add()->set_gas_used(21000);
+  for (const auto& bl : blocks)
+    views.save_block(*bl, deliver_txs);
+  done = true;
+  for (auto& t : readers)
+    t.join();
+
+  CHECK(consistent);
+  for (auto height = 1; height <= num_blocks; height++) {
+    CHECK(views.find_block(block_hashes[height - 1]) == height);
+    CHECK(views.load_receipts(height).size() == 1);
+  }
+}
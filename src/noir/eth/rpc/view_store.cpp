@@ -0,0 +1,181 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <noir/codec/rlp.h>
+#include <noir/core/codec.h>
+#include <noir/eth/common/block.h>
+#include <noir/eth/rpc/view_store.h>
+#include <fc/variant_object.hpp>
+
+namespace noir::eth {
+
+namespace {
+  fc::variant tx_to_json(std::span<const unsigned char> raw_tx,
+    const Bytes32& hash,
+    const Bytes32& block_hash,
+    uint64_t height,
+    uint32_t index) {
+    fc::mutable_variant_object t_mvo;
+    t_mvo("hash", to_data(hash));
+    t_mvo("blockHash", to_data(block_hash));
+    t_mvo("blockNumber", to_quantity(height));
+    t_mvo("transactionIndex", to_quantity(index));
+    try {
+      auto t = codec::rlp::decode<transaction>(raw_tx);
+      t_mvo("nonce", to_quantity(t.nonce));
+      t_mvo("gasPrice", fmt::format("0x{}", to_hex(t.gas_price)));
+      t_mvo("gas", to_quantity(t.gas));
+      t_mvo("to", to_data(t.to));
+      t_mvo("value", fmt::format("0x{}", to_hex(t.value)));
+      t_mvo("input", to_data(t.data));
+      t_mvo("v", to_quantity(t.v));
+      t_mvo("r", to_data(t.r));
+      t_mvo("s", to_data(t.s));
+    } catch (const std::exception&) {
+      // not an eth tx, e.g. sent through tendermint rpc
+      t_mvo("input", to_data(raw_tx));
+    }
+    return t_mvo;
+  }
+} // namespace
+
+fc::variant block_view::to_json(bool full_tx) const {
+  fc::mutable_variant_object b_mvo(header.get_object());
+  b_mvo("number", to_quantity(height));
+  b_mvo("hash", to_data(hash));
+  b_mvo("uncles", fc::variants{});
+  if (full_tx) {
+    b_mvo("transactions", txs);
+  } else {
+    fc::variants hashes;
+    for (const auto& h : tx_hashes) {
+      hashes.emplace_back(to_data(h));
+    }
+    b_mvo("transactions", hashes);
+  }
+  return b_mvo;
+}
+
+view_store::view_store(
+  std::shared_ptr<db_session_type> session, std::shared_ptr<consensus::block_store> block_store, size_t cache_size)
+  : db_session(std::move(session)), block_store(std::move(block_store)), cache_size(cache_size) {}
+
+std::vector<receipt> view_store::save_block(const consensus::block& bl,
+  const google::protobuf::RepeatedPtrField<::tendermint::abci::ResponseDeliverTx>& deliver_txs) {
+  auto height = static_cast<uint64_t>(bl.header.height);
+  auto block_hash = Bytes32(const_cast<consensus::block&>(bl).get_hash());
+  std::vector<std::pair<Bytes, Bytes>> batch;
+  batch.emplace_back(encode_key<prefix::block_hash>(block_hash), encode(height));
+
+  std::vector<receipt> receipts;
+  uint64_t cumulative_gas_used = 0;
+  for (uint32_t i = 0; const auto& tx : bl.data.txs) {
+    auto tx_hash = get_tx_hash(tx);
+    batch.emplace_back(encode_key<prefix::tx_hash>(tx_hash), encode(tx_location{height, i}));
+
+    auto gas_used = i < deliver_txs.size() ? static_cast<uint64_t>(deliver_txs[i].gas_used()) : 0;
+    cumulative_gas_used += gas_used;
+    receipts.push_back(receipt{
+      .status = i < deliver_txs.size() && deliver_txs[i].code() == 0,
+      .cumulative_gas_used = cumulative_gas_used,
+      .bloom = make_bloom({}),
+      .tx_hash = tx_hash,
+      .gas_used = gas_used,
+      .block_hash = block_hash,
+      .block_number = height,
+      .transaction_index = i,
+    });
+    ++i;
+  }
+  batch.emplace_back(encode_key<prefix::receipts>(height), encode(receipts));
+
+  {
+    std::scoped_lock g{db_mtx};
+    db_session->write_from_bytes(batch);
+    db_session->commit();
+  }
+  return receipts;
+}
+
+std::optional<uint64_t> view_store::find_block(const Bytes32& block_hash) {
+  std::unique_lock g{db_mtx};
+  auto value = db_session->read_from_bytes(encode_key<prefix::block_hash>(block_hash));
+  g.unlock();
+  if (!value)
+    return std::nullopt;
+  return decode<uint64_t>(*value);
+}
+
+std::optional<tx_location> view_store::find_tx(const Bytes32& tx_hash) {
+  std::unique_lock g{db_mtx};
+  auto value = db_session->read_from_bytes(encode_key<prefix::tx_hash>(tx_hash));
+  g.unlock();
+  if (!value)
+    return std::nullopt;
+  return decode<tx_location>(*value);
+}
+
+std::vector<receipt> view_store::load_receipts(uint64_t height) {
+  std::unique_lock g{db_mtx};
+  auto value = db_session->read_from_bytes(encode_key<prefix::receipts>(height));
+  g.unlock();
+  if (!value)
+    return {};
+  return decode<std::vector<receipt>>(*value);
+}
+
+std::shared_ptr<const block_view> view_store::load_block(uint64_t height) {
+  {
+    std::scoped_lock g{cache_mtx};
+    if (auto it = cache.find(height); it != cache.end()) {
+      lru.splice(lru.begin(), lru, it->second);
+      return *it->second;
+    }
+  }
+
+  consensus::block bl;
+  if (!block_store->load_block(static_cast<int64_t>(height), bl))
+    return nullptr;
+  auto view = std::make_shared<block_view>();
+  view->height = height;
+  view->hash = Bytes32(bl.get_hash());
+  view->header = eth::header(bl.header).to_json();
+  for (uint32_t i = 0; const auto& tx : bl.data.txs) {
+    view->tx_hashes.push_back(get_tx_hash(tx));
+    view->txs.push_back(tx_to_json(tx, view->tx_hashes.back(), view->hash, height, i++));
+  }
+
+  std::scoped_lock g{cache_mtx};
+  // another thread may have materialized the same block meanwhile
+  if (auto it = cache.find(height); it != cache.end())
+    return *it->second;
+  lru.push_front(view);
+  cache[height] = lru.begin();
+  if (lru.size() > cache_size) {
+    cache.erase(lru.back()->height);
+    lru.pop_back();
+  }
+  return view;
+}
+
+template<view_store::prefix key_prefix>
+Bytes view_store::encode_key(std::span<const unsigned char> key) {
+  Bytes key_(1 + key.size());
+  key_[0] = static_cast<unsigned char>(key_prefix);
+  std::copy(key.begin(), key.end(), key_.begin() + 1);
+  return key_;
+}
+
+template<view_store::prefix key_prefix>
+Bytes view_store::encode_key(uint64_t height) {
+  // big endian, so that receipts are ordered by height
+  std::array<unsigned char, sizeof(height)> key;
+  for (auto i = 0; i < key.size(); i++) {
+    key[i] = height >> (8 * (key.size() - 1 - i));
+  }
+  return encode_key<key_prefix>(key);
+}
+
+} // namespace noir::eth
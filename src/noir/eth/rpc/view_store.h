@@ -0,0 +1,90 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/consensus/store/block_store.h>
+#include <noir/eth/common/receipt.h>
+#include <fc/variant.hpp>
+#include <fmt/core.h>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace noir::eth {
+
+/// \brief hex encoded quantity of eth json-rpc, without leading zeros
+inline std::string to_quantity(uint64_t v) {
+  return fmt::format("0x{:x}", v);
+}
+
+/// \brief hex encoded unformatted data of eth json-rpc
+inline std::string to_data(std::span<const unsigned char> v) {
+  return fmt::format("0x{}", to_hex(v));
+}
+
+struct tx_location {
+  uint64_t height;
+  uint32_t index;
+};
+
+/// \brief eth block assembled from a committed block
+struct block_view {
+  uint64_t height;
+  Bytes32 hash;
+  fc::variant header;
+  std::vector<Bytes32> tx_hashes;
+  fc::variants txs;
+
+  fc::variant to_json(bool full_tx) const;
+};
+
+/// \brief eth shaped indices of committed blocks
+/// save_block() records eth block hash -> height, eth tx hash -> location and the encoded receipts of a block in a
+/// single batch at commit, so that rpc responses are looked up instead of recomputed from tendermint blocks. Blocks
+/// materialized last are kept in an LRU, as clients mostly poll blocks near the head.
+class view_store {
+  using db_session_type = noir::db::session::session<noir::db::session::rocksdb_t>;
+
+public:
+  view_store(std::shared_ptr<db_session_type> session,
+    std::shared_ptr<consensus::block_store> block_store,
+    size_t cache_size = 128);
+
+  /// \return receipts of the txs of bl
+  std::vector<receipt> save_block(const consensus::block& bl,
+    const google::protobuf::RepeatedPtrField<::tendermint::abci::ResponseDeliverTx>& deliver_txs);
+
+  std::optional<uint64_t> find_block(const Bytes32& block_hash);
+  std::optional<tx_location> find_tx(const Bytes32& tx_hash);
+  std::vector<receipt> load_receipts(uint64_t height);
+
+  /// \return nullptr if the block at height is not in the block store
+  std::shared_ptr<const block_view> load_block(uint64_t height);
+
+private:
+  enum class prefix : char {
+    block_hash = 0,
+    tx_hash = 1,
+    receipts = 2,
+  };
+
+  template<prefix key_prefix>
+  static Bytes encode_key(std::span<const unsigned char> key);
+  template<prefix key_prefix>
+  static Bytes encode_key(uint64_t height);
+
+  // rpc threads, the eth_logs pool and save_block all use db_session, which isn't thread-safe even for reads, as
+  // reading fills its cache
+  std::mutex db_mtx;
+  std::shared_ptr<db_session_type> db_session;
+  std::shared_ptr<consensus::block_store> block_store;
+
+  std::mutex cache_mtx;
+  size_t cache_size;
+  std::list<std::shared_ptr<const block_view>> lru;
+  std::unordered_map<uint64_t, decltype(lru)::iterator> cache;
+};
+
+} // namespace noir::eth
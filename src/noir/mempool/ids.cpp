@@ -4,6 +4,8 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 #include <noir/mempool/ids.h>
+#include <algorithm>
+#include <bit>
 #include <mutex>
 
 namespace noir::mempool {
@@ -48,4 +50,77 @@ uint16_t MempoolIDs::next_peer_id() {
   return cur_id;
 }
 
+auto PeerSet::contains(uint16_t peer_id) const -> bool {
+  if (bits && peer_id >= base && peer_id - base < window_size) {
+    return bits & (uint64_t(1) << (peer_id - base));
+  }
+  return std::binary_search(overflow.begin(), overflow.end(), peer_id);
+}
+
+auto PeerSet::insert(uint16_t peer_id) -> bool {
+  if (!bits) {
+    base = peer_id - peer_id % window_size;
+  }
+  if (peer_id >= base && peer_id - base < window_size) {
+    auto bit = uint64_t(1) << (peer_id - base);
+    if (bits & bit) {
+      return false;
+    }
+    bits |= bit;
+    return true;
+  }
+  auto it = std::lower_bound(overflow.begin(), overflow.end(), peer_id);
+  if (it != overflow.end() && *it == peer_id) {
+    return false;
+  }
+  overflow.insert(it, peer_id);
+  return true;
+}
+
+auto PeerSet::size() const -> size_t {
+  return std::popcount(bits) + overflow.size();
+}
+
+auto SenderIds::acquire(const std::string& sender) -> uint32_t {
+  if (sender.empty()) {
+    return no_sender;
+  }
+  if (auto it = ids.find(sender); it != ids.end()) {
+    entries[it->second - 1].refs++;
+    return it->second;
+  }
+
+  uint32_t id;
+  if (!free_ids.empty()) {
+    id = free_ids.back();
+    free_ids.pop_back();
+    entries[id - 1] = {sender, 1};
+  } else {
+    entries.push_back({sender, 1});
+    id = entries.size();
+  }
+  ids.emplace(sender, id);
+  return id;
+}
+
+void SenderIds::release(uint32_t id) {
+  if (id == no_sender || id > entries.size()) {
+    return;
+  }
+  auto& entry = entries[id - 1];
+  if (!entry.refs || --entry.refs) {
+    return;
+  }
+  ids.erase(entry.sender);
+  entry.sender = {};
+  free_ids.push_back(id);
+}
+
+auto SenderIds::find(const std::string& sender) const -> uint32_t {
+  if (auto it = ids.find(sender); it != ids.end()) {
+    return it->second;
+  }
+  return no_sender;
+}
+
 } // namespace noir::mempool
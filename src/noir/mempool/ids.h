@@ -8,6 +8,8 @@
 #include <map>
 #include <set>
 #include <shared_mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace noir::mempool {
 
@@ -28,4 +30,54 @@ private:
   std::set<uint16_t> active_ids = {unknown_peer_id};
 };
 
+/// \brief set of peer ids, stored inline as a bitmap of a 64 id window
+/// Ids outside the window of the first id inserted are kept in a sorted vector, which is rarely needed as a tx is
+/// usually seen from a few peers connected at around the same time.
+class PeerSet {
+public:
+  auto contains(uint16_t peer_id) const -> bool;
+
+  /// \return true if peer_id is newly inserted
+  auto insert(uint16_t peer_id) -> bool;
+
+  auto size() const -> size_t;
+
+  /// \brief bytes allocated outside of the set itself
+  auto heap_bytes() const -> size_t {
+    return overflow.capacity() * sizeof(uint16_t);
+  }
+
+private:
+  static constexpr uint16_t window_size = 64;
+
+  uint64_t bits{0};
+  uint16_t base{0};
+  std::vector<uint16_t> overflow;
+};
+
+/// \brief interns tx senders into dense ids starting from 1, which are recycled once released by all holders
+class SenderIds {
+public:
+  static constexpr uint32_t no_sender = 0;
+
+  /// \brief returns the id of sender, adding a reference to it; empty sender is always no_sender
+  auto acquire(const std::string& sender) -> uint32_t;
+  void release(uint32_t id);
+  auto find(const std::string& sender) const -> uint32_t;
+
+  auto size() const -> size_t {
+    return ids.size();
+  }
+
+private:
+  struct Entry {
+    std::string sender;
+    uint32_t refs;
+  };
+
+  std::unordered_map<std::string, uint32_t> ids;
+  std::vector<Entry> entries; ///< indexed by id - 1
+  std::vector<uint32_t> free_ids;
+};
+
 } // namespace noir::mempool
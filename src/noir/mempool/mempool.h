@@ -5,13 +5,19 @@
 //
 #pragma once
 #include <noir/clist/clist.h>
+#include <noir/codec/protobuf.h>
+#include <noir/common/expiry_wheel.h>
+#include <noir/common/trace.h>
 #include <noir/config/mempool.h>
+#include <noir/consensus/abci_types.h>
 #include <noir/core/core.h>
 #include <noir/mempool/cache.h>
 #include <noir/mempool/priority_queue.h>
+#include <noir/metrics/metrics.h>
 #include <tendermint/proxy/app_conn.h>
 #include <tendermint/types/tx.h>
 #include <algorithm>
+#include <filesystem>
 
 namespace noir::mempool {
 
@@ -27,13 +33,51 @@ struct ErrMempoolIsFull {
   }
 };
 
+/// \brief breakdown of memory used by a mempool
+struct TxMempoolMemoryUsage {
+  int num_txs;
+  int num_spilled_txs;
+  int64_t resident_bytes; ///< tx bodies in RAM
+  int64_t spilled_bytes; ///< tx bodies in the spill file
+  int64_t metadata_bytes; ///< RAM used for txs other than their bodies, including indices referring to them
+
+  auto overhead_per_tx() const -> int64_t {
+    return num_txs ? metadata_bytes / num_txs : 0;
+  }
+};
+
 template<abci::Client Client>
 class TxMempool {
 public:
+  TxMempool() = default;
+  TxMempool(config::MempoolConfig* config,
+    std::shared_ptr<proxy::AppConnMempool<Client>> proxy_app_conn,
+    int64_t height)
+    : config(config),
+      proxy_app_conn(std::move(proxy_app_conn)),
+      height(height),
+      cache(config->cache_size),
+      height_expiry(config->ttl_num_blocks + 1),
+      time_expiry(config->ttl_duration.count()) {}
+
   // with_pre_check();
   // with_post_check();
   // with_metrics();
 
+  /// \brief enables the tiered mode if max_resident_txs_bytes is configured; must be called before adding txs
+  auto open_spill_file() -> Result<void> {
+    if (config->max_resident_txs_bytes <= 0) {
+      return success();
+    }
+    auto path = std::filesystem::path(config->root_dir) / config->spill_file;
+    auto file = TxSpillFile::open(path.string(), config->max_txs_bytes);
+    if (!file) {
+      return file.error();
+    }
+    bodies = std::make_unique<TxBodyStore>(std::move(file.value()), config->max_resident_txs_bytes);
+    return success();
+  }
+
   auto size() {
     return tx_store.size();
   }
@@ -54,6 +98,28 @@ public:
     return gossip_index.front();
   }
 
+  /// \brief returns the body of a tx, which is loaded from the spill file if it was moved out of RAM
+  auto load_tx(const WrappedTx& wtx) -> types::Tx {
+    return bodies ? bodies->load(wtx) : wtx.tx;
+  }
+
+  auto memory_usage() -> TxMempoolMemoryUsage {
+    std::shared_lock _{mtx};
+
+    auto usage = TxMempoolMemoryUsage{.num_txs = size()};
+    for (const auto& wtx : tx_store.get_all_txs()) {
+      usage.metadata_bytes += wtx->metadata_bytes() + index_bytes_per_tx;
+    }
+    if (bodies) {
+      usage.num_spilled_txs = bodies->num_spilled();
+      usage.resident_bytes = bodies->resident_bytes();
+      usage.spilled_bytes = bodies->spilled_bytes();
+    } else {
+      usage.resident_bytes = size_bytes();
+    }
+    return usage;
+  }
+
   void enable_txs_available() {
     std::unique_lock _{mtx};
     txs_available_ = eo::make_chan(1);
@@ -63,7 +129,32 @@ public:
     return txs_available_;
   }
 
-  // check_tx();
+  /// \brief checks tx with the app, then adds it if valid
+  /// Unlike the original implementation, the app is called synchronously, so the tx is added once this returns.
+  auto check_tx(const types::Tx& tx, const TxInfo& tx_info = {}) -> Result<void> {
+    trace::span span("check_tx");
+    if (tx.size() > config->max_tx_bytes) {
+      return Error::format("tx too large: max={}, actual={}", config->max_tx_bytes, tx.size());
+    }
+
+    if (!cache.push(tx)) {
+      // record the peer the tx came from, so it isn't gossiped back
+      tx_store.get_or_set_peer_by_tx_hash(tx.key(), tx_info.sender_id);
+      return Error("tx already exists in cache");
+    }
+
+    abci::RequestCheckTx req{};
+    req.set_tx(std::string(tx.begin(), tx.end()));
+    req.set_type(abci::CheckTxType::NEW);
+    auto res = proxy_app_conn->check_tx_sync(req);
+    if (!res) {
+      cache.remove(tx);
+      return res.error();
+    }
+
+    std::unique_lock _{mtx};
+    return add_new_transaction(tx, *res.value(), tx_info);
+  }
 
   auto remove_tx_by_key(const types::TxKey& tx_key) -> Result<void> {
     std::unique_lock _{mtx};
@@ -84,10 +175,11 @@ public:
     }
 
     size_bytes_ = 0;
+    update_size_metrics();
     cache.reset();
   }
 
-  auto reap_max_bytes_max_gas(int64_t max_bytes, int64_t max_gas) {
+  auto reap_max_bytes_max_gas(int64_t max_bytes, int64_t max_gas) -> std::vector<types::Tx> {
     std::shared_lock _{mtx};
 
     int64_t total_gas = 0;
@@ -105,20 +197,22 @@ public:
     txs.reserve(priority_index.num_txs());
     while (priority_index.num_txs() > 0) {
       auto wtx = priority_index.pop_tx();
-      txs.push_back(wtx->tx);
+      txs.push_back(load_tx(*wtx));
       wtxs.push_back(wtx);
-      // auto size = types::compute_proto_size_for_txs();
-      auto size = 0;
+      // size of the tx in the txs field of block data
+      int64_t size = codec::protobuf::message_field_size(1, txs.back().size());
 
       if (max_bytes > -1 && (total_size + size) > max_bytes) {
-        // return txs...;
+        txs.pop_back();
+        return txs;
       }
 
       total_size += size;
 
       auto gas = total_gas + wtx->gas_wanted;
       if (max_gas > -1 && gas > max_gas) {
-        // return txs...;
+        txs.pop_back();
+        return txs;
       }
 
       total_gas = gas;
@@ -127,6 +221,16 @@ public:
     return txs;
   }
 
+  /// \brief returns keys declared by CheckTx of txs, no keys for txs not in the mempool
+  auto tx_accesses(const std::vector<types::Tx>& txs) -> std::vector<consensus::tx_access> {
+    std::vector<consensus::tx_access> accesses(txs.size());
+    for (size_t i = 0; i < txs.size(); i++) {
+      if (auto wtx = tx_store.get_tx_by_hash(txs[i].key()); wtx && wtx->access)
+        accesses[i] = *wtx->access;
+    }
+    return accesses;
+  }
+
   auto reap_max_txs(int max) {
     std::shared_lock _{mtx};
 
@@ -150,20 +254,102 @@ public:
     txs.reserve(cap);
     while (priority_index.num_txs() > 0 && txs.size() < max) {
       auto wtx = priority_index.pop_tx();
-      txs.push_back(wtx->tx);
+      txs.push_back(load_tx(*wtx));
       wtxs.push_back(wtx);
     }
 
     return txs;
   }
 
-  // auto update();
+  /// \brief removes txs committed in a block, then purges expired txs and rechecks the rest if configured
+  auto update(int64_t block_height,
+    const std::vector<types::Tx>& block_txs,
+    const google::protobuf::RepeatedPtrField<abci::ResponseDeliverTx>& deliver_tx_responses) -> Result<void> {
+    if (block_txs.size() != deliver_tx_responses.size()) {
+      return Error::format("number of txs ({}) doesn't match number of responses ({})", block_txs.size(),
+        deliver_tx_responses.size());
+    }
+
+    std::unique_lock _{mtx};
+    height = block_height;
+    notified_txs_available = false;
+
+    for (auto i = 0; i < block_txs.size(); i++) {
+      if (deliver_tx_responses[i].code() == consensus::code_type_ok) {
+        cache.push(block_txs[i]);
+      } else if (!config->keep_invalid_txs_in_cache) {
+        cache.remove(block_txs[i]);
+      }
+
+      if (auto wtx = tx_store.get_tx_by_hash(block_txs[i].key()); wtx) {
+        remove_tx(wtx, false);
+      }
+    }
+
+    purge_expired_txs(block_height);
+
+    if (size() > 0) {
+      if (config->recheck) {
+        update_re_check_txs();
+      } else {
+        notify_txs_available();
+      }
+    }
+    return success();
+  }
 
 private:
   // void init_tx_callback(const std::shared_ptr<WrappedTx>& wtx, ...);
 
   // void default_tx_callback();
 
+  auto add_new_transaction(const types::Tx& tx, const abci::ResponseCheckTx& res, const TxInfo& tx_info)
+    -> Result<void> {
+    if (res.code() != consensus::code_type_ok) {
+      if (!config->keep_invalid_txs_in_cache) {
+        cache.remove(tx);
+      }
+      return success();
+    }
+
+    if (!res.sender().empty() && tx_store.get_tx_by_sender(res.sender())) {
+      return Error::format("tx already exists for sender: {}", res.sender());
+    }
+
+    auto wtx = std::make_shared<WrappedTx>(WrappedTx{
+      .tx = tx,
+      .hash = tx.key(),
+      .height = height,
+      .gas_wanted = res.gas_wanted(),
+      .priority = res.priority(),
+      .sender_id = tx_store.intern_sender(res.sender()),
+      .access = res.read_keys().empty() && res.write_keys().empty()
+        ? nullptr
+        : std::make_shared<const consensus::tx_access>(consensus::tx_access::from_check_tx(res)),
+      .timestamp = std::chrono::system_clock::now().time_since_epoch().count(),
+    });
+    wtx->peers.insert(tx_info.sender_id);
+
+    if (auto ok = can_add_tx(wtx); !ok) {
+      auto evict_txs =
+        priority_index.get_evictable_txs(wtx->priority, wtx->size(), size_bytes(), config->max_txs_bytes);
+      if (evict_txs.empty()) {
+        // no room for the new tx
+        cache.remove(tx);
+        tx_store.release_sender(wtx->sender_id);
+        return Error(ok.error().message());
+      }
+      for (const auto& evict_tx : evict_txs) {
+        remove_tx(evict_tx, true);
+      }
+      metrics_.evicted_for_room.inc(evict_txs.size());
+    }
+
+    insert_tx(wtx);
+    notify_txs_available();
+    return success();
+  }
+
   // TODO
   void update_re_check_txs() {
     if (!size()) {
@@ -176,17 +362,17 @@ private:
 
     for (auto e = gossip_index.front(); e; e = e->next()) {
       if (!tx_store.is_tx_removed(e->value->hash)) {
-        auto& wtx = *e->value;
+        auto tx = load_tx(*e->value);
         abci::RequestCheckTx req{};
-        req.set_tx(std::string(wtx.tx.begin(), wtx.tx.end()));
+        req.set_tx(std::string(tx.begin(), tx.end()));
         req.set_type(abci::CheckTxType::RECHECK);
-        if (auto ok = invoke(proxy_app_conn->check_tx_async(req)); !ok) {
+        if (auto ok = proxy_app_conn->check_tx_async(req); !ok) {
           // logger->error(...);
         }
       }
     }
 
-    if (auto ok = invoke(proxy_app_conn->flush_async()); !ok) {
+    if (auto ok = proxy_app_conn->flush_async(); !ok) {
       // logger->error(...);
     }
   }
@@ -215,6 +401,19 @@ private:
     wtx->gossip_el = std::move(gossip_el);
 
     size_bytes_ += wtx->size();
+    update_size_metrics();
+
+    if (bodies) {
+      bodies->add(wtx);
+    }
+
+    // deadlines are the first height and time at which the tx is expired
+    if (config && config->ttl_num_blocks > 0) {
+      height_expiry.add(wtx->height + config->ttl_num_blocks + 1, wtx->key());
+    }
+    if (config && config->ttl_duration.count() > 0) {
+      time_expiry.add(wtx->timestamp + config->ttl_duration.count() + 1, wtx->key());
+    }
   }
 
   void remove_tx(const std::shared_ptr<WrappedTx>& wtx, bool remove_from_cache) {
@@ -229,41 +428,42 @@ private:
     wtx->gossip_el->detach_prev();
 
     size_bytes_ -= wtx->size();
+    update_size_metrics();
 
     if (remove_from_cache) {
-      cache.remove(wtx->tx);
+      cache.remove(load_tx(*wtx));
+    }
+    if (bodies) {
+      bodies->remove(wtx);
     }
   }
 
+  auto is_tx_expired(const WrappedTx& wtx, int64_t block_height, int64_t now) -> bool {
+    return (config->ttl_num_blocks > 0 && (block_height - wtx.height) > config->ttl_num_blocks) ||
+      (config->ttl_duration.count() > 0 && (now - wtx.timestamp) > config->ttl_duration.count());
+  }
+
   void purge_expired_txs(int64_t block_height) {
     auto now = std::chrono::system_clock::now().time_since_epoch().count();
-    auto expired_txs = std::map<types::TxKey, std::shared_ptr<WrappedTx>>();
 
-    if (config->ttl_num_blocks > 0) {
-      auto& height_index = priority_index.txs.template get<by_height>();
-      for (const auto& wtx : height_index) {
-        if ((block_height - wtx->height) > config->ttl_num_blocks) {
-          expired_txs[wtx->tx.key()] = wtx;
-        } else {
-          break;
-        }
+    // keys popped may belong to txs already removed, or removed and then added again with a later deadline
+    auto purge = [&](const types::TxKey& key) {
+      if (auto wtx = tx_store.get_tx_by_hash(key); wtx && is_tx_expired(*wtx, block_height, now)) {
+        remove_tx(wtx, false);
+        metrics_.evicted_expired.inc();
       }
+    };
+    if (config->ttl_num_blocks > 0) {
+      height_expiry.expire(block_height, purge);
     }
-
     if (config->ttl_duration.count() > 0) {
-      auto& timestamp_index = priority_index.txs.template get<by_timestamp>();
-      for (const auto& wtx : timestamp_index) {
-        if ((now - wtx->timestamp) > config->ttl_duration.count()) {
-          expired_txs[wtx->tx.key()] = wtx;
-        } else {
-          break;
-        }
-      }
+      time_expiry.expire(now, purge);
     }
+  }
 
-    for (const auto& wtx : expired_txs) {
-      remove_tx(wtx.second, false);
-    }
+  void update_size_metrics() {
+    metrics_.size.set(size());
+    metrics_.size_bytes.set(size_bytes());
   }
 
   void notify_txs_available() {
@@ -280,7 +480,19 @@ private:
 
 private:
   // std::shared_ptr<log::Logger> logger;
-  // metrics;
+  struct Metrics {
+    static metrics::counter evicted_txs(const std::string& reason) {
+      return metrics::default_registry().make_counter(
+        "noir_mempool_evicted_txs_total", "Number of txs evicted from the mempool", {{"reason", reason}});
+    }
+
+    metrics::gauge size =
+      metrics::default_registry().make_gauge("noir_mempool_size", "Number of txs in the mempool");
+    metrics::gauge size_bytes =
+      metrics::default_registry().make_gauge("noir_mempool_size_bytes", "Total bytes of txs in the mempool");
+    metrics::counter evicted_for_room = evicted_txs("full");
+    metrics::counter evicted_expired = evicted_txs("expired");
+  } metrics_;
   // TODO: change this to reference unless nullable
   config::MempoolConfig* config = nullptr;
   std::shared_ptr<proxy::AppConnMempool<Client>> proxy_app_conn;
@@ -292,6 +504,17 @@ private:
 
   std::atomic<int64_t> size_bytes_;
 
+  // rough size of nodes referring to a tx; an ordered index takes 3 pointers in a multi_index node
+  static constexpr size_t index_bytes_per_tx =
+    sizeof(types::TxKey) + 5 * sizeof(void*) + // tx_store hash node with cached hash, and its bucket
+    (2 + 2 * 3) * sizeof(void*) + // priority_index
+    sizeof(types::TxKey) + sizeof(int64_t) + // height_expiry or time_expiry, while ttl is configured
+    sizeof(clist::CElement<std::shared_ptr<WrappedTx>>) + 2 * sizeof(void*) + // gossip_index with control block
+    4 * sizeof(void*); // bodies, while resident
+
+  /// bodies of txs when tiered, i.e. some of them are moved to a spill file
+  std::unique_ptr<TxBodyStore> bodies;
+
   LRUTxCache cache;
 
   TxStore tx_store;
@@ -301,16 +524,11 @@ private:
   clist::CElementPtr<std::shared_ptr<WrappedTx>> recheck_cursor;
   clist::CElementPtr<std::shared_ptr<WrappedTx>> recheck_end;
 
-  struct by_height;
-  struct by_timestamp;
+  TxPriorityQueue<> priority_index;
 
-  TxPriorityQueue<boost::multi_index::ordered_non_unique<boost::multi_index::tag<by_height>,
-                    boost::multi_index::key<&WrappedTx::height>,
-                    std::greater_equal<int64_t>>,
-    boost::multi_index::ordered_non_unique<boost::multi_index::tag<by_timestamp>,
-      boost::multi_index::key<&WrappedTx::timestamp>,
-      std::greater_equal<tstamp>>>
-    priority_index;
+  /// keys of txs registered at their expiry height and time, so that purging doesn't scan the whole mempool
+  expiry_wheel<types::TxKey> height_expiry{0};
+  expiry_wheel<types::TxKey> time_expiry{0};
 
   std::shared_mutex mtx;
   // mempool::PreCheckFunc pre_check;
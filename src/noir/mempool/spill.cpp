@@ -0,0 +1,108 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <noir/mempool/spill.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace noir::mempool {
+
+Result<std::unique_ptr<TxSpillFile>> TxSpillFile::open(const std::string& path, uint64_t capacity) {
+  if (capacity == 0)
+    return Error::format("spill file capacity must be positive");
+
+  auto fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (fd < 0)
+    return Error::format("unable to open {}: {}", path, std::strerror(errno));
+
+  // sparse, so disk blocks are only allocated for pages actually written
+  if (::ftruncate(fd, static_cast<off_t>(capacity)) < 0) {
+    auto err = errno;
+    ::close(fd);
+    ::unlink(path.c_str());
+    return Error::format("unable to resize {}: {}", path, std::strerror(err));
+  }
+
+  auto addr = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  auto err = errno;
+  ::close(fd);
+  ::unlink(path.c_str());
+  if (addr == MAP_FAILED)
+    return Error::format("unable to map {}: {}", path, std::strerror(err));
+
+  // bodies are loaded one at a time when reaped or gossiped
+  ::madvise(addr, capacity, MADV_RANDOM);
+  return std::unique_ptr<TxSpillFile>(new TxSpillFile(static_cast<unsigned char*>(addr), capacity));
+}
+
+TxSpillFile::TxSpillFile(unsigned char* data, uint64_t capacity): data_(data), capacity_(capacity) {
+  free_extents.emplace(0, capacity);
+}
+
+TxSpillFile::~TxSpillFile() {
+  ::munmap(data_, capacity_);
+}
+
+auto TxSpillFile::write(std::span<const unsigned char> body) -> std::optional<Extent> {
+  if (body.empty())
+    return Extent{0, 0};
+
+  uint64_t offset;
+  {
+    std::scoped_lock g{mtx};
+    auto it = std::find_if(
+      free_extents.begin(), free_extents.end(), [&](const auto& free) { return free.second >= body.size(); });
+    if (it == free_extents.end())
+      return std::nullopt;
+
+    offset = it->first;
+    if (auto rest = it->second - body.size(); rest > 0)
+      free_extents.emplace(offset + body.size(), rest);
+    free_extents.erase(it);
+    used += body.size();
+  }
+
+  std::memcpy(data_ + offset, body.data(), body.size());
+  return Extent{offset, static_cast<uint32_t>(body.size())};
+}
+
+auto TxSpillFile::read(const Extent& extent) const -> types::Tx {
+  auto first = data_ + extent.offset;
+  return Bytes(std::span<const unsigned char>(first, extent.size));
+}
+
+void TxSpillFile::release(const Extent& extent) {
+  if (!extent.size)
+    return;
+
+  std::scoped_lock g{mtx};
+  auto [it, _] = free_extents.emplace(extent.offset, extent.size);
+  used -= extent.size;
+
+  // coalesce with the following and preceding free extents
+  if (auto next = std::next(it); next != free_extents.end() && it->first + it->second == next->first) {
+    it->second += next->second;
+    free_extents.erase(next);
+  }
+  if (it != free_extents.begin()) {
+    if (auto prev = std::prev(it); prev->first + prev->second == it->first) {
+      prev->second += it->second;
+      free_extents.erase(it);
+    }
+  }
+}
+
+auto TxSpillFile::used_bytes() -> uint64_t {
+  std::scoped_lock g{mtx};
+  return used;
+}
+
+} // namespace noir::mempool
@@ -0,0 +1,60 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/core/result.h>
+#include <tendermint/types/tx.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+
+namespace noir::mempool {
+
+/// \brief memory mapped file holding tx bodies that a tiered mempool moved out of RAM
+/// Space is handed out first-fit from a list of free extents, so the file never grows beyond its capacity.
+/// The file is unlinked as soon as it is mapped, as spilled txs don't outlive the process.
+class TxSpillFile {
+public:
+  struct Extent {
+    uint64_t offset;
+    uint32_t size;
+  };
+
+  static Result<std::unique_ptr<TxSpillFile>> open(const std::string& path, uint64_t capacity);
+
+  TxSpillFile(const TxSpillFile&) = delete;
+  TxSpillFile& operator=(const TxSpillFile&) = delete;
+  ~TxSpillFile();
+
+  /// \brief copies body into the file
+  /// \return extent holding body, or std::nullopt if there isn't enough free space
+  auto write(std::span<const unsigned char> body) -> std::optional<Extent>;
+
+  /// \note extent must not be released while being read
+  auto read(const Extent& extent) const -> types::Tx;
+
+  void release(const Extent& extent);
+
+  auto capacity() const -> uint64_t {
+    return capacity_;
+  }
+
+  auto used_bytes() -> uint64_t;
+
+private:
+  TxSpillFile(unsigned char* data, uint64_t capacity);
+
+  unsigned char* data_;
+  uint64_t capacity_;
+
+  std::mutex mtx;
+  uint64_t used{0};
+  std::map<uint64_t, uint64_t> free_extents; ///< offset -> size
+};
+
+} // namespace noir::mempool
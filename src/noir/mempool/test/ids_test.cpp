@@ -24,3 +24,50 @@ TEST_CASE("MempoolIDsBasic", "[noir][mempool]") {
   CHECK(2 == ids.get_for_peer(peer_id));
   ids.reclaim(peer_id);
 }
+
+TEST_CASE("PeerSet", "[noir][mempool]") {
+  auto peers = PeerSet{};
+  CHECK(peers.size() == 0);
+  CHECK(!peers.contains(0));
+
+  CHECK(peers.insert(70));
+  CHECK(!peers.insert(70));
+  CHECK(peers.insert(127));
+  CHECK(peers.heap_bytes() == 0);
+
+  // outside of the inline window
+  CHECK(peers.insert(5));
+  CHECK(peers.insert(65535));
+  CHECK(!peers.insert(5));
+
+  CHECK(peers.size() == 4);
+  for (auto id : {5, 70, 127, 65535}) {
+    CHECK(peers.contains(id));
+  }
+  for (auto id : {0, 64, 69, 71, 128, 65534}) {
+    CHECK(!peers.contains(id));
+  }
+}
+
+TEST_CASE("SenderIds", "[noir][mempool]") {
+  auto senders = SenderIds{};
+  CHECK(senders.acquire("") == SenderIds::no_sender);
+
+  auto foo = senders.acquire("foo");
+  auto bar = senders.acquire("bar");
+  CHECK(foo == 1);
+  CHECK(bar == 2);
+  CHECK(senders.acquire("foo") == foo);
+  CHECK(senders.find("foo") == foo);
+  CHECK(senders.find("baz") == SenderIds::no_sender);
+
+  // released once no holder is left
+  senders.release(foo);
+  CHECK(senders.find("foo") == foo);
+  senders.release(foo);
+  CHECK(senders.find("foo") == SenderIds::no_sender);
+  CHECK(senders.size() == 1);
+
+  // ids are recycled
+  CHECK(senders.acquire("baz") == foo);
+}
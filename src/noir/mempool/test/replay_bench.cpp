@@ -0,0 +1,408 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+// Replays a tx arrival trace against TxMempool, committing a block at every block interval of the trace, and reports
+// check_tx/reap/update throughput, latency percentiles and memory over time as JSON.
+//
+// A trace is a text file of `<arrival_us> <tx_id> <size> <peer_id>` lines, where arrivals of the same tx_id are the
+// same tx seen again, e.g. from other peers. Without --trace, a synthetic trace is generated whose tx ids follow a
+// Zipf distribution over --unique-txs, and it can be saved with --dump-trace to replay exactly the same one later.
+//
+// The trace is replayed as fast as possible; arrival times only decide when blocks are committed.
+#include <noir/mempool/mempool.h>
+#include <tendermint/abci/client/client.h>
+#include <appbase/CLI11.hpp>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+
+using namespace noir;
+using namespace noir::mempool;
+
+namespace {
+
+/// ABCI app answering check_tx with a priority derived from the tx, a fixed gas and a fixed latency
+class StubClient {
+public:
+  int64_t max_priority = 1000;
+  int64_t gas_wanted = 1;
+  std::chrono::microseconds latency{0};
+
+  std::atomic<uint64_t> num_check_txs{0};
+  std::atomic<uint64_t> num_rechecks{0};
+
+  void set_response_callback(abci::Callback cb) {
+    res_cb = std::move(cb);
+  }
+
+  auto error() -> Result<void> {
+    return success();
+  }
+
+  auto check_tx_sync(const abci::RequestCheckTx& req) -> Result<std::unique_ptr<abci::ResponseCheckTx>> {
+    return std::make_unique<abci::ResponseCheckTx>(respond(req));
+  }
+
+  auto check_tx_async(const abci::RequestCheckTx& req) -> Result<std::shared_ptr<abci::ReqRes>> {
+    auto rr = std::make_shared<abci::ReqRes>();
+    rr->request = std::make_unique<abci::Request>();
+    *rr->request->mutable_check_tx() = req;
+    rr->response = std::make_unique<abci::Response>();
+    *rr->response->mutable_check_tx() = respond(req);
+    rr->callback_invoked = false;
+    if (res_cb) {
+      res_cb(rr->request.get(), rr->response.get());
+    }
+    rr->invoke_callback();
+    rr->done();
+    return rr;
+  }
+
+  auto flush_async() -> Result<std::shared_ptr<abci::ReqRes>> {
+    auto rr = std::make_shared<abci::ReqRes>();
+    rr->callback_invoked = true;
+    rr->done();
+    return rr;
+  }
+
+  auto flush_sync() -> Result<void> {
+    return success();
+  }
+
+  // not used by the mempool
+  auto echo_async(const std::string&) -> Result<std::shared_ptr<abci::ReqRes>> {
+    return unsupported();
+  }
+  auto info_async(const abci::RequestInfo&) -> Result<std::shared_ptr<abci::ReqRes>> {
+    return unsupported();
+  }
+  auto deliver_tx_async(const abci::RequestDeliverTx&) -> Result<std::shared_ptr<abci::ReqRes>> {
+    return unsupported();
+  }
+  auto query_async(const abci::RequestQuery&) -> Result<std::shared_ptr<abci::ReqRes>> {
+    return unsupported();
+  }
+  auto commit_async() -> Result<std::shared_ptr<abci::ReqRes>> {
+    return unsupported();
+  }
+  auto init_chain_async(const abci::RequestInitChain&) -> Result<std::shared_ptr<abci::ReqRes>> {
+    return unsupported();
+  }
+  auto begin_block_async(const abci::RequestBeginBlock&) -> Result<std::shared_ptr<abci::ReqRes>> {
+    return unsupported();
+  }
+  auto end_block_async(const abci::RequestEndBlock&) -> Result<std::shared_ptr<abci::ReqRes>> {
+    return unsupported();
+  }
+  auto list_snapshots_async(const abci::RequestListSnapshots&) -> Result<std::shared_ptr<abci::ReqRes>> {
+    return unsupported();
+  }
+  auto offer_snapshot_async(const abci::RequestOfferSnapshot&) -> Result<std::shared_ptr<abci::ReqRes>> {
+    return unsupported();
+  }
+  auto load_snapshot_chunk_async(const abci::RequestLoadSnapshotChunk&) -> Result<std::shared_ptr<abci::ReqRes>> {
+    return unsupported();
+  }
+  auto apply_snapshot_chunk_async(const abci::RequestApplySnapshotChunk&) -> Result<std::shared_ptr<abci::ReqRes>> {
+    return unsupported();
+  }
+  auto echo_sync(const std::string&) -> Result<std::unique_ptr<abci::ResponseEcho>> {
+    return unsupported();
+  }
+  auto info_sync(const abci::RequestInfo&) -> Result<std::unique_ptr<abci::ResponseInfo>> {
+    return unsupported();
+  }
+  auto deliver_tx_sync(const abci::RequestDeliverTx&) -> Result<std::unique_ptr<abci::ResponseDeliverTx>> {
+    return unsupported();
+  }
+  auto query_sync(const abci::RequestQuery&) -> Result<std::unique_ptr<abci::ResponseQuery>> {
+    return unsupported();
+  }
+  auto commit_sync() -> Result<std::unique_ptr<abci::ResponseCommit>> {
+    return unsupported();
+  }
+  auto init_chain_sync(const abci::RequestInitChain&) -> Result<std::unique_ptr<abci::ResponseInitChain>> {
+    return unsupported();
+  }
+  auto begin_block_sync(const abci::RequestBeginBlock&) -> Result<std::unique_ptr<abci::ResponseBeginBlock>> {
+    return unsupported();
+  }
+  auto end_block_sync(const abci::RequestEndBlock&) -> Result<std::unique_ptr<abci::ResponseEndBlock>> {
+    return unsupported();
+  }
+  auto list_snapshots_sync(const abci::RequestListSnapshots&)
+    -> Result<std::unique_ptr<abci::ResponseListSnapshots>> {
+    return unsupported();
+  }
+  auto offer_snapshot_sync(const abci::RequestOfferSnapshot&)
+    -> Result<std::unique_ptr<abci::ResponseOfferSnapshot>> {
+    return unsupported();
+  }
+  auto load_snapshot_chunk_sync(const abci::RequestLoadSnapshotChunk&)
+    -> Result<std::unique_ptr<abci::ResponseLoadSnapshotChunk>> {
+    return unsupported();
+  }
+  auto apply_snapshot_chunk_sync(const abci::RequestApplySnapshotChunk&)
+    -> Result<std::unique_ptr<abci::ResponseApplySnapshotChunk>> {
+    return unsupported();
+  }
+
+private:
+  auto respond(const abci::RequestCheckTx& req) -> abci::ResponseCheckTx {
+    if (latency.count() > 0) {
+      std::this_thread::sleep_for(latency);
+    }
+    (req.type() == abci::CheckTxType::RECHECK ? num_rechecks : num_check_txs)++;
+
+    abci::ResponseCheckTx res{};
+    res.set_code(consensus::code_type_ok);
+    res.set_gas_wanted(gas_wanted);
+    res.set_priority(std::hash<std::string>{}(req.tx()) % (max_priority + 1));
+    return res;
+  }
+
+  static auto unsupported() -> Error {
+    return Error("not supported by the stub app");
+  }
+
+  abci::Callback res_cb;
+};
+
+static_assert(abci::Client<StubClient>);
+
+struct TraceEntry {
+  int64_t arrival_us;
+  uint64_t tx_id;
+  uint32_t size;
+  uint16_t peer_id;
+};
+
+auto read_trace(const std::string& path) -> Result<std::vector<TraceEntry>> {
+  std::ifstream in(path);
+  if (!in) {
+    return Error::format("unable to open trace: {}", path);
+  }
+  std::vector<TraceEntry> trace;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    TraceEntry e{};
+    if (std::sscanf(line.c_str(), "%ld %lu %u %hu", &e.arrival_us, &e.tx_id, &e.size, &e.peer_id) != 4) {
+      return Error::format("invalid trace line {}: {}", trace.size() + 1, line);
+    }
+    trace.push_back(e);
+  }
+  return trace;
+}
+
+/// Poisson arrivals at rate per second of tx ids drawn from a Zipf distribution with exponent s
+auto make_zipf_trace(size_t num_arrivals, size_t num_unique, double s, double rate, uint32_t size, int num_peers)
+  -> std::vector<TraceEntry> {
+  std::vector<double> cdf(num_unique);
+  double sum = 0;
+  for (size_t i = 0; i < num_unique; i++) {
+    sum += 1.0 / std::pow(double(i + 1), s);
+    cdf[i] = sum;
+  }
+
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> uniform(0, sum);
+  std::exponential_distribution<double> interval(rate / 1e6);
+  std::uniform_int_distribution<uint16_t> peer(1, num_peers);
+
+  // ranks are mapped to ids by a fixed permutation, so that popular txs are spread over the trace
+  std::vector<uint64_t> ids(num_unique);
+  std::iota(ids.begin(), ids.end(), 0);
+  std::shuffle(ids.begin(), ids.end(), rng);
+
+  std::vector<TraceEntry> trace(num_arrivals);
+  double at = 0;
+  for (auto& e : trace) {
+    at += interval(rng);
+    auto rank = std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin();
+    e = {int64_t(at), ids[std::min<size_t>(rank, num_unique - 1)], size, peer(rng)};
+  }
+  return trace;
+}
+
+void write_trace(const std::string& path, const std::vector<TraceEntry>& trace) {
+  std::ofstream out(path, std::ios::trunc);
+  out << "# arrival_us tx_id size peer_id\n";
+  for (const auto& e : trace) {
+    out << fmt::format("{} {} {} {}\n", e.arrival_us, e.tx_id, e.size, e.peer_id);
+  }
+}
+
+auto make_tx(uint64_t tx_id, uint32_t size) -> types::Tx {
+  types::Tx tx(Bytes(std::max<size_t>(size, sizeof(tx_id))));
+  std::memcpy(tx.data(), &tx_id, sizeof(tx_id));
+  return tx;
+}
+
+auto rss_bytes() -> int64_t {
+  std::ifstream statm("/proc/self/statm");
+  int64_t size = 0, resident = 0;
+  statm >> size >> resident;
+  return resident * ::sysconf(_SC_PAGESIZE);
+}
+
+struct Latencies {
+  std::vector<int64_t> ns;
+
+  template<typename Func>
+  auto measure(Func&& f) {
+    auto start = std::chrono::steady_clock::now();
+    auto ret = f();
+    ns.push_back((std::chrono::steady_clock::now() - start).count());
+    return ret;
+  }
+
+  auto total_sec() const -> double {
+    return std::accumulate(ns.begin(), ns.end(), int64_t(0)) / 1e9;
+  }
+
+  auto to_json(uint64_t num_items) -> std::string {
+    std::sort(ns.begin(), ns.end());
+    auto percentile = [&](double p) { return ns.empty() ? 0 : ns[std::min(ns.size() - 1, size_t(p * ns.size()))]; };
+    auto total = total_sec();
+    return fmt::format(R"({{"count": {}, "items": {}, "items_per_sec": {:.1f}, "p50_us": {:.1f}, "p99_us": {:.1f}, )"
+                       R"("max_us": {:.1f}}})",
+      ns.size(), num_items, total > 0 ? num_items / total : 0.0, percentile(0.5) / 1e3, percentile(0.99) / 1e3,
+      ns.empty() ? 0.0 : ns.back() / 1e3);
+  }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  CLI::App app{"Replays a tx arrival trace against TxMempool"};
+
+  std::string trace_path, dump_trace_path, output_path;
+  size_t num_arrivals = 200'000, num_unique = 100'000;
+  double zipf_s = 1.1, rate = 5'000;
+  uint32_t tx_size = 250;
+  int num_peers = 20;
+  int64_t block_interval_ms = 1'000, max_block_bytes = 1024 * 1024, max_block_gas = -1;
+
+  auto stub = std::make_shared<StubClient>();
+  int64_t app_latency_us = 0;
+
+  config::MempoolConfig config;
+  config.root_dir = "/tmp/noir_bench";
+  config.spill_file = "mempool.spill";
+
+  app.add_option("--trace", trace_path, "Trace to replay instead of a synthetic one");
+  app.add_option("--dump-trace", dump_trace_path, "Path to save the replayed trace");
+  app.add_option("--output", output_path, "Path of the JSON results, written to stdout if empty");
+  app.add_option("--arrivals", num_arrivals, "Number of tx arrivals of a synthetic trace");
+  app.add_option("--unique-txs", num_unique, "Number of distinct txs of a synthetic trace");
+  app.add_option("--zipf", zipf_s, "Zipf exponent of tx ids of a synthetic trace");
+  app.add_option("--rate", rate, "Arrivals per second of a synthetic trace");
+  app.add_option("--tx-size", tx_size, "Tx size of a synthetic trace");
+  app.add_option("--peers", num_peers, "Number of peers txs arrive from in a synthetic trace");
+  app.add_option("--block-interval-ms", block_interval_ms, "Trace time between blocks");
+  app.add_option("--max-block-bytes", max_block_bytes, "Max bytes reaped per block");
+  app.add_option("--max-block-gas", max_block_gas, "Max gas reaped per block, unlimited if -1");
+  app.add_option("--app-priority", stub->max_priority, "Max priority returned by the app");
+  app.add_option("--app-gas", stub->gas_wanted, "Gas wanted returned by the app");
+  app.add_option("--app-latency-us", app_latency_us, "Latency of the app per check_tx");
+  app.add_option("--size", config.size, "Max number of txs in the mempool");
+  app.add_option("--max-txs-bytes", config.max_txs_bytes, "Max bytes of txs in the mempool");
+  app.add_option("--max-resident-txs-bytes", config.max_resident_txs_bytes, "Enables the tiered mode if non-zero");
+  app.add_option("--cache-size", config.cache_size, "Size of the cache of seen txs");
+  app.add_option("--ttl-num-blocks", config.ttl_num_blocks, "Blocks until a tx expires, never if 0");
+  app.add_option("--recheck", config.recheck, "Recheck txs remaining after each block");
+  CLI11_PARSE(app, argc, argv);
+
+  stub->latency = std::chrono::microseconds(app_latency_us);
+
+  std::vector<TraceEntry> trace;
+  if (!trace_path.empty()) {
+    auto ok = read_trace(trace_path);
+    if (!ok) {
+      std::cerr << ok.error().message() << std::endl;
+      return 1;
+    }
+    trace = std::move(ok.value());
+  } else {
+    trace = make_zipf_trace(num_arrivals, num_unique, zipf_s, rate, tx_size, num_peers);
+  }
+  if (!dump_trace_path.empty()) {
+    write_trace(dump_trace_path, trace);
+  }
+
+  std::filesystem::create_directories(config.root_dir);
+  auto mp = TxMempool<StubClient>(&config, std::make_shared<proxy::AppConnMempool<StubClient>>(stub), 0);
+  if (auto ok = mp.open_spill_file(); !ok) {
+    std::cerr << ok.error().message() << std::endl;
+    return 1;
+  }
+
+  Latencies check_tx, reap, update;
+  uint64_t num_added = 0, num_rejected = 0, num_reaped = 0;
+  int64_t height = 0;
+  int64_t next_block_us = block_interval_ms * 1'000;
+  std::string samples;
+
+  auto commit_block = [&](int64_t at_us) {
+    auto txs = reap.measure([&]() { return mp.reap_max_bytes_max_gas(max_block_bytes, max_block_gas); });
+    num_reaped += txs.size();
+
+    google::protobuf::RepeatedPtrField<abci::ResponseDeliverTx> responses;
+    for (auto i = 0; i < txs.size(); i++) {
+      responses.Add()->set_code(consensus::code_type_ok);
+    }
+    auto ok = update.measure([&]() { return mp.update(++height, txs, responses); });
+    if (!ok) {
+      std::cerr << ok.error().message() << std::endl;
+    }
+
+    auto usage = mp.memory_usage();
+    samples += fmt::format(R"({}{{"height": {}, "at_us": {}, "block_txs": {}, "num_txs": {}, "size_bytes": {}, )"
+                           R"("metadata_bytes": {}, "resident_bytes": {}, "spilled_bytes": {}, "rss_bytes": {}}})",
+      samples.empty() ? "" : ", ", height, at_us, txs.size(), usage.num_txs, mp.size_bytes(), usage.metadata_bytes,
+      usage.resident_bytes, usage.spilled_bytes, rss_bytes());
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  for (const auto& e : trace) {
+    while (e.arrival_us >= next_block_us) {
+      commit_block(next_block_us);
+      next_block_us += block_interval_ms * 1'000;
+    }
+    auto tx = make_tx(e.tx_id, e.size);
+    auto ok = check_tx.measure([&]() { return mp.check_tx(tx, {.sender_id = e.peer_id}); });
+    ok ? num_added++ : num_rejected++;
+  }
+  if (!trace.empty()) {
+    commit_block(trace.back().arrival_us);
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  auto results = fmt::format(
+    R"({{"arrivals": {}, "added": {}, "rejected": {}, "reaped": {}, "blocks": {}, "elapsed_sec": {:.3f}, )"
+    R"("check_tx": {}, "reap": {}, "update": {}, "rechecks": {}, "rechecks_per_sec": {:.1f}, "samples": [{}]}})",
+    trace.size(), num_added, num_rejected, num_reaped, height, elapsed, check_tx.to_json(trace.size()),
+    reap.to_json(num_reaped), update.to_json(height), stub->num_rechecks.load(),
+    update.total_sec() > 0 ? stub->num_rechecks / update.total_sec() : 0.0, samples);
+
+  if (output_path.empty()) {
+    std::cout << results << std::endl;
+  } else {
+    std::ofstream(output_path, std::ios::trunc) << results << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,70 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+
+#include <noir/mempool/spill.h>
+#include <filesystem>
+
+using namespace noir;
+using namespace noir::mempool;
+
+namespace {
+
+auto open_spill_file(uint64_t capacity) {
+  std::filesystem::create_directories("/tmp/noir_test");
+  auto file = TxSpillFile::open("/tmp/noir_test/mempool.spill", capacity);
+  REQUIRE(file);
+  CHECK(!std::filesystem::exists("/tmp/noir_test/mempool.spill"));
+  return std::move(file.value());
+}
+
+} // namespace
+
+TEST_CASE("TxSpillFile", "[noir][mempool]") {
+  SECTION("WriteRead") {
+    auto file = open_spill_file(1024);
+    auto a = file->write(Bytes(std::span("tx_a")));
+    auto b = file->write(Bytes(std::span("tx_b_longer")));
+    REQUIRE(a);
+    REQUIRE(b);
+    CHECK(file->read(*a) == Bytes(std::span("tx_a")));
+    CHECK(file->read(*b) == Bytes(std::span("tx_b_longer")));
+    CHECK(file->used_bytes() == a->size + b->size);
+
+    auto empty = file->write(Bytes());
+    REQUIRE(empty);
+    CHECK(file->read(*empty).empty());
+  }
+
+  SECTION("Full") {
+    auto file = open_spill_file(16);
+    auto a = file->write(Bytes(10));
+    REQUIRE(a);
+    CHECK(!file->write(Bytes(10)));
+
+    file->release(*a);
+    CHECK(file->used_bytes() == 0);
+    CHECK(file->write(Bytes(16)));
+  }
+
+  SECTION("ReleaseCoalesces") {
+    auto file = open_spill_file(30);
+    auto a = file->write(Bytes(10));
+    auto b = file->write(Bytes(10));
+    auto c = file->write(Bytes(10));
+    REQUIRE((a && b && c));
+    CHECK(!file->write(Bytes(1)));
+
+    // frees are merged with both neighbors regardless of the order of releases
+    file->release(*a);
+    file->release(*c);
+    CHECK(!file->write(Bytes(20)));
+    file->release(*b);
+    auto d = file->write(Bytes(30));
+    REQUIRE(d);
+    CHECK(d->offset == 0);
+  }
+}
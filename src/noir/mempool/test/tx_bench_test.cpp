@@ -0,0 +1,107 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+
+#include <noir/mempool/tx.h>
+
+using namespace noir;
+using namespace noir::mempool;
+
+namespace {
+
+/// bookkeeping WrappedTx used to have per tx, i.e. a sender string and an ordered set of peer ids
+struct LegacyTxMetadata {
+  std::string sender;
+  std::set<uint16_t> peers;
+
+  auto heap_bytes() const -> size_t {
+    constexpr size_t peer_node_size = sizeof(uint16_t) + 4 * sizeof(void*);
+    auto sender_bytes = sender.capacity() > std::string().capacity() ? sender.capacity() + 1 : 0;
+    return sender_bytes + peers.size() * peer_node_size;
+  }
+};
+
+auto make_txs(TxStore& store, int num_txs) -> std::vector<std::shared_ptr<WrappedTx>> {
+  auto wtxs = std::vector<std::shared_ptr<WrappedTx>>(num_txs);
+  for (auto i = 0; i < num_txs; i++) {
+    auto tx = fmt::format("test_tx_{:d}", i);
+    wtxs[i] = std::make_shared<WrappedTx>(WrappedTx{
+      .tx = Bytes(std::span(tx)),
+      .priority = i,
+      .sender_id = store.intern_sender(fmt::format("0x{:040x}", i)),
+    });
+    wtxs[i]->hash = wtxs[i]->tx.key();
+  }
+  return wtxs;
+}
+
+} // namespace
+
+TEST_CASE("TxStoreBenchmarks", "[noir][mempool]") {
+  auto N = 10000;
+  auto num_peers = 8;
+
+  SECTION("metadata bytes") {
+    auto store = TxStore();
+    auto wtxs = make_txs(store, N);
+    size_t bytes = 0;
+    size_t legacy_bytes = 0;
+    for (auto i = 0; i < N; i++) {
+      auto legacy = LegacyTxMetadata{.sender = fmt::format("0x{:040x}", i)};
+      for (uint16_t peer_id = 1; peer_id <= num_peers; peer_id++) {
+        wtxs[i]->peers.insert(peer_id);
+        legacy.peers.insert(peer_id);
+      }
+      bytes += wtxs[i]->metadata_bytes();
+      legacy_bytes += sizeof(WrappedTx) - sizeof(PeerSet) - sizeof(uint32_t) + sizeof(LegacyTxMetadata) +
+        legacy.heap_bytes();
+    }
+    WARN(fmt::format("metadata bytes per tx with {} peers: {} (string sender and std::set peers: {})", num_peers,
+      bytes / N, legacy_bytes / N));
+  }
+
+  BENCHMARK_ADVANCED("SetTx")(Catch::Benchmark::Chronometer meter) {
+    auto store = TxStore();
+    auto wtxs = make_txs(store, N);
+    meter.measure([&]() {
+      for (const auto& wtx : wtxs) {
+        store.set_tx(wtx);
+      }
+    });
+  };
+
+  BENCHMARK_ADVANCED("GetTxByHash")(Catch::Benchmark::Chronometer meter) {
+    auto store = TxStore();
+    auto wtxs = make_txs(store, N);
+    for (const auto& wtx : wtxs) {
+      store.set_tx(wtx);
+    }
+    meter.measure([&]() {
+      auto found = 0;
+      for (const auto& wtx : wtxs) {
+        found += store.get_tx_by_hash(wtx->hash) != nullptr;
+      }
+      return found;
+    });
+  };
+
+  BENCHMARK_ADVANCED("GetOrSetPeerByTxHash")(Catch::Benchmark::Chronometer meter) {
+    auto store = TxStore();
+    auto wtxs = make_txs(store, N);
+    for (const auto& wtx : wtxs) {
+      store.set_tx(wtx);
+    }
+    meter.measure([&]() {
+      auto seen = 0;
+      for (uint16_t peer_id = 1; peer_id <= num_peers; peer_id++) {
+        for (const auto& wtx : wtxs) {
+          seen += store.get_or_set_peer_by_tx_hash(wtx->hash, peer_id).second;
+        }
+      }
+      return seen;
+    });
+  };
+}
@@ -7,6 +7,7 @@
 
 #include <noir/mempool/tx.h>
 #include <range/v3/view/enumerate.hpp>
+#include <filesystem>
 #include <random>
 
 using namespace noir;
@@ -18,18 +19,21 @@ TEST_CASE("TxStore", "[noir][mempool]") {
     auto wtx = std::make_shared<WrappedTx>(WrappedTx{
       .tx = Bytes(std::span("test_tx")),
       .priority = 1,
-      .sender = "foo",
+      .sender_id = txs.intern_sender("foo"),
       .timestamp = std::chrono::system_clock::now().time_since_epoch().count(),
     });
 
-    auto res = txs.get_tx_by_sender(wtx->sender);
+    auto res = txs.get_tx_by_sender("foo");
     CHECK(!res);
 
     txs.set_tx(wtx);
 
-    res = txs.get_tx_by_sender(wtx->sender);
+    res = txs.get_tx_by_sender("foo");
     CHECK(res);
     CHECK(res == wtx);
+
+    txs.remove_tx(wtx);
+    CHECK(!txs.get_tx_by_sender("foo"));
   }
 
   SECTION("GetTxByHash") {
@@ -37,7 +41,7 @@ TEST_CASE("TxStore", "[noir][mempool]") {
     auto wtx = std::make_shared<WrappedTx>(WrappedTx{
       .tx = Bytes(std::span("test_tx")),
       .priority = 1,
-      .sender = "foo",
+      .sender_id = txs.intern_sender("foo"),
       .timestamp = std::chrono::system_clock::now().time_since_epoch().count(),
     });
 
@@ -67,12 +71,13 @@ TEST_CASE("TxStore", "[noir][mempool]") {
     CHECK(res);
     CHECK(res == wtx);
 
-    wtx->sender = "foo";
+    wtx->sender_id = txs.intern_sender("foo");
     txs.set_tx(wtx);
 
     res = txs.get_tx_by_hash(key);
     CHECK(res);
     CHECK(res == wtx);
+    CHECK(txs.get_tx_by_sender("foo") == wtx);
   }
 
   SECTION("GetOrSetPeerByTxHash") {
@@ -235,3 +240,60 @@ TEST_CASE("WrappedTxList", "[noir][mempool]") {
     CHECK(expected == got);
   }
 }
+
+TEST_CASE("TxBodyStore", "[noir][mempool]") {
+  std::filesystem::create_directories("/tmp/noir_test");
+  auto file = TxSpillFile::open("/tmp/noir_test/mempool.spill", 1024 * 1024);
+  REQUIRE(file);
+  auto bodies = TxBodyStore(std::move(file.value()), 100);
+
+  auto make_tx = [](int64_t priority, size_t size) {
+    auto tx = Bytes(size);
+    std::fill(tx.begin(), tx.end(), static_cast<unsigned char>(priority));
+    return std::make_shared<WrappedTx>(WrappedTx{
+      .tx = tx,
+      .priority = priority,
+      .timestamp = std::chrono::system_clock::now().time_since_epoch().count(),
+    });
+  };
+
+  auto low = make_tx(1, 40);
+  auto mid = make_tx(2, 40);
+  auto high = make_tx(3, 40);
+  auto key = low->tx.key();
+  auto body = low->tx;
+
+  bodies.add(mid);
+  bodies.add(high);
+  CHECK(bodies.num_spilled() == 0);
+  CHECK(bodies.resident_bytes() == 80);
+
+  // over budget: the lowest priority tx is spilled, even if it is the newest one
+  bodies.add(low);
+  CHECK(bodies.num_spilled() == 1);
+  CHECK(bodies.resident_bytes() == 80);
+  CHECK(bodies.spilled_bytes() == 40);
+  CHECK(low->spilled);
+  CHECK(low->tx.empty());
+  CHECK(low->size() == 40);
+  CHECK(low->key() == key);
+  CHECK(bodies.load(*low) == body);
+  CHECK(bodies.load(*high) == high->tx);
+
+  auto highest = make_tx(4, 40);
+  bodies.add(highest);
+  CHECK(bodies.num_spilled() == 2);
+  CHECK(mid->spilled);
+  CHECK(!high->spilled);
+  CHECK(!highest->spilled);
+
+  bodies.remove(low);
+  bodies.remove(high);
+  CHECK(bodies.num_spilled() == 1);
+  CHECK(bodies.resident_bytes() == 40);
+  CHECK(bodies.spilled_bytes() == 40);
+  CHECK(bodies.load(*mid) == make_tx(2, 40)->tx);
+
+  // metadata stays in RAM while the body is spilled
+  CHECK(mid->metadata_bytes() >= sizeof(WrappedTx));
+}
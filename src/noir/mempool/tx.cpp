@@ -4,17 +4,30 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 #include <noir/mempool/tx.h>
-#include <range/v3/view/enumerate.hpp>
 #include <mutex>
 
 namespace noir::mempool {
 
 auto WrappedTx::size() const -> int {
-  return tx.size();
+  return spilled ? spilled->size : tx.size();
 }
 
 auto WrappedTx::key() const -> types::TxKey {
-  return tx.key();
+  // hash is set before the body is spilled
+  return spilled ? hash : tx.key();
+}
+
+auto WrappedTx::metadata_bytes() const -> size_t {
+  auto bytes = sizeof(WrappedTx) + peers.heap_bytes();
+  if (access) {
+    bytes += sizeof(consensus::tx_access);
+    for (const auto& keys : {&access->read_keys, &access->write_keys}) {
+      bytes += keys->capacity() * sizeof(std::string);
+      for (const auto& k : *keys)
+        bytes += k.capacity() > std::string().capacity() ? k.capacity() : 0;
+    }
+  }
+  return bytes;
 }
 
 auto WrappedTx::ptr() -> WrappedTx* {
@@ -28,9 +41,10 @@ auto TxStore::size() -> int {
 
 auto TxStore::get_all_txs() -> std::vector<std::shared_ptr<WrappedTx>> {
   std::shared_lock g{mtx};
-  auto wtxs = std::vector<std::shared_ptr<WrappedTx>>(txs.size());
-  for (auto [i, wtx] : ranges::views::enumerate(txs.get<TxStore::by_key>())) {
-    wtxs[i] = wtx;
+  auto wtxs = std::vector<std::shared_ptr<WrappedTx>>();
+  wtxs.reserve(txs.size());
+  for (const auto& [_, wtx] : txs) {
+    wtxs.push_back(wtx);
   }
   return wtxs;
 }
@@ -41,69 +55,131 @@ auto TxStore::get_tx_by_sender(const std::string& sender) -> std::shared_ptr<Wra
     return nullptr;
   }
   std::shared_lock g{mtx};
-  auto& sender_txs = txs.get<TxStore::by_sender>();
-  if (auto wtx = sender_txs.find(sender); wtx != sender_txs.end()) {
-    return *wtx;
+  if (auto id = senders.find(sender); id != SenderIds::no_sender && id <= txs_by_sender.size()) {
+    return txs_by_sender[id - 1];
   }
   return nullptr;
 }
 
 auto TxStore::get_tx_by_hash(const types::TxKey& hash) -> std::shared_ptr<WrappedTx> {
   std::shared_lock g{mtx};
-  auto& hash_txs = txs.get<TxStore::by_key>();
-  if (auto wtx = hash_txs.find(hash); wtx != hash_txs.end()) {
-    return *wtx;
+  if (auto it = txs.find(hash); it != txs.end()) {
+    return it->second;
   }
   return nullptr;
 }
 
 auto TxStore::is_tx_removed(const types::TxKey& hash) -> bool {
   std::shared_lock g{mtx};
-  auto& hash_txs = txs.get<TxStore::by_key>();
-  if (auto wtx = hash_txs.find(hash); wtx != hash_txs.end()) {
-    return (*wtx)->removed;
+  if (auto it = txs.find(hash); it != txs.end()) {
+    return it->second->removed;
   }
   return false;
 }
 
+auto TxStore::intern_sender(const std::string& sender) -> uint32_t {
+  std::unique_lock g{mtx};
+  return senders.acquire(sender);
+}
+
+void TxStore::release_sender(uint32_t sender_id) {
+  std::unique_lock g{mtx};
+  senders.release(sender_id);
+}
+
 void TxStore::set_tx(const std::shared_ptr<WrappedTx>& wtx) {
   std::unique_lock g{mtx};
-  txs.insert(wtx);
+  txs.insert_or_assign(wtx->key(), wtx);
+  if (auto id = wtx->sender_id; id != SenderIds::no_sender) {
+    if (id > txs_by_sender.size()) {
+      txs_by_sender.resize(id);
+    }
+    txs_by_sender[id - 1] = wtx;
+  }
 }
 
 void TxStore::remove_tx(const std::shared_ptr<WrappedTx>& wtx) {
   std::unique_lock g{mtx};
-  txs.erase(wtx->tx.key());
+  txs.erase(wtx->key());
+  if (auto id = wtx->sender_id; id != SenderIds::no_sender && !wtx->removed) {
+    if (id <= txs_by_sender.size() && txs_by_sender[id - 1] == wtx) {
+      txs_by_sender[id - 1] = nullptr;
+    }
+    senders.release(id);
+  }
   wtx->removed = true;
 }
 
 auto TxStore::tx_has_peer(const types::TxKey& hash, uint16_t peer_id) -> bool {
   std::shared_lock g{mtx};
-
-  auto& hash_txs = txs.get<TxStore::by_key>();
-  auto wtx = hash_txs.find(hash);
-  if (wtx == hash_txs.end()) {
+  auto it = txs.find(hash);
+  if (it == txs.end()) {
     return false;
   }
-  return (*wtx)->peers.contains(peer_id);
+  return it->second->peers.contains(peer_id);
 }
 
 auto TxStore::get_or_set_peer_by_tx_hash(const types::TxKey& hash, uint16_t peer_id)
   -> std::pair<std::shared_ptr<WrappedTx>, bool> {
   std::unique_lock g{mtx};
-
-  auto& hash_txs = txs.get<TxStore::by_key>();
-  auto wtx = hash_txs.find(hash);
-  if (wtx == hash_txs.end()) {
+  auto it = txs.find(hash);
+  if (it == txs.end()) {
     return {nullptr, false};
   }
+  return {it->second, !it->second->peers.insert(peer_id)};
+}
+
+void TxBodyStore::add(const std::shared_ptr<WrappedTx>& wtx) {
+  std::unique_lock g{mtx};
+  resident.insert(wtx.get());
+  resident_bytes_ += wtx->size();
+
+  while (resident_bytes_ > max_resident_bytes && !resident.empty()) {
+    auto coldest = *resident.begin();
+    auto extent = file->write(coldest->tx);
+    if (!extent) {
+      break; // spill file is full or fragmented; keep the rest in RAM
+    }
+    resident.erase(resident.begin());
+    resident_bytes_ -= coldest->size();
+    // key() returns hash once the body is gone
+    coldest->hash = coldest->tx.key();
+    coldest->spilled = extent;
+    coldest->tx = {};
+    num_spilled_++;
+  }
+}
+
+void TxBodyStore::remove(const std::shared_ptr<WrappedTx>& wtx) {
+  std::unique_lock g{mtx};
+  if (wtx->spilled) {
+    file->release(*wtx->spilled);
+    num_spilled_--;
+  } else if (resident.erase(wtx.get())) {
+    resident_bytes_ -= wtx->size();
+  }
+}
 
-  if ((*wtx)->peers.contains(peer_id)) {
-    return {*wtx, true};
+auto TxBodyStore::load(const WrappedTx& wtx) -> types::Tx {
+  std::shared_lock g{mtx};
+  if (wtx.spilled) {
+    return file->read(*wtx.spilled);
   }
+  return wtx.tx;
+}
+
+auto TxBodyStore::resident_bytes() -> int64_t {
+  std::shared_lock g{mtx};
+  return resident_bytes_;
+}
+
+auto TxBodyStore::spilled_bytes() -> int64_t {
+  return file->used_bytes();
+}
 
-  (*wtx)->peers.insert(peer_id);
-  return {*wtx, false};
+auto TxBodyStore::num_spilled() -> int {
+  std::shared_lock g{mtx};
+  return num_spilled_;
 }
 
 auto WrappedTxList::size() -> int {
@@ -6,17 +6,18 @@
 #pragma once
 #include <noir/clist/clist.h>
 #include <noir/common/time.h>
+#include <noir/consensus/tx_schedule.h>
 #include <noir/consensus/types/node_id.h>
+#include <noir/mempool/ids.h>
+#include <noir/mempool/spill.h>
 #include <tendermint/types/mempool.h>
 #include <tendermint/types/tx.h>
-#include <boost/multi_index/key.hpp>
-#include <boost/multi_index/member.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index_container.hpp>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <set>
 #include <shared_mutex>
+#include <unordered_map>
 
 namespace noir::mempool {
 
@@ -26,22 +27,27 @@ struct TxInfo {
 };
 
 struct WrappedTx {
-  types::Tx tx;
+  types::Tx tx; ///< empty while the body is spilled
   types::TxKey hash;
   int64_t height;
   int64_t gas_wanted;
   int64_t priority;
-  std::string sender;
+  uint32_t sender_id; ///< interned by TxStore::intern_sender, SenderIds::no_sender if none
+  std::shared_ptr<const consensus::tx_access> access; ///< keys declared by CheckTx, null if none
   tstamp timestamp;
-  std::set<uint16_t> peers;
+  PeerSet peers;
   // XXX: heap_index for priority_queue is handled by boost::multi_index
   // int heap_index;
   clist::CElementPtr<std::shared_ptr<WrappedTx>> gossip_el;
   bool removed;
+  std::optional<TxSpillFile::Extent> spilled;
 
   auto size() const -> int;
   auto key() const -> types::TxKey;
 
+  /// \brief bytes of RAM used for this tx other than its body, not counting containers referring to it
+  auto metadata_bytes() const -> size_t;
+
   auto ptr() -> WrappedTx*;
 };
 
@@ -52,33 +58,69 @@ public:
   auto get_tx_by_sender(const std::string& sender) -> std::shared_ptr<WrappedTx>;
   auto get_tx_by_hash(const types::TxKey& hash) -> std::shared_ptr<WrappedTx>;
   auto is_tx_removed(const types::TxKey& hash) -> bool;
+
+  /// \brief returns the id of sender to be set as WrappedTx::sender_id; released when the tx is removed
+  auto intern_sender(const std::string& sender) -> uint32_t;
+  /// \brief releases a sender id of a tx which wasn't added after all
+  void release_sender(uint32_t sender_id);
   void set_tx(const std::shared_ptr<WrappedTx>& wtx);
   void remove_tx(const std::shared_ptr<WrappedTx>& wtx);
   auto tx_has_peer(const types::TxKey& hash, uint16_t peer_id) -> bool;
   auto get_or_set_peer_by_tx_hash(const types::TxKey& hash, uint16_t peer_id)
     -> std::pair<std::shared_ptr<WrappedTx>, bool>;
 
-  struct by_key;
-  struct by_sender;
+private:
+  /// tx keys are sha256 digests, so any 8 bytes of them are uniformly distributed
+  struct key_hash {
+    size_t operator()(const types::TxKey& key) const {
+      size_t h;
+      std::memcpy(&h, key.data(), sizeof(h));
+      return h;
+    }
+  };
+
+  std::shared_mutex mtx;
+  std::unordered_map<types::TxKey, std::shared_ptr<WrappedTx>, key_hash> txs;
+  SenderIds senders;
+  std::vector<std::shared_ptr<WrappedTx>> txs_by_sender; ///< indexed by sender id - 1
+};
+
+/// \brief keeps tx bodies within a RAM budget by moving bodies of the coldest txs to a spill file
+/// Txs are colder as they would be reaped later, i.e. lower priority first and newer first among the same priority.
+class TxBodyStore {
+public:
+  TxBodyStore(std::unique_ptr<TxSpillFile> file, int64_t max_resident_bytes)
+    : file(std::move(file)), max_resident_bytes(max_resident_bytes) {}
+
+  /// \brief accounts the body of a newly added tx, then spills bodies of the coldest txs while over budget
+  void add(const std::shared_ptr<WrappedTx>& wtx);
+  void remove(const std::shared_ptr<WrappedTx>& wtx);
+
+  /// \brief returns the body of tx, loading it from the spill file if spilled
+  auto load(const WrappedTx& wtx) -> types::Tx;
+
+  auto resident_bytes() -> int64_t;
+  auto spilled_bytes() -> int64_t;
+  auto num_spilled() -> int;
 
 private:
-  template<typename T>
-  using tag = boost::multi_index::tag<T>;
-
-  // clang-format off
-  using Txs = boost::multi_index_container<
-    std::shared_ptr<WrappedTx>,
-    boost::multi_index::indexed_by<
-      // FIXME: According to original implementation, following two indices should be ordered_unique,
-      // but put these ordered_non_unique temporarily for testing
-      boost::multi_index::ordered_non_unique<tag<by_key>, boost::multi_index::key<&WrappedTx::key>>,
-      boost::multi_index::ordered_non_unique<tag<by_sender>, boost::multi_index::key<&WrappedTx::sender>>
-    >
-  >;
-  // clang-format on
+  struct colder {
+    bool operator()(const WrappedTx* lhs, const WrappedTx* rhs) const {
+      if (lhs->priority != rhs->priority)
+        return lhs->priority < rhs->priority;
+      if (lhs->timestamp != rhs->timestamp)
+        return lhs->timestamp > rhs->timestamp;
+      return lhs < rhs;
+    }
+  };
+
+  std::unique_ptr<TxSpillFile> file;
+  int64_t max_resident_bytes;
 
   std::shared_mutex mtx;
-  Txs txs;
+  std::set<WrappedTx*, colder> resident;
+  int64_t resident_bytes_{0};
+  int num_spilled_{0};
 };
 
 class WrappedTxList {
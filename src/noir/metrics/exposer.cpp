@@ -0,0 +1,116 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <noir/metrics/exposer.h>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+#include <fmt/core.h>
+
+namespace noir::metrics {
+
+namespace {
+  constexpr size_t max_request_size = 8192;
+
+  std::string make_response(std::string_view status, std::string_view content_type, std::string_view body) {
+    return fmt::format("HTTP/1.1 {}\r\nContent-Type: {}\r\nContent-Length: {}\r\nConnection: close\r\n\r\n{}", status,
+      content_type, body.size(), body);
+  }
+
+  /// reads a request, writes the response and closes the connection
+  struct session : std::enable_shared_from_this<session> {
+    session(boost::asio::ip::tcp::socket socket, const registry& r)
+      : socket(std::move(socket)), request(max_request_size), r(r) {}
+
+    void start() {
+      boost::asio::async_read_until(
+        socket, request, "\r\n\r\n", [self = shared_from_this()](const boost::system::error_code& ec, size_t) {
+          if (ec)
+            return;
+          self->respond();
+        });
+    }
+
+    void respond() {
+      std::string line;
+      std::istream in(&request);
+      std::getline(in, line);
+      auto method_end = line.find(' ');
+      auto path_end = line.find(' ', method_end + 1);
+      auto method = line.substr(0, method_end);
+      auto path = method_end != std::string::npos ? line.substr(method_end + 1, path_end - method_end - 1) : "";
+      if (method != "GET") {
+        response = make_response("405 Method Not Allowed", "text/plain", "");
+      } else if (path != "/metrics" && !path.starts_with("/metrics?")) {
+        response = make_response("404 Not Found", "text/plain", "");
+      } else {
+        response = make_response("200 OK", content_type, r.scrape());
+      }
+      boost::asio::async_write(
+        socket, boost::asio::buffer(response), [self = shared_from_this()](const boost::system::error_code&, size_t) {
+          boost::system::error_code ignored;
+          self->socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+        });
+    }
+
+    boost::asio::ip::tcp::socket socket;
+    boost::asio::streambuf request;
+    std::string response;
+    const registry& r;
+  };
+} // namespace
+
+exposer::exposer(boost::asio::io_context& io_context, const registry& r): r(r), acceptor(io_context) {}
+
+Result<std::shared_ptr<exposer>> exposer::listen(
+  boost::asio::io_context& io_context, const std::string& address, const registry& r) {
+  auto colon = address.rfind(':');
+  if (colon == std::string::npos)
+    return Error::format("failed to parse address: {}", address);
+  auto host = colon ? address.substr(0, colon) : std::string("0.0.0.0");
+
+  boost::system::error_code ec;
+  boost::asio::ip::tcp::resolver resolver(io_context);
+  auto endpoints = resolver.resolve(host, address.substr(colon + 1), ec);
+  if (ec)
+    return ec;
+
+  auto e = std::shared_ptr<exposer>(new exposer(io_context, r));
+  auto endpoint = endpoints.begin()->endpoint();
+  e->acceptor.open(endpoint.protocol(), ec);
+  if (!ec)
+    e->acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true), ec);
+  if (!ec)
+    e->acceptor.bind(endpoint, ec);
+  if (!ec)
+    e->acceptor.listen(boost::asio::socket_base::max_listen_connections, ec);
+  if (ec)
+    return ec;
+  e->accept();
+  return e;
+}
+
+uint16_t exposer::port() const {
+  return acceptor.local_endpoint().port();
+}
+
+void exposer::stop() {
+  boost::asio::post(acceptor.get_executor(), [self = shared_from_this()]() {
+    boost::system::error_code ignored;
+    self->acceptor.close(ignored);
+  });
+}
+
+void exposer::accept() {
+  acceptor.async_accept([self = shared_from_this()](const boost::system::error_code& ec, auto socket) {
+    if (!self->acceptor.is_open())
+      return;
+    if (!ec)
+      std::make_shared<session>(std::move(socket), self->r)->start();
+    self->accept();
+  });
+}
+
+} // namespace noir::metrics
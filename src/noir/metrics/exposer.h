@@ -0,0 +1,38 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/core/result.h>
+#include <noir/metrics/metrics.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <memory>
+#include <string>
+
+namespace noir::metrics {
+
+/// \brief serves scrapes of a registry at /metrics over plain HTTP, for nodes built without the rpc plugin
+/// Each connection is answered once and closed, as Prometheus opens one per scrape.
+class exposer : public std::enable_shared_from_this<exposer> {
+public:
+  /// \brief starts accepting scrapes on address, e.g. "0.0.0.0:26660"; port 0 picks a free port
+  static Result<std::shared_ptr<exposer>> listen(
+    boost::asio::io_context& io_context, const std::string& address, const registry& r = default_registry());
+
+  uint16_t port() const;
+
+  /// \brief stops accepting scrapes; scrapes being answered complete
+  void stop();
+
+private:
+  exposer(boost::asio::io_context& io_context, const registry& r);
+
+  void accept();
+
+  const registry& r;
+  boost::asio::ip::tcp::acceptor acceptor;
+};
+
+} // namespace noir::metrics
@@ -0,0 +1,243 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <noir/common/check.h>
+#include <noir/metrics/metrics.h>
+#include <fmt/core.h>
+
+#include <cctype>
+#include <cmath>
+#include <memory>
+
+namespace noir::metrics {
+
+namespace detail {
+  namespace {
+    std::mutex shards_mtx;
+    // shards outlive their threads, so counts of exited threads are still exported
+    std::vector<std::unique_ptr<shard>> shards;
+    std::atomic<uint32_t> num_slots{num_discarded_slots};
+
+    uint32_t allocate_slots(uint32_t n) {
+      auto index = num_slots.fetch_add(n);
+      check(index + n <= chunk_size * max_chunks, "too many metrics: {}", index + n);
+      return index;
+    }
+  } // namespace
+
+  shard& register_shard() {
+    auto s = std::make_unique<shard>();
+    local_shard = s.get();
+    std::scoped_lock g{shards_mtx};
+    shards.push_back(std::move(s));
+    return *local_shard;
+  }
+
+  shard::chunk& add_chunk(shard& s, uint32_t i) {
+    auto c = new shard::chunk{};
+    s.chunks[i].store(c, std::memory_order_release);
+    return *c;
+  }
+
+  uint64_t sum(uint32_t index) {
+    uint64_t total = 0;
+    std::scoped_lock g{shards_mtx};
+    for (const auto& s : shards) {
+      if (auto c = s->chunks[index / chunk_size].load(std::memory_order_acquire))
+        total += (*c)[index % chunk_size].load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  double sum_double(uint32_t index) {
+    double total = 0;
+    std::scoped_lock g{shards_mtx};
+    for (const auto& s : shards) {
+      if (auto c = s->chunks[index / chunk_size].load(std::memory_order_acquire))
+        total += std::bit_cast<double>((*c)[index % chunk_size].load(std::memory_order_relaxed));
+    }
+    return total;
+  }
+} // namespace detail
+
+namespace {
+  void check_name(const std::string& name) {
+    auto valid = !name.empty() && !std::isdigit(static_cast<unsigned char>(name[0])) &&
+      std::all_of(name.begin(), name.end(),
+        [](unsigned char c) { return std::isalnum(c) || c == '_' || c == ':'; });
+    check(valid, "invalid metric name: {}", name);
+  }
+
+  /// escapes a label value, or help text, which keeps double quotes as they are
+  std::string escape(std::string_view value, bool quoted = true) {
+    std::string out;
+    for (auto c : value) {
+      if (c == '\\' || (quoted && c == '"')) {
+        out += '\\';
+        out += c;
+      } else if (c == '\n') {
+        out += "\\n";
+      } else {
+        out += c;
+      }
+    }
+    return out;
+  }
+
+  /// labels inside braces, without them, e.g. channel="32",peer="a1b2"
+  std::string format_labels(const label_set& labels) {
+    std::string out;
+    for (const auto& [name, value] : labels) {
+      check_name(name);
+      out += fmt::format("{}{}=\"{}\"", out.empty() ? "" : ",", name, escape(value));
+    }
+    return out;
+  }
+
+  std::string with_labels(const std::string& name, const std::string& labels, const std::string& extra = "") {
+    if (labels.empty() && extra.empty())
+      return name;
+    return fmt::format("{}{{{}{}{}}}", name, labels, labels.empty() || extra.empty() ? "" : ",", extra);
+  }
+
+  std::string format_value(double v) {
+    if (std::isinf(v))
+      return v > 0 ? "+Inf" : "-Inf";
+    if (std::isnan(v))
+      return "NaN";
+    return fmt::format("{}", v);
+  }
+
+  const char* type_name(metric_type type) {
+    switch (type) {
+    case metric_type::counter:
+      return "counter";
+    case metric_type::gauge:
+      return "gauge";
+    case metric_type::histogram:
+      return "histogram";
+    }
+    return "untyped";
+  }
+
+  struct exported_family {
+    std::string help;
+    metric_type type;
+    std::vector<std::string> lines;
+  };
+} // namespace
+
+registry::series& registry::find_or_add(const std::string& name,
+  const std::string& help,
+  metric_type type,
+  std::vector<double> bounds,
+  const label_set& labels) {
+  check_name(name);
+  auto key = format_labels(labels);
+
+  std::scoped_lock g{mtx};
+  auto [it, added] = families.try_emplace(name);
+  auto& f = it->second;
+  if (added) {
+    f.help = help;
+    f.type = type;
+    f.bounds = std::move(bounds);
+  } else {
+    check(f.type == type, "metric {} is already registered as a {}", name, type_name(f.type));
+    check(f.bounds == bounds, "metric {} is already registered with other buckets", name);
+  }
+
+  auto [s, new_series] = f.series_by_labels.try_emplace(key);
+  if (new_series) {
+    if (type == metric_type::gauge)
+      s->second.val = &gauges.emplace_back(0);
+    else
+      s->second.index = detail::allocate_slots(type == metric_type::counter ? 1 : f.bounds.size() + 2);
+  }
+  return s->second;
+}
+
+counter registry::make_counter(const std::string& name, const std::string& help, const label_set& labels) {
+  return counter(find_or_add(name, help, metric_type::counter, {}, labels).index);
+}
+
+gauge registry::make_gauge(const std::string& name, const std::string& help, const label_set& labels) {
+  return gauge(find_or_add(name, help, metric_type::gauge, {}, labels).val);
+}
+
+histogram registry::make_histogram(
+  const std::string& name, const std::string& help, std::vector<double> bounds, const label_set& labels) {
+  check(std::is_sorted(bounds.begin(), bounds.end()), "buckets of metric {} are not sorted", name);
+  auto index = find_or_add(name, help, metric_type::histogram, bounds, labels).index;
+  std::scoped_lock g{mtx};
+  return histogram(index, &families.at(name).bounds);
+}
+
+void registry::add_collector(collector c) {
+  std::scoped_lock g{mtx};
+  collectors.push_back(std::move(c));
+}
+
+std::string registry::scrape() const {
+  std::map<std::string, exported_family> exported;
+  std::vector<collector> to_collect;
+  {
+    std::scoped_lock g{mtx};
+    for (const auto& [name, f] : families) {
+      auto& e = exported.try_emplace(name, exported_family{f.help, f.type, {}}).first->second;
+      for (const auto& [labels, s] : f.series_by_labels) {
+        switch (f.type) {
+        case metric_type::counter:
+          e.lines.push_back(fmt::format("{} {}", with_labels(name, labels), detail::sum(s.index)));
+          break;
+        case metric_type::gauge:
+          e.lines.push_back(fmt::format("{} {}", with_labels(name, labels), s.val->load(std::memory_order_relaxed)));
+          break;
+        case metric_type::histogram: {
+          // buckets are counted separately and exported cumulative
+          uint64_t count = 0;
+          for (size_t i = 0; i <= f.bounds.size(); i++) {
+            count += detail::sum(s.index + i);
+            auto le = i < f.bounds.size() ? format_value(f.bounds[i]) : "+Inf";
+            e.lines.push_back(
+              fmt::format("{} {}", with_labels(name + "_bucket", labels, fmt::format("le=\"{}\"", le)), count));
+          }
+          auto sum = detail::sum_double(s.index + f.bounds.size() + 1);
+          e.lines.push_back(fmt::format("{} {}", with_labels(name + "_sum", labels), format_value(sum)));
+          e.lines.push_back(fmt::format("{} {}", with_labels(name + "_count", labels), count));
+          break;
+        }
+        }
+      }
+    }
+    to_collect = collectors;
+  }
+
+  // collectors may take a while, e.g. reading properties of a db, so they run without blocking registrations
+  std::vector<sample> samples;
+  for (const auto& c : to_collect)
+    c(samples);
+  for (const auto& s : samples) {
+    auto& e = exported.try_emplace(s.name, exported_family{s.help, s.type, {}}).first->second;
+    e.lines.push_back(fmt::format("{} {}", with_labels(s.name, format_labels(s.labels)), format_value(s.value)));
+  }
+
+  std::string out;
+  for (const auto& [name, e] : exported) {
+    out += fmt::format("# HELP {} {}\n# TYPE {} {}\n", name, escape(e.help, false), name, type_name(e.type));
+    for (const auto& line : e.lines) {
+      out += line;
+      out += '\n';
+    }
+  }
+  return out;
+}
+
+registry& default_registry() {
+  static registry r;
+  return r;
+}
+
+} // namespace noir::metrics
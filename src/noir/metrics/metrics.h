@@ -0,0 +1,250 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+
+/// \defgroup metrics Metrics
+/// \brief Counters, gauges and histograms exported in the Prometheus text format
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace noir::metrics {
+
+/// \brief label names and values of a series, in the order they are exported
+using label_set = std::vector<std::pair<std::string, std::string>>;
+
+enum class metric_type {
+  counter,
+  gauge,
+  histogram,
+};
+
+namespace detail {
+  constexpr uint32_t chunk_size = 512;
+  constexpr uint32_t max_chunks = 2048;
+  /// slots reserved for handles that were never registered, whose updates are dropped
+  constexpr uint32_t num_discarded_slots = 2;
+
+  /// slots of counters and histograms updated by a single thread; only the owning thread writes, and scrapes sum the
+  /// slots of all threads
+  struct shard {
+    using chunk = std::array<std::atomic<uint64_t>, chunk_size>;
+
+    std::array<std::atomic<chunk*>, max_chunks> chunks{};
+
+    ~shard() {
+      for (auto& c : chunks)
+        delete c.load();
+    }
+  };
+
+  inline thread_local shard* local_shard = nullptr;
+  inline std::atomic<int64_t> discarded_gauge{0};
+  inline const std::vector<double> no_bounds{};
+
+  shard& register_shard();
+  shard::chunk& add_chunk(shard& s, uint32_t i);
+
+  inline std::atomic<uint64_t>& local_slot(uint32_t index) {
+    auto s = local_shard ? local_shard : &register_shard();
+    auto c = s->chunks[index / chunk_size].load(std::memory_order_relaxed);
+    if (!c) [[unlikely]]
+      c = &add_chunk(*s, index / chunk_size);
+    return (*c)[index % chunk_size];
+  }
+
+  /// no other thread writes to the slot, so neither a locked instruction nor a fence is needed
+  inline void add(uint32_t index, uint64_t v) {
+    auto& slot = local_slot(index);
+    slot.store(slot.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+  }
+
+  inline void add_double(uint32_t index, double v) {
+    auto& slot = local_slot(index);
+    slot.store(std::bit_cast<uint64_t>(std::bit_cast<double>(slot.load(std::memory_order_relaxed)) + v),
+      std::memory_order_relaxed);
+  }
+
+  uint64_t sum(uint32_t index);
+  double sum_double(uint32_t index);
+} // namespace detail
+
+/// \brief monotonically increasing count, e.g. of bytes sent
+/// An increment is a plain store to a slot of the calling thread, merged with the slots of other threads on scrape.
+/// Default constructed counters aren't registered, and drop increments.
+/// \ingroup metrics
+class counter {
+public:
+  counter() = default;
+
+  void inc(uint64_t v = 1) const {
+    detail::add(index, v);
+  }
+
+  uint64_t value() const {
+    return detail::sum(index);
+  }
+
+private:
+  friend class registry;
+  explicit counter(uint32_t index): index(index) {}
+
+  uint32_t index = 0;
+};
+
+/// \brief value that goes up and down, e.g. number of txs in the mempool
+/// A gauge is a single atomic shared by all threads, as the last value set wins.
+/// \ingroup metrics
+class gauge {
+public:
+  gauge() = default;
+
+  void set(int64_t v) const {
+    val->store(v, std::memory_order_relaxed);
+  }
+
+  void add(int64_t v) const {
+    val->fetch_add(v, std::memory_order_relaxed);
+  }
+
+  int64_t value() const {
+    return val->load(std::memory_order_relaxed);
+  }
+
+private:
+  friend class registry;
+  explicit gauge(std::atomic<int64_t>* val): val(val) {}
+
+  std::atomic<int64_t>* val = &detail::discarded_gauge;
+};
+
+/// \brief distribution of observed values, e.g. of latencies in seconds, counted in buckets fixed at registration
+/// \ingroup metrics
+class histogram {
+public:
+  /// \brief observes the seconds elapsed from its construction to its destruction
+  class timer {
+  public:
+    explicit timer(const histogram& h): h(h), start(std::chrono::steady_clock::now()) {}
+
+    timer(const timer&) = delete;
+    timer& operator=(const timer&) = delete;
+
+    ~timer() {
+      h.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+  private:
+    const histogram& h;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  histogram() = default;
+
+  void observe(double v) const {
+    auto bucket = std::lower_bound(bounds->begin(), bounds->end(), v) - bounds->begin();
+    detail::add(index + bucket, 1);
+    detail::add_double(index + bounds->size() + 1, v);
+  }
+
+  [[nodiscard]] timer time() const {
+    return timer(*this);
+  }
+
+  uint64_t count() const {
+    uint64_t n = 0;
+    for (uint32_t i = 0; i <= bounds->size(); i++)
+      n += detail::sum(index + i);
+    return n;
+  }
+
+  double sum() const {
+    return detail::sum_double(index + bounds->size() + 1);
+  }
+
+private:
+  friend class registry;
+  histogram(uint32_t index, const std::vector<double>* bounds): index(index), bounds(bounds) {}
+
+  // a slot per bucket including +Inf, followed by a slot of the sum
+  uint32_t index = 0;
+  const std::vector<double>* bounds = &detail::no_bounds;
+};
+
+/// \brief value kept elsewhere, e.g. by rocksdb, reported by a collector on scrape
+struct sample {
+  std::string name;
+  std::string help;
+  metric_type type;
+  label_set labels;
+  double value;
+};
+
+using collector = std::function<void(std::vector<sample>&)>;
+
+/// \brief buckets in seconds suited to latencies from tens of microseconds to seconds
+inline const std::vector<double> latency_buckets = {
+  0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+
+/// \brief content type of scrape()
+constexpr auto content_type = "text/plain; version=0.0.4; charset=utf-8";
+
+/// \brief metrics by name and labels, exported in the Prometheus text format
+/// Labels are resolved at registration, which returns a handle to update the series with. Registering a name and labels
+/// again returns the same series, so handles may be registered wherever they are needed. Registration takes a lock, so
+/// handles on hot paths are better registered once and kept.
+/// \ingroup metrics
+class registry {
+public:
+  counter make_counter(const std::string& name, const std::string& help, const label_set& labels = {});
+  gauge make_gauge(const std::string& name, const std::string& help, const label_set& labels = {});
+  histogram make_histogram(const std::string& name,
+    const std::string& help,
+    std::vector<double> bounds = latency_buckets,
+    const label_set& labels = {});
+
+  void add_collector(collector c);
+
+  /// \brief all series in the Prometheus text exposition format 0.0.4
+  std::string scrape() const;
+
+private:
+  struct series {
+    uint32_t index = 0;
+    std::atomic<int64_t>* val = nullptr;
+  };
+
+  struct family {
+    std::string help;
+    metric_type type;
+    std::vector<double> bounds;
+    std::map<std::string, series> series_by_labels;
+  };
+
+  series& find_or_add(
+    const std::string& name, const std::string& help, metric_type type, std::vector<double> bounds, const label_set&);
+
+  mutable std::mutex mtx;
+  std::map<std::string, family> families;
+  std::deque<std::atomic<int64_t>> gauges;
+  std::vector<collector> collectors;
+};
+
+/// \brief registry of the process, which the node exports at /metrics
+registry& default_registry();
+
+} // namespace noir::metrics
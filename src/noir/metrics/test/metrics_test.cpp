@@ -0,0 +1,153 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/metrics/exposer.h>
+#include <noir/metrics/metrics.h>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <thread>
+
+using namespace noir::metrics;
+
+TEST_CASE("metrics: counters merged across threads", "[noir][metrics]") {
+  constexpr int num_threads = 8;
+  constexpr int num_incs = 100'000;
+  registry r;
+  auto c = r.make_counter("noir_test_total", "Test counter", {{"channel", "32"}});
+
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < num_threads; i++) {
+    threads.emplace_back([&]() {
+      for (auto j = 0; j < num_incs; j++)
+        c.inc();
+      c.inc(10);
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  // counts of exited threads are kept
+  CHECK(c.value() == num_threads * (num_incs + 10));
+
+  // the same name and labels resolve to the same series
+  CHECK(r.make_counter("noir_test_total", "Test counter", {{"channel", "32"}}).value() == c.value());
+  CHECK(r.make_counter("noir_test_total", "Test counter", {{"channel", "33"}}).value() == 0);
+
+  CHECK_THROWS(r.make_gauge("noir_test_total", "Test counter"));
+  CHECK_THROWS(r.make_counter("noir-test", "Invalid name"));
+  CHECK_THROWS(r.make_counter("noir_test_total", "Invalid label", {{"0channel", "32"}}));
+
+  // handles not registered drop updates
+  counter{}.inc();
+  gauge{}.set(1);
+  histogram{}.observe(1);
+}
+
+TEST_CASE("metrics: scrape", "[noir][metrics]") {
+  registry r;
+  auto sent = r.make_counter("noir_p2p_bytes_sent_total", "Bytes sent", {{"channel", "32"}, {"peer", "a1"}});
+  auto size = r.make_gauge("noir_mempool_size", "Number of txs");
+  auto latency = r.make_histogram("noir_abci_seconds", "Latency", {0.01, 0.1}, {{"method", "commit"}});
+  r.add_collector([](std::vector<sample>& samples) {
+    samples.push_back({"noir_db_bytes_read_total", "Bytes \"read\"\nby db", metric_type::counter, {}, 42});
+    samples.push_back({"noir_db_sst_bytes", "Sst bytes", metric_type::gauge, {{"cf", "de\"fault"}}, 1.5});
+  });
+
+  sent.inc(100);
+  size.set(7);
+  size.add(-2);
+  latency.observe(0.005);
+  latency.observe(0.05);
+  std::thread([&]() { latency.observe(0.5); }).join();
+  CHECK(size.value() == 5);
+  CHECK(latency.count() == 3);
+  CHECK(latency.sum() == Catch::Approx(0.555));
+
+  CHECK(r.scrape() ==
+    "# HELP noir_abci_seconds Latency\n"
+    "# TYPE noir_abci_seconds histogram\n"
+    "noir_abci_seconds_bucket{method=\"commit\",le=\"0.01\"} 1\n"
+    "noir_abci_seconds_bucket{method=\"commit\",le=\"0.1\"} 2\n"
+    "noir_abci_seconds_bucket{method=\"commit\",le=\"+Inf\"} 3\n"
+    "noir_abci_seconds_sum{method=\"commit\"} 0.555\n"
+    "noir_abci_seconds_count{method=\"commit\"} 3\n"
+    "# HELP noir_db_bytes_read_total Bytes \"read\"\\nby db\n"
+    "# TYPE noir_db_bytes_read_total counter\n"
+    "noir_db_bytes_read_total 42\n"
+    "# HELP noir_db_sst_bytes Sst bytes\n"
+    "# TYPE noir_db_sst_bytes gauge\n"
+    "noir_db_sst_bytes{cf=\"de\\\"fault\"} 1.5\n"
+    "# HELP noir_mempool_size Number of txs\n"
+    "# TYPE noir_mempool_size gauge\n"
+    "noir_mempool_size 5\n"
+    "# HELP noir_p2p_bytes_sent_total Bytes sent\n"
+    "# TYPE noir_p2p_bytes_sent_total counter\n"
+    "noir_p2p_bytes_sent_total{channel=\"32\",peer=\"a1\"} 100\n");
+
+  CHECK_THROWS(r.make_histogram("noir_abci_seconds", "Latency", {0.01, 0.2}, {{"method", "query"}}));
+  CHECK_THROWS(r.make_histogram("noir_unsorted_seconds", "Latency", {0.1, 0.01}));
+}
+
+TEST_CASE("metrics: histogram of several label sets", "[noir][metrics]") {
+  registry r;
+  auto commit = r.make_histogram("noir_abci_seconds", "Latency", {0.01, 0.1}, {{"method", "commit"}});
+  auto query = r.make_histogram("noir_abci_seconds", "Latency", {0.01, 0.1}, {{"method", "query"}});
+  commit.observe(0.005);
+  query.observe(0.05);
+  query.observe(0.5);
+  CHECK(commit.count() == 1);
+  CHECK(query.count() == 2);
+  CHECK(r.make_histogram("noir_abci_seconds", "Latency", {0.01, 0.1}, {{"method", "query"}}).count() == 2);
+
+  auto scraped = r.scrape();
+  CHECK(scraped.find("noir_abci_seconds_bucket{method=\"commit\",le=\"0.01\"} 1\n") != std::string::npos);
+  CHECK(scraped.find("noir_abci_seconds_bucket{method=\"query\",le=\"0.1\"} 1\n") != std::string::npos);
+  CHECK(scraped.find("noir_abci_seconds_count{method=\"query\"} 2\n") != std::string::npos);
+
+  CHECK_THROWS(r.make_histogram("noir_abci_seconds", "Latency", {0.01}, {{"method", "commit"}}));
+}
+
+TEST_CASE("metrics: histogram timer", "[noir][metrics]") {
+  registry r;
+  auto h = r.make_histogram("noir_timer_seconds", "Timer");
+  {
+    auto t = h.time();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  CHECK(h.count() == 1);
+  CHECK(h.sum() >= 0.002);
+}
+
+TEST_CASE("metrics: exposer", "[noir][metrics]") {
+  registry r;
+  r.make_counter("noir_p2p_bytes_sent_total", "Bytes sent").inc(3);
+
+  boost::asio::io_context io_context;
+  auto e = exposer::listen(io_context, "127.0.0.1:0", r);
+  REQUIRE(e);
+  std::thread t([&]() { io_context.run(); });
+
+  auto get = [&](std::string_view request) {
+    boost::asio::io_context client;
+    boost::asio::ip::tcp::socket socket(client);
+    socket.connect({boost::asio::ip::make_address("127.0.0.1"), e.value()->port()});
+    boost::asio::write(socket, boost::asio::buffer(request));
+    std::string response;
+    boost::system::error_code ec;
+    boost::asio::read(socket, boost::asio::dynamic_buffer(response), ec);
+    return response;
+  };
+
+  auto ok = get("GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+  CHECK(ok.starts_with("HTTP/1.1 200 OK\r\n"));
+  CHECK(ok.find(content_type) != std::string::npos);
+  CHECK(ok.ends_with("\r\n\r\n" + r.scrape()));
+  CHECK(get("GET /status HTTP/1.1\r\n\r\n").starts_with("HTTP/1.1 404"));
+  CHECK(get("POST /metrics HTTP/1.1\r\n\r\n").starts_with("HTTP/1.1 405"));
+
+  e.value()->stop();
+  t.join();
+}
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 #include <noir/common/check.h>
+#include <noir/common/trace.h>
 #include <noir/p2p/conn/merlin.h>
 #include <noir/p2p/conn/secret_connection.h>
 
@@ -126,6 +127,7 @@ Bytes secret_connection::derive_secrets(Bytes32& dh_secret) {
 }
 
 Result<std::pair<int, std::vector<std::shared_ptr<Bytes>>>> secret_connection::write(std::span<unsigned char> data) {
+  trace::span span("secret_connection_encrypt");
   std::scoped_lock g(send_mtx);
   int n{};
   std::vector<std::shared_ptr<Bytes>> ret;
@@ -165,6 +167,7 @@ Result<std::pair<int, std::vector<std::shared_ptr<Bytes>>>> secret_connection::w
 }
 
 Result<std::shared_ptr<Bytes>> secret_connection::read(std::span<unsigned char> data, bool is_peek) {
+  trace::span span("secret_connection_decrypt");
   std::scoped_lock g(recv_mtx);
   check(data.size() == 1044, "invalid sealed_frame size");
 
@@ -0,0 +1,154 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <noir/common/check.h>
+#include <noir/common/log.h>
+#include <noir/common/plugin_interface.h>
+#include <noir/p2p/dispatcher.h>
+
+#include <appbase/application.hpp>
+#include <fc/log/logger_config.hpp>
+#include <fmt/core.h>
+
+#include <algorithm>
+
+namespace noir::p2p {
+
+dispatcher::dispatcher(size_t num_threads): num_threads(std::max<size_t>(num_threads, 1)) {}
+
+dispatcher::~dispatcher() {
+  stop();
+}
+
+void dispatcher::add_inbox(
+  const std::string& name, const std::vector<channel_id>& channels, int priority, size_t capacity, handler fn) {
+  std::scoped_lock g{mtx};
+  check(threads.empty(), "inboxes must be added before the dispatcher starts");
+  check(capacity > 0, fmt::format("capacity of inbox {} must be positive", name));
+  auto& r = metrics::default_registry();
+  metrics::label_set labels = {{"inbox", name}};
+  auto it = std::upper_bound(
+    inboxes.begin(), inboxes.end(), priority, [](int p, const auto& in) { return p < in->priority; });
+  auto& in = **inboxes.insert(it,
+    std::make_unique<inbox>(inbox{
+      .name = name,
+      .priority = priority,
+      .capacity = capacity,
+      .fn = std::move(fn),
+      .depth = r.make_gauge("noir_p2p_inbox_depth", "Number of envelopes queued for a reactor", labels),
+      .dropped = r.make_counter("noir_p2p_inbox_dropped_total", "Number of envelopes dropped at a full inbox", labels),
+    }));
+  for (auto id : channels) {
+    check(!inbox_by_channel.contains(id), fmt::format("channel {:#04x} already has an inbox", static_cast<int>(id)));
+    inbox_by_channel[id] = &in;
+  }
+}
+
+void dispatcher::start() {
+  std::scoped_lock g{mtx};
+  if (!threads.empty())
+    return;
+  stopping = false;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([this, i]() {
+      fc::set_os_thread_name("dispatch-" + std::to_string(i));
+      run();
+    });
+  }
+}
+
+void dispatcher::stop() {
+  {
+    std::scoped_lock g{mtx};
+    stopping = true;
+  }
+  cv.notify_all();
+  for (auto& t : threads) {
+    t.join();
+  }
+  std::scoped_lock g{mtx};
+  threads.clear();
+  for (auto& in : inboxes) {
+    in->queue.clear();
+    in->depth.set(0);
+  }
+}
+
+bool dispatcher::dispatch(const envelope_ptr& env) {
+  auto it = inbox_by_channel.find(env->id);
+  if (it == inbox_by_channel.end())
+    return false;
+  auto& in = *it->second;
+  {
+    std::scoped_lock g{mtx};
+    if (in.queue.size() >= in.capacity) {
+      in.dropped.inc();
+      return false;
+    }
+    in.queue.push_back(env);
+    in.depth.set(in.queue.size());
+  }
+  cv.notify_one();
+  return true;
+}
+
+size_t dispatcher::depth(const std::string& name) const {
+  std::scoped_lock g{mtx};
+  auto it = std::find_if(inboxes.begin(), inboxes.end(), [&](const auto& in) { return in->name == name; });
+  return it != inboxes.end() ? (*it)->queue.size() : 0;
+}
+
+dispatcher::inbox* dispatcher::next_inbox() {
+  for (auto& in : inboxes) {
+    if (!in->busy && !in->queue.empty())
+      return in.get();
+  }
+  return nullptr;
+}
+
+void dispatcher::run() {
+  std::unique_lock g{mtx};
+  while (true) {
+    inbox* in{};
+    cv.wait(g, [&]() { return stopping || (in = next_inbox()); });
+    if (stopping)
+      return;
+    auto env = std::move(in->queue.front());
+    in->queue.pop_front();
+    in->depth.set(in->queue.size());
+    in->busy = true;
+    g.unlock();
+
+    try {
+      in->fn(env);
+    } catch (const std::exception& e) {
+      elog(fmt::format("failed to handle envelope of inbox {}: {}", in->name, e.what()));
+    } catch (...) {
+      elog(fmt::format("failed to handle envelope of inbox {}", in->name));
+    }
+
+    g.lock();
+    in->busy = false;
+    if (!in->queue.empty())
+      cv.notify_one();
+  }
+}
+
+void add_reactor_inboxes(dispatcher& d, appbase::application& app) {
+  namespace methods = plugin_interface::incoming::methods;
+  d.add_inbox("consensus", {State, Data, Vote, VoteSetBits}, 0, 4096,
+    [&app](const envelope_ptr& env) { app.get_method<methods::cs_reactor_message>()(env); });
+  d.add_inbox("block_sync", {BlockSync}, 1, 1024,
+    [&app](const envelope_ptr& env) { app.get_method<methods::bs_reactor_message>()(env); });
+  d.add_inbox("evidence", {Evidence}, 2, 1024,
+    [&app](const envelope_ptr& env) { app.get_method<methods::es_reactor_message>()(env); });
+  // tx_pool is a plugin of its own, and without it Transaction envelopes have no provider to reach
+  if (app.find_plugin(tx_pool_plugin_name)) {
+    d.add_inbox("tx_pool", {Transaction}, 2, 4096,
+      [&app](const envelope_ptr& env) { app.get_method<methods::tp_reactor_message>()(env); });
+  }
+}
+
+} // namespace noir::p2p
@@ -0,0 +1,87 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/metrics/metrics.h>
+#include <noir/p2p/types.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace appbase {
+class application;
+}
+
+namespace noir::p2p {
+
+/// \brief hands envelopes received from peers to reactors through bounded inboxes, on threads of its own
+/// Envelopes of an inbox are handled one at a time, in the order they were dispatched. A free thread always takes the
+/// next envelope from the inbox of the highest priority which has any, so consensus messages never wait behind mempool
+/// or evidence traffic. An envelope dispatched to a full inbox is dropped, as peers gossip again what is missed.
+class dispatcher {
+public:
+  using handler = std::function<void(const envelope_ptr&)>;
+
+  explicit dispatcher(size_t num_threads = 2);
+  ~dispatcher();
+
+  /// \brief adds an inbox for envelopes of channels; must be called before start
+  /// \param[in] priority inboxes of a lower value are drained first
+  /// \param[in] capacity number of envelopes queued at most
+  void add_inbox(
+    const std::string& name, const std::vector<channel_id>& channels, int priority, size_t capacity, handler fn);
+
+  void start();
+  /// \brief joins threads after the envelopes being handled; envelopes left queued are discarded
+  void stop();
+
+  /// \brief queues env to the inbox of its channel
+  /// \return false if env is dropped, as the inbox is full or no inbox takes its channel
+  bool dispatch(const envelope_ptr& env);
+
+  /// \return number of envelopes queued in the inbox of name
+  size_t depth(const std::string& name) const;
+
+private:
+  struct inbox {
+    std::string name;
+    int priority;
+    size_t capacity;
+    handler fn;
+    std::deque<envelope_ptr> queue;
+    bool busy{false};
+    metrics::gauge depth;
+    metrics::counter dropped;
+  };
+
+  void run();
+  /// \return inbox of the highest priority with envelopes and not being drained by another thread, or nullptr
+  inbox* next_inbox();
+
+  const size_t num_threads;
+  std::vector<std::unique_ptr<inbox>> inboxes; // sorted by priority
+  std::map<channel_id, inbox*> inbox_by_channel;
+
+  mutable std::mutex mtx;
+  std::condition_variable cv;
+  bool stopping{false};
+  std::vector<std::thread> threads;
+};
+
+/// \brief name under which appbase registers noir::tx_pool::tx_pool, whose header p2p does not depend on
+inline constexpr const char* tx_pool_plugin_name = "noir::tx_pool::tx_pool";
+
+/// \brief adds inboxes handing envelopes to the consensus, block_sync, evidence and tx_pool reactors of app
+/// The tx_pool inbox is added only when the tx_pool plugin is registered; otherwise Transaction envelopes are dropped
+/// at dispatch instead of failing in a handler.
+void add_reactor_inboxes(dispatcher& d, appbase::application& app);
+
+} // namespace noir::p2p
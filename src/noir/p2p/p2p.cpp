@@ -10,8 +10,10 @@
 #include <noir/consensus/tx.h>
 #include <noir/consensus/types/encoding_helper.h>
 #include <noir/consensus/types/node_info.h>
+#include <noir/metrics/metrics.h>
 #include <noir/net/detail/message_buffer.h>
 #include <noir/p2p/conn/secret_connection.h>
+#include <noir/p2p/dispatcher.h>
 #include <noir/p2p/p2p.h>
 #include <noir/p2p/queued_buffer.h>
 #include <noir/p2p/types.h>
@@ -26,6 +28,7 @@
 #include <google/protobuf/wrappers.pb.h>
 
 #include <atomic>
+#include <map>
 #include <shared_mutex>
 
 namespace noir::p2p {
@@ -99,6 +102,15 @@ public:
   tstamp latest_msg_time{0};
   tstamp hb_timeout;
 
+  struct channel_metrics {
+    metrics::counter messages_sent;
+    metrics::counter bytes_sent;
+    metrics::counter messages_received;
+    metrics::counter bytes_received;
+  };
+  std::map<int32_t, channel_metrics> metrics_by_channel; // accessed only from strand threads
+  channel_metrics& get_channel_metrics(int32_t id);
+
   bool connected();
   bool current();
 
@@ -187,14 +199,6 @@ public:
   consensus::abci* abci_plug{nullptr};
 
   // Channels
-  plugin_interface::incoming::channels::cs_reactor_message_queue::channel_type& cs_reactor_mq_channel =
-    app.get_channel<plugin_interface::incoming::channels::cs_reactor_message_queue>();
-  plugin_interface::incoming::channels::bs_reactor_message_queue::channel_type& bs_reactor_mq_channel =
-    app.get_channel<plugin_interface::incoming::channels::bs_reactor_message_queue>();
-  plugin_interface::incoming::channels::es_reactor_message_queue::channel_type& es_reactor_mq_channel =
-    app.get_channel<plugin_interface::incoming::channels::es_reactor_message_queue>();
-  plugin_interface::incoming::channels::tp_reactor_message_queue::channel_type& tp_reactor_mq_channel =
-    app.get_channel<plugin_interface::incoming::channels::tp_reactor_message_queue>();
   plugin_interface::channels::update_peer_status::channel_type& update_peer_status_channel =
     app.get_channel<plugin_interface::channels::update_peer_status>();
 
@@ -229,6 +233,9 @@ public:
   uint16_t thread_pool_size = 2;
   std::optional<named_thread_pool> thread_pool;
 
+  // Hands envelopes from peers to reactors
+  dispatcher inbound{2};
+
 public:
   void update_chain_info();
   void start_listen_loop();
@@ -524,6 +531,7 @@ void p2p::plugin_initialize(const CLI::App& config) {
   // my->p2p_server_address = "0.0.0.0:9876"; // An externally accessible host:port for identifying this node.
   // Defaults to p2p-listen-endpoint
   my->thread_pool_size = 2; // number of threads to use
+  add_reactor_inboxes(my->inbound, app);
 
   // setup node_info
   auto abci_options = config.get_subcommand("abci");
@@ -557,6 +565,7 @@ void p2p::plugin_startup() {
     ilog(fmt::format("my node_id is {}", my->node_id.to_string()));
 
     my->thread_pool.emplace("p2p", my->thread_pool_size);
+    my->inbound.start();
 
     tcp::endpoint listen_endpoint;
     if (my->p2p_address.size() > 0) {
@@ -631,6 +640,7 @@ void p2p::plugin_shutdown() {
   my->connector_check_timer->cancel();
   my->thread_pool->stop();
   my->thread_pool.reset();
+  my->inbound.stop();
 }
 
 std::string p2p::connect(const std::string& host) {
@@ -862,7 +872,29 @@ void connection::flush_queues() {
   buffer_queue.clear_write_queue();
 }
 
+connection::channel_metrics& connection::get_channel_metrics(int32_t id) {
+  auto it = metrics_by_channel.find(id);
+  if (it == metrics_by_channel.end()) {
+    auto& r = metrics::default_registry();
+    metrics::label_set labels = {{"channel", fmt::format("{:#04x}", id)}, {"peer", to_hex(conn_node_id)}};
+    it = metrics_by_channel
+           .emplace(id,
+             channel_metrics{
+               .messages_sent = r.make_counter("noir_p2p_messages_sent_total", "Number of messages sent", labels),
+               .bytes_sent = r.make_counter("noir_p2p_bytes_sent_total", "Bytes of messages sent", labels),
+               .messages_received =
+                 r.make_counter("noir_p2p_messages_received_total", "Number of messages received", labels),
+               .bytes_received = r.make_counter("noir_p2p_bytes_received_total", "Bytes of messages received", labels),
+             })
+           .first;
+  }
+  return it->second;
+}
+
 void connection::enqueue(const envelope& m) {
+  auto& channel = get_channel_metrics(m.id);
+  channel.messages_sent.inc();
+  channel.bytes_sent.inc(m.message.size());
   ::tendermint::p2p::PacketMsg msg;
   msg.set_channel_id(m.id);
   msg.set_data({m.message.begin(), m.message.end()});
@@ -1227,6 +1259,7 @@ Result<void> connection::task_node_info(std::shared_ptr<Bytes> bz) {
   auto peer_info = consensus::node_info::from_proto(pb);
   ilog(fmt::format("node_info: peer={}", peer_info->node_id.id));
   conn_node_id = from_hex(peer_info->node_id.id);
+  metrics_by_channel.clear();
 
   cb_current_task = [conn = shared_from_this()](
                       std::shared_ptr<Bytes> msg) -> Result<void> { return conn->task_process_message(msg); };
@@ -1249,6 +1282,9 @@ Result<void> connection::task_process_message(std::shared_ptr<Bytes> bz) {
     dlog(" >> PONG");
   } else if (pb_packet.sum_case() == tendermint::p2p::Packet::kPacketMsg) {
     const auto& msg = pb_packet.packet_msg();
+    auto& channel = get_channel_metrics(msg.channel_id());
+    channel.messages_received.inc();
+    channel.bytes_received.inc(msg.data().size());
     dlog(fmt::format(" >> MSG : channel_id={} eof={} data={}", msg.channel_id(), msg.eof(), to_hex(msg.data())));
     auto new_envelope = std::make_shared<envelope>();
     new_envelope->from = to_hex(conn_node_id);
@@ -1260,17 +1296,12 @@ Result<void> connection::task_process_message(std::shared_ptr<Bytes> bz) {
     case Data:
     case Vote:
     case VoteSetBits:
-      // case Consensus:
-      my_impl->cs_reactor_mq_channel.publish( ///< notify consensus reactor to take additional actions
-        appbase::priority::medium, new_envelope);
-      break;
     case BlockSync:
-      my_impl->bs_reactor_mq_channel.publish( ///< notify block_sync reactor to take additional actions
-        appbase::priority::medium, new_envelope);
-      break;
     case Evidence:
-      my_impl->es_reactor_mq_channel.publish( ///< notify evidence reactor to take additional actions
-        appbase::priority::medium, new_envelope);
+    case Transaction:
+      if (!my_impl->inbound.dispatch(new_envelope)) { ///< notify reactors to take additional actions
+        dlog(fmt::format("dropped envelope as inbox is full or absent: channel_id={}", msg.channel_id()));
+      }
       break;
     case PeerError:
       elog(fmt::format("received peer_error from={} error={}", new_envelope->from, to_hex(msg.data())));
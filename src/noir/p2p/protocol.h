@@ -167,6 +167,20 @@ struct vote_set_bits_message {
   block_id block_id_;
   std::shared_ptr<consensus::bit_array> votes;
 };
+
+/// \brief votes a peer is missing, gossiped at once rather than as a vote_message each
+struct votes_message {
+  std::vector<vote_message> votes;
+};
+
+/// \brief votes received since the last has_votes_message of a height, round and type, replacing a has_vote_message
+/// per vote
+struct has_votes_message {
+  int64_t height;
+  int32_t round;
+  signed_msg_type type;
+  std::shared_ptr<consensus::bit_array> votes;
+};
 ///< consensus message ends
 
 enum go_away_reason {
@@ -212,7 +226,9 @@ using cs_reactor_message = std::variant<new_round_step_message,
   vote_message,
   has_vote_message,
   vote_set_maj23_message,
-  vote_set_bits_message>;
+  vote_set_bits_message,
+  votes_message,
+  has_votes_message>;
 
 /// \brief messages that will be delivered to block_sync reactor
 using bs_reactor_message = std::variant<consensus::block_request,
@@ -244,3 +260,5 @@ NOIR_REFLECT(noir::p2p::vote_message, type, height, round, block_id_, timestamp,
 NOIR_REFLECT(noir::p2p::has_vote_message, height, round, type, index);
 NOIR_REFLECT(noir::p2p::vote_set_maj23_message, height, round, type, block_id_);
 NOIR_REFLECT(noir::p2p::vote_set_bits_message, height, round, type, block_id_, votes);
+NOIR_REFLECT(noir::p2p::votes_message, votes);
+NOIR_REFLECT(noir::p2p::has_votes_message, height, round, type, votes);
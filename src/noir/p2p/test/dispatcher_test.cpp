@@ -0,0 +1,106 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#include <catch2/catch_all.hpp>
+#include <noir/p2p/dispatcher.h>
+#include <appbase/application.hpp>
+
+#include <future>
+
+using namespace noir;
+using namespace noir::p2p;
+
+namespace {
+
+envelope_ptr make_envelope(channel_id id, const std::string& from) {
+  auto env = std::make_shared<envelope>();
+  env->id = id;
+  env->from = from;
+  return env;
+}
+
+} // namespace
+
+TEST_CASE("dispatcher: Keep order within an inbox", "[noir][p2p]") {
+  std::mutex mtx;
+  std::vector<std::string> handled;
+  std::promise<void> done;
+  dispatcher d(4);
+  d.add_inbox("consensus", {State, Vote}, 0, 100, [&](const envelope_ptr& env) {
+    std::scoped_lock g{mtx};
+    handled.push_back(env->from);
+    if (handled.size() == 50)
+      done.set_value();
+  });
+  d.start();
+  for (auto i = 0; i < 50; i++) {
+    CHECK(d.dispatch(make_envelope(i % 2 ? State : Vote, std::to_string(i))));
+  }
+  done.get_future().wait();
+  d.stop();
+
+  for (auto i = 0; i < 50; i++) {
+    CHECK(handled[i] == std::to_string(i));
+  }
+}
+
+TEST_CASE("dispatcher: Drop at a full inbox", "[noir][p2p]") {
+  dispatcher d(1);
+  d.add_inbox("evidence", {Evidence}, 2, 3, [](const envelope_ptr&) {});
+
+  // not started, so nothing is drained
+  for (auto i = 0; i < 3; i++) {
+    CHECK(d.dispatch(make_envelope(Evidence, "")));
+  }
+  CHECK(!d.dispatch(make_envelope(Evidence, "")));
+  CHECK(d.depth("evidence") == 3);
+  CHECK(!d.dispatch(make_envelope(BlockSync, "")));
+}
+
+TEST_CASE("dispatcher: Drain inboxes by priority", "[noir][p2p]") {
+  std::vector<std::string> handled;
+  std::promise<void> blocked, release, done;
+  auto released = release.get_future();
+  dispatcher d(1);
+  d.add_inbox("tx_pool", {Transaction}, 2, 100, [&](const envelope_ptr& env) {
+    if (env->from == "first") {
+      blocked.set_value();
+      released.wait();
+    }
+    handled.push_back(env->from);
+    if (handled.size() == 5)
+      done.set_value();
+  });
+  d.add_inbox("consensus", {Vote}, 0, 100, [&](const envelope_ptr& env) {
+    handled.push_back(env->from);
+    if (handled.size() == 5)
+      done.set_value();
+  });
+  d.start();
+
+  // the only thread is busy while mempool and consensus traffic queue up
+  CHECK(d.dispatch(make_envelope(Transaction, "first")));
+  blocked.get_future().wait();
+  CHECK(d.dispatch(make_envelope(Transaction, "tx")));
+  CHECK(d.dispatch(make_envelope(Vote, "vote1")));
+  CHECK(d.dispatch(make_envelope(Transaction, "tx")));
+  CHECK(d.dispatch(make_envelope(Vote, "vote2")));
+  release.set_value();
+  done.get_future().wait();
+  d.stop();
+
+  CHECK((handled == std::vector<std::string>{"first", "vote1", "vote2", "tx", "tx"}));
+}
+
+TEST_CASE("dispatcher: No tx_pool inbox without the plugin", "[noir][p2p]") {
+  appbase::application app;
+  dispatcher d(1);
+  add_reactor_inboxes(d, app);
+
+  CHECK(d.dispatch(make_envelope(Vote, "")));
+  CHECK(d.depth("consensus") == 1);
+  CHECK(!d.dispatch(make_envelope(Transaction, "")));
+  CHECK(d.depth("tx_pool") == 0);
+}
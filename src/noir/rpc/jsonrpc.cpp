@@ -27,8 +27,7 @@ public:
           try {
             if (body.empty())
               body = "{}";
-            auto result = endpoints[url].handle_request(body);
-            cb(200, result);
+            endpoints[url].handle_request(body, [cb](fc::variant result) { cb(200, std::move(result)); });
           } catch (...) {
             rpc::handle_exception("jsonrpc", "jsonrpc", body, cb);
           }
@@ -3,6 +3,7 @@
 // Copyright (c) 2022 Haderech Pte. Ltd.
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
+#include <noir/common/trace.h>
 #include <noir/rpc/jsonrpc/endpoint.h>
 #include <fc/exception/exception.hpp>
 #include <fc/io/json.hpp>
@@ -13,6 +14,10 @@ void detail::endpoint_impl::add_handler(const std::string& method_name, request_
   handlers.emplace(method_name, handler);
 }
 
+void detail::endpoint_impl::add_async_handler(const std::string& method_name, async_request_handler handler) {
+  async_handlers.emplace(method_name, handler);
+}
+
 void detail::endpoint_impl::rpc_id(const fc::variant_object& request, response& response) {
   if (request.contains("id")) {
     const fc::variant& _id = request["id"];
@@ -35,7 +40,12 @@ void detail::endpoint_impl::rpc_jsonrpc(const fc::variant_object& request, respo
       std::string method = request["method"].as_string();
       try {
         fc::variant func_args = request.contains("params") ? request["params"] : fc::variant("{}");
-        response.result = handlers.at(method)(func_args);
+        auto it = handlers.find(method);
+        if (it == handlers.end())
+          throw std::out_of_range(method);
+        // spans keep their name by pointer, so the key of the handler is used rather than method
+        trace::span span(it->first.c_str());
+        response.result = it->second(func_args);
       } catch (fc::assert_exception& e) {
         response.error = error(error_code::internal_error, e.to_string(), fc::variant(*(e.dynamic_copy_exception())));
       } catch (std::out_of_range& e) {
@@ -119,13 +129,67 @@ fc::variant detail::endpoint_impl::handle_request(const std::string& message) {
   }
 }
 
+void detail::endpoint_impl::handle_request(const std::string& message, std::function<void(fc::variant)> cb) {
+  // only a single request to an async handler is deferred; batches and anything invalid are handled as usual
+  auto it = async_handlers.end();
+  fc::variant v;
+  try {
+    v = fc::json::from_string(message);
+    if (v.is_object() && v.get_object().contains("method") && v.get_object()["method"].is_string())
+      it = async_handlers.find(v.get_object()["method"].as_string());
+  } catch (...) {
+  }
+  if (it == async_handlers.end()) {
+    cb(handle_request(message));
+    return;
+  }
+
+  const auto& request = v.get_object();
+  auto has_id = request.contains("id");
+  auto res = std::make_shared<response>();
+  rpc_id(request, *res);
+  if (!res->error &&
+    !(request.contains("jsonrpc") && request["jsonrpc"].is_string() && request["jsonrpc"].as_string() == "2.0"))
+    res->error = error(error_code::invalid_request, "jsonrpc value is not \"2.0\"");
+  if (res->error) {
+    cb(has_id ? fc::variant(*res) : fc::variant());
+    return;
+  }
+
+  try {
+    fc::variant func_args = request.contains("params") ? request["params"] : fc::variant("{}");
+    trace::span span(it->first.c_str());
+    it->second(func_args, [res, has_id, cb](std::optional<fc::variant> result, std::optional<error> err) {
+      res->result = std::move(result);
+      res->error = std::move(err);
+      cb(has_id ? fc::variant(*res) : fc::variant());
+    });
+  } catch (fc::exception& e) {
+    // handlers throw only before completing their request; async handlers cancel any pending completion first
+    res->error = error(error_code::server_error, e.to_string(), fc::variant(*(e.dynamic_copy_exception())));
+    cb(has_id ? fc::variant(*res) : fc::variant());
+  } catch (std::exception& e) {
+    res->error = error(error_code::server_error, "Unknown error - parsing rpc message failed", fc::variant(e.what()));
+    cb(has_id ? fc::variant(*res) : fc::variant());
+  }
+}
+
 void endpoint::add_handler(const std::string& method_name, request_handler handler) {
   ilog("${method} is added", ("method", method_name));
   my->add_handler(method_name, handler);
 }
 
+void endpoint::add_async_handler(const std::string& method_name, async_request_handler handler) {
+  ilog("${method} is added", ("method", method_name));
+  my->add_async_handler(method_name, handler);
+}
+
 fc::variant endpoint::handle_request(const std::string& message) {
   return my->handle_request(message);
 }
 
+void endpoint::handle_request(const std::string& message, std::function<void(fc::variant)> cb) {
+  my->handle_request(message, std::move(cb));
+}
+
 } // namespace noir::jsonrpc
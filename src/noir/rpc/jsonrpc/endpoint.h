@@ -32,6 +32,12 @@ struct error {
   std::optional<fc::variant> data;
 };
 
+/// completes an asynchronous request with either its result or an error
+typedef std::function<void(std::optional<fc::variant> result, std::optional<error> err)> response_callback;
+
+/// handler that may complete its request later from any thread, e.g. once a tx is committed
+typedef std::function<void(const fc::variant&, response_callback)> async_request_handler;
+
 struct response {
   std::string jsonrpc = "2.0";
   std::optional<fc::variant> result;
@@ -53,10 +59,13 @@ namespace detail {
     response rpc(const fc::variant& message);
 
     void add_handler(const std::string& method_name, request_handler handler);
+    void add_async_handler(const std::string& method_name, async_request_handler handler);
     fc::variant handle_request(const std::string& message);
+    void handle_request(const std::string& message, std::function<void(fc::variant)> cb);
 
   private:
     std::map<std::string, request_handler> handlers;
+    std::map<std::string, async_request_handler> async_handlers;
   };
 } // namespace detail
 
@@ -65,8 +74,13 @@ public:
   endpoint(): my(new detail::endpoint_impl()) {}
 
   void add_handler(const std::string& method, request_handler handler);
+  void add_async_handler(const std::string& method, async_request_handler handler);
   fc::variant handle_request(const std::string& message);
 
+  /// \brief handles message, calling cb once its response is ready
+  /// A single request to an async handler is completed by the handler, and any other message before returning.
+  void handle_request(const std::string& message, std::function<void(fc::variant)> cb);
+
 private:
   std::unique_ptr<detail::endpoint_impl> my;
 };
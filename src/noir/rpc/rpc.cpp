@@ -8,6 +8,7 @@
 //#include <noir/rpc/local_endpoint.h>
 //#endif
 #include <noir/common/thread_pool.h>
+#include <noir/metrics/metrics.h>
 
 #include <boost/asio.hpp>
 #include <boost/optional.hpp>
@@ -223,6 +224,8 @@ public:
 
   // key -> priority, url_handler
   map<string, detail::internal_url_handler> url_handlers;
+  // key -> content type, text_handler
+  map<string, std::pair<string, text_handler>> text_handlers;
   std::optional<tcp::endpoint> listen_endpoint;
   string access_control_allow_origin;
   string access_control_allow_headers;
@@ -647,6 +650,13 @@ public:
         return;
       }
 
+      if (auto it = text_handlers.find(con->get_uri()->get_resource()); it != text_handlers.end()) {
+        con->append_header("Content-type", it->second.first);
+        con->set_body(it->second.second());
+        con->set_status(websocketpp::http::status_code::ok);
+        return;
+      }
+
       con->append_header("Content-type", "application/json");
       con->defer_http_response();
 
@@ -912,6 +922,7 @@ void rpc::plugin_initialize(const CLI::App& config) {
 
 void rpc::plugin_startup() {
   handle_sighup(); // setup logging
+  add_text_handler("/metrics", metrics::content_type, []() { return metrics::default_registry().scrape(); });
   app.post(priority::high, [this]() {
     try {
       my->thread_pool.emplace("rpc", my->thread_pool_size);
@@ -1027,6 +1038,7 @@ void rpc::plugin_shutdown() {
 
   // release rpc_impl_ptr shared_ptrs captured in url handlers
   my->url_handlers.clear();
+  my->text_handlers.clear();
 
   app.post(0, [me = my]() {}); // keep my pointer alive until queue is drained
 }
@@ -1046,6 +1058,11 @@ void rpc::add_async_handler(const string& url, const url_handler& handler) {
   my->url_handlers[url] = my->make_http_thread_url_handler(handler);
 }
 
+void rpc::add_text_handler(const string& url, const string& content_type, const text_handler& handler) {
+  fc_ilog(logger, "add text url: ${c}", ("c", url));
+  my->text_handlers[url] = {content_type, handler};
+}
+
 void rpc::handle_exception(const char* api_name, const char* call_name, const string& body, url_response_callback cb) {
   try {
     try {
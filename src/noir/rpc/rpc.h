@@ -40,6 +40,13 @@ using url_handler = std::function<void(std::string, std::string, url_response_ca
  * call, and the handler is the function which implements the API call
  */
 using api_description = std::map<std::string, url_handler>;
+
+/**
+ * @brief Callback type for a handler of plain text, e.g. metrics
+ *
+ * Returns: response_body
+ **/
+using text_handler = std::function<std::string()>;
 using ws_api_description = std::map<std::string, message_handler>;
 
 struct rpc_defaults {
@@ -100,6 +107,10 @@ public:
       add_handler(call.first, call.second);
   }
 
+  /// \brief serves the text returned by handler as is, with the given content type
+  /// The handler is called on the http thread, so it must be thread safe and must not block.
+  void add_text_handler(const std::string& url, const std::string& content_type, const text_handler& handler);
+
   // standard exception handling for api handlers
   static void handle_exception(
     const char* api_name, const char* call_name, const std::string& body, url_response_callback cb);
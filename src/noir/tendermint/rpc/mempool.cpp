@@ -7,6 +7,8 @@
 #include <noir/consensus/abci_types.h>
 #include <noir/consensus/tx.h>
 #include <noir/tendermint/rpc/mempool.h>
+#include <mutex>
+#include <optional>
 
 namespace noir::tendermint::rpc {
 
@@ -31,20 +33,91 @@ result_broadcast_tx mempool::broadcast_tx_sync(const tx& t) {
     .hash = get_tx_hash(t)};
 }
 
-// TODO: not implemented
-// result_broadcast_tx_commit mempool::broadcast_tx_commit(const tx& t) {
-//  return result_broadcast_tx_commit{};
-//}
+void mempool::broadcast_tx_commit(const tx& t, std::function<void(Result<result_broadcast_tx_commit>)> done) {
+  if (!commit_waiters) {
+    done(Error("broadcast_tx_commit is not available"));
+    return;
+  }
 
-result_unconfirmed_txs mempool::unconfirmed_txs(const uint32_t& limit_ptr) {
-  auto txs = tx_pool_ptr->reap_max_txs(limit_ptr);
-  return result_unconfirmed_txs{
-    .count = txs.size(), .total = tx_pool_ptr->size(), .total_bytes = tx_pool_ptr->size_bytes(), .txs = txs};
+  // waits before checking tx, so that its commit can't be missed. A commit seen before the result of check_tx is
+  // stored is kept until then, so the result is never read while check_tx writes it.
+  using commit_result = Result<::tendermint::abci::TxResult>;
+  struct pending_commit {
+    std::mutex mtx;
+    std::optional<::tendermint::abci::ResponseCheckTx> check_tx;
+    std::optional<commit_result> committed;
+  };
+  auto tx_hash = get_tx_hash(t);
+  auto pending = std::make_shared<pending_commit>();
+  auto complete = [tx_hash, done](const ::tendermint::abci::ResponseCheckTx& check_tx, commit_result res) {
+    if (!res) {
+      done(res.error());
+      return;
+    }
+    done(result_broadcast_tx_commit{.check_tx = check_tx,
+      .deliver_tx = res.value().result(),
+      .hash = Bytes(tx_hash),
+      .height = res.value().height()});
+  };
+  auto id = commit_waiters->wait(tx_hash, get_time() + commit_timeout.count(), [pending, complete](commit_result res) {
+    {
+      std::scoped_lock g{pending->mtx};
+      if (!pending->check_tx) {
+        pending->committed = std::move(res);
+        return;
+      }
+    }
+    complete(*pending->check_tx, std::move(res));
+  });
+
+  // a handler throws only before completing its request, and the request is completed only once check_tx returns
+  response_check_tx* r{};
+  try {
+    r = &tx_pool_ptr->check_tx_sync(std::make_shared<consensus::tx>(t));
+  } catch (...) {
+    commit_waiters->cancel(tx_hash, id);
+    throw;
+  }
+  ::tendermint::abci::ResponseCheckTx check_tx_res;
+  check_tx_res.set_code(r->code);
+  check_tx_res.set_data({r->data.begin(), r->data.end()});
+  check_tx_res.set_log(r->log);
+  check_tx_res.set_codespace(r->codespace);
+  check_tx_res.set_mempool_error(r->mempool_error);
+
+  std::optional<commit_result> committed;
+  {
+    std::scoped_lock g{pending->mtx};
+    pending->check_tx = check_tx_res;
+    committed = std::move(pending->committed);
+  }
+  if (committed) {
+    complete(check_tx_res, std::move(*committed));
+  } else if (r->code != code_type_ok) {
+    // tx won't be committed, so the waiter is completed here with the result of check_tx
+    if (commit_waiters->cancel(tx_hash, id))
+      done(result_broadcast_tx_commit{.check_tx = check_tx_res, .hash = Bytes(tx_hash)});
+  }
+}
+
+result_unconfirmed_txs mempool::unconfirmed_txs(uint64_t cursor, uint32_t limit, bool hashes_only) {
+  auto snapshot = tx_pool_ptr->snapshot();
+  auto res = result_unconfirmed_txs{.total = snapshot->size, .total_bytes = snapshot->bytes, .epoch = snapshot->epoch};
+  res.next_cursor = snapshot->for_each(cursor, limit, [&](const auto& e) {
+    if (hashes_only) {
+      res.hashes.push_back(e.hash);
+    } else {
+      res.txs.push_back(e.tx);
+    }
+  });
+  res.count = hashes_only ? res.hashes.size() : res.txs.size();
+  return res;
 }
 
 result_unconfirmed_txs mempool::num_unconfirmed_txs() {
+  auto snapshot = tx_pool_ptr->snapshot();
   return result_unconfirmed_txs{
-    .count = tx_pool_ptr->size(), .total = tx_pool_ptr->size(), .total_bytes = tx_pool_ptr->size_bytes()};
+    .count = snapshot->size, .total = snapshot->size, .total_bytes = snapshot->bytes, .epoch = snapshot->epoch};
 }
 
 response_check_tx& mempool::check_tx(const tx& t) {
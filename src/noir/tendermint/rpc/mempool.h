@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 #pragma once
+#include <noir/consensus/tx_commit_waiters.h>
 #include <noir/tendermint/rpc/responses.h>
 #include <noir/tx_pool/tx_pool.h>
 
@@ -13,8 +14,11 @@ class mempool {
 public:
   result_broadcast_tx broadcast_tx_async(const Bytes& tx);
   result_broadcast_tx broadcast_tx_sync(const Bytes& tx);
-  //  result_broadcast_tx_commit broadcast_tx_commit(const tx& t);
-  result_unconfirmed_txs unconfirmed_txs(const uint32_t& limit_ptr);
+  /// \brief checks tx, then calls done once it is committed or timeout passes
+  void broadcast_tx_commit(const Bytes& tx, std::function<void(Result<result_broadcast_tx_commit>)> done);
+  /// \brief a page of txs in the pool, read from a snapshot without locking the pool
+  /// \param cursor next_cursor of the previous page, or 0 for the first page
+  result_unconfirmed_txs unconfirmed_txs(uint64_t cursor, uint32_t limit, bool hashes_only = false);
   result_unconfirmed_txs num_unconfirmed_txs();
   noir::consensus::response_check_tx& check_tx(const Bytes& tx);
 
@@ -22,8 +26,15 @@ public:
     this->tx_pool_ptr = tx_pool_ptr;
   }
 
+  void set_commit_waiters(std::shared_ptr<consensus::tx_commit_waiters> waiters, std::chrono::microseconds timeout) {
+    commit_waiters = std::move(waiters);
+    commit_timeout = timeout;
+  }
+
 private:
   noir::tx_pool::tx_pool* tx_pool_ptr;
+  std::shared_ptr<consensus::tx_commit_waiters> commit_waiters;
+  std::chrono::microseconds commit_timeout{std::chrono::seconds(10)};
 };
 
 } // namespace noir::tendermint::rpc
@@ -31,9 +31,16 @@ struct result_unconfirmed_txs {
   uint64_t total;
   uint64_t total_bytes;
   std::vector<std::shared_ptr<const Bytes>> txs;
+
+  /// epoch of the pool snapshot the page was read from
+  uint64_t epoch;
+  /// cursor of the next page, or 0 if this is the last one
+  uint64_t next_cursor;
+  /// set instead of txs if only hashes are requested
+  std::vector<Bytes32> hashes;
 };
 
 } // namespace noir::tendermint::rpc
 
 NOIR_REFLECT(tendermint::rpc::result_broadcast_tx, code, data, log, codespace, mempool_error, hash);
-NOIR_REFLECT(tendermint::rpc::result_unconfirmed_txs, count, total, total_bytes, txs);
+NOIR_REFLECT(tendermint::rpc::result_unconfirmed_txs, count, total, total_bytes, txs, epoch, next_cursor, hashes);
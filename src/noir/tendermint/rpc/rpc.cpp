@@ -3,9 +3,12 @@
 // Copyright (c) 2022 Haderech Pte. Ltd.
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
+#include <noir/common/trace.h>
+#include <noir/consensus/abci.h>
 #include <noir/rpc/jsonrpc.h>
 #include <noir/tendermint/rpc/rpc.h>
 #include <fc/crypto/base64.hpp>
+#include <fc/io/json.hpp>
 
 namespace noir::tendermint::rpc {
 using namespace appbase;
@@ -13,7 +16,10 @@ using namespace fc;
 using namespace noir;
 using namespace noir::rpc;
 
-rpc::rpc(appbase::application& app): plugin(app), mempool_(std::make_shared<mempool>()) {}
+rpc::rpc(appbase::application& app)
+  : plugin(app),
+    mempool_(std::make_shared<mempool>()),
+    commit_waiters(std::make_shared<consensus::tx_commit_waiters>()) {}
 
 void rpc::set_program_options(CLI::App& config) {}
 
@@ -27,6 +33,15 @@ void rpc::plugin_initialize(const CLI::App& config) {
 void rpc::plugin_startup() {
   ilog("starting tendermint rpc");
 
+  // a single subscription to tx events completes all broadcast_tx_commit requests
+  if (auto abci = app.find_plugin<consensus::abci>(); abci && abci->node_) {
+    commit_waiters->subscribe(*abci->node_->event_bus_);
+    mempool_->set_commit_waiters(commit_waiters, std::chrono::seconds(10));
+    commit_thread.emplace("tx_commit", 1);
+    expire_timer = std::make_unique<boost::asio::steady_timer>(commit_thread->get_executor());
+    expire_commit_waiters();
+  }
+
   auto& endpoint = app.get_plugin<noir::rpc::jsonrpc>().get_or_create_endpoint("/tendermint");
   endpoint.add_handler("broadcast_tx_async", [&](auto& req) {
     auto tx = req.get_object()["tx"].as_string();
@@ -46,20 +61,31 @@ void rpc::plugin_startup() {
     to_variant(result, res);
     return res;
   });
-  endpoint.add_handler("broadcast_tx_commit", [&](auto& req) {
-    //      auto enc_tx = req.get_object()["tx"].as_string();
-    //      auto d = fc::base64_decode(enc_tx);
-    //      std::vector<char> raw_tx(d.begin(), d.end());
-    //      auto result = mempool_->broadcast_tx_commit(raw_tx);
-    //      variant res;
-    //      to_variant(result, res);
-    //      return res;
-    check(false, "not implemented yet");
-    return fc::variant(nullptr);
+  endpoint.add_async_handler("broadcast_tx_commit", [&](auto& req, noir::jsonrpc::response_callback cb) {
+    auto enc_tx = req.get_object()["tx"].as_string();
+    auto d = base64_decode(enc_tx);
+    std::vector<char> raw_tx(d.begin(), d.end());
+    mempool_->broadcast_tx_commit(raw_tx, [cb](Result<result_broadcast_tx_commit> result) {
+      if (!result) {
+        cb({}, noir::jsonrpc::error(noir::jsonrpc::server_error, result.error().message()));
+        return;
+      }
+      auto to_variant = [](const auto& res) {
+        return mutable_variant_object("code", res.code())("data", base64_encode(res.data()))("log", res.log())(
+          "gas_wanted", res.gas_wanted())("gas_used", res.gas_used())("codespace", res.codespace());
+      };
+      cb(variant(mutable_variant_object("check_tx", to_variant(result.value().check_tx))(
+           "deliver_tx", to_variant(result.value().deliver_tx))("hash", result.value().hash.to_string())(
+           "height", std::to_string(result.value().height))),
+        std::nullopt);
+    });
   });
   endpoint.add_handler("unconfirmed_txs", [&](const fc::variant& req) {
-    auto limit = req.get_object()["limit"].as<uint32_t>();
-    auto result = mempool_->unconfirmed_txs(limit);
+    const auto& params = req.get_object();
+    auto limit = params["limit"].as<uint32_t>();
+    auto cursor = params.contains("cursor") ? params["cursor"].as<uint64_t>() : 0;
+    auto hashes_only = params.contains("hashes_only") && params["hashes_only"].as_bool();
+    auto result = mempool_->unconfirmed_txs(cursor, limit, hashes_only);
     variant res;
     to_variant(result, res);
     return fc::variant(res);
@@ -79,8 +105,27 @@ void rpc::plugin_startup() {
     to_variant(result, res);
     return res;
   });
+  endpoint.add_handler("dump_trace", [&](auto& req) {
+    // spans recorded so far in the Chrome trace event format; empty unless tracing is enabled
+    return fc::json::from_string(trace::to_chrome_trace());
+  });
 }
 
-void rpc::plugin_shutdown() {}
+void rpc::plugin_shutdown() {
+  if (expire_timer) {
+    expire_timer->cancel();
+    commit_thread->stop();
+  }
+}
+
+void rpc::expire_commit_waiters() {
+  expire_timer->expires_after(std::chrono::milliseconds(100));
+  expire_timer->async_wait([this](const boost::system::error_code& ec) {
+    if (ec)
+      return;
+    commit_waiters->expire(get_time());
+    expire_commit_waiters();
+  });
+}
 
 } // namespace noir::tendermint::rpc
@@ -4,9 +4,11 @@
 // SPDX-License-Identifier: AGPL-3.0-or-later
 //
 #pragma once
+#include <noir/common/thread_pool.h>
 #include <noir/rpc/rpc.h>
 #include <noir/tendermint/rpc/mempool.h>
 #include <appbase/application.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 namespace noir::tendermint::rpc {
 
@@ -22,7 +24,12 @@ public:
   void plugin_shutdown();
 
 private:
+  void expire_commit_waiters();
+
   std::shared_ptr<mempool> mempool_;
+  std::shared_ptr<consensus::tx_commit_waiters> commit_waiters;
+  std::optional<named_thread_pool> commit_thread;
+  std::unique_ptr<boost::asio::steady_timer> expire_timer;
 };
 
 } // namespace noir::tendermint::rpc
@@ -545,6 +545,48 @@ TEST_CASE("tx_pool: Reap tx using max bytes & gas", "[noir][tx_pool]") {
   }
 }
 
+TEST_CASE("tx_pool: Snapshot pagination", "[noir][tx_pool]") {
+  auto test_helper = std::make_unique<::test_helper>();
+  auto& tp = test_helper->make_tx_pool();
+
+  const uint64_t tx_count = 1000;
+  auto txs = test_helper->new_txs(tx_count);
+  for (auto& tx : txs) {
+    CHECK_NOTHROW(tp.check_tx_sync(tx));
+  }
+
+  auto snapshot = tp.snapshot();
+  CHECK(snapshot->size == tx_count);
+
+  // pages of a snapshot are unaffected by txs removed later
+  std::vector<tx_ptr> block_txs(txs.begin(), txs.begin() + tx_count / 2);
+  std::vector<response_deliver_tx> responses(block_txs.size());
+  tp.update(1, block_txs, responses);
+  CHECK(tp.snapshot()->size == tx_count / 2);
+  CHECK(tp.snapshot()->epoch > snapshot->epoch);
+
+  std::vector<Bytes32> hashes;
+  uint64_t cursor = 0;
+  do {
+    cursor = snapshot->for_each(cursor, 64, [&](const auto& e) { hashes.push_back(e.hash); });
+  } while (cursor);
+  CHECK(hashes.size() == tx_count);
+  for (auto i = 0; i < tx_count; i++) {
+    CHECK(hashes[i] == get_tx_hash(*txs[i]));
+  }
+
+  // cursors of an older snapshot stay valid on a newer one
+  hashes.clear();
+  cursor = snapshot->for_each(0, tx_count / 2 + 1, [](const auto&) {});
+  tp.snapshot()->for_each(cursor, tx_count, [&](const auto& e) { hashes.push_back(e.hash); });
+  CHECK(hashes.size() == tx_count / 2 - 1);
+  CHECK(hashes.front() == get_tx_hash(*txs[tx_count / 2 + 1]));
+
+  tp.flush();
+  CHECK(tp.snapshot()->size == 0);
+  CHECK(tp.snapshot()->for_each(0, tx_count, [](const auto&) {}) == 0);
+}
+
 TEST_CASE("tx_pool: Update", "[noir][tx_pool]") {
   auto test_helper = std::make_unique<::test_helper>();
 
@@ -679,10 +721,7 @@ TEST_CASE("tx_pool: Broadcast tx", "[noir][tx_pool]") {
 
     auto size = tp.size();
 
-    app.get_channel<plugin_interface::incoming::channels::tp_reactor_message_queue>().publish(
-      appbase::priority::medium, new_env);
-
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    app.get_method<plugin_interface::incoming::methods::tp_reactor_message>()(new_env);
     CHECK(size + 1 == tp.size());
   }
 
@@ -14,9 +14,11 @@ tx_pool::tx_pool(appbase::application& app)
     config_(config{}),
     tx_queue_(config_.max_tx_num * config_.max_tx_bytes),
     tx_cache_(config_.max_tx_num),
+    height_expiry_(config_.ttl_num_blocks),
+    time_expiry_(config_.ttl_duration),
     proxy_app_(std::make_shared<consensus::app_connection>()),
     xmt_mq_channel_(app.get_channel<plugin_interface::egress::channels::transmit_message_queue>()),
-    msg_handle_(app.get_channel<plugin_interface::incoming::channels::tp_reactor_message_queue>().subscribe(
+    msg_handle_(app.get_method<plugin_interface::incoming::methods::tp_reactor_message>().register_provider(
       [this](auto&& arg) { handle_msg(std::forward<decltype(arg)>(arg)); })) {}
 
 tx_pool::tx_pool(appbase::application& app,
@@ -27,10 +29,12 @@ tx_pool::tx_pool(appbase::application& app,
     config_(cfg),
     tx_queue_(config_.max_tx_num * config_.max_tx_bytes),
     tx_cache_(config_.max_tx_num),
+    height_expiry_(config_.ttl_num_blocks),
+    time_expiry_(config_.ttl_duration),
     proxy_app_(new_proxy_app),
     block_height_(block_height),
     xmt_mq_channel_(app.get_channel<plugin_interface::egress::channels::transmit_message_queue>()),
-    msg_handle_(app.get_channel<plugin_interface::incoming::channels::tp_reactor_message_queue>().subscribe(
+    msg_handle_(app.get_method<plugin_interface::incoming::methods::tp_reactor_message>().register_provider(
       [this](auto&& arg) { handle_msg(std::forward<decltype(arg)>(arg)); })) {}
 
 void tx_pool::set_program_options(CLI::App& cfg) {
@@ -58,6 +62,8 @@ void tx_pool::plugin_initialize(const CLI::App& config) {
     config_.max_tx_bytes = tx_pool_options->get_option("--max_tx_bytes")->as<uint64_t>();
     config_.ttl_duration = tx_pool_options->get_option("--ttl_duration")->as<tstamp>();
     config_.ttl_num_blocks = tx_pool_options->get_option("--ttl_num_blocks")->as<uint64_t>();
+    height_expiry_ = expiry_wheel<consensus::tx_hash>(config_.ttl_num_blocks);
+    time_expiry_ = expiry_wheel<consensus::tx_hash>(config_.ttl_duration);
     config_.gas_price_bump = tx_pool_options->get_option("--gas_price_bump")->as<uint64_t>();
   }
   FC_LOG_AND_RETHROW()
@@ -136,16 +142,27 @@ void tx_pool::add_tx(
           "gas price is not enough for nonce override (tx_hash: {}, nonce: {})", tx_hash.to_string(), res.nonce));
     }
     tx_queue_.erase(old_wtx.hash);
+    snapshot_.erase(old_wtx.hash);
   }
 
   auto wtx = consensus::wrapped_tx(res.sender, tx_ptr, res.gas_wanted, res.nonce, block_height_);
 
   if (!tx_queue_.add_tx(wtx)) {
+    snapshot_.publish();
     if (!config_.keep_invalid_txs_in_cache) {
       tx_cache_.del(tx_hash);
     }
     FC_THROW_EXCEPTION(fc::full_pool_exception, fmt::format("Tx pool is full"));
   }
+  snapshot_.add(tx_hash, tx_ptr);
+  snapshot_.publish();
+
+  if (config_.ttl_num_blocks > 0) {
+    height_expiry_.add(wtx.height + config_.ttl_num_blocks, tx_hash);
+  }
+  if (config_.ttl_duration > 0) {
+    time_expiry_.add(wtx.time_stamp + config_.ttl_duration, tx_hash);
+  }
 
   if (config_.broadcast) {
     broadcast_tx(*tx_ptr);
@@ -197,6 +214,10 @@ std::vector<std::shared_ptr<const consensus::tx>> tx_pool::reap_max_txs(uint64_t
   return txs;
 }
 
+std::shared_ptr<const tx_snapshot> tx_pool::snapshot() const {
+  return snapshot_.current();
+}
+
 void tx_pool::update(uint64_t block_height,
   const std::vector<consensus::tx_ptr>& block_txs,
   std::vector<consensus::response_deliver_tx> responses,
@@ -223,28 +244,31 @@ void tx_pool::update(uint64_t block_height,
     }
 
     tx_queue_.erase(tx_hash);
+    snapshot_.erase(tx_hash);
   }
 
+  // hashes popped may belong to txs already committed or overridden
   if (config_.ttl_num_blocks > 0) {
-    uint64_t expired_block_height = block_height_ > config_.ttl_num_blocks ? block_height_ - config_.ttl_num_blocks : 0;
-    auto begin = tx_queue_.begin<unapplied_tx_queue::by_height>(0);
-    auto end = tx_queue_.end<unapplied_tx_queue::by_height>(expired_block_height);
-    for (auto& itr = begin; itr != end; itr++) {
-      auto& wtx = itr->wtx;
-      tx_queue_.erase(wtx.hash);
-    }
+    height_expiry_.expire(block_height_, [&](const consensus::tx_hash& tx_hash) {
+      if (auto wtx = tx_queue_.get_tx(tx_hash); wtx && wtx->height + config_.ttl_num_blocks <= block_height_) {
+        tx_queue_.erase(tx_hash);
+        snapshot_.erase(tx_hash);
+      }
+    });
   }
 
   if (config_.ttl_duration > 0) {
-    auto expired_time = get_time() - config_.ttl_duration;
-    auto begin = tx_queue_.begin<unapplied_tx_queue::by_time>(0);
-    auto end = tx_queue_.end<unapplied_tx_queue::by_time>(expired_time);
-    for (auto& itr = begin; itr != end; itr++) {
-      auto& wtx = itr->wtx;
-      tx_queue_.erase(wtx.hash);
-    }
+    auto now = get_time();
+    time_expiry_.expire(now, [&](const consensus::tx_hash& tx_hash) {
+      if (auto wtx = tx_queue_.get_tx(tx_hash); wtx && wtx->time_stamp + config_.ttl_duration <= now) {
+        tx_queue_.erase(tx_hash);
+        snapshot_.erase(tx_hash);
+      }
+    });
   }
 
+  snapshot_.publish();
+
   if (config_.recheck) {
     update_recheck_txs();
   }
@@ -277,6 +301,10 @@ void tx_pool::flush() {
   std::scoped_lock scoped_lock(mutex_);
   tx_queue_.clear();
   tx_cache_.reset();
+  height_expiry_.clear();
+  time_expiry_.clear();
+  snapshot_.clear();
+  snapshot_.publish();
 }
 
 void tx_pool::flush_app_conn() {
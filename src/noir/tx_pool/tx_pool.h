@@ -5,11 +5,13 @@
 //
 #pragma once
 
+#include <noir/common/expiry_wheel.h>
 #include <noir/common/plugin_interface.h>
 #include <noir/consensus/abci_types.h>
 #include <noir/consensus/app_connection.h>
 #include <noir/consensus/tx.h>
 #include <noir/tx_pool/LRU_cache.h>
+#include <noir/tx_pool/tx_snapshot.h>
 #include <noir/tx_pool/unapplied_tx_queue.h>
 #include <appbase/application.hpp>
 #include <fc/exception/exception.hpp>
@@ -44,13 +46,20 @@ private:
   unapplied_tx_queue tx_queue_;
   LRU_cache<consensus::tx_hash, consensus::tx_ptr> tx_cache_;
 
+  // txs of tx_queue_ republished on every change, so that readers don't need mutex_
+  tx_snapshot_index snapshot_;
+
+  // hashes of txs registered at their expiry height and time, so that update doesn't scan the whole pool
+  expiry_wheel<consensus::tx_hash> height_expiry_;
+  expiry_wheel<consensus::tx_hash> time_expiry_;
+
   uint64_t block_height_ = 0;
 
   precheck_func* precheck_ = nullptr;
   postcheck_func* postcheck_ = nullptr;
 
   plugin_interface::egress::channels::transmit_message_queue::channel_type& xmt_mq_channel_;
-  plugin_interface::incoming::channels::tp_reactor_message_queue ::channel_type::handle msg_handle_;
+  plugin_interface::incoming::methods::tp_reactor_message::method_type::handle msg_handle_;
 
 public:
   tx_pool(appbase::application& app);
@@ -76,6 +85,10 @@ public:
 
   std::vector<std::shared_ptr<const consensus::tx>> reap_max_bytes_max_gas(uint64_t max_bytes, uint64_t max_gas);
   std::vector<std::shared_ptr<const consensus::tx>> reap_max_txs(uint64_t tx_count);
+
+  /// \brief txs in the pool as of the last change, without locking the pool
+  std::shared_ptr<const tx_snapshot> snapshot() const;
+
   void update(uint64_t block_height,
     const std::vector<consensus::tx_ptr>& block_txs,
     std::vector<consensus::response_deliver_tx> responses,
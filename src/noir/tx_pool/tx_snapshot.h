@@ -0,0 +1,169 @@
+// This file is part of NOIR.
+//
+// Copyright (c) 2022 Haderech Pte. Ltd.
+// SPDX-License-Identifier: AGPL-3.0-or-later
+//
+#pragma once
+#include <noir/consensus/tx.h>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace noir::tx_pool {
+
+/// \brief immutable view of the txs in the pool at some epoch
+/// Txs are ordered by seq, which increases as txs are added, so a seq serves as a cursor that stays valid while txs
+/// before or after it are removed.
+struct tx_snapshot {
+  struct entry {
+    uint64_t seq;
+    consensus::tx_hash hash;
+    std::shared_ptr<const consensus::tx> tx;
+  };
+  using chunk = std::vector<entry>;
+
+  uint64_t epoch{0};
+  size_t size{0};
+  uint64_t bytes{0};
+  std::vector<std::shared_ptr<const chunk>> chunks;
+
+  /// \brief calls f on at most limit txs with seq greater than or equal to cursor, in seq order
+  /// \return cursor of the next page, or 0 if there are no more txs
+  template<typename F>
+  uint64_t for_each(uint64_t cursor, size_t limit, F&& f) const {
+    auto c = std::lower_bound(
+      chunks.begin(), chunks.end(), cursor, [](const auto& chunk, uint64_t seq) { return chunk->back().seq < seq; });
+    for (; c != chunks.end(); c++) {
+      auto e = std::lower_bound((*c)->begin(), (*c)->end(), cursor, [](const auto& e, uint64_t seq) {
+        return e.seq < seq;
+      });
+      for (; e != (*c)->end(); e++) {
+        if (limit-- == 0)
+          return e->seq;
+        f(*e);
+      }
+    }
+    return 0;
+  }
+};
+
+/// \brief maintains the txs of the pool as chunks that are copied on write, and publishes them as tx_snapshot
+/// Writers must be serialized by the owner, whereas current() may be called from any thread without locking. A
+/// mutation copies at most two chunks, and publish() copies the chunk pointers only, so keeping snapshots costs
+/// O(chunk_size + size / chunk_size) per tx regardless of how often they are read. Chunks falling below half full are
+/// merged with a neighbour, so no two adjacent chunks are both below half full and there are O(size / chunk_size).
+class tx_snapshot_index {
+public:
+  static constexpr size_t chunk_size = 256;
+
+  tx_snapshot_index(): published(std::make_shared<const tx_snapshot>()) {}
+
+  void add(const consensus::tx_hash& hash, const std::shared_ptr<const consensus::tx>& tx) {
+    if (seqs.contains(hash))
+      return;
+    auto seq = next_seq++;
+    if (chunks.empty() || chunks.back().chunk->size() >= chunk_size)
+      chunks.push_back({std::make_shared<tx_snapshot::chunk>(), true});
+    writable(chunks.back()).push_back({seq, hash, tx});
+    seqs[hash] = seq;
+    bytes += tx->size();
+    dirty = true;
+  }
+
+  bool erase(const consensus::tx_hash& hash) {
+    auto it = seqs.find(hash);
+    if (it == seqs.end())
+      return false;
+    auto seq = it->second;
+    seqs.erase(it);
+
+    auto c = std::lower_bound(
+      chunks.begin(), chunks.end(), seq, [](const auto& slot, uint64_t seq) { return slot.chunk->back().seq < seq; });
+    auto& entries = writable(*c);
+    auto e = std::lower_bound(
+      entries.begin(), entries.end(), seq, [](const auto& e, uint64_t seq) { return e.seq < seq; });
+    bytes -= e->tx->size();
+    entries.erase(e);
+    if (entries.empty())
+      chunks.erase(c);
+    else if (entries.size() < chunk_size / 2)
+      merge_with_neighbour(c);
+    dirty = true;
+    return true;
+  }
+
+  void clear() {
+    chunks.clear();
+    seqs.clear();
+    bytes = 0;
+    dirty = true;
+  }
+
+  /// \brief number of chunks txs are kept in
+  size_t num_chunks() const {
+    return chunks.size();
+  }
+
+  /// \brief makes changes since the last call visible to current()
+  void publish() {
+    if (!dirty)
+      return;
+    auto snapshot = std::make_shared<tx_snapshot>();
+    snapshot->epoch = ++epoch;
+    snapshot->size = seqs.size();
+    snapshot->bytes = bytes;
+    snapshot->chunks.reserve(chunks.size());
+    for (auto& slot : chunks) {
+      snapshot->chunks.push_back(slot.chunk);
+      slot.owned = false;
+    }
+    std::atomic_store(&published, std::shared_ptr<const tx_snapshot>(std::move(snapshot)));
+    dirty = false;
+  }
+
+  std::shared_ptr<const tx_snapshot> current() const {
+    return std::atomic_load(&published);
+  }
+
+private:
+  struct slot {
+    std::shared_ptr<tx_snapshot::chunk> chunk;
+    // chunks not yet published can be modified in place
+    bool owned;
+  };
+
+  tx_snapshot::chunk& writable(slot& s) {
+    if (!s.owned) {
+      s.chunk = std::make_shared<tx_snapshot::chunk>(*s.chunk);
+      s.owned = true;
+    }
+    return *s.chunk;
+  }
+
+  /// merges the chunk at c with the next or previous one if both fit in a single chunk
+  void merge_with_neighbour(std::vector<slot>::iterator c) {
+    auto fits = [&](std::vector<slot>::iterator other) {
+      return c->chunk->size() + other->chunk->size() <= chunk_size;
+    };
+    if (auto next = std::next(c); next != chunks.end() && fits(next)) {
+      auto& entries = writable(*c);
+      entries.insert(entries.end(), next->chunk->begin(), next->chunk->end());
+      chunks.erase(next);
+    } else if (c != chunks.begin() && fits(std::prev(c))) {
+      auto& entries = writable(*std::prev(c));
+      entries.insert(entries.end(), c->chunk->begin(), c->chunk->end());
+      chunks.erase(c);
+    }
+  }
+
+  uint64_t next_seq{1};
+  uint64_t epoch{0};
+  uint64_t bytes{0};
+  bool dirty{false};
+  std::vector<slot> chunks;
+  std::unordered_map<consensus::tx_hash, uint64_t, consensus::tx_hash_hash> seqs;
+  std::shared_ptr<const tx_snapshot> published;
+};
+
+} // namespace noir::tx_pool